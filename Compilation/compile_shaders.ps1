@@ -17,50 +17,36 @@ if (-not (Test-Path "Learning/Shaders")) {
   New-Item -Path "Learning/Shaders" -ItemType Directory | Out-Null
 }
 
-# Проверка существования исходных файлов шейдеров
-if (-not (Test-Path "Learning/Shaders/triangle.vert")) {
-  Write-Error "Не найден исходный файл вершинного шейдера: Learning/Shaders/triangle.vert"
-  exit 1
-}
+# Поиск исходных файлов шейдеров (вершинные, фрагментные и вычислительные)
+$shaders = @(Get-ChildItem -Path "Learning/Shaders" -File |
+  Where-Object { $_.Extension -in ".vert", ".frag", ".comp" })
 
-if (-not (Test-Path "Learning/Shaders/triangle.frag")) {
-  Write-Error "Не найден исходный файл фрагментного шейдера: Learning/Shaders/triangle.frag"
+if ($shaders.Count -eq 0) {
+  Write-Error "Не найдены исходные файлы шейдеров в Learning/Shaders"
   exit 1
 }
 
-# Компиляция вершинного шейдера
-Write-Host "Компиляция вершинного шейдера..."
-$vertCmd = "& `"$GLSLC`" -c `"Learning/Shaders/triangle.vert`" -o `"Learning/Shaders/triangle.vert.spv`""
-Write-Host "Выполняется: $vertCmd"
-Invoke-Expression $vertCmd
-if ($LASTEXITCODE -ne 0) {
-  Write-Error "Ошибка при компиляции вершинного шейдера"
-  exit $LASTEXITCODE
-}
-
-# Компиляция фрагментного шейдера
-Write-Host "Компиляция фрагментного шейдера..."
-$fragCmd = "& `"$GLSLC`" -c `"Learning/Shaders/triangle.frag`" -o `"Learning/Shaders/triangle.frag.spv`""
-Write-Host "Выполняется: $fragCmd"
-Invoke-Expression $fragCmd
-if ($LASTEXITCODE -ne 0) {
-  Write-Error "Ошибка при компиляции фрагментного шейдера"
-  exit $LASTEXITCODE
-}
-
-# Проверка создания файлов
-if (Test-Path "Learning/Shaders/triangle.vert.spv") {
-  Write-Host "Вершинный шейдер скомпилирован успешно: Learning/Shaders/triangle.vert.spv"
-}
-else {
-  Write-Error "Файл вершинного шейдера не создан!"
-}
-
-if (Test-Path "Learning/Shaders/triangle.frag.spv") {
-  Write-Host "Фрагментный шейдер скомпилирован успешно: Learning/Shaders/triangle.frag.spv"
-}
-else {
-  Write-Error "Файл фрагментного шейдера не создан!"
+# Компиляция каждого шейдера в <имя>.<стадия>.spv
+foreach ($shader in $shaders) {
+  $source = "Learning/Shaders/$($shader.Name)"
+  $output = "$source.spv"
+
+  Write-Host "Компиляция шейдера $($shader.Name)..."
+  $cmd = "& `"$GLSLC`" -c `"$source`" -o `"$output`""
+  Write-Host "Выполняется: $cmd"
+  Invoke-Expression $cmd
+  if ($LASTEXITCODE -ne 0) {
+    Write-Error "Ошибка при компиляции шейдера $($shader.Name)"
+    exit $LASTEXITCODE
+  }
+
+  # Проверка создания файла
+  if (Test-Path $output) {
+    Write-Host "Шейдер скомпилирован успешно: $output"
+  }
+  else {
+    Write-Error "Файл шейдера не создан: $output"
+  }
 }
 
 Write-Host "Компиляция шейдеров завершена!"
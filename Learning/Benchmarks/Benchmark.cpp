@@ -0,0 +1,223 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double elapsedNs(Clock::time_point start, Clock::time_point end)
+  {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+  }
+
+  // Перцентиль отсортированного массива (линейная интерполяция между соседями)
+  double percentile(const std::vector<double>& sorted, double fraction)
+  {
+    if (sorted.empty())
+    {
+      return 0.0;
+    }
+    double position = fraction * static_cast<double>(sorted.size() - 1);
+    size_t lower    = static_cast<size_t>(position);
+    size_t upper    = std::min(lower + 1, sorted.size() - 1);
+    double weight   = position - static_cast<double>(lower);
+    return sorted[lower] * (1.0 - weight) + sorted[upper] * weight;
+  }
+
+  // Экранирование строки для JSON
+  std::string escapeJson(const std::string& text)
+  {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+      switch (c)
+      {
+        case '"':
+          escaped += "\\\"";
+          break;
+        case '\\':
+          escaped += "\\\\";
+          break;
+        case '\n':
+          escaped += "\\n";
+          break;
+        case '\t':
+          escaped += "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+          {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+          }
+          else
+          {
+            escaped += c;
+          }
+      }
+    }
+    return escaped;
+  }
+}  // namespace
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options) : m_options(options) {}
+
+bool BenchmarkRunner::matches(const std::string& name) const
+{
+  return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& name, const IterationFn& fn)
+{
+  if (!matches(name))
+  {
+    return;
+  }
+
+  // Прогрев: кэши, ленивые выделения памяти драйвера, предсказатель переходов
+  Clock::time_point warmupStart = Clock::now();
+  fn();
+  double firstNs   = elapsedNs(warmupStart, Clock::now());
+  double minTimeNs = m_options.minTimeSec * 1e9;
+  if (firstNs < minTimeNs * 0.1)  // Дорогие случаи прогреваются одной итерацией
+  {
+    fn();
+    fn();
+  }
+
+  // Подбор размера пакета по повторному замеру одной итерации
+  Clock::time_point probeStart = Clock::now();
+  fn();
+  double   probeNs = std::max(elapsedNs(probeStart, Clock::now()), 1.0);
+  uint64_t batch   = 1;
+  if (probeNs < m_options.minBatchNs)
+  {
+    batch = static_cast<uint64_t>(m_options.minBatchNs / probeNs) + 1;
+  }
+
+  std::vector<double> samples;
+  samples.reserve(static_cast<size_t>(std::min<uint64_t>(m_options.maxSamples, 4096)));
+
+  double totalNs = 0.0;
+  while (samples.size() < m_options.maxSamples &&
+         (totalNs < minTimeNs || samples.size() < m_options.minSamples))
+  {
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < batch; i++)
+    {
+      fn();
+    }
+    double sampleNs = elapsedNs(start, Clock::now());
+
+    totalNs += sampleNs;
+    samples.push_back(sampleNs / static_cast<double>(batch));
+
+    // Очень медленные случаи не растягиваются до minSamples сверх разумного
+    if (totalNs > minTimeNs * 20.0 && samples.size() >= 5)
+    {
+      break;
+    }
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  BenchmarkResult result;
+  result.name       = name;
+  result.samples    = samples.size();
+  result.batch      = batch;
+  result.iterations = result.samples * batch;
+  result.medianNs   = percentile(samples, 0.5);
+  result.p99Ns      = percentile(samples, 0.99);
+  result.minNs      = samples.front();
+  result.maxNs      = samples.back();
+  result.meanNs     = totalNs / static_cast<double>(result.iterations);
+  m_results.push_back(result);
+
+  std::printf("  %-40s median %12.1f ns  p99 %12.1f ns  (%llu итераций)\n", name.c_str(),
+              result.medianNs, result.p99Ns, static_cast<unsigned long long>(result.iterations));
+  std::fflush(stdout);
+}
+
+void BenchmarkRunner::skip(const std::string& name, const std::string& reason)
+{
+  if (!matches(name))
+  {
+    return;
+  }
+
+  BenchmarkResult result;
+  result.name = name;
+  result.note = reason;
+  m_results.push_back(result);
+
+  std::printf("  %-40s пропущен: %s\n", name.c_str(), reason.c_str());
+  std::fflush(stdout);
+}
+
+void BenchmarkRunner::setContext(const std::string& key, const std::string& value)
+{
+  for (auto& entry : m_context)
+  {
+    if (entry.first == key)
+    {
+      entry.second = value;
+      return;
+    }
+  }
+  m_context.emplace_back(key, value);
+}
+
+void BenchmarkRunner::printTable(std::ostream& out) const
+{
+  out << std::left << std::setw(40) << "Случай" << std::right << std::setw(14) << "median, нс"
+      << std::setw(14) << "p99, нс" << std::setw(14) << "min, нс" << std::setw(12) << "итераций"
+      << "\n";
+
+  for (const auto& result : m_results)
+  {
+    out << std::left << std::setw(40) << result.name << std::right;
+    if (result.iterations == 0)
+    {
+      out << "  пропущен: " << result.note << "\n";
+      continue;
+    }
+    out << std::fixed << std::setprecision(1) << std::setw(14) << result.medianNs << std::setw(14)
+        << result.p99Ns << std::setw(14) << result.minNs << std::setw(12) << result.iterations
+        << "\n";
+  }
+}
+
+void BenchmarkRunner::writeJson(std::ostream& out) const
+{
+  out << "{\n  \"context\": {";
+  for (size_t i = 0; i < m_context.size(); i++)
+  {
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << escapeJson(m_context[i].first) << "\": \""
+        << escapeJson(m_context[i].second) << "\"";
+  }
+  out << (m_context.empty() ? "},\n" : "\n  },\n");
+
+  out << "  \"benchmarks\": [";
+  for (size_t i = 0; i < m_results.size(); i++)
+  {
+    const BenchmarkResult& result = m_results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escapeJson(result.name) << "\"";
+    if (result.iterations == 0)
+    {
+      out << ", \"skipped\": true, \"reason\": \"" << escapeJson(result.note) << "\"}";
+      continue;
+    }
+    out << std::fixed << std::setprecision(1) << ", \"iterations\": " << result.iterations
+        << ", \"samples\": " << result.samples << ", \"batch\": " << result.batch
+        << ", \"median_ns\": " << result.medianNs << ", \"p99_ns\": " << result.p99Ns
+        << ", \"mean_ns\": " << result.meanNs << ", \"min_ns\": " << result.minNs
+        << ", \"max_ns\": " << result.maxNs << "}";
+  }
+  out << (m_results.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Результат одного измерения (времена - на одну итерацию, в наносекундах)
+struct BenchmarkResult
+{
+  std::string name;
+  uint64_t    iterations = 0;  // Всего выполнено итераций
+  uint64_t    samples    = 0;  // Количество замеров (в замере batch итераций)
+  uint64_t    batch      = 1;  // Итераций в одном замере
+  double      medianNs   = 0.0;
+  double      p99Ns      = 0.0;
+  double      meanNs     = 0.0;
+  double      minNs      = 0.0;
+  double      maxNs      = 0.0;
+  std::string note;  // Пояснение (например, причина пропуска)
+};
+
+// Параметры запуска
+struct BenchmarkOptions
+{
+  double      minTimeSec = 0.5;     // Минимальное время измерения одного случая
+  uint64_t    minSamples = 50;      // Минимум замеров для устойчивых перцентилей
+  uint64_t    maxSamples = 100000;  // Ограничение на количество замеров
+  double      minBatchNs = 2000.0;  // Короткие операции группируются до этого времени
+  std::string filter;               // Подстрока имени (пустая - все случаи)
+};
+
+/**
+ * @brief Минимальный набор инструментов микробенчмарков.
+ * Каждый случай прогревается, затем короткие операции объединяются в пакеты, чтобы
+ * время замера было заметно больше разрешения часов. Замеры собираются, пока не
+ * набрано и минимальное время, и минимальное количество, а статистика считается по
+ * времени одной итерации: медиана и 99-й перцентиль устойчивее среднего к выбросам.
+ */
+class BenchmarkRunner
+{
+public:
+  // Одна итерация измеряемой операции
+  using IterationFn = std::function<void()>;
+
+  explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+  /**
+   * @brief Проверка имени случая по фильтру
+   */
+  bool matches(const std::string& name) const;
+
+  /**
+   * @brief Измерение случая (пропускается, если имя не проходит фильтр)
+   * @param name Имя случая вида "группа/параметр"
+   * @param fn Одна итерация
+   */
+  void run(const std::string& name, const IterationFn& fn);
+
+  /**
+   * @brief Запись пропущенного случая с причиной
+   */
+  void skip(const std::string& name, const std::string& reason);
+
+  /**
+   * @brief Сведения об окружении, попадающие в JSON (устройство, драйвер...)
+   */
+  void setContext(const std::string& key, const std::string& value);
+
+  // Вывод результатов
+  void printTable(std::ostream& out) const;
+  void writeJson(std::ostream& out) const;
+
+  const std::vector<BenchmarkResult>& getResults() const { return m_results; }
+
+private:
+  BenchmarkOptions                                 m_options;
+  std::vector<BenchmarkResult>                     m_results;
+  std::vector<std::pair<std::string, std::string>> m_context;
+};
+
+/**
+ * @brief Запрет компилятору выбрасывать вычисление, результат которого не используется
+ */
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+  (void)*sink;
+#endif
+}
@@ -0,0 +1,1016 @@
+// Микробенчмарки горячих путей движка на CPU.
+// Запуск из корня репозитория (пути к шейдерам относительные), окно не нужно:
+// поверхность создаётся через VK_EXT_headless_surface (например, lavapipe на Linux).
+//   vkapibench [--json <файл>] [--filter <подстрока>] [--min-time <секунды>]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Benchmark.h"
+#include "Bvh.h"
+#include "FrustumCuller.h"
+#include "LinearArena.h"
+#include "LodSelector.h"
+#include "Metrics.h"
+#include "PerformanceHud.h"
+#include "SpriteBatcher.h"
+#include "ThreadPool.h"
+#include "TransformSystem.h"
+#include "VulkanDevice.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanRenderQueue.h"
+#include "VulkanRenderer.h"
+#include "VulkanSwapChain.h"
+#include "VulkanUniformBuffer.h"
+#include "VulkanUtils.h"
+
+namespace
+{
+  // Графический конвейер треугольника для замеров записи команд
+  struct BenchPipeline
+  {
+    vk::UniquePipelineLayout layout;
+    vk::UniquePipeline       pipeline;
+  };
+
+  const vk::Format   TARGET_FORMAT = vk::Format::eR8G8B8A8Unorm;
+  const vk::Extent2D TARGET_EXTENT = {256, 256};
+
+  vk::UniqueInstance createHeadlessInstance()
+  {
+    vk::ApplicationInfo appInfo = {};
+    appInfo.pApplicationName    = "vkapibench";
+    appInfo.applicationVersion  = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.pEngineName         = "No Engine";
+    appInfo.engineVersion       = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.apiVersion          = VK_API_VERSION_1_3;
+
+    const char* extensions[] = {VK_KHR_SURFACE_EXTENSION_NAME,
+                                VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+
+    vk::InstanceCreateInfo createInfo  = {};
+    createInfo.pApplicationInfo        = &appInfo;
+    createInfo.enabledExtensionCount   = 2;
+    createInfo.ppEnabledExtensionNames = extensions;
+
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
+    try
+    {
+      vk::UniqueInstance instance = vk::createInstanceUnique(createInfo);
+      VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+      return instance;
+    }
+    catch (const vk::SystemError& e)
+    {
+      throw std::runtime_error("Не удалось создать экземпляр Vulkan: " + std::string(e.what()));
+    }
+  }
+
+  vk::UniqueSurfaceKHR createHeadlessSurface(vk::Instance instance)
+  {
+    // Функция расширения не экспортируется загрузчиком напрямую
+    auto createFn = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+        instance.getProcAddr("vkCreateHeadlessSurfaceEXT"));
+    if (!createFn)
+    {
+      throw std::runtime_error("VK_EXT_headless_surface недоступно");
+    }
+
+    VkHeadlessSurfaceCreateInfoEXT createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    if (createFn(static_cast<VkInstance>(instance), &createInfo, nullptr, &surface) != VK_SUCCESS)
+    {
+      throw std::runtime_error("Не удалось создать headless-поверхность");
+    }
+    return vk::UniqueSurfaceKHR(surface, instance);
+  }
+
+  vk::UniqueShaderModule loadShader(vk::Device device, const std::string& path)
+  {
+    std::vector<char>          code       = VulkanUtils::readFile(path);
+    vk::ShaderModuleCreateInfo createInfo = {};
+    createInfo.codeSize                   = code.size();
+    createInfo.pCode                      = reinterpret_cast<const uint32_t*>(code.data());
+    return device.createShaderModuleUnique(createInfo);
+  }
+
+  // Конвейер с шейдерами треугольника, dynamic rendering и динамическими viewport/scissor
+  BenchPipeline createTrianglePipeline(vk::Device device, vk::DescriptorSetLayout setLayout)
+  {
+    vk::UniqueShaderModule vertModule = loadShader(device, "Learning/Shaders/triangle.vert.spv");
+    vk::UniqueShaderModule fragModule = loadShader(device, "Learning/Shaders/triangle.frag.spv");
+
+    vk::PipelineShaderStageCreateInfo stages[2] = {};
+    stages[0].stage                             = vk::ShaderStageFlagBits::eVertex;
+    stages[0].module                            = *vertModule;
+    stages[0].pName                             = "main";
+    stages[1].stage                             = vk::ShaderStageFlagBits::eFragment;
+    stages[1].module                            = *fragModule;
+    stages[1].pName                             = "main";
+
+    auto bindingDescription    = Vertex::getBindingDescription();
+    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+
+    vk::PipelineVertexInputStateCreateInfo vertexInput = {};
+    vertexInput.vertexBindingDescriptionCount          = 1;
+    vertexInput.pVertexBindingDescriptions             = &bindingDescription;
+    vertexInput.vertexAttributeDescriptionCount =
+        static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.topology                                 = vk::PrimitiveTopology::eTriangleList;
+
+    vk::PipelineViewportStateCreateInfo viewportState = {};
+    viewportState.viewportCount                       = 1;
+    viewportState.scissorCount                        = 1;
+
+    vk::PipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.polygonMode                              = vk::PolygonMode::eFill;
+    rasterizer.cullMode                                 = vk::CullModeFlagBits::eNone;
+    rasterizer.frontFace                                = vk::FrontFace::eCounterClockwise;
+    rasterizer.lineWidth                                = 1.0f;
+
+    vk::PipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.rasterizationSamples                   = vk::SampleCountFlagBits::e1;
+
+    vk::PipelineColorBlendAttachmentState blendAttachment = {};
+    blendAttachment.colorWriteMask =
+        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+        vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+    vk::PipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.attachmentCount                       = 1;
+    colorBlending.pAttachments                          = &blendAttachment;
+
+    vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                          vk::DynamicState::eScissor};
+    vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+    dynamicState.dynamicStateCount                     = 2;
+    dynamicState.pDynamicStates                        = dynamicStates;
+
+    vk::PipelineRenderingCreateInfo renderingInfo = {};
+    renderingInfo.colorAttachmentCount            = 1;
+    renderingInfo.pColorAttachmentFormats         = &TARGET_FORMAT;
+
+    BenchPipeline result;
+
+    vk::PipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.setLayoutCount               = 1;
+    layoutInfo.pSetLayouts                  = &setLayout;
+    result.layout                           = device.createPipelineLayoutUnique(layoutInfo);
+
+    vk::GraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.pNext                          = &renderingInfo;
+    pipelineInfo.stageCount                     = 2;
+    pipelineInfo.pStages                        = stages;
+    pipelineInfo.pVertexInputState              = &vertexInput;
+    pipelineInfo.pInputAssemblyState            = &inputAssembly;
+    pipelineInfo.pViewportState                 = &viewportState;
+    pipelineInfo.pRasterizationState            = &rasterizer;
+    pipelineInfo.pMultisampleState              = &multisampling;
+    pipelineInfo.pColorBlendState               = &colorBlending;
+    pipelineInfo.pDynamicState                  = &dynamicState;
+    pipelineInfo.layout                         = *result.layout;
+
+    result.pipeline = std::move(device.createGraphicsPipelineUnique(nullptr, pipelineInfo).value);
+    return result;
+  }
+
+  void benchReadFile(BenchmarkRunner& runner)
+  {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "vkapibench";
+    std::filesystem::create_directories(directory);
+
+    const size_t sizes[] = {4u << 10, 64u << 10, 1u << 20, 16u << 20};
+    for (size_t size : sizes)
+    {
+      std::string name = "readFile/size=" + std::to_string(size >> 10) + "KiB";
+      if (!runner.matches(name))
+      {
+        continue;
+      }
+
+      std::filesystem::path path = directory / ("file_" + std::to_string(size) + ".bin");
+      {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; i++)
+        {
+          data[i] = static_cast<char>(i * 31u);
+        }
+        std::ofstream file(path, std::ios::binary);
+        file.write(data.data(), static_cast<std::streamsize>(size));
+      }
+
+      // Файл после первого чтения лежит в страничном кэше: замеряется путь без диска
+      std::string pathString = path.string();
+      runner.run(name, [&] { doNotOptimize(VulkanUtils::readFile(pathString)); });
+
+      std::filesystem::remove(path);
+    }
+  }
+
+  void benchMetrics(BenchmarkRunner& runner)
+  {
+    // Запись в гистограмму стоит на пути drawFrame четыре раза за кадр
+    MetricsRegistry   registry;
+    LatencyHistogram& histogram = registry.addHistogram("bench_seconds", "Замер");
+    MetricsCounter&   counter   = registry.addCounter("bench_total", "Замер");
+
+    uint64_t value = 1;
+    runner.run("metrics/histogramRecord", [&] {
+      value = value * 6364136223846793005ull + 1442695040888963407ull;
+      histogram.record(value >> 40);  // Значения до ~16 мс
+    });
+    runner.run("metrics/counterAdd", [&] { counter.add(3); });
+
+    // Снимок делается в потоке экспорта, но его стоимость определяет допустимый период
+    std::ostringstream text;
+    runner.run("metrics/writePrometheus", [&] {
+      text.str(std::string());
+      registry.writePrometheus(text);
+      doNotOptimize(text.tellp());
+    });
+  }
+
+  void benchFrameMemory(BenchmarkRunner& runner)
+  {
+    // Временный список кадра (как кандидаты стриминга текстур): куча против арены
+    const size_t     count = 256;
+    uint64_t         value = 1;
+    std::vector<int> source(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      value     = value * 6364136223846793005ull + 1442695040888963407ull;
+      source[i] = static_cast<int>(value >> 33);
+    }
+
+    runner.run("frameMemory/heapVector", [&] {
+      std::vector<const int*> list;
+      list.reserve(count);
+      for (const int& item : source)
+      {
+        list.push_back(&item);
+      }
+      doNotOptimize(list.data());
+    });
+
+    LinearArena arena(64 * 1024);
+    runner.run("frameMemory/arenaVector", [&] {
+      {
+        ArenaVector<const int*> list{ArenaAllocator<const int*>(arena)};
+        list.reserve(count);
+        for (const int& item : source)
+        {
+          list.push_back(&item);
+        }
+        doNotOptimize(list.data());
+      }
+      arena.reset();
+    });
+  }
+
+  void benchTransforms(BenchmarkRunner& runner)
+  {
+    // Миллион узлов: 1024 корня, у каждого узла до 4 детей (около 10 уровней)
+    const uint32_t ROOT_COUNT = 1024;
+    const uint32_t NODE_COUNT = 1024 * 1024;
+
+    ThreadPool                   pool;
+    TransformSystem              transforms(&pool);
+    std::vector<TransformHandle> handles(NODE_COUNT);
+    for (uint32_t i = 0; i < NODE_COUNT; i++)
+    {
+      TransformHandle parent = i < ROOT_COUNT ? INVALID_TRANSFORM : handles[(i - ROOT_COUNT) / 4];
+      handles[i]             = transforms.create(parent);
+      transforms.setLocal(handles[i], glm::vec3(1.0f, 0.5f, 0.25f),
+                          glm::angleAxis(0.1f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(1.0f));
+    }
+    transforms.update();  // Перестановка по глубине - один раз, вне замеров
+
+    for (bool simd : {true, false})
+    {
+      transforms.setSimdEnabled(simd);
+      std::string suffix = simd ? "/simd" : "/scalar";
+      float       angle  = 0.0f;
+
+      // Двигаются корни: пересчитывается вся иерархия
+      runner.run("transforms/update1M/allChanged" + suffix, [&] {
+        angle += 0.01f;
+        for (uint32_t i = 0; i < ROOT_COUNT; i++)
+        {
+          transforms.setRotation(handles[i], glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+        }
+        transforms.update();
+      });
+
+      // Двигается каждый десятый лист: блоки без изменений пропускаются
+      runner.run("transforms/update1M/tenthLeaves" + suffix, [&] {
+        angle += 0.01f;
+        for (uint32_t i = NODE_COUNT / 4; i < NODE_COUNT; i += 10)
+        {
+          transforms.setPosition(handles[i], glm::vec3(angle, 0.0f, 0.0f));
+        }
+        transforms.update();
+      });
+
+      runner.run("transforms/update1M/static" + suffix, [&] { transforms.update(); });
+    }
+  }
+
+  void benchCulling(BenchmarkRunner& runner)
+  {
+    // Миллион сфер и миллион AABB в кубе 200 м, камера в центре куба видит малую их часть
+    const uint32_t OBJECT_COUNT = 1024 * 1024;
+
+    ThreadPool    pool;
+    FrustumCuller culler(&pool);
+    uint64_t      value = 1;
+    for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+    {
+      float random[4];  // [0, 1)
+      for (float& r : random)
+      {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        r     = static_cast<float>(value >> 40) / static_cast<float>(1u << 24);
+      }
+
+      glm::vec3 center = glm::vec3(random[0], random[1], random[2]) * 200.0f - 100.0f;
+      glm::vec3 extent = glm::vec3(random[3] * 2.0f + 0.1f);
+      culler.addSphere(center, extent.x);
+      culler.addBox(center - extent, center + extent);
+    }
+
+    glm::mat4 viewProj = glm::perspectiveRH_ZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+
+    for (bool simd : {true, false})
+    {
+      culler.setSimdEnabled(simd);
+      runner.run(std::string("culling/cull2M") + (simd ? "/simd" : "/scalar"), [&] {
+        culler.cull(viewProj);
+        doNotOptimize(culler.getVisibleBoxes().data());
+      });
+    }
+  }
+
+  void benchBvh(BenchmarkRunner& runner)
+  {
+    // Плотность сцены постоянна: ребро куба растёт как корень кубический из размера
+    const std::pair<uint32_t, const char*> SCENES[] = {
+        {10000, "10k"}, {100000, "100k"}, {1000000, "1M"}, {10000000, "10M"}};
+    const uint32_t MAX_TIMED_BUILD = 1000000;  // Сборка больших сцен - однократный замер
+
+    ThreadPool pool;
+    for (const auto& [count, label] : SCENES)
+    {
+      // Сцена на 10M занимает сотни мегабайт: без подходящих случаев она не создаётся
+      std::string suffix = std::string("/") + label;
+      const char* cases[] = {"build", "refit1pct", "frustum", "raycast", "aabbQuery"};
+      if (std::none_of(std::begin(cases), std::end(cases), [&](const char* name)
+                       { return runner.matches("bvh/" + std::string(name) + suffix); }))
+      {
+        continue;
+      }
+
+      float             side  = 20.0f * std::cbrt(static_cast<float>(count) / 1000.0f);
+      uint64_t          value = 1;
+      std::vector<Aabb> bounds(count);
+      auto              random = [&value] {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(value >> 40) / static_cast<float>(1u << 24);  // [0, 1)
+      };
+      for (Aabb& box : bounds)
+      {
+        glm::vec3 center = (glm::vec3(random(), random(), random()) - 0.5f) * side;
+        glm::vec3 extent = glm::vec3(random() + 0.1f);
+        box.min          = center - extent;
+        box.max          = center + extent;
+      }
+
+      Bvh bvh(&pool);
+      if (count <= MAX_TIMED_BUILD)
+      {
+        runner.run("bvh/build" + suffix, [&] { bvh.build(bounds); });
+      }
+      else
+      {
+        bvh.build(bounds);
+        std::cout << "  bvh/build" << suffix << ": " << bvh.getStats().buildMs
+                  << " мс (однократно)" << std::endl;
+      }
+
+      // Каждую итерацию сдвигается 1% примитивов
+      uint32_t moved = 0;
+      runner.run("bvh/refit1pct" + suffix, [&] {
+        for (uint32_t i = 0; i < count / 100; i++)
+        {
+          uint32_t primitive = (moved++ * 7919u) % count;
+          Aabb&    box       = bounds[primitive];
+          box.min.y         += 0.01f;
+          box.max.y         += 0.01f;
+          bvh.setBounds(primitive, box);
+        }
+        bvh.refit();
+      });
+
+      glm::mat4 viewProj = glm::perspectiveRH_ZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+      std::vector<uint32_t> result;
+      runner.run("bvh/frustum" + suffix, [&] {
+        bvh.queryFrustum(viewProj, result);
+        doNotOptimize(result.data());
+      });
+
+      runner.run("bvh/raycast" + suffix, [&] {
+        glm::vec3 direction(random() - 0.5f, random() - 0.5f, random() - 0.5f);
+        doNotOptimize(bvh.raycast(glm::vec3(0.0f), direction, side));
+      });
+
+      runner.run("bvh/aabbQuery" + suffix, [&] {
+        Aabb area;
+        area.min = (glm::vec3(random(), random(), random()) - 0.5f) * side;
+        area.max = area.min + glm::vec3(10.0f);
+        bvh.queryAabb(area, result);
+        doNotOptimize(result.data());
+      });
+    }
+  }
+
+  void benchLod(BenchmarkRunner& runner)
+  {
+    // Рельеф 128x128 квадратов (32K треугольников) с открытой границей
+    const uint32_t GRID_SIZE = 128;
+
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t>  indices;
+    for (uint32_t y = 0; y <= GRID_SIZE; y++)
+    {
+      for (uint32_t x = 0; x <= GRID_SIZE; x++)
+      {
+        float height = 4.0f * std::sin(x * 0.1f) * std::cos(y * 0.07f) + std::sin(x * y * 0.01f);
+        positions.emplace_back(static_cast<float>(x), height, static_cast<float>(y));
+      }
+    }
+    for (uint32_t y = 0; y < GRID_SIZE; y++)
+    {
+      for (uint32_t x = 0; x < GRID_SIZE; x++)
+      {
+        uint32_t corner = y * (GRID_SIZE + 1) + x;
+        indices.insert(indices.end(), {corner, corner + 1, corner + GRID_SIZE + 1, corner + 1,
+                                       corner + GRID_SIZE + 2, corner + GRID_SIZE + 1});
+      }
+    }
+
+    runner.run("lod/buildChain/32K", [&] {
+      LodChain chain = MeshSimplifier::buildLodChain(positions, indices);
+      doNotOptimize(chain.indices.data());
+    });
+
+    // Миллион копий рельефа в масштабе 1:20 (6.4 м) в кубе 400 м вокруг камеры
+    const uint32_t OBJECT_COUNT = 1024 * 1024;
+    const float    SCALE        = 0.05f;
+
+    ThreadPool  pool;
+    LodSelector selector(&pool);
+    uint32_t    mesh  = selector.addMesh(MeshSimplifier::buildLodChain(positions, indices));
+    uint64_t    value = 1;
+    for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+    {
+      float random[3];  // [0, 1)
+      for (float& r : random)
+      {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        r     = static_cast<float>(value >> 40) / static_cast<float>(1u << 24);
+      }
+      glm::vec3 center = glm::vec3(random[0], random[1], random[2]) * 400.0f - 200.0f;
+      selector.addObject(mesh, center, GRID_SIZE * 0.71f * SCALE, SCALE);
+    }
+
+    glm::mat4 viewProj = glm::perspectiveRH_ZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    runner.run("lod/select1M", [&] {
+      selector.select(viewProj, glm::vec2(1920.0f, 1080.0f));
+      doNotOptimize(selector.getLevels().data());
+    });
+  }
+
+  void benchHud(BenchmarkRunner& runner)
+  {
+    // Полный график и все строки: столько вершин оверлей пишет каждый кадр
+    PerformanceHud hud;
+    for (uint32_t i = 0; i < PerformanceHud::HISTORY_SIZE; i++)
+    {
+      HudFrameStats stats = {};
+      stats.frameMs       = i % 30 == 0 ? 40.0f : 16.0f;
+      stats.cpuMs         = 2.5f;
+      stats.gpuMs         = 4.0f;
+      stats.draws         = 1200;
+      stats.triangles     = 3500000;
+      stats.memoryUsage   = 900ull << 20;
+      stats.memoryBudget  = 8192ull << 20;
+      hud.addFrame(stats);
+    }
+
+    std::vector<HudVertex> vertices(PerformanceHud::MAX_VERTICES);
+    runner.run("hud/build", [&] {
+      doNotOptimize(hud.build(vertices.data(), static_cast<uint32_t>(vertices.size())));
+      doNotOptimize(vertices.data());
+    });
+  }
+
+  void benchSprites(BenchmarkRunner& runner)
+  {
+    // Миллион спрайтов на четырёх страницах вперемешку: худший случай для группировки
+    const uint32_t SPRITE_COUNT = 1u << 20;
+    const uint32_t PAGE_COUNT   = 4;
+
+    ThreadPool    pool;
+    SpriteBatcher batcher(PAGE_COUNT, &pool);
+    batcher.setViewport(1920.0f, 1080.0f);
+    Sprite* sprites = batcher.allocate(SPRITE_COUNT);
+    for (uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+      Sprite& sprite = sprites[i];
+      sprite         = {};
+      sprite.x       = static_cast<float>(i % 1920);
+      sprite.y       = static_cast<float>((i / 1920) % 1080);
+      sprite.width   = 8.0f;
+      sprite.height  = 8.0f;
+      sprite.u1      = 1.0f;
+      sprite.v1      = 1.0f;
+      sprite.color   = 0xFFFFFFFFu;
+      sprite.page    = (i * 2654435761u >> 16) % PAGE_COUNT;
+    }
+
+    std::vector<SpriteVertex> vertices(static_cast<size_t>(SPRITE_COUNT) * 4);
+    runner.run("sprites/build1M", [&] {
+      doNotOptimize(batcher.build(vertices.data(), SPRITE_COUNT).data());
+      doNotOptimize(vertices.data());
+    });
+  }
+
+  void benchFindMemoryType(BenchmarkRunner& runner, VulkanDevice& device)
+  {
+    runner.run("findMemoryType/deviceLocal", [&] {
+      doNotOptimize(device.findMemoryType(~0u, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    });
+    runner.run("findMemoryType/hostVisibleCoherent", [&] {
+      doNotOptimize(device.findMemoryType(~0u, vk::MemoryPropertyFlagBits::eHostVisible |
+                                                   vk::MemoryPropertyFlagBits::eHostCoherent));
+    });
+  }
+
+  void benchSwapChainCreate(BenchmarkRunner& runner, VulkanDevice& device,
+                            vk::SurfaceKHR surface)
+  {
+    // Создание и уничтожение: у поверхности одновременно может быть только одна swap chain
+    runner.run("create/swapchain", [&] {
+      VulkanSwapChain swapChain(device, surface, nullptr);
+      if (swapChain.init() != 0)
+      {
+        throw std::runtime_error("Не удалось создать swap chain");
+      }
+      swapChain.cleanup();
+    });
+  }
+
+  void benchPipelineCreate(BenchmarkRunner& runner, VulkanDevice& device,
+                           vk::DescriptorSetLayout setLayout)
+  {
+    // Включает чтение SPIR-V и создание шейдерных модулей, как при старте рендерера
+    runner.run("create/graphicsPipeline", [&] {
+      BenchPipeline pipeline = createTrianglePipeline(device.getDevice(), setLayout);
+      doNotOptimize(pipeline.pipeline);
+    });
+  }
+
+  // Запись кадра тем же путём, что и в рендерере: очередь отрисовки внутри графа кадра
+  void benchRecord(BenchmarkRunner& runner, VulkanDevice& device, ThreadPool& threadPool,
+                   VulkanUniformBuffer& uniformBuffer)
+  {
+    vk::Device    vkDevice = device.getDevice();
+    BenchPipeline pipeline =
+        createTrianglePipeline(vkDevice, uniformBuffer.getDescriptorSetLayout());
+
+    vk::UniqueBuffer    vertexBuffer;
+    TrackedDeviceMemory vertexMemory;
+    device.createBuffer(sizeof(Vertex) * 3, vk::BufferUsageFlagBits::eVertexBuffer,
+                        vk::MemoryPropertyFlagBits::eDeviceLocal, vertexBuffer, vertexMemory);
+
+    vk::CommandPoolCreateInfo poolInfo = {};
+    poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    poolInfo.queueFamilyIndex          = device.getQueueFamilyIndices().graphicsFamily.value();
+    vk::UniqueCommandPool commandPool  = vkDevice.createCommandPoolUnique(poolInfo);
+
+    vk::CommandBufferAllocateInfo allocInfo = {};
+    allocInfo.commandPool                   = *commandPool;
+    allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount            = 1;
+    vk::UniqueCommandBuffer commandBuffer =
+        std::move(vkDevice.allocateCommandBuffersUnique(allocInfo)[0]);
+
+    VulkanRenderQueue renderQueue(&threadPool);
+
+    RenderGraphImageDesc targetDesc = {};
+    targetDesc.format               = TARGET_FORMAT;
+    targetDesc.extent               = TARGET_EXTENT;
+    targetDesc.usage                = vk::ImageUsageFlagBits::eColorAttachment;
+
+    VulkanRenderGraph   graph(device);
+    RenderGraphResource target = graph.createImage("target", targetDesc);
+    uint32_t            pass   = graph.addPass("draws", [&](vk::CommandBuffer cmd) {
+      vk::RenderingAttachmentInfo colorAttachment = {};
+      colorAttachment.imageView                   = graph.getImageView(target);
+      colorAttachment.imageLayout                 = vk::ImageLayout::eColorAttachmentOptimal;
+      colorAttachment.loadOp                      = vk::AttachmentLoadOp::eClear;
+      colorAttachment.storeOp                     = vk::AttachmentStoreOp::eStore;
+
+      vk::RenderingInfo renderingInfo    = {};
+      renderingInfo.renderArea.extent    = TARGET_EXTENT;
+      renderingInfo.layerCount           = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments    = &colorAttachment;
+
+      vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                            static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f);
+      vk::Rect2D   scissor({0, 0}, TARGET_EXTENT);
+
+      cmd.beginRendering(renderingInfo);
+      cmd.setViewport(0, viewport);
+      cmd.setScissor(0, scissor);
+      renderQueue.execute(cmd);
+      cmd.endRendering();
+    });
+    graph.use(pass, target, RenderGraphAccess::ColorAttachmentWrite);
+    graph.markOutput(target);
+    graph.compile();
+
+    const uint32_t drawCounts[] = {1, 100, 1000, 10000};
+    for (uint32_t drawCount : drawCounts)
+    {
+      // Пакеты с разными материалами и глубиной, чтобы сортировка выполняла работу
+      std::vector<DrawPacket> packets(drawCount);
+      for (uint32_t i = 0; i < drawCount; i++)
+      {
+        float depth = static_cast<float>((i * 7919u) % drawCount) / static_cast<float>(drawCount);
+        packets[i].key                = RenderKey::makeOpaque(0, 0, i % 16, depth, i);
+        packets[i].pipeline           = *pipeline.pipeline;
+        packets[i].pipelineLayout     = *pipeline.layout;
+        packets[i].descriptorSet      = uniformBuffer.getDescriptorSet();
+        packets[i].dynamicOffsetCount = 2;
+        packets[i].vertexBuffer       = *vertexBuffer;
+        packets[i].count              = 3;
+      }
+      renderQueue.reserve(drawCount);
+
+      runner.run("record/draws=" + std::to_string(drawCount), [&] {
+        renderQueue.clear();
+        for (const DrawPacket& packet : packets)
+        {
+          renderQueue.push(packet);
+        }
+        renderQueue.sort();
+
+        commandBuffer->reset();
+        commandBuffer->begin(
+            vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        graph.execute(*commandBuffer);
+        commandBuffer->end();
+      });
+    }
+
+    // Буфер записан, но не отправлялся: достаточно сбросить его до уничтожения пула
+    commandBuffer->reset();
+  }
+
+  // Вызов функций устройства через трамплин загрузчика и через указатели vkGetDeviceProcAddr,
+  // которыми пользуется движок: одна и та же запись draw-вызовов с разными диспетчерами
+  void benchDispatch(BenchmarkRunner& runner, VulkanDevice& device, vk::Instance instance,
+                     VulkanUniformBuffer& uniformBuffer)
+  {
+    using Dispatcher = VULKAN_HPP_DEFAULT_DISPATCHER_TYPE;
+
+    // Без устройства функции уровня устройства загружаются через vkGetInstanceProcAddr
+    // и указывают на трамплины загрузчика, как при статической компоновке
+    Dispatcher loaderDispatch(static_cast<VkInstance>(instance),
+                              VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr);
+
+    vk::Device    vkDevice = device.getDevice();
+    BenchPipeline pipeline =
+        createTrianglePipeline(vkDevice, uniformBuffer.getDescriptorSetLayout());
+
+    vk::UniqueBuffer    vertexBuffer;
+    TrackedDeviceMemory vertexMemory;
+    device.createBuffer(sizeof(Vertex) * 3, vk::BufferUsageFlagBits::eVertexBuffer,
+                        vk::MemoryPropertyFlagBits::eDeviceLocal, vertexBuffer, vertexMemory);
+
+    vk::CommandPoolCreateInfo poolInfo = {};
+    poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    poolInfo.queueFamilyIndex          = device.getQueueFamilyIndices().graphicsFamily.value();
+    vk::UniqueCommandPool commandPool  = vkDevice.createCommandPoolUnique(poolInfo);
+
+    vk::CommandBufferAllocateInfo allocInfo = {};
+    allocInfo.commandPool                   = *commandPool;
+    allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount            = 1;
+    vk::UniqueCommandBuffer commandBuffer =
+        std::move(vkDevice.allocateCommandBuffersUnique(allocInfo)[0]);
+
+    RenderGraphImageDesc targetDesc = {};
+    targetDesc.format               = TARGET_FORMAT;
+    targetDesc.extent               = TARGET_EXTENT;
+    targetDesc.usage                = vk::ImageUsageFlagBits::eColorAttachment;
+
+    const Dispatcher* pDispatch     = &VULKAN_HPP_DEFAULT_DISPATCHER;
+    uint32_t          drawCount     = 0;
+    vk::DescriptorSet descriptorSet = uniformBuffer.getDescriptorSet();
+
+    VulkanRenderGraph   graph(device);
+    RenderGraphResource target = graph.createImage("target", targetDesc);
+    uint32_t            pass   = graph.addPass("draws", [&](vk::CommandBuffer cmd) {
+      const Dispatcher& d = *pDispatch;
+
+      vk::RenderingAttachmentInfo colorAttachment = {};
+      colorAttachment.imageView                   = graph.getImageView(target);
+      colorAttachment.imageLayout                 = vk::ImageLayout::eColorAttachmentOptimal;
+      colorAttachment.loadOp                      = vk::AttachmentLoadOp::eClear;
+      colorAttachment.storeOp                     = vk::AttachmentStoreOp::eStore;
+
+      vk::RenderingInfo renderingInfo    = {};
+      renderingInfo.renderArea.extent    = TARGET_EXTENT;
+      renderingInfo.layerCount           = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments    = &colorAttachment;
+
+      vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                            static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f);
+      vk::Rect2D   scissor({0, 0}, TARGET_EXTENT);
+
+      cmd.beginRendering(renderingInfo, d);
+      cmd.setViewport(0, viewport, d);
+      cmd.setScissor(0, scissor, d);
+      cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *pipeline.pipeline, d);
+      cmd.bindVertexBuffers(0, *vertexBuffer, vk::DeviceSize(0), d);
+
+      // Как в очереди отрисовки при смене объекта: набор со своими смещениями и draw
+      const uint32_t offsets[2] = {};
+      for (uint32_t i = 0; i < drawCount; i++)
+      {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline.layout, 0, 1,
+                               &descriptorSet, 2, offsets, d);
+        cmd.draw(3, 1, 0, 0, d);
+      }
+      cmd.endRendering(d);
+    });
+    graph.use(pass, target, RenderGraphAccess::ColorAttachmentWrite);
+    graph.markOutput(target);
+    graph.compile();
+
+    const char*       variants[]    = {"loader", "device"};
+    const Dispatcher* dispatchers[] = {&loaderDispatch, &VULKAN_HPP_DEFAULT_DISPATCHER};
+    const uint32_t    drawCounts[]  = {1000, 10000, 100000};
+    for (uint32_t count : drawCounts)
+    {
+      for (uint32_t variant = 0; variant < 2; variant++)
+      {
+        drawCount = count;
+        pDispatch = dispatchers[variant];
+
+        std::string name =
+            std::string("dispatch/") + variants[variant] + "/draws=" + std::to_string(count);
+        runner.run(name, [&] {
+          commandBuffer->reset();
+          commandBuffer->begin(
+              vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+          graph.execute(*commandBuffer);
+          commandBuffer->end();
+        });
+      }
+    }
+
+    // Буфер записан, но не отправлялся: достаточно сбросить его до уничтожения пула
+    commandBuffer->reset();
+  }
+
+  // Сброс командных буферов кадра: по одному (eResetCommandBuffer) против сброса пула
+  void benchCommandReset(BenchmarkRunner& runner, VulkanDevice& device)
+  {
+    vk::Device     vkDevice    = device.getDevice();
+    const uint32_t bufferCount = 2;  // Как в VulkanFrameContext: загрузки и кадр
+
+    vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+    const vk::CommandPoolCreateFlags poolFlags[] = {
+        vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+        vk::CommandPoolCreateFlagBits::eTransient};
+    const char* names[] = {"commands/resetBuffers", "commands/resetPool"};
+
+    for (uint32_t variant = 0; variant < 2; variant++)
+    {
+      vk::CommandPoolCreateInfo poolInfo = {};
+      poolInfo.flags                     = poolFlags[variant];
+      poolInfo.queueFamilyIndex          = device.getQueueFamilyIndices().graphicsFamily.value();
+      vk::UniqueCommandPool commandPool  = vkDevice.createCommandPoolUnique(poolInfo);
+
+      vk::CommandBufferAllocateInfo allocInfo = {};
+      allocInfo.commandPool                   = *commandPool;
+      allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+      allocInfo.commandBufferCount            = bufferCount;
+
+      std::vector<vk::CommandBuffer> commandBuffers = vkDevice.allocateCommandBuffers(allocInfo);
+
+      bool resetPool = variant == 1;
+      runner.run(names[variant], [&] {
+        if (resetPool)
+        {
+          vkDevice.resetCommandPool(*commandPool);
+        }
+        for (vk::CommandBuffer commandBuffer : commandBuffers)
+        {
+          if (!resetPool)
+          {
+            commandBuffer.reset();
+          }
+          commandBuffer.begin(beginInfo);
+          commandBuffer.end();
+        }
+      });
+
+      // Буферы освобождаются вместе с пулом
+      vkDevice.resetCommandPool(*commandPool);
+    }
+  }
+
+  // Полный кадр рендерера: ожидание слота, получение изображения, запись, submit2, present
+  void benchDrawFrame(BenchmarkRunner& runner, VulkanDevice& device, vk::SurfaceKHR surface,
+                      ThreadPool& threadPool)
+  {
+    const std::string name = "frame/drawFrame";
+    if (!runner.matches(name))
+    {
+      return;
+    }
+
+    VulkanSwapChain swapChain(device, surface, nullptr);
+    if (swapChain.init() != 0)
+    {
+      runner.skip(name, "не удалось создать swap chain");
+      return;
+    }
+
+    {
+      VulkanRenderer renderer(device, swapChain, threadPool);
+      if (renderer.init() != 0)
+      {
+        runner.skip(name, "не удалось инициализировать рендерер (шейдеры скомпилированы?)");
+      }
+      else
+      {
+        // Симуляция не замеряется: каждый кадр получает следующий шаг 60 Гц
+        FrameSnapshot snapshot;
+        runner.run(name, [&] {
+          snapshot.simulationStep++;
+          snapshot.simulationTime += 1.0 / 60.0;
+          renderer.drawFrame(snapshot);
+        });
+        renderer.cleanup();
+      }
+    }
+
+    swapChain.cleanup();
+  }
+
+  void printUsage()
+  {
+    std::cout << "Использование: vkapibench [--json <файл>] [--filter <подстрока>] "
+                 "[--min-time <секунды>]"
+              << std::endl;
+  }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  BenchmarkOptions options;
+  std::string      jsonPath;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--json") == 0 && hasValue)
+    {
+      jsonPath = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+    {
+      options.filter = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+    {
+      options.minTimeSec = std::strtod(argv[++i], nullptr);
+    }
+    else
+    {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  BenchmarkRunner runner(options);
+
+  std::cout << "Файловый ввод:" << std::endl;
+  benchReadFile(runner);
+
+  std::cout << "Метрики:" << std::endl;
+  benchMetrics(runner);
+  benchFrameMemory(runner);
+
+  std::cout << "Преобразования:" << std::endl;
+  benchTransforms(runner);
+
+  std::cout << "Отсечение:" << std::endl;
+  benchCulling(runner);
+  benchBvh(runner);
+
+  std::cout << "Уровни детализации:" << std::endl;
+  benchLod(runner);
+
+  std::cout << "Оверлей:" << std::endl;
+  benchHud(runner);
+
+  std::cout << "Спрайты:" << std::endl;
+  benchSprites(runner);
+
+  try
+  {
+    vk::UniqueInstance   instance = createHeadlessInstance();
+    vk::UniqueSurfaceKHR surface  = createHeadlessSurface(*instance);
+
+    VulkanDevice device(*instance, *surface);
+    if (device.init() != 0)
+    {
+      throw std::runtime_error("Не удалось инициализировать VulkanDevice");
+    }
+
+    vk::PhysicalDeviceProperties properties = device.getPhysicalDevice().getProperties();
+    runner.setContext("device", properties.deviceName.data());
+    runner.setContext("driverVersion", std::to_string(properties.driverVersion));
+    std::string apiVersion = std::to_string(VK_API_VERSION_MAJOR(properties.apiVersion)) + "." +
+                             std::to_string(VK_API_VERSION_MINOR(properties.apiVersion));
+    runner.setContext("apiVersion", apiVersion);
+
+    ThreadPool threadPool;
+    runner.setContext("threads", std::to_string(threadPool.getThreadCount()));
+
+    VulkanUniformBuffer uniformBuffer(device, 1, 64 * 1024);
+    if (uniformBuffer.init() != 0)
+    {
+      throw std::runtime_error("Не удалось инициализировать uniform-буфер");
+    }
+
+    std::cout << "Vulkan (" << properties.deviceName.data() << "):" << std::endl;
+    benchFindMemoryType(runner, device);
+    benchSwapChainCreate(runner, device, *surface);
+    benchPipelineCreate(runner, device, uniformBuffer.getDescriptorSetLayout());
+    benchRecord(runner, device, threadPool, uniformBuffer);
+    benchDispatch(runner, device, *instance, uniformBuffer);
+    benchCommandReset(runner, device);
+    benchDrawFrame(runner, device, *surface, threadPool);
+
+    device.getDevice().waitIdle();
+    uniformBuffer.cleanup();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Замеры Vulkan пропущены: " << e.what() << std::endl;
+    runner.setContext("vulkanError", e.what());
+  }
+
+  std::cout << std::endl;
+  runner.printTable(std::cout);
+
+  if (!jsonPath.empty())
+  {
+    std::ofstream jsonFile(jsonPath);
+    if (!jsonFile)
+    {
+      std::cerr << "Не удалось открыть " << jsonPath << std::endl;
+      return EXIT_FAILURE;
+    }
+    runner.writeJson(jsonFile);
+    std::cout << "Результаты записаны в " << jsonPath << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Ограничивающий параллелепипед, выровненный по осям (пустой по умолчанию)
+struct Aabb
+{
+  glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+  void grow(const glm::vec3& point)
+  {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+
+  void grow(const Aabb& other)
+  {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+  }
+
+  bool overlaps(const Aabb& other) const
+  {
+    return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y &&
+           max.y >= other.min.y && min.z <= other.max.z && max.z >= other.min.z;
+  }
+
+  // Половина площади поверхности (для SAH важны только отношения площадей)
+  float halfArea() const
+  {
+    glm::vec3 extent = glm::max(max - min, glm::vec3(0.0f));
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+  }
+};
+
+/**
+ * @brief Узел BVH: 32 байта, два узла на строку кэша.
+ * Дети внутреннего узла лежат парой подряд, поэтому хранится только индекс левого
+ */
+struct BvhNode
+{
+  float    min[3];
+  uint32_t leftOrFirst;  // Внутренний узел: левый ребёнок; лист: первый индекс примитива
+  float    max[3];
+  uint32_t count;  // Примитивов в листе (0 - внутренний узел)
+};
+
+const uint32_t BVH_NO_HIT = 0xFFFFFFFFu;
+
+// Статистика последней сборки и обновления
+struct BvhStats
+{
+  uint32_t primitives = 0;
+  uint32_t nodes      = 0;
+  uint32_t leaves     = 0;
+  uint32_t depth      = 0;  // Уровней от корня до самого глубокого листа
+  double   buildMs    = 0.0;
+  double   refitMs    = 0.0;
+};
+
+/**
+ * @brief Иерархия ограничивающих объёмов для отсечения, выбора лучом и запросов по области.
+ * Строится по эвристике площади поверхности (SAH) с разбиением центров на корзины:
+ * крупные узлы раскладываются по корзинам и достраиваются параллельно в пуле потоков.
+ * Узлы хранятся плоским массивом в порядке обхода в глубину - поддерево левого ребёнка
+ * идёт сразу за парой детей, и спуск по дереву читает память подряд.
+ *
+ * Движущиеся объекты обновляются без пересборки: setBounds() помечает лист, а refit()
+ * одним проходом с конца массива пересчитывает границы помеченных узлов и их предков.
+ * Топология при этом не меняется, поэтому после больших перемещений качество дерева
+ * падает, и его стоит пересобрать.
+ */
+class Bvh
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pool Пул потоков для параллельной сборки (nullptr - однопоточно)
+   */
+  explicit Bvh(ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Сборка дерева заново
+   * @param bounds Границы примитивов; индекс примитива - позиция в массиве
+   */
+  void build(const std::vector<Aabb>& bounds);
+
+  /**
+   * @brief Новые границы примитива (применяются в refit())
+   */
+  void setBounds(uint32_t primitive, const Aabb& bounds);
+
+  /**
+   * @brief Пересчёт границ узлов, затронутых setBounds()
+   */
+  void refit();
+
+  /**
+   * @brief Примитивы, пересекающие пирамиду видимости (консервативно, по границам)
+   * @param viewProj Матрица вида и проекции (глубина клипа [0, 1])
+   * @param result Индексы примитивов (очищается перед запросом)
+   */
+  void queryFrustum(const glm::mat4& viewProj, std::vector<uint32_t>& result) const;
+
+  /**
+   * @brief Ближайший примитив, границы которого пересекает луч
+   * @param direction Направление луча (нормировать не обязательно, расстояние - в его длинах)
+   * @param maxDistance Дальность луча
+   * @param hitDistance Расстояние до точки входа в границы (может быть nullptr)
+   * @return Индекс примитива или BVH_NO_HIT
+   */
+  uint32_t raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                   float* hitDistance = nullptr) const;
+
+  /**
+   * @brief Примитивы, границы которых пересекают область
+   * @param result Индексы примитивов (очищается перед запросом)
+   */
+  void queryAabb(const Aabb& area, std::vector<uint32_t>& result) const;
+
+  const std::vector<BvhNode>& getNodes() const { return m_nodes; }
+  const BvhStats&             getStats() const { return m_stats; }
+  uint32_t                    size() const { return static_cast<uint32_t>(m_bounds.size()); }
+
+private:
+  struct BuildContext;
+  struct BuildTask;
+
+  ThreadPool* m_pool;
+
+  std::vector<Aabb>     m_bounds;      // Границы примитивов
+  std::vector<uint32_t> m_primitives;  // Индексы примитивов в порядке листьев
+  std::vector<BvhNode>  m_nodes;       // Узлы в порядке обхода в глубину, 0 - корень
+  std::vector<uint32_t> m_parents;     // Родитель каждого узла (для refit)
+  std::vector<uint32_t> m_leafOf;      // Лист каждого примитива
+  std::vector<uint8_t>  m_dirty;       // Узлы, границы которых нужно пересчитать
+
+  BvhStats m_stats;
+
+  const uint32_t MAX_LEAF_SIZE    = 8;      // Больше - узел делится, даже если SAH против
+  const uint32_t PARALLEL_BINNING = 65536;  // С этого размера корзины заполняются в пуле
+  const uint32_t PARALLEL_SUBTREE = 4096;   // С этого размера дети строятся параллельно
+
+  void buildSubtree(BuildContext& context, const BuildTask& root);
+  bool splitNode(BuildContext& context, const BuildTask& task, BuildTask* children);
+  void flatten(const BuildContext& context);
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Цель основного прохода, в которую рисовались кадры трассы (значения Vk* перечислений)
+struct TraceTarget
+{
+  uint32_t colorFormat = 0;  // VkFormat
+  uint32_t depthFormat = 0;  // VkFormat
+  uint32_t samples     = 1;  // VkSampleCountFlagBits
+};
+
+// Буфер, загруженный при создании ресурсов, с исходным содержимым
+struct TraceBuffer
+{
+  uint32_t             id    = 0;
+  uint32_t             usage = 0;  // VkBufferUsageFlags
+  std::vector<uint8_t> data;
+};
+
+struct TraceVertexAttribute
+{
+  uint32_t location = 0;
+  uint32_t format   = 0;  // VkFormat
+  uint32_t offset   = 0;
+};
+
+/**
+ * @brief Состояние графического конвейера, по которому он пересоздаётся при воспроизведении.
+ * Шейдеры хранятся путями к SPIR-V: трасса воспроизводится из корня того же репозитория.
+ */
+struct TracePipeline
+{
+  uint32_t                          id = 0;
+  std::string                       vertexShader;
+  std::string                       fragmentShader;
+  uint32_t                          topology     = 0;  // VkPrimitiveTopology
+  uint32_t                          vertexStride = 0;  // Шаг вершин binding = 0
+  std::vector<TraceVertexAttribute> attributes;
+  uint32_t                          cullMode  = 0;  // VkCullModeFlags
+  uint32_t                          frontFace = 0;  // VkFrontFace
+
+  // Глубина и смешивание единственного цветового вложения
+  uint32_t depthTest      = 0;
+  uint32_t depthWrite     = 0;
+  uint32_t depthCompareOp = 0;  // VkCompareOp
+  uint32_t blendEnable    = 0;
+  uint32_t srcColorFactor = 0;  // VkBlendFactor
+  uint32_t dstColorFactor = 0;
+  uint32_t colorBlendOp   = 0;  // VkBlendOp
+  uint32_t srcAlphaFactor = 0;
+  uint32_t dstAlphaFactor = 0;
+  uint32_t alphaBlendOp   = 0;
+  uint32_t colorWriteMask = 0xF;
+  uint32_t frameUniforms  = 0;  // 1 - set 0 с константами кадра и объекта (VulkanUniformBuffer)
+};
+
+// Uniform-данные кадра: смещение от начала области кадра и содержимое
+struct TraceUniformBlock
+{
+  uint32_t             offset = 0;
+  std::vector<uint8_t> data;
+};
+
+// Draw-вызов: конвейер и буферы - идентификаторы трассы, смещения - от начала области кадра
+struct TraceDraw
+{
+  static const uint32_t NO_BUFFER = ~0u;
+
+  uint32_t pipeline           = 0;
+  uint32_t vertexBuffer       = NO_BUFFER;
+  uint32_t indexBuffer        = NO_BUFFER;  // NO_BUFFER - draw без индексов
+  uint32_t count              = 0;
+  uint32_t instanceCount      = 1;
+  uint32_t firstVertex        = 0;  // Первая вершина или первый индекс
+  int32_t  vertexOffset       = 0;
+  uint32_t dynamicOffsetCount = 0;
+  uint32_t dynamicOffsets[2]  = {};
+};
+
+// Кадр: размер цели, uniform-данные и draw-вызовы в порядке воспроизведения
+struct TraceFrame
+{
+  uint32_t                       width  = 0;
+  uint32_t                       height = 0;
+  std::vector<TraceUniformBlock> uniforms;
+  std::vector<TraceDraw>         draws;
+};
+
+/**
+ * @brief Трасса команд рендерера: ресурсы, состояния конвейеров и потоки draw-вызовов кадров.
+ * Файл - заголовок и последовательность блоков "тег, размер, данные" в little-endian.
+ * Неизвестные теги пропускаются, поэтому новые блоки не ломают чтение старым кодом.
+ */
+struct CommandTrace
+{
+  static const uint32_t MAGIC   = 0x52544B56;  // "VKTR"
+  static const uint32_t VERSION = 1;
+
+  // Теги блоков
+  static const uint32_t TAG_TARGET   = 1;
+  static const uint32_t TAG_BUFFER   = 2;
+  static const uint32_t TAG_PIPELINE = 3;
+  static const uint32_t TAG_FRAME    = 4;
+
+  TraceTarget                target;
+  std::vector<TraceBuffer>   buffers;
+  std::vector<TracePipeline> pipelines;
+  std::vector<TraceFrame>    frames;
+
+  /**
+   * @brief Чтение трассы из файла
+   * @param path Путь к файлу трассы
+   * @return Трасса (исключение std::runtime_error при ошибке формата)
+   */
+  static CommandTrace load(const std::string& path);
+};
+
+/**
+ * @brief Потоковая запись трассы: каждый блок пишется в файл сразу, кадры в памяти
+ * не накапливаются.
+ */
+class CommandTraceWriter
+{
+public:
+  /**
+   * @brief Создание файла и запись заголовка (исключение std::runtime_error при ошибке)
+   * @param path Путь к файлу трассы
+   * @param target Цель основного прохода
+   */
+  CommandTraceWriter(const std::string& path, const TraceTarget& target);
+
+  void writeBuffer(const TraceBuffer& buffer);
+  void writePipeline(const TracePipeline& pipeline);
+  void writeFrame(const TraceFrame& frame);
+
+  /**
+   * @brief Завершение записи (файл закрывается и в деструкторе)
+   */
+  void close();
+
+  uint64_t getBytesWritten() const { return m_bytesWritten; }
+
+private:
+  std::ofstream        m_file;
+  std::vector<uint8_t> m_chunk;  // Собираемый блок (память переиспользуется)
+  uint64_t             m_bytesWritten = 0;
+
+  void putU32(uint32_t value);
+  void putBytes(const void* data, size_t size);
+  void putString(const std::string& value);
+  void flushChunk(uint32_t tag);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vulkan/vulkan.hpp>
+
+#include "CommandTrace.h"
+#include "VulkanRenderQueue.h"
+
+/**
+ * @brief Запись того, что рендерер отправляет на GPU, в трассу команд.
+ * Рендерер регистрирует загруженные буферы и созданные конвейеры, а каждый кадр передаёт
+ * свои uniform-данные и отсортированную очередь отрисовки. Пакеты, ресурсы которых не
+ * зарегистрированы (например, буферы, которые заполняет сам GPU), в трассу не попадают
+ * и считаются пропущенными. После frameCount кадров файл закрывается.
+ */
+class CommandTraceRecorder
+{
+public:
+  /**
+   * @brief Конструктор (исключение std::runtime_error, если файл не создать)
+   * @param path Путь к файлу трассы
+   * @param target Цель основного прохода
+   * @param frameCount Количество записываемых кадров
+   */
+  CommandTraceRecorder(const std::string& path, const TraceTarget& target, uint32_t frameCount);
+
+  /**
+   * @brief Набор констант кадра и объекта: его динамические смещения переводятся в
+   * смещения от начала области кадра
+   */
+  void setFrameUniforms(vk::DescriptorSet descriptorSet) { m_vkFrameUniforms = descriptorSet; }
+
+  /**
+   * @brief Регистрация буфера с содержимым, загруженным при создании
+   */
+  void addBuffer(vk::Buffer buffer, vk::BufferUsageFlags usage, const void* data, size_t size);
+
+  /**
+   * @brief Регистрация графического конвейера по структуре, из которой он создан
+   * @param pipeline Созданный конвейер
+   * @param info Описание конвейера (вершины, сборка, растеризация, глубина, смешивание)
+   * @param vertexShader Путь к SPIR-V вершинного шейдера
+   * @param fragmentShader Путь к SPIR-V фрагментного шейдера
+   * @param frameUniforms Set 0 конвейера - набор констант кадра и объекта
+   */
+  void addPipeline(vk::Pipeline pipeline, const vk::GraphicsPipelineCreateInfo& info,
+                   const std::string& vertexShader, const std::string& fragmentShader,
+                   bool frameUniforms);
+
+  /**
+   * @brief Начало кадра
+   * @param uniformBase Начало области кадра в uniform-буфере
+   */
+  void beginFrame(vk::DeviceSize uniformBase);
+
+  /**
+   * @brief Uniform-данные кадра по динамическому смещению offset
+   */
+  void addUniform(uint32_t offset, const void* data, size_t size);
+
+  /**
+   * @brief Запись кадра из отсортированной очереди
+   * @return true, если записаны все кадры (или запись прервана ошибкой) и файл закрыт
+   */
+  bool endFrame(const VulkanRenderQueue& queue, vk::Extent2D extent);
+
+private:
+  CommandTraceWriter m_writer;
+  uint32_t           m_frameCount;
+  uint32_t           m_recordedFrames = 0;
+  uint64_t           m_recordedDraws  = 0;
+  uint64_t           m_skippedDraws   = 0;
+
+  vk::DescriptorSet                        m_vkFrameUniforms;  // Набор констант (не владеет)
+  std::unordered_map<VkBuffer, uint32_t>   m_bufferIds;
+  std::unordered_map<VkPipeline, uint32_t> m_pipelineIds;
+
+  vk::DeviceSize m_uniformBase = 0;
+  TraceFrame     m_frame;  // Собираемый кадр (память переиспользуется)
+
+  /**
+   * @brief Перевод пакета в draw-вызов трассы
+   * @return false, если ресурсы пакета не зарегистрированы
+   */
+  bool translate(const DrawPacket& packet, TraceDraw& draw) const;
+};
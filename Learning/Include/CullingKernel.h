@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Simd.h"
+
+/**
+ * @brief SoA-представление ограничивающих объёмов для ядер отсечения.
+ * Плоскости пирамиды видимости нормированы, нормали смотрят внутрь: точка p внутри,
+ * если x * p.x + y * p.y + z * p.z + w >= 0.
+ */
+struct CullingSoa
+{
+  float        planes[6][4];  // Плоскости пирамиды видимости (x, y, z, w)
+  const float* center[3];     // Центры сфер или AABB
+  const float* radius;        // Радиусы сфер (для AABB не используется)
+  const float* extent[3];     // Полуразмеры AABB (для сфер не используется)
+};
+
+namespace CullingKernel
+{
+  /**
+   * @brief Отсечение объектов [begin, end) ядром AVX2
+   * (определено только при сборке с VKAPI_ENABLE_AVX2)
+   * @param visible Выходной массив не короче end - begin: индексы видимых объектов
+   * @return Количество видимых объектов
+   */
+  uint32_t cullSpheresAvx2(const CullingSoa& soa, uint32_t begin, uint32_t end,
+                           uint32_t* visible);
+  uint32_t cullBoxesAvx2(const CullingSoa& soa, uint32_t begin, uint32_t end, uint32_t* visible);
+
+  namespace
+  {
+    // Маска видимости Lanes::WIDTH объектов начиная с first
+    template <typename Lanes, bool BOX>
+    uint32_t testBlock(const CullingSoa& soa, uint32_t first)
+    {
+      using V = typename Lanes::V;
+      using M = typename Lanes::M;
+
+      V cx   = Lanes::load(soa.center[0] + first);
+      V cy   = Lanes::load(soa.center[1] + first);
+      V cz   = Lanes::load(soa.center[2] + first);
+      V zero = Lanes::set1(0.0f);
+
+      V reach = zero;
+      V ex    = zero;
+      V ey    = zero;
+      V ez    = zero;
+      if constexpr (BOX)
+      {
+        ex = Lanes::load(soa.extent[0] + first);
+        ey = Lanes::load(soa.extent[1] + first);
+        ez = Lanes::load(soa.extent[2] + first);
+      }
+      else
+      {
+        reach = Lanes::load(soa.radius + first);
+      }
+
+      M inside = Lanes::cmpGe(zero, zero);
+      for (uint32_t p = 0; p < 6; p++)
+      {
+        const float* plane    = soa.planes[p];
+        V            distance = Lanes::fmadd(Lanes::set1(plane[2]), cz, Lanes::set1(plane[3]));
+        distance              = Lanes::fmadd(Lanes::set1(plane[1]), cy, distance);
+        distance              = Lanes::fmadd(Lanes::set1(plane[0]), cx, distance);
+
+        // Проекция AABB на нормаль: самая дальняя вдоль нормали вершина
+        if constexpr (BOX)
+        {
+          reach = Lanes::mul(Lanes::set1(std::fabs(plane[2])), ez);
+          reach = Lanes::fmadd(Lanes::set1(std::fabs(plane[1])), ey, reach);
+          reach = Lanes::fmadd(Lanes::set1(std::fabs(plane[0])), ex, reach);
+        }
+
+        inside = Lanes::andMask(inside, Lanes::cmpGe(Lanes::add(distance, reach), zero));
+      }
+      return Lanes::maskBits(inside);
+    }
+
+    /**
+     * @brief Отсечение объектов [begin, end): полные блоки ядром Lanes, хвост - скалярно.
+     * Индексы видимых объектов записываются подряд без ветвлений
+     * @return Количество видимых объектов
+     */
+    template <typename Lanes, bool BOX>
+    uint32_t cullRange(const CullingSoa& soa, uint32_t begin, uint32_t end, uint32_t* visible)
+    {
+      uint32_t count = 0;
+      uint32_t i     = begin;
+      for (; i + Lanes::WIDTH <= end; i += Lanes::WIDTH)
+      {
+        uint32_t bits = testBlock<Lanes, BOX>(soa, i);
+        for (uint32_t k = 0; k < Lanes::WIDTH; k++)
+        {
+          visible[count] = i + k;  // count <= i + k - begin: запись всегда в пределах
+          count += (bits >> k) & 1;
+        }
+      }
+
+      for (; i < end; i++)
+      {
+        visible[count] = i;
+        count += testBlock<Simd::ScalarLanes, BOX>(soa, i);
+      }
+      return count;
+    }
+  }  // namespace
+}  // namespace CullingKernel
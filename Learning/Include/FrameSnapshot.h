@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Результат одного шага симуляции - всё, что нужно рендереру для кадра.
+ * Снимок не меняется после публикации: поток рендеринга читает его, пока поток
+ * симуляции уже заполняет следующий (см. TripleBuffer).
+ */
+struct FrameSnapshot
+{
+  uint64_t  simulationStep = 0;                // Номер шага симуляции (с 1)
+  double    simulationTime = 0.0;              // Время симуляции в секундах
+  float     animationTime  = 0.0f;             // Фаза анимации [0, 1)
+  glm::mat4 viewProj       = glm::mat4(1.0f);  // Матрица камеры
+};
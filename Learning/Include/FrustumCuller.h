@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "CullingKernel.h"
+#include "ThreadPool.h"
+
+// Статистика последнего отсечения
+struct CullingStats
+{
+  uint32_t tested  = 0;  // Проверено объектов (сферы и AABB)
+  uint32_t visible = 0;  // Попали в пирамиду видимости
+  uint32_t culled  = 0;  // Отброшены
+  double   timeMs  = 0.0;
+};
+
+/**
+ * @brief Отсечение по пирамиде видимости на CPU.
+ * Ограничивающие сферы и AABB хранятся в отдельных SoA-массивах и проверяются против
+ * шести плоскостей камеры по 8 объектов за инструкцию (AVX2; NEON - по 4, иначе
+ * скалярно, см. Simd.h). Большие наборы делятся между потоками пула, а результат -
+ * сжатые списки индексов видимых объектов по возрастанию, готовые для сборки пакетов
+ * отрисовки.
+ *
+ * Индекс объекта - порядковый номер добавления в своём наборе (сферы и AABB
+ * нумеруются независимо). Проверка консервативна: объект на границе считается видимым.
+ */
+class FrustumCuller
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pool Пул потоков для параллельного отсечения (nullptr - однопоточно)
+   */
+  explicit FrustumCuller(ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Добавление ограничивающей сферы
+   * @return Индекс сферы (в этом виде он попадает в getVisibleSpheres())
+   */
+  uint32_t addSphere(const glm::vec3& center, float radius);
+
+  /**
+   * @brief Добавление AABB
+   * @return Индекс AABB (в этом виде он попадает в getVisibleBoxes())
+   */
+  uint32_t addBox(const glm::vec3& min, const glm::vec3& max);
+
+  // Обновление границ движущихся объектов
+  void setSphere(uint32_t index, const glm::vec3& center, float radius);
+  void setBox(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+
+  /**
+   * @brief Удаление всех объектов (память сохраняется)
+   */
+  void clear();
+
+  /**
+   * @brief Отсечение всех объектов по пирамиде видимости камеры
+   * @param viewProj Матрица вида и проекции (глубина клипа [0, 1], как в Vulkan)
+   */
+  void cull(const glm::mat4& viewProj);
+
+  // Индексы видимых объектов по возрастанию (действительны до следующего cull())
+  const std::vector<uint32_t>& getVisibleSpheres() const { return m_visibleSpheres; }
+  const std::vector<uint32_t>& getVisibleBoxes() const { return m_visibleBoxes; }
+
+  /**
+   * @brief Использовать векторное ядро (false - только скалярное, для сравнения)
+   */
+  void setSimdEnabled(bool enabled) { m_simdEnabled = enabled; }
+
+  /**
+   * @brief Название ядра, которым выполняется cull()
+   */
+  const char* getKernelName() const;
+
+  /**
+   * @brief Нормированные плоскости пирамиды видимости (нормали внутрь): x, y, z, w
+   * @param viewProj Матрица вида и проекции (глубина клипа [0, 1])
+   */
+  static void extractPlanes(const glm::mat4& viewProj, float planes[6][4]);
+
+  const CullingStats& getStats() const { return m_stats; }
+  uint32_t            getSphereCount() const;
+  uint32_t            getBoxCount() const;
+
+private:
+  // Участок сжатого списка, записанный одним блоком parallelFor
+  struct ChunkResult
+  {
+    uint32_t begin = 0;
+    uint32_t count = 0;
+  };
+
+  ThreadPool* m_pool;
+
+  // SoA-массивы сфер и AABB (AABB хранятся как центр и полуразмеры)
+  std::array<std::vector<float>, 3> m_sphereCenter;
+  std::vector<float>                m_sphereRadius;
+  std::array<std::vector<float>, 3> m_boxCenter;
+  std::array<std::vector<float>, 3> m_boxExtent;
+
+  std::vector<uint32_t>    m_visibleSpheres;
+  std::vector<uint32_t>    m_visibleBoxes;
+  std::vector<ChunkResult> m_chunks;
+
+  bool         m_simdEnabled = true;
+  CullingStats m_stats;
+
+  const uint32_t MIN_CHUNK = 16384;  // Объектов на блок, меньшие наборы - на месте
+
+  // Отсечение одного набора с записью сжатого списка видимых
+  template <bool BOX>
+  void cullSet(const CullingSoa& soa, uint32_t count, std::vector<uint32_t>& visible);
+
+  template <bool BOX>
+  uint32_t cullRange(const CullingSoa& soa, uint32_t begin, uint32_t end,
+                     uint32_t* visible) const;
+};
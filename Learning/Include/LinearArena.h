@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Линейный (bump-pointer) аллокатор временной памяти.
+ * Выделение - сдвиг указателя в заранее выделенном блоке, освобождение отдельных
+ * объектов не поддерживается: вся память возвращается одним reset(). Деструкторы
+ * размещённых объектов не вызываются, поэтому в арене живут только тривиальные
+ * данные (или объекты, чьё уничтожение организует владелец, см. VulkanFrameContext).
+ *
+ * Если блок закончился, выделение не отказывает: память берётся из кучи отдельным
+ * куском, а при следующем reset() блок увеличивается до пикового заполнения. После
+ * короткого прогрева горячий путь работает без обращений к куче.
+ */
+class LinearArena
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param capacity Начальный размер блока в байтах
+   */
+  explicit LinearArena(size_t capacity = 0);
+
+  LinearArena(LinearArena&& other) noexcept;
+  LinearArena& operator=(LinearArena&& other) noexcept;
+
+  LinearArena(const LinearArena&)            = delete;
+  LinearArena& operator=(const LinearArena&) = delete;
+
+  /**
+   * @brief Выделение неинициализированной памяти
+   * @param size Размер в байтах
+   * @param alignment Выравнивание (степень двойки)
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    uintptr_t base    = reinterpret_cast<uintptr_t>(m_buffer.get());
+    uintptr_t current = base + m_offset;
+    uintptr_t aligned = (current + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    if (m_buffer && aligned + size <= base + m_capacity)
+    {
+      m_offset = aligned + size - base;
+      return reinterpret_cast<void*>(aligned);
+    }
+    return allocateOverflow(size, alignment);
+  }
+
+  /**
+   * @brief Массив из count неинициализированных элементов
+   */
+  template <typename T>
+  T* allocateArray(size_t count)
+  {
+    return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /**
+   * @brief Создание объекта в арене (деструктор при reset() не вызывается)
+   */
+  template <typename T, typename... Args>
+  T* create(Args&&... args)
+  {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Освобождение всей памяти арены. Ранее выделенные указатели становятся
+   * недействительными; после переполнения блок увеличивается до пикового заполнения
+   */
+  void reset();
+
+  // Занято с последнего reset(), размер блока, наибольшее заполнение между reset()
+  // и количество выделений из кучи за всё время
+  size_t getUsed() const { return m_offset + m_overflowBytes; }
+  size_t getCapacity() const { return m_capacity; }
+  size_t getPeak() const { return m_peak; }
+  size_t getOverflowCount() const { return m_overflowCount; }
+
+private:
+  std::unique_ptr<std::byte[]>              m_buffer;
+  std::vector<std::unique_ptr<std::byte[]>> m_overflow;  // Куски из кучи до следующего reset()
+  size_t                                    m_capacity      = 0;
+  size_t                                    m_offset        = 0;
+  size_t                                    m_overflowBytes = 0;
+  size_t                                    m_overflowCount = 0;
+  size_t                                    m_peak          = 0;
+
+  void* allocateOverflow(size_t size, size_t alignment);
+};
+
+/**
+ * @brief Адаптер LinearArena для стандартных контейнеров.
+ * deallocate ничего не делает: память возвращается при reset() арены, поэтому
+ * контейнер должен быть уничтожен до него. Рост контейнера оставляет старый буфер
+ * занятым до reset() - размер лучше резервировать заранее.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(LinearArena& arena) : m_pArena(&arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : m_pArena(other.getArena())
+  {
+  }
+
+  T*   allocate(size_t count) { return m_pArena->allocateArray<T>(count); }
+  void deallocate(T*, size_t) {}
+
+  LinearArena* getArena() const { return m_pArena; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const
+  {
+    return m_pArena == other.getArena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const
+  {
+    return m_pArena != other.getArena();
+  }
+
+private:
+  LinearArena* m_pArena;
+};
+
+// Вектор во временной памяти кадра
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+// Статистика последнего выбора уровней
+struct LodStats
+{
+  uint32_t objects   = 0;
+  uint32_t switches  = 0;  // Объектов, сменивших уровень
+  uint64_t triangles = 0;  // Треугольников на выбранных уровнях
+  uint64_t saved     = 0;  // Треугольников, не отправленных благодаря LOD
+  double   timeMs    = 0.0;
+};
+
+/**
+ * @brief Выбор уровня детализации объектов по ошибке на экране.
+ * Ошибка уровня из цепочки (в единицах меша) проецируется в пиксели по расстоянию до
+ * ближайшей точки ограничивающей сферы, и выбирается самый грубый уровень, ошибка
+ * которого не больше порога. Переход на более грубый уровень требует запаса
+ * (гистерезис), поэтому объект на границе порога не переключается каждый кадр.
+ *
+ * Объекты хранятся SoA-массивами, большие наборы обрабатываются параллельно в пуле.
+ */
+class LodSelector
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pool Пул потоков для параллельного выбора (nullptr - однопоточно)
+   */
+  explicit LodSelector(ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Регистрация цепочки уровней меша (копируются только ошибки и размеры уровней)
+   * @return Индекс меша для addObject()
+   */
+  uint32_t addMesh(const LodChain& chain);
+
+  /**
+   * @brief Добавление объекта с ограничивающей сферой в пространстве мира
+   * @param scale Масштаб модели (ошибки уровней умножаются на него)
+   * @return Индекс объекта (позиция в getLevels())
+   */
+  uint32_t addObject(uint32_t mesh, const glm::vec3& center, float radius, float scale = 1.0f);
+
+  // Обновление границ движущегося объекта
+  void setObject(uint32_t index, const glm::vec3& center, float radius);
+
+  /**
+   * @brief Удаление всех объектов и мешей (память сохраняется)
+   */
+  void clear();
+
+  /**
+   * @brief Выбор уровней всех объектов для камеры
+   * @param viewProj Матрица вида и проекции (перспективная или ортографическая)
+   * @param viewport Размер области вывода в пикселях
+   */
+  void select(const glm::mat4& viewProj, const glm::vec2& viewport);
+
+  /**
+   * @brief Допустимая ошибка на экране в пикселях
+   */
+  void setThreshold(float pixels) { m_threshold = pixels; }
+
+  /**
+   * @brief Доля порога, на которую ошибка грубого уровня должна быть меньше для перехода
+   */
+  void setHysteresis(float fraction) { m_hysteresis = fraction; }
+
+  // Текущий уровень каждого объекта
+  const std::vector<uint8_t>& getLevels() const { return m_levels; }
+
+  const LodStats& getStats() const { return m_stats; }
+  uint32_t        getObjectCount() const { return static_cast<uint32_t>(m_levels.size()); }
+
+private:
+  // Уровни меша в общем массиве m_levelErrors
+  struct MeshLevels
+  {
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+
+  // Счётчики одного блока parallelFor
+  struct ChunkResult
+  {
+    uint32_t switches  = 0;
+    uint64_t triangles = 0;
+    uint64_t saved     = 0;
+  };
+
+  ThreadPool* m_pool;
+
+  std::vector<MeshLevels> m_meshes;
+  std::vector<float>      m_levelErrors;     // Ошибки уровней всех мешей подряд
+  std::vector<uint32_t>   m_levelTriangles;  // Треугольников на уровне
+
+  // SoA-массивы объектов
+  std::vector<float>    m_centerX;
+  std::vector<float>    m_centerY;
+  std::vector<float>    m_centerZ;
+  std::vector<float>    m_radius;
+  std::vector<float>    m_scale;
+  std::vector<uint32_t> m_mesh;
+  std::vector<uint8_t>  m_levels;
+
+  std::vector<ChunkResult> m_chunks;
+
+  float    m_threshold  = 1.0f;
+  float    m_hysteresis = 0.25f;
+  LodStats m_stats;
+
+  const uint32_t MIN_CHUNK  = 16384;  // Объектов на блок, меньшие наборы - на месте
+  const uint32_t MAX_LEVELS = 255;    // Уровень хранится в uint8_t
+
+  /**
+   * @brief Выбор уровней объектов [begin, end)
+   * @param depthRow Строка матрицы, дающая глубину w точки клипа
+   * @param pixelScale Пикселей на единицу мира при w = 1
+   */
+  ChunkResult selectRange(const glm::vec4& depthRow, float pixelScale, uint32_t begin,
+                          uint32_t end);
+};
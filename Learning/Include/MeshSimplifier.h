@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Уровень детализации: диапазон общего индексного буфера цепочки
+struct LodLevel
+{
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  float    error      = 0.0f;  // Отклонение от исходного меша (в единицах меша)
+};
+
+/**
+ * @brief Цепочка уровней детализации одного меша.
+ * Все уровни ссылаются на исходные вершины, поэтому буфер вершин общий, а индексы
+ * уровней лежат подряд в одном массиве: уровень 0 - исходный меш, каждый следующий
+ * грубее, ошибки не убывают.
+ */
+struct LodChain
+{
+  std::vector<uint32_t> indices;
+  std::vector<LodLevel> levels;
+};
+
+// Параметры построения цепочки
+struct LodChainOptions
+{
+  uint32_t maxLevels  = 8;      // Уровней вместе с исходным
+  float    ratio      = 0.5f;   // Доля треугольников следующего уровня от предыдущего
+  float    maxError   = 1e30f;  // Ошибка, после которой упрощение прекращается
+  float    minSavings = 0.1f;   // Уровень, сокративший меньше этой доли, не добавляется
+};
+
+namespace MeshSimplifier
+{
+  /**
+   * @brief Упрощение треугольного меша стягиванием рёбер по квадрикам ошибок (QEM).
+   * Вершина стягивается в соседнюю, поэтому новых вершин не появляется, и результат -
+   * только новый список индексов. Границы меша сохраняются: граничная вершина сдвигается
+   * лишь вдоль границы. Вершины, положение которых совпадает с другой вершиной (швы
+   * атрибутов), и вершины неманифолдных рёбер не удаляются.
+   * @param positions Положения вершин
+   * @param indices Список треугольников
+   * @param targetIndexCount Желаемое количество индексов
+   * @param maxError Наибольшая допустимая ошибка стягивания (в единицах меша)
+   * @param resultError Достигнутая ошибка (может быть nullptr)
+   * @return Индексы упрощённого меша (не больше исходного количества)
+   */
+  std::vector<uint32_t> simplify(const std::vector<glm::vec3>& positions,
+                                 const std::vector<uint32_t>& indices, size_t targetIndexCount,
+                                 float maxError, float* resultError = nullptr);
+
+  /**
+   * @brief Построение цепочки уровней: каждый уровень упрощается из предыдущего,
+   * а его ошибка - сумма ошибок шагов (оценка сверху по неравенству треугольника)
+   */
+  LodChain buildLodChain(const std::vector<glm::vec3>& positions,
+                         const std::vector<uint32_t>& indices,
+                         const LodChainOptions&       options = LodChainOptions());
+}  // namespace MeshSimplifier
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Гистограмма задержек в стиле HDR Histogram.
+ * Корзины лог-линейные: каждая степень двойки делится на SUB_BUCKET_COUNT равных частей,
+ * поэтому относительная погрешность любого перцентиля не больше 1/SUB_BUCKET_COUNT при
+ * фиксированной памяти. Запись - O(1) без блокировок и выделений; писатель один
+ * (поток кадра), читать снимок можно из любого потока.
+ */
+class LatencyHistogram
+{
+public:
+  static const uint32_t SUB_BUCKET_BITS  = 5;   // 32 части на октаву: погрешность ~3%
+  static const uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+  static const uint32_t MAX_VALUE_BITS   = 38;  // До 2^38 нс (~4.5 мин), больше - в последнюю
+  static const uint32_t OCTAVE_COUNT     = MAX_VALUE_BITS - SUB_BUCKET_BITS + 1;
+  static const uint32_t BUCKET_COUNT     = OCTAVE_COUNT * SUB_BUCKET_COUNT;
+
+  // Копия счётчиков на момент чтения
+  struct Snapshot
+  {
+    std::vector<uint64_t> counts;  // По корзинам, см. getBucketUpperBound()
+    uint64_t              count = 0;
+    uint64_t              sumNs = 0;
+    uint64_t              maxNs = 0;
+
+    // Значение перцентиля (верхняя граница корзины), fraction в [0, 1]
+    uint64_t getPercentile(double fraction) const;
+
+    // Количество значений не больше boundNs (точно на границах корзин)
+    uint64_t countAtOrBelow(uint64_t boundNs) const;
+  };
+
+  /**
+   * @brief Запись значения в наносекундах (только из потока-писателя)
+   */
+  void record(uint64_t valueNs)
+  {
+    relaxedIncrement(m_counts[getBucketIndex(valueNs)], 1);
+    relaxedIncrement(m_sumNs, valueNs);
+    if (valueNs > m_maxNs.load(std::memory_order_relaxed))
+    {
+      m_maxNs.store(valueNs, std::memory_order_relaxed);
+    }
+  }
+
+  void record(std::chrono::steady_clock::duration duration)
+  {
+    record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+  }
+
+  Snapshot snapshot() const;
+
+  static uint32_t getBucketIndex(uint64_t valueNs);
+  static uint64_t getBucketUpperBound(uint32_t index);  // Наибольшее значение корзины
+
+private:
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts = {};
+  std::atomic<uint64_t>                           m_sumNs{0};
+  std::atomic<uint64_t>                           m_maxNs{0};
+
+  // Писатель один: обычные load/store без атомарного RMW (без lock-префикса на x86)
+  static void relaxedIncrement(std::atomic<uint64_t>& counter, uint64_t value)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Монотонный счётчик (потокобезопасный)
+ */
+class MetricsCounter
+{
+public:
+  void     add(uint64_t value) { m_value.fetch_add(value, std::memory_order_relaxed); }
+  uint64_t get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @brief Набор именованных метрик с выводом в текстовом формате Prometheus.
+ * Метрики регистрируются при инициализации и живут столько же, сколько реестр:
+ * ссылки на них можно хранить и писать в них без обращения к реестру.
+ */
+class MetricsRegistry
+{
+public:
+  /**
+   * @brief Регистрация гистограммы задержек
+   * @param name Имя метрики Prometheus (значения экспортируются в секундах)
+   * @param help Описание для строки # HELP
+   */
+  LatencyHistogram& addHistogram(const std::string& name, const std::string& help);
+
+  /**
+   * @brief Регистрация монотонного счётчика
+   */
+  MetricsCounter& addCounter(const std::string& name, const std::string& help);
+
+  /**
+   * @brief Снимок всех метрик в текстовом формате Prometheus (0.0.4).
+   * Гистограмма выводится как histogram на границах EXPORT_BOUNDS_MS и как набор
+   * перцентилей <name>_quantile, посчитанных по полному разрешению корзин
+   */
+  void writePrometheus(std::ostream& out) const;
+
+private:
+  template <typename T>
+  struct Entry
+  {
+    std::string        name;
+    std::string        help;
+    std::unique_ptr<T> metric;  // Адрес не меняется при добавлении новых метрик
+  };
+
+  mutable std::mutex                   m_mutex;  // Защищает списки, не сами метрики
+  std::vector<Entry<LatencyHistogram>> m_histograms;
+  std::vector<Entry<MetricsCounter>>   m_counters;
+};
+
+/**
+ * @brief Периодическая запись метрик в файл.
+ * Файл перезаписывается атомарно (запись во временный файл и переименование), так что
+ * читатель - например, textfile collector node_exporter - никогда не видит половину снимка.
+ * Запись выполняется в собственном потоке и не задерживает кадр.
+ */
+class MetricsExporter
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param registry Реестр метрик (должен пережить экспортёр)
+   * @param path Путь к файлу снимка
+   * @param intervalSec Период записи в секундах
+   */
+  MetricsExporter(const MetricsRegistry& registry, const std::string& path, double intervalSec);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter&)            = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  /**
+   * @brief Запуск потока записи
+   */
+  void start();
+
+  /**
+   * @brief Остановка потока с записью последнего снимка
+   */
+  void stop();
+
+  /**
+   * @brief Немедленная запись снимка (в вызывающем потоке)
+   * @return true, если файл записан
+   */
+  bool writeSnapshot() const;
+
+private:
+  const MetricsRegistry& m_registry;
+  std::string            m_path;
+  double                 m_intervalSec;
+
+  std::thread             m_thread;
+  std::mutex              m_mutex;
+  std::condition_variable m_wakeUp;
+  bool                    m_stopping = false;
+
+  void exportLoop();
+};
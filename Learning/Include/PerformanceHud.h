@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Вершина оверлея: положение в пикселях от левого верхнего угла, координаты атласа, цвет
+struct HudVertex
+{
+  float    position[2];
+  float    uv[2];
+  uint32_t color;  // RGBA8 (R в младшем байте)
+};
+
+// Показатели кадра для оверлея
+struct HudFrameStats
+{
+  float    frameMs      = 0.0f;  // Интервал между кадрами
+  float    cpuMs        = 0.0f;  // Подготовка и запись кадра на CPU
+  float    gpuMs        = 0.0f;  // Выполнение команд кадра на GPU (0 - замер недоступен)
+  float    cullMs       = 0.0f;
+  float    lodMs        = 0.0f;
+  float    particlesMs  = 0.0f;  // Симуляция частиц на GPU
+  uint32_t draws        = 0;
+  uint64_t triangles    = 0;
+  uint64_t memoryUsage  = 0;  // Занято в локальных кучах устройства, байт
+  uint64_t memoryBudget = 0;
+};
+
+/**
+ * @brief Оверлей с показателями производительности.
+ * Строит треугольники текста, фона и графика времени кадров одним списком вершин,
+ * который рисуется одним вызовом с одной текстурой - атласом встроенного шрифта 5x7.
+ * Прямоугольники берут из атласа полностью заполненную ячейку, поэтому текст и
+ * графика не требуют смены конвейера. Класс не обращается к Vulkan.
+ */
+class PerformanceHud
+{
+public:
+  // Размер атласа шрифта (R8, одна ячейка 6x8 на символ)
+  static const uint32_t ATLAS_WIDTH  = 96;
+  static const uint32_t ATLAS_HEIGHT = 32;
+
+  // Кадров в графике и наибольшее количество вершин, которое возвращает build()
+  static const uint32_t HISTORY_SIZE   = 240;
+  static const uint32_t MAX_LINE_CHARS = 40;
+  static const uint32_t LINE_COUNT     = 5;
+  static const uint32_t MAX_VERTICES   = (3 + HISTORY_SIZE + LINE_COUNT * MAX_LINE_CHARS) * 6;
+
+  /**
+   * @brief Пиксели атласа шрифта (ATLAS_WIDTH x ATLAS_HEIGHT, построчно)
+   */
+  static std::vector<uint8_t> buildFontAtlas();
+
+  /**
+   * @brief Упаковка цвета в формат HudVertex::color
+   */
+  static uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
+
+  /**
+   * @brief Целочисленный масштаб пикселя шрифта и графика
+   */
+  void setScale(uint32_t scale) { m_scale = scale > 0 ? scale : 1; }
+
+  /**
+   * @brief Добавление показателей очередного кадра (время кадра попадает в график)
+   */
+  void addFrame(const HudFrameStats& stats);
+
+  /**
+   * @brief Построение вершин оверлея для последнего кадра
+   * @param vertices Буфер вершин (например, отображённая память GPU)
+   * @param capacity Размер буфера в вершинах (лишнее отбрасывается)
+   * @return Количество записанных вершин (кратно 6)
+   */
+  uint32_t build(HudVertex* vertices, uint32_t capacity) const;
+
+private:
+  // Запись вершин с проверкой места
+  struct VertexWriter
+  {
+    HudVertex* vertices;
+    uint32_t   capacity;
+    uint32_t   count;
+  };
+
+  std::array<float, HISTORY_SIZE> m_history      = {};  // Кольцо времён кадров
+  uint32_t                        m_historyHead  = 0;   // Позиция следующей записи
+  uint32_t                        m_historyCount = 0;
+  HudFrameStats                   m_stats;
+  uint32_t                        m_scale = 2;
+
+  const float TARGET_FRAME_MS = 1000.0f / 60.0f;  // Кадры дольше подсвечиваются на графике
+
+  /**
+   * @brief Четырёхугольник из двух треугольников (пропускается, если места нет)
+   */
+  void emitQuad(VertexWriter& writer, float x0, float y0, float x1, float y1, float u0, float v0,
+                float u1, float v1, uint32_t color) const;
+
+  /**
+   * @brief Прямоугольник цвета color (сплошная ячейка атласа)
+   */
+  void emitRect(VertexWriter& writer, float x, float y, float width, float height,
+                uint32_t color) const;
+
+  /**
+   * @brief Строка текста от точки (x, y)
+   */
+  void emitText(VertexWriter& writer, float x, float y, const char* text, uint32_t color) const;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Элемент сортировки: ключ и индекс исходного элемента
+struct SortEntry
+{
+  uint64_t key;
+  uint32_t index;
+};
+
+namespace RadixSort
+{
+  /**
+   * @brief Стабильная LSD-сортировка по 64-битному ключу (8 проходов по 8 бит).
+   * Проходы, в которых у всех ключей одинаковый байт, пропускаются.
+   * При наличии пула гистограммы и раскладка считаются параллельно по блокам.
+   * @param entries Сортируемые элементы (результат остаётся здесь)
+   * @param scratch Временный буфер (размер подгоняется автоматически)
+   * @param pool Пул потоков (nullptr - однопоточно)
+   */
+  void sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch,
+            ThreadPool* pool = nullptr);
+}  // namespace RadixSort
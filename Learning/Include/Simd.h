@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Векторные «полосы» для ядер, написанных один раз в виде шаблона.
+ * Ядро оперирует типами V (значения) и M (маски сравнений) и статическими функциями
+ * набора, а ширина WIDTH определяет, сколько элементов SoA-массивов обрабатывается за
+ * шаг. Скалярный набор доступен всегда и используется для хвостов и как запасной вариант.
+ *
+ * AVX2-набор виден только в единицах трансляции, собранных с -mavx2 (/arch:AVX2,
+ * см. VKAPI_ENABLE_AVX2 в CMakeLists.txt): остальной код движка остаётся
+ * совместимым с любым x86-64, а выбор ядра делается при запуске по hasAvx2().
+ * Наборы и ядра на их основе лежат в безымянном пространстве имён: у каждой единицы
+ * трансляции своя копия, и компоновщик не подставит в скалярный код версию,
+ * собранную с AVX2.
+ */
+namespace Simd
+{
+  /**
+   * @brief Поддерживают ли процессор и ОС инструкции AVX2 и FMA (результат кэшируется)
+   */
+  bool hasAvx2();
+
+  namespace
+  {
+    struct ScalarLanes
+    {
+      using V = float;
+      using M = bool;
+
+      static constexpr uint32_t    WIDTH = 1;
+      static constexpr const char* NAME  = "скаляр";
+
+      static V    load(const float* p) { return *p; }
+      static void store(float* p, V v) { *p = v; }
+      static V    set1(float value) { return value; }
+      static V    add(V a, V b) { return a + b; }
+      static V    sub(V a, V b) { return a - b; }
+      static V    mul(V a, V b) { return a * b; }
+      static V    fmadd(V a, V b, V c) { return a * b + c; }
+      static V    gather(const float* base, const uint32_t* indices) { return base[indices[0]]; }
+
+      static M        cmpGe(V a, V b) { return a >= b; }
+      static M        andMask(M a, M b) { return a && b; }
+      static uint32_t maskBits(M m) { return m ? 1u : 0u; }
+    };
+
+#if defined(__ARM_NEON)
+    struct NeonLanes
+    {
+      using V = float32x4_t;
+      using M = uint32x4_t;
+
+      static constexpr uint32_t    WIDTH = 4;
+      static constexpr const char* NAME  = "NEON";
+
+      static V    load(const float* p) { return vld1q_f32(p); }
+      static void store(float* p, V v) { vst1q_f32(p, v); }
+      static V    set1(float value) { return vdupq_n_f32(value); }
+      static V    add(V a, V b) { return vaddq_f32(a, b); }
+      static V    sub(V a, V b) { return vsubq_f32(a, b); }
+      static V    mul(V a, V b) { return vmulq_f32(a, b); }
+      static V    fmadd(V a, V b, V c) { return vfmaq_f32(c, a, b); }
+
+      // В NEON нет gather: элементы собираются по одному
+      static V gather(const float* base, const uint32_t* indices)
+      {
+        float values[4] = {base[indices[0]], base[indices[1]], base[indices[2]],
+                           base[indices[3]]};
+        return vld1q_f32(values);
+      }
+
+      static M cmpGe(V a, V b) { return vcgeq_f32(a, b); }
+      static M andMask(M a, M b) { return vandq_u32(a, b); }
+
+      // Бит i результата - полоса i маски (аналог movemask)
+      static uint32_t maskBits(M m)
+      {
+        return (vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) |
+               (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8);
+      }
+    };
+#endif
+
+#if defined(__AVX2__)
+    struct Avx2Lanes
+    {
+      using V = __m256;
+      using M = __m256;
+
+      static constexpr uint32_t    WIDTH = 8;
+      static constexpr const char* NAME  = "AVX2";
+
+      static V    load(const float* p) { return _mm256_loadu_ps(p); }
+      static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+      static V    set1(float value) { return _mm256_set1_ps(value); }
+      static V    add(V a, V b) { return _mm256_add_ps(a, b); }
+      static V    sub(V a, V b) { return _mm256_sub_ps(a, b); }
+      static V    mul(V a, V b) { return _mm256_mul_ps(a, b); }
+      static V    fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+
+      static V gather(const float* base, const uint32_t* indices)
+      {
+        __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+        return _mm256_i32gather_ps(base, offsets, 4);
+      }
+
+      static M        cmpGe(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+      static M        andMask(M a, M b) { return _mm256_and_ps(a, b); }
+      static uint32_t maskBits(M m) { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+    };
+#endif
+  }  // namespace
+}  // namespace Simd
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Спрайт: прямоугольник в пикселях от левого верхнего угла и его область на странице атласа
+struct Sprite
+{
+  float    x, y;
+  float    width, height;
+  float    u0, v0, u1, v1;  // Нормализованные координаты на странице
+  uint32_t color;           // RGBA8 (R в младшем байте), умножается на текстуру
+  uint32_t page;            // Страница атласа (меньше количества страниц батчера)
+};
+
+// Вершина спрайта (16 байт): положение в NDC, координаты атласа в unorm16, цвет
+struct SpriteVertex
+{
+  float    position[2];
+  uint16_t uv[2];
+  uint32_t color;
+};
+
+// Пачка спрайтов одной страницы: квады [firstQuad, firstQuad + quadCount)
+struct SpriteBatch
+{
+  uint32_t page      = 0;
+  uint32_t firstQuad = 0;
+  uint32_t quadCount = 0;
+};
+
+/**
+ * @brief Сборка спрайтов в пачки по страницам атласа.
+ * Спрайты кадра копятся в массиве, а build() раскладывает их подсчётом по страницам
+ * (внутри страницы порядок добавления сохраняется) и пишет по четыре вершины на спрайт
+ * сразу в выходной буфер - обычно постоянно отображённую память GPU. Каждая пачка
+ * рисуется одним индексированным вызовом с общим статическим буфером индексов квадов.
+ * Большие наборы раскладываются параллельно в пуле потоков.
+ */
+class SpriteBatcher
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pageCount Количество страниц атласа
+   * @param pool Пул потоков для параллельной сборки (nullptr - однопоточно)
+   */
+  explicit SpriteBatcher(uint32_t pageCount, ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Индексы квадов 0-1-2, 2-3-0 для quadCount квадов подряд
+   */
+  static std::vector<uint32_t> buildQuadIndices(uint32_t quadCount);
+
+  /**
+   * @brief Начало кадра: удаление спрайтов прошлого кадра (память сохраняется)
+   */
+  void clear() { m_sprites.clear(); }
+
+  void reserve(size_t spriteCount) { m_sprites.reserve(spriteCount); }
+
+  /**
+   * @brief Добавление спрайта
+   */
+  void draw(const Sprite& sprite) { m_sprites.push_back(sprite); }
+
+  /**
+   * @brief Добавление count спрайтов, которые вызывающий заполнит сам (например,
+   * параллельно). Указатель действует до следующего добавления
+   */
+  Sprite* allocate(uint32_t count);
+
+  /**
+   * @brief Размер цели в пикселях (для перевода положений в NDC)
+   */
+  void setViewport(float width, float height);
+
+  /**
+   * @brief Запись вершин всех спрайтов, сгруппированных по страницам
+   * @param vertices Буфер на maxQuads * 4 вершин
+   * @param maxQuads Вместимость буфера в квадах (лишние спрайты отбрасываются)
+   * @return Пачки в порядке страниц (пустые страницы пропускаются)
+   */
+  const std::vector<SpriteBatch>& build(SpriteVertex* vertices, uint32_t maxQuads);
+
+  uint32_t getSpriteCount() const { return static_cast<uint32_t>(m_sprites.size()); }
+  uint32_t getPageCount() const { return m_pageCount; }
+
+private:
+  uint32_t    m_pageCount;
+  ThreadPool* m_pool;
+
+  std::vector<Sprite>      m_sprites;
+  std::vector<SpriteBatch> m_batches;
+  std::vector<uint32_t>    m_chunkOffsets;  // Счётчики, затем позиции записи [блок][страница]
+
+  // Перевод пикселей в NDC: ndc = pixel * scale - 1
+  float m_scaleX = 1.0f;
+  float m_scaleY = 1.0f;
+
+  const uint32_t MIN_CHUNK = 16384;  // Спрайтов на блок, меньшие наборы - на месте
+
+  /**
+   * @brief Запись вершин спрайтов [begin, end) по позициям offsets (по странице)
+   */
+  void writeRange(SpriteVertex* vertices, uint32_t maxQuads, uint32_t begin, uint32_t end,
+                  uint32_t* offsets) const;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Поток, на котором выполняется стадия запуска
+enum class StartupThread
+{
+  Main,   // Вызывающий поток (SDL и всё, что обязано жить в главном потоке)
+  Worker  // Любой рабочий поток пула
+};
+
+/**
+ * @brief Граф стадий запуска приложения.
+ * Стадия выполняется, как только завершены все её зависимости: стадии главного
+ * потока - в вызывающем потоке, остальные - в пуле, параллельно с ним. Для каждой
+ * стадии запоминаются момент начала и длительность, из которых строится отчёт о
+ * времени запуска. Ошибка стадии (исключение) отменяет все ещё не начатые стадии.
+ */
+class StartupGraph
+{
+public:
+  // Тело стадии: ошибка сообщается исключением
+  using StageFn = std::function<void()>;
+
+  /**
+   * @brief Добавление стадии
+   * @param name Имя стадии в отчёте
+   * @param thread Поток выполнения
+   * @param dependencies Индексы стадий, которые должны завершиться раньше
+   * @param fn Тело стадии
+   * @return Индекс стадии
+   */
+  uint32_t addStage(const std::string& name, StartupThread thread,
+                    const std::vector<uint32_t>& dependencies, StageFn fn);
+
+  /**
+   * @brief Выполнение всех стадий (возвращается, когда завершены все начатые)
+   * @param pool Пул для стадий StartupThread::Worker
+   * @return true, если все стадии выполнены без ошибок
+   */
+  bool run(ThreadPool& pool);
+
+  /**
+   * @brief Текст первой ошибки (пустой, если ошибок не было)
+   */
+  const std::string& getError() const { return m_error; }
+
+  /**
+   * @brief Отчёт: начало и длительность каждой стадии, общее время и выигрыш
+   * от параллельного выполнения относительно последовательного
+   */
+  void printReport(std::ostream& out) const;
+
+private:
+  enum class StageState
+  {
+    Pending,
+    Running,
+    Done,
+    Failed,
+    Skipped  // Не выполнялась из-за ошибки другой стадии
+  };
+
+  struct Stage
+  {
+    std::string           name;
+    StartupThread         thread;
+    std::vector<uint32_t> dependencies;
+    StageFn               fn;
+    StageState            state   = StageState::Pending;
+    double                startMs = 0.0;  // От начала run()
+    double                timeMs  = 0.0;
+  };
+
+  std::vector<Stage>                    m_stages;
+  std::chrono::steady_clock::time_point m_startTime;
+  double                                m_totalMs = 0.0;
+  std::string                           m_error;
+
+  bool isReady(const Stage& stage) const;
+  void execute(uint32_t index, std::string& error);  // Выполнение тела с замером времени
+};
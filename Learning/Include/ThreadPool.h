@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Пул рабочих потоков для параллельной обработки на CPU.
+ * Вызывающий поток участвует в работе наравне с рабочими, поэтому
+ * parallelFor можно безопасно вызывать и изнутри задачи пула.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param workerCount Количество рабочих потоков (0 - по числу ядер минус один)
+   */
+  explicit ThreadPool(uint32_t workerCount = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Количество потоков, выполняющих работу (рабочие + вызывающий)
+   */
+  uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+  /**
+   * @brief Постановка задачи в очередь без ожидания
+   */
+  void submit(std::function<void()> task);
+
+  /**
+   * @brief Параллельная обработка диапазона [0, count) непрерывными блоками
+   * @param count Размер диапазона
+   * @param minChunk Минимальный размер блока (меньшие диапазоны обрабатываются на месте)
+   * @param fn Обработчик блока: fn(begin, end, chunkIndex)
+   * @return Количество блоков, на которые был разбит диапазон
+   */
+  uint32_t parallelFor(uint32_t count, uint32_t minChunk,
+                       const std::function<void(uint32_t, uint32_t, uint32_t)>& fn);
+
+  /**
+   * @brief Максимальное количество блоков, которое может вернуть parallelFor
+   */
+  uint32_t getMaxChunks() const { return getThreadCount(); }
+
+private:
+  std::vector<std::thread>          m_workers;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex                        m_mutex;
+  std::condition_variable           m_taskAvailable;
+  std::condition_variable           m_taskFinished;
+  bool                              m_stopping = false;
+
+  // Выполнение одной задачи из очереди (false - очередь пуста)
+  bool runPendingTask();
+  void workerLoop();
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Simd.h"
+
+/**
+ * @brief SoA-представление узлов TransformSystem для ядер обновления.
+ * Мировая матрица хранится как аффинная 3x4 по столбцам: world[col * 3 + row],
+ * столбец 3 - перенос. Узел 0 - единичный корень, родитель всех корней сцены.
+ */
+struct TransformSoa
+{
+  const float*    position[3];  // Локальный перенос
+  const float*    rotation[4];  // Локальный поворот (кватернион x, y, z, w, нормирован)
+  const float*    scale[3];     // Локальный масштаб
+  const uint32_t* parent;       // Индекс родителя (всегда меньше индекса узла)
+  uint8_t*        localDirty;   // Локальное преобразование менялось с прошлого обновления
+  uint8_t*        changed;      // Мировая матрица изменилась в этом обновлении
+  float*          world[12];
+};
+
+namespace TransformKernel
+{
+  /**
+   * @brief Обновление узлов [begin, end) одного уровня иерархии ядром AVX2
+   * (определено только при сборке с VKAPI_ENABLE_AVX2)
+   * @return Количество узлов с изменившейся мировой матрицей
+   */
+  uint32_t updateRangeAvx2(const TransformSoa& soa, uint32_t begin, uint32_t end);
+
+  namespace
+  {
+    // Флаги изменения WIDTH узлов: свой локальный или изменившийся родитель
+    template <uint32_t WIDTH>
+    uint32_t propagateDirty(const TransformSoa& soa, uint32_t first)
+    {
+      uint32_t count = 0;
+      for (uint32_t i = first; i < first + WIDTH; i++)
+      {
+        uint8_t changed   = soa.localDirty[i] | soa.changed[soa.parent[i]];
+        soa.changed[i]    = changed;
+        soa.localDirty[i] = 0;
+        count += changed;
+      }
+      return count;
+    }
+
+    // world = parentWorld * (T * R * S) для Lanes::WIDTH узлов начиная с first
+    template <typename Lanes>
+    void computeBlock(const TransformSoa& soa, uint32_t first)
+    {
+      using V = typename Lanes::V;
+
+      V qx = Lanes::load(soa.rotation[0] + first);
+      V qy = Lanes::load(soa.rotation[1] + first);
+      V qz = Lanes::load(soa.rotation[2] + first);
+      V qw = Lanes::load(soa.rotation[3] + first);
+
+      V one = Lanes::set1(1.0f);
+      V two = Lanes::set1(2.0f);
+      V x2  = Lanes::mul(qx, two);
+      V y2  = Lanes::mul(qy, two);
+      V z2  = Lanes::mul(qz, two);
+      V xx  = Lanes::mul(qx, x2);
+      V yy  = Lanes::mul(qy, y2);
+      V zz  = Lanes::mul(qz, z2);
+      V xy  = Lanes::mul(qx, y2);
+      V xz  = Lanes::mul(qx, z2);
+      V yz  = Lanes::mul(qy, z2);
+      V wx  = Lanes::mul(qw, x2);
+      V wy  = Lanes::mul(qw, y2);
+      V wz  = Lanes::mul(qw, z2);
+
+      // Локальная матрица по столбцам: столбцы поворота умножены на масштаб
+      V sx = Lanes::load(soa.scale[0] + first);
+      V sy = Lanes::load(soa.scale[1] + first);
+      V sz = Lanes::load(soa.scale[2] + first);
+
+      V local[12];
+      local[0]  = Lanes::mul(Lanes::sub(one, Lanes::add(yy, zz)), sx);
+      local[1]  = Lanes::mul(Lanes::add(xy, wz), sx);
+      local[2]  = Lanes::mul(Lanes::sub(xz, wy), sx);
+      local[3]  = Lanes::mul(Lanes::sub(xy, wz), sy);
+      local[4]  = Lanes::mul(Lanes::sub(one, Lanes::add(xx, zz)), sy);
+      local[5]  = Lanes::mul(Lanes::add(yz, wx), sy);
+      local[6]  = Lanes::mul(Lanes::add(xz, wy), sz);
+      local[7]  = Lanes::mul(Lanes::sub(yz, wx), sz);
+      local[8]  = Lanes::mul(Lanes::sub(one, Lanes::add(xx, yy)), sz);
+      local[9]  = Lanes::load(soa.position[0] + first);
+      local[10] = Lanes::load(soa.position[1] + first);
+      local[11] = Lanes::load(soa.position[2] + first);
+
+      // Мировые матрицы родителей: соседние узлы обычно делят одного родителя
+      const uint32_t* parents = soa.parent + first;
+      V               parent[12];
+      for (uint32_t k = 0; k < 12; k++)
+      {
+        parent[k] = Lanes::gather(soa.world[k], parents);
+      }
+
+      // Столбцы 0..2: поворот родителя на столбец локальной матрицы
+      for (uint32_t col = 0; col < 3; col++)
+      {
+        for (uint32_t row = 0; row < 3; row++)
+        {
+          V value = Lanes::mul(parent[row], local[col * 3]);
+          value   = Lanes::fmadd(parent[3 + row], local[col * 3 + 1], value);
+          value   = Lanes::fmadd(parent[6 + row], local[col * 3 + 2], value);
+          Lanes::store(soa.world[col * 3 + row] + first, value);
+        }
+      }
+
+      // Перенос: поворот родителя на локальный перенос плюс перенос родителя
+      for (uint32_t row = 0; row < 3; row++)
+      {
+        V value = Lanes::fmadd(parent[row], local[9], parent[9 + row]);
+        value   = Lanes::fmadd(parent[3 + row], local[10], value);
+        value   = Lanes::fmadd(parent[6 + row], local[11], value);
+        Lanes::store(soa.world[9 + row] + first, value);
+      }
+    }
+
+    /**
+     * @brief Обновление узлов [begin, end) одного уровня: полные блоки ядром Lanes,
+     * хвост - скалярно. Блоки без изменений пропускаются целиком
+     * @return Количество узлов с изменившейся мировой матрицей
+     */
+    template <typename Lanes>
+    uint32_t updateRange(const TransformSoa& soa, uint32_t begin, uint32_t end)
+    {
+      uint32_t changed = 0;
+      uint32_t i       = begin;
+      for (; i + Lanes::WIDTH <= end; i += Lanes::WIDTH)
+      {
+        uint32_t blockChanged = propagateDirty<Lanes::WIDTH>(soa, i);
+        if (blockChanged > 0)
+        {
+          // Неизменившиеся узлы блока получают то же значение (с точностью до округления)
+          computeBlock<Lanes>(soa, i);
+          changed += blockChanged;
+        }
+      }
+
+      for (; i < end; i++)
+      {
+        if (propagateDirty<1>(soa, i) > 0)
+        {
+          computeBlock<Simd::ScalarLanes>(soa, i);
+          changed++;
+        }
+      }
+      return changed;
+    }
+  }  // namespace
+}  // namespace TransformKernel
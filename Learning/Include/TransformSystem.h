@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "TransformKernel.h"
+
+// Идентификатор узла TransformSystem (не меняется при перестановке узлов)
+using TransformHandle = uint32_t;
+
+const TransformHandle INVALID_TRANSFORM = 0xFFFFFFFFu;
+
+// Статистика последнего обновления
+struct TransformUpdateStats
+{
+  uint32_t nodes     = 0;      // Узлов в иерархии
+  uint32_t changed   = 0;      // Узлов с изменившейся мировой матрицей
+  uint32_t levels    = 0;      // Глубина иерархии
+  bool     reordered = false;  // Узлы переставлялись из-за изменения иерархии
+  double   timeMs    = 0.0;
+};
+
+/**
+ * @brief Иерархия преобразований в раскладке структуры массивов (SoA).
+ * Локальные TRS и мировые матрицы лежат в отдельных массивах по компонентам, а узлы
+ * упорядочены по глубине (обход в ширину): родитель всегда раньше детей, дети одного
+ * родителя - подряд. Уровни обновляются по очереди, внутри уровня - параллельно
+ * блоками по 8 узлов векторным ядром (AVX2, NEON или скалярным, см. Simd.h).
+ *
+ * Изменение локального преобразования помечает узел; мировая матрица пересчитывается
+ * только у помеченных узлов и их потомков, а блоки без изменений пропускаются.
+ * Изменения иерархии (создание, удаление, смена родителя) перестраивают порядок узлов
+ * при следующем update().
+ */
+class TransformSystem
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pool Пул потоков для параллельного обновления уровней (nullptr - однопоточно)
+   */
+  explicit TransformSystem(ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Создание узла с единичным локальным преобразованием
+   * @param parent Родитель (INVALID_TRANSFORM - корень)
+   */
+  TransformHandle create(TransformHandle parent = INVALID_TRANSFORM);
+
+  /**
+   * @brief Удаление узла. Дети переходят к его родителю с прежними локальными TRS
+   */
+  void destroy(TransformHandle handle);
+
+  /**
+   * @brief Смена родителя (INVALID_TRANSFORM - сделать корнем).
+   * Родитель не может быть потомком узла
+   */
+  void setParent(TransformHandle handle, TransformHandle parent);
+
+  // Локальное преобразование (поворот нормируется)
+  void setLocal(TransformHandle handle, const glm::vec3& position, const glm::quat& rotation,
+                const glm::vec3& scale);
+  void setPosition(TransformHandle handle, const glm::vec3& position);
+  void setRotation(TransformHandle handle, const glm::quat& rotation);
+  void setScale(TransformHandle handle, const glm::vec3& scale);
+
+  /**
+   * @brief Пересчёт мировых матриц изменившихся узлов
+   */
+  void update();
+
+  /**
+   * @brief Мировая матрица узла на момент последнего update()
+   */
+  glm::mat4 getWorldMatrix(TransformHandle handle) const;
+
+  /**
+   * @brief Изменилась ли мировая матрица узла в последнем update()
+   */
+  bool isWorldChanged(TransformHandle handle) const;
+
+  /**
+   * @brief Использовать векторное ядро (false - только скалярное, для сравнения)
+   */
+  void setSimdEnabled(bool enabled) { m_simdEnabled = enabled; }
+
+  /**
+   * @brief Название ядра, которым выполняется update()
+   */
+  const char* getKernelName() const;
+
+  const TransformUpdateStats& getStats() const { return m_stats; }
+  uint32_t                    size() const;
+
+private:
+  ThreadPool* m_pool;
+
+  // SoA-массивы по внутреннему индексу; индекс 0 - единичный корень
+  std::array<std::vector<float>, 3>  m_position;
+  std::array<std::vector<float>, 4>  m_rotation;
+  std::array<std::vector<float>, 3>  m_scale;
+  std::array<std::vector<float>, 12> m_world;  // Аффинная 3x4 по столбцам (см. TransformSoa)
+  std::vector<uint32_t>              m_parent;
+  std::vector<uint8_t>               m_localDirty;
+  std::vector<uint8_t>               m_changed;
+
+  // Отображение идентификаторов на внутренние индексы и обратно
+  std::vector<uint32_t> m_handleToIndex;  // INVALID_INDEX - идентификатор свободен
+  std::vector<uint32_t> m_indexToHandle;
+  std::vector<uint32_t> m_freeHandles;
+
+  // Уровни иерархии (начало каждого, последний элемент - конец) и порядок узлов
+  std::vector<uint32_t> m_levelStart;
+  bool                  m_orderDirty = false;  // Иерархия менялась после rebuildOrder()
+
+  std::vector<uint32_t> m_chunkChanged;  // Счётчики изменений по блокам parallelFor
+
+  bool                 m_simdEnabled = true;
+  TransformUpdateStats m_stats;
+
+  static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+  const uint32_t            BLOCK_SIZE    = 8;     // Кратность блоков parallelFor
+  const uint32_t            MIN_CHUNK     = 4096;  // Узлов на блок, меньшие уровни - на месте
+
+  uint32_t getIndex(TransformHandle handle) const;
+  void     rebuildOrder();
+  uint32_t updateRange(const TransformSoa& soa, uint32_t begin, uint32_t end) const;
+};
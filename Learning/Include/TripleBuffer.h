@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Тройной буфер для передачи значений от одного писателя одному читателю.
+ * Писатель и читатель владеют каждый своим слотом, третий слот - общий: публикация и
+ * получение меняют свой слот с общим одной атомарной операцией. Ни одна сторона не
+ * ждёт другую, читатель всегда получает последнее опубликованное значение, а
+ * промежуточные значения, которые он не успел забрать, пропускаются.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+  /**
+   * @brief Слот писателя (принадлежит писателю до publish())
+   */
+  T& getWriteSlot() { return m_slots[m_writeIndex]; }
+
+  /**
+   * @brief Публикация заполненного слота; писатель получает новый слот
+   */
+  void publish()
+  {
+    uint32_t previous = m_shared.exchange(m_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+    m_writeIndex      = previous & INDEX_MASK;
+  }
+
+  /**
+   * @brief Получение последнего опубликованного значения
+   * @return false, если с прошлого вызова ничего не публиковалось (слот читателя не меняется)
+   */
+  bool acquire()
+  {
+    if (!(m_shared.load(std::memory_order_relaxed) & FRESH_BIT))
+    {
+      return false;
+    }
+    uint32_t previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+    m_readIndex       = previous & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * @brief Слот читателя (не меняется до следующего успешного acquire())
+   */
+  const T& getReadSlot() const { return m_slots[m_readIndex]; }
+
+private:
+  static const uint32_t INDEX_MASK = 3;
+  static const uint32_t FRESH_BIT  = 4;  // В общем слоте значение, которое читатель не видел
+
+  std::array<T, 3> m_slots = {};
+
+  // Индексы писателя и читателя на разных кэш-линиях, чтобы потоки не мешали друг другу
+  alignas(64) std::atomic<uint32_t> m_shared{1};
+  alignas(64) uint32_t m_writeIndex = 0;  // Только поток писателя
+  alignas(64) uint32_t m_readIndex  = 2;  // Только поток читателя
+};
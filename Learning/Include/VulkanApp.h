@@ -1,9 +1,13 @@
 #pragma once
 
 #define SDL_MAIN_HANDLED
+#include <atomic>
 #include <memory>
 #include <vulkan/vulkan.hpp>
 
+#include "FrameSnapshot.h"
+#include "ThreadPool.h"
+#include "TripleBuffer.h"
 #include "VulkanCore.h"
 #include "VulkanDevice.h"
 #include "VulkanRenderer.h"
@@ -11,6 +15,10 @@
 
 /**
  * @brief Главный класс приложения, управляющий всеми компонентами Vulkan.
+ * Работает в трёх потоках: главный обрабатывает события SDL, поток симуляции с
+ * фиксированным шагом публикует снимки кадра, поток рендеринга рисует последний
+ * опубликованный снимок. Снимки передаются через тройной буфер без блокировок, поэтому
+ * ожидание GPU не задерживает ни события, ни симуляцию следующих кадров.
  */
 class VulkanApp
 {
@@ -26,14 +34,28 @@ public:
 
 private:
   // Компоненты приложения
+  std::unique_ptr<ThreadPool>      m_threadPool;  // Общий пул рабочих потоков
   std::unique_ptr<VulkanCore>      m_core;       // Базовый компонент Vulkan
   std::unique_ptr<VulkanDevice>    m_device;     // Компонент управления устройством
   std::unique_ptr<VulkanSwapChain> m_swapChain;  // Компонент управления swap chain
   std::unique_ptr<VulkanRenderer>  m_renderer;   // Компонент рендеринга
 
+  // Обмен снимками между потоками симуляции и рендеринга
+  TripleBuffer<FrameSnapshot> m_snapshots;
+  std::atomic<bool>           m_running{false};  // Сброс останавливает все потоки
+
+  // Параметры потоков
+  const double DEFAULT_SIMULATION_HZ = 60.0;  // Частота шага симуляции (VKAPI_SIMULATION_HZ)
+  const int    EVENT_WAIT_MS         = 10;    // Максимальный сон главного потока
+  const int    MAX_FRAMES            = 300;   // Ограничение числа кадров для тестирования
+
   // Основной цикл приложения
   void mainLoop();
 
+  // Циклы потоков симуляции и рендеринга
+  void simulationLoop();
+  void renderLoop();
+
   // Инициализация компонентов
   bool initComponents();
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+
+/**
+ * @brief Вычислительный конвейер.
+ * Объединяет шейдер, layout набора дескрипторов, push-константы и пул дескрипторов,
+ * из которого выделяются наборы для этого конвейера.
+ */
+class VulkanComputePipeline
+{
+public:
+  explicit VulkanComputePipeline(VulkanDevice& device);
+  ~VulkanComputePipeline();
+
+  /**
+   * @brief Создание конвейера
+   * @param shaderPath Путь к SPIR-V вычислительного шейдера
+   * @param bindings Привязки набора дескрипторов (set = 0)
+   * @param pushConstantSize Размер push-констант в байтах (0 - без констант)
+   * @param maxSets Сколько наборов дескрипторов можно выделить
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init(const std::string& shaderPath, const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+           uint32_t pushConstantSize, uint32_t maxSets = 1);
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Выделение набора дескрипторов из пула конвейера
+   */
+  vk::DescriptorSet allocateDescriptorSet();
+
+  /**
+   * @brief Запись storage-буфера в набор дескрипторов
+   */
+  void writeStorageBuffer(vk::DescriptorSet set, uint32_t binding, vk::Buffer buffer,
+                          vk::DeviceSize range = VK_WHOLE_SIZE) const;
+
+  /**
+   * @brief Запись storage-изображения (layout General) в набор дескрипторов
+   */
+  void writeStorageImage(vk::DescriptorSet set, uint32_t binding, vk::ImageView view) const;
+
+  /**
+   * @brief Запись изображения с сэмплером в набор дескрипторов
+   */
+  void writeSampledImage(
+      vk::DescriptorSet set, uint32_t binding, vk::ImageView view, vk::Sampler sampler,
+      vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal) const;
+
+  /**
+   * @brief Привязка конвейера и набора дескрипторов
+   */
+  void bind(vk::CommandBuffer commandBuffer, vk::DescriptorSet set) const;
+
+  /**
+   * @brief Загрузка push-констант (размер должен совпадать с указанным в init)
+   */
+  template <typename T>
+  void pushConstants(vk::CommandBuffer commandBuffer, const T& constants) const
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Push-константы должны быть POD");
+    commandBuffer.pushConstants(*m_vkPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0,
+                                sizeof(T), &constants);
+  }
+
+  /**
+   * @brief Запуск вычислений
+   */
+  void dispatch(vk::CommandBuffer commandBuffer, uint32_t groupsX, uint32_t groupsY = 1,
+                uint32_t groupsZ = 1) const;
+
+  /**
+   * @brief Количество рабочих групп для покрытия count элементов
+   */
+  static uint32_t groupCount(uint32_t count, uint32_t localSize)
+  {
+    return (count + localSize - 1) / localSize;
+  }
+
+  // Геттеры
+  vk::Pipeline            getPipeline() const { return *m_vkPipeline; }
+  vk::PipelineLayout      getPipelineLayout() const { return *m_vkPipelineLayout; }
+  vk::DescriptorSetLayout getDescriptorSetLayout() const { return *m_vkDescriptorSetLayout; }
+
+private:
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  vk::UniqueDescriptorSetLayout m_vkDescriptorSetLayout;  // Layout набора (RAII)
+  vk::UniqueDescriptorPool      m_vkDescriptorPool;       // Пул наборов (RAII)
+  vk::UniquePipelineLayout      m_vkPipelineLayout;       // Layout конвейера (RAII)
+  vk::UniquePipeline            m_vkPipeline;             // Конвейер (RAII)
+};
@@ -35,6 +35,12 @@ public:
    */
   bool processEvents();
 
+  /**
+   * @brief Ожидает события окна не дольше timeoutMs и обрабатывает все накопившиеся
+   * @return true если приложение должно продолжать работу, false - для завершения
+   */
+  bool waitEvents(int timeoutMs);
+
   /**
    * @brief Получить указатель на экземпляр Vulkan
    */
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "VulkanMemoryTracker.h"
+
 // Структура для хранения индексов семейств очередей
 struct QueueFamilyIndices
 {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  std::optional<uint32_t> computeFamily;  // Семейство только для вычислений (async compute)
 
   bool isComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
 };
@@ -40,6 +44,13 @@ public:
    */
   void cleanup();
 
+  /**
+   * @brief Предпочтительное устройство (вызывать до init): подстрока имени без учёта
+   * регистра или UUID. VKAPI_DEVICE имеет приоритет. Неподходящее или не найденное
+   * устройство игнорируется, и выбор идёт по оценке
+   */
+  void setPreferredDevice(const std::string& nameOrUuid) { m_preferredDevice = nameOrUuid; }
+
   // Геттеры
   vk::PhysicalDevice getPhysicalDevice() const { return m_vkPhysicalDevice; }
   vk::Device         getDevice() const { return *m_vkDevice; }
@@ -47,10 +58,57 @@ public:
   vk::Queue          getPresentQueue() const { return m_vkPresentQueue; }
   QueueFamilyIndices getQueueFamilyIndices() const { return m_queueFamilyIndices; }
 
+  // Очередь для асинхронных вычислений (графическая, если отдельной нет)
+  vk::Queue getComputeQueue() const { return m_vkComputeQueue; }
+  uint32_t  getComputeFamily() const
+  {
+    return m_queueFamilyIndices.computeFamily.value_or(m_queueFamilyIndices.graphicsFamily.value());
+  }
+  bool hasAsyncCompute() const { return m_queueFamilyIndices.computeFamily.has_value(); }
+
   // Поддержка устройств
   bool               checkDeviceExtensionSupport(vk::PhysicalDevice device);
   QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice device);
 
+  /**
+   * @brief Поиск типа памяти с нужными свойствами
+   * @param typeFilter Битовая маска допустимых типов (из vk::MemoryRequirements)
+   * @param properties Требуемые свойства памяти
+   * @return Индекс типа памяти
+   */
+  uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+
+  /**
+   * @brief Проверка наличия типа памяти с нужными свойствами (без исключения)
+   */
+  bool hasMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+
+  /**
+   * @brief Выделение памяти устройства с учётом в VulkanMemoryTracker
+   * @param allocInfo Размер и тип памяти
+   * @param category Категория для отчётов и порогов
+   * @return Выделенная память (RAII)
+   */
+  TrackedDeviceMemory allocateMemory(const vk::MemoryAllocateInfo& allocInfo,
+                                     MemoryCategory                category) const;
+
+  /**
+   * @brief Создание буфера и выделение памяти под него
+   * @param size Размер буфера в байтах
+   * @param usage Назначение буфера
+   * @param properties Требуемые свойства памяти
+   * @param buffer Созданный буфер (RAII)
+   * @param memory Выделенная память (RAII)
+   * @param category Категория памяти (staging-буферы учитываются отдельно)
+   */
+  void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage,
+                    vk::MemoryPropertyFlags properties, vk::UniqueBuffer& buffer,
+                    TrackedDeviceMemory& memory,
+                    MemoryCategory       category = MemoryCategory::Buffer) const;
+
+  // Учёт видеопамяти и бюджет (VK_EXT_memory_budget, если поддерживается)
+  VulkanMemoryTracker& getMemoryTracker() const { return *m_memoryTracker; }
+
 private:
   // Экземпляр Vulkan и поверхность (не владеет ими)
   vk::Instance   m_vkInstance;
@@ -66,11 +124,35 @@ private:
   QueueFamilyIndices m_queueFamilyIndices;
   vk::Queue          m_vkGraphicsQueue;
   vk::Queue          m_vkPresentQueue;
+  vk::Queue          m_vkComputeQueue;
+
+  // Свойства памяти физического устройства (кэшируются при выборе устройства)
+  vk::PhysicalDeviceMemoryProperties m_vkMemoryProperties;
+
+  // Учёт выделений по кучам и категориям (создаётся вместе с логическим устройством)
+  std::unique_ptr<VulkanMemoryTracker> m_memoryTracker;
+
+  // Оценка физического устройства при выборе
+  struct DeviceCandidate
+  {
+    vk::PhysicalDevice       device;
+    std::string              name;
+    std::string              uuid;
+    bool                     suitable = false;
+    int64_t                  score    = 0;
+    std::vector<std::string> reasons;  // Слагаемые оценки или причина непригодности
+  };
+
+  std::string m_preferredDevice;  // Подстрока имени или UUID (пустая - по оценке)
 
   // Вспомогательные методы
-  void pickPhysicalDevice();                         // Выбор физического устройства
-  void createLogicalDevice();                        // Создание логического устройства
-  bool isDeviceSuitable(vk::PhysicalDevice device);  // Проверка пригодности устройства
+  void pickPhysicalDevice();   // Выбор физического устройства
+  void createLogicalDevice();  // Создание логического устройства
+  bool isDeviceSuitable(vk::PhysicalDevice device,
+                        std::string&       reason);  // Проверка пригодности устройства
+  DeviceCandidate evaluateDevice(vk::PhysicalDevice device);  // Оценка производительности
+  static bool     matchesPreference(const DeviceCandidate& candidate,
+                                    const std::string&     preference);
 
   // Константы
   const std::vector<const char*> m_deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+
+// Формат файлов захвата
+enum class CaptureFormat
+{
+  Raw,  // Пиксели RGBA8 без заголовка
+  Ppm,  // Binary PPM (P6), RGB
+  Png   // PNG без сжатия (stored-блоки deflate), RGB
+};
+
+/**
+ * @brief Захват кадров на диск без остановки рендеринга.
+ * Кадр копируется в один из буферов кольца в памяти хоста той же отправкой, что и
+ * сам кадр. Готовность проверяется опросом timeline-семафора без ожидания, затем
+ * пиксели прямо из отображённой памяти забирает фоновый поток кодирования.
+ * Если свободного буфера нет, кадр пропускается: рендеринг никогда не ждёт диск.
+ */
+class VulkanFrameCapture
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param extent Размер захватываемого изображения
+   * @param directory Каталог для файлов (создаётся при необходимости)
+   * @param format Формат файлов
+   * @param ringSize Количество буферов в кольце
+   */
+  VulkanFrameCapture(VulkanDevice& device, vk::Extent2D extent, const std::string& directory,
+                     CaptureFormat format, uint32_t ringSize = 4);
+  ~VulkanFrameCapture();
+
+  VulkanFrameCapture(const VulkanFrameCapture&)            = delete;
+  VulkanFrameCapture& operator=(const VulkanFrameCapture&) = delete;
+
+  /**
+   * @brief Создание буферов кольца и запуск потока кодирования
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init();
+
+  /**
+   * @brief Дозапись готовых кадров и остановка потока (GPU должен быть свободен)
+   */
+  void cleanup();
+
+  /**
+   * @brief Запись копирования изображения RGBA8 в свободный буфер кольца
+   * @param commandBuffer Командный буфер кадра
+   * @param image Изображение в layout eTransferSrcOptimal
+   * @param frameIndex Номер кадра для имени файла
+   * @param timelineValue Значение timeline, после которого копия готова
+   * @return false, если свободного буфера нет и кадр пропущен
+   */
+  bool record(vk::CommandBuffer commandBuffer, vk::Image image, uint64_t frameIndex,
+              uint64_t timelineValue);
+
+  /**
+   * @brief Передача завершённых копий потоку кодирования (без ожидания)
+   * @param completedValue Текущее значение timeline
+   */
+  void poll(uint64_t completedValue);
+
+  /**
+   * @brief Разбор VKAPI_CAPTURE_FORMAT (raw, ppm, png; по умолчанию ppm)
+   */
+  static CaptureFormat parseFormat(const char* name);
+
+  // Статистика
+  uint64_t getCapturedCount() const { return m_capturedCount; }
+  uint64_t getDroppedCount() const { return m_droppedCount; }
+
+private:
+  // Состояние буфера кольца (меняется только основным потоком)
+  enum class SlotState
+  {
+    Free,     // Можно записывать копию
+    Pending,  // Копия записана, GPU ещё не закончил
+    Encoding  // Пиксели у потока кодирования
+  };
+
+  struct ReadbackSlot
+  {
+    vk::UniqueBuffer    buffer;                   // Буфер в памяти хоста (RAII)
+    TrackedDeviceMemory memory;                   // Память буфера (RAII)
+    const uint8_t*      pixels        = nullptr;  // Постоянно отображённая память
+    SlotState           state         = SlotState::Free;
+    uint64_t            frameIndex    = 0;
+    uint64_t            timelineValue = 0;
+  };
+
+  // Задание потоку кодирования
+  struct EncodeJob
+  {
+    uint32_t slot;
+    uint64_t frameIndex;
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  vk::Extent2D   m_extent;
+  std::string    m_directory;
+  CaptureFormat  m_format;
+  uint32_t       m_ringSize;
+  vk::DeviceSize m_frameSize = 0;  // Байт в одном кадре RGBA8
+
+  std::vector<ReadbackSlot> m_slots;
+  uint32_t                  m_nextSlot = 0;  // Следующий проверяемый слот (по кругу)
+
+  // Поток кодирования и общая с ним очередь
+  std::thread             m_encoderThread;
+  std::mutex              m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::deque<EncodeJob>   m_jobs;      // Под m_mutex
+  std::vector<uint32_t>   m_finished;  // Закодированные слоты, под m_mutex
+  bool                    m_stopping = false;
+
+  uint64_t m_capturedCount = 0;
+  uint64_t m_droppedCount  = 0;
+
+  void encoderLoop();
+  void encode(const EncodeJob& job, std::vector<uint8_t>& scratch) const;
+  std::string makeFileName(uint64_t frameIndex) const;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vulkan/vulkan.hpp>
+
+#include "LinearArena.h"
+#include "VulkanDevice.h"
+
+/**
+ * @brief Состояние одного кадра в обработке.
+ * Собирает в одном месте всё, что раньше хранилось параллельными векторами по слоту
+ * кадра: пул команд графической очереди с буферами кадра, семафор получения
+ * изображения, линейную арену для временных данных CPU и список отложенной работы.
+ *
+ * begin() вызывается, когда GPU завершил предыдущий кадр этого слота: отложенная
+ * работа выполняется, пул команд сбрасывается одним vkResetCommandPool (без
+ * VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT и сброса буферов по одному),
+ * арена освобождается. Ни один из шагов не обращается к куче.
+ */
+class VulkanFrameContext
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param arenaBytes Начальный размер арены в байтах
+   */
+  VulkanFrameContext(VulkanDevice& device, size_t arenaBytes);
+  ~VulkanFrameContext();
+
+  VulkanFrameContext(const VulkanFrameContext&)            = delete;
+  VulkanFrameContext& operator=(const VulkanFrameContext&) = delete;
+
+  /**
+   * @brief Создание пула команд, командных буферов и семафора
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init();
+
+  /**
+   * @brief Выполнение отложенной работы и очистка ресурсов (GPU должен простаивать)
+   */
+  void cleanup();
+
+  /**
+   * @brief Начало кадра в слоте: отложенная работа, сброс пула команд и арены
+   */
+  void begin();
+
+  /**
+   * @brief Отложенная работа до завершения кадра на GPU (до следующего begin()).
+   * Функтор хранится в арене кадра, поэтому может захватывать move-only объекты
+   * и не требует выделения памяти. Выполняется в порядке добавления
+   */
+  template <typename F>
+  void defer(F&& fn)
+  {
+    using Fn = std::decay_t<F>;
+
+    DeferredWork* work = m_arena.create<DeferredFn<Fn>>(std::forward<F>(fn));
+    if (m_pDeferredTail)
+    {
+      m_pDeferredTail->pNext = work;
+    }
+    else
+    {
+      m_pDeferredHead = work;
+    }
+    m_pDeferredTail = work;
+    m_deferredCount++;
+  }
+
+  /**
+   * @brief Удержание ресурса (например, vk::Unique*), пока GPU может его читать
+   */
+  template <typename T>
+  void retire(T&& resource)
+  {
+    defer(Holder<std::decay_t<T>>{std::forward<T>(resource)});
+  }
+
+  // Геттеры
+  vk::CommandBuffer getCommandBuffer() const { return m_vkCommandBuffer; }
+  vk::CommandBuffer getUploadCommandBuffer() const { return m_vkUploadCommandBuffer; }
+  vk::Semaphore     getImageAvailableSemaphore() const { return *m_vkImageAvailableSemaphore; }
+  LinearArena&      getArena() { return m_arena; }
+  uint32_t          getDeferredCount() const { return m_deferredCount; }
+
+private:
+  // Узел списка отложенной работы (живёт в арене)
+  struct DeferredWork
+  {
+    using RunFn = void (*)(DeferredWork* work);
+
+    DeferredWork* pNext = nullptr;
+    RunFn         run   = nullptr;  // Выполнение и уничтожение узла
+  };
+
+  template <typename F>
+  struct DeferredFn : DeferredWork
+  {
+    F fn;
+
+    explicit DeferredFn(F&& function) : fn(std::move(function)) { run = &invoke; }
+    explicit DeferredFn(const F& function) : fn(function) { run = &invoke; }
+
+    static void invoke(DeferredWork* work)
+    {
+      DeferredFn* self = static_cast<DeferredFn*>(work);
+      self->fn();
+      self->~DeferredFn();
+    }
+  };
+
+  // Функтор, который только владеет ресурсом: освобождение - в деструкторе
+  template <typename T>
+  struct Holder
+  {
+    T    resource;
+    void operator()() {}
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  // Команды кадра: буферы освобождаются вместе с пулом
+  vk::UniqueCommandPool m_vkCommandPool;          // Пул команд слота (RAII)
+  vk::CommandBuffer     m_vkCommandBuffer;        // Основной буфер кадра
+  vk::CommandBuffer     m_vkUploadCommandBuffer;  // Загрузки, отправляемые перед кадром
+
+  vk::UniqueSemaphore m_vkImageAvailableSemaphore;  // Получение изображения swap chain
+
+  // Временная память CPU и отложенная работа
+  LinearArena   m_arena;
+  DeferredWork* m_pDeferredHead = nullptr;
+  DeferredWork* m_pDeferredTail = nullptr;
+  uint32_t      m_deferredCount = 0;
+
+  void runDeferred();
+};
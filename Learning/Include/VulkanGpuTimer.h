@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+
+/**
+ * @brief Замер времени на GPU парой timestamp на каждый кадр в обработке.
+ * Запросы слота frameSlot занимают индексы 2 * frameSlot и 2 * frameSlot + 1.
+ * Результат читается, когда кадр слота уже завершён (после ожидания слота).
+ */
+class VulkanGpuTimer
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param framesInFlight Количество кадров в обработке (пар timestamp)
+   */
+  VulkanGpuTimer(VulkanDevice& device, uint32_t framesInFlight);
+
+  /**
+   * @brief Создание пула запросов
+   * @return Статус (0 - успешно, -1 - графическая очередь не поддерживает timestamp)
+   */
+  int init();
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Сброс пары запросов слота и timestamp начала
+   * @param stage Стадия, после которой пишется timestamp
+   */
+  void begin(vk::CommandBuffer commandBuffer, uint32_t frameSlot, vk::PipelineStageFlags2 stage);
+
+  /**
+   * @brief Timestamp конца
+   * @param stage Стадия, после которой пишется timestamp
+   */
+  void end(vk::CommandBuffer commandBuffer, uint32_t frameSlot, vk::PipelineStageFlags2 stage);
+
+  /**
+   * @brief Время между begin и end кадра, завершённого в слоте frameSlot
+   * @return Миллисекунды или nullopt, если замера в слоте ещё не было
+   */
+  std::optional<double> read(uint32_t frameSlot) const;
+
+  bool isAvailable() const { return static_cast<bool>(m_vkQueryPool); }
+
+private:
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  uint32_t m_framesInFlight;
+
+  vk::UniqueQueryPool m_vkQueryPool;  // Пул timestamp-запросов (RAII)
+  std::vector<bool>   m_slotRecorded;
+  float               m_timestampPeriod = 0.0f;  // Наносекунд на тик
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "PerformanceHud.h"
+#include "VulkanDevice.h"
+#include "VulkanGpuTimer.h"
+
+/**
+ * @brief Оверлей производительности поверх готового кадра.
+ * Атлас шрифта загружается один раз, вершины кадра PerformanceHud пишет прямо в
+ * постоянно отображённую область слота кадра, и весь оверлей рисуется одним
+ * вызовом draw в отдельном проходе по изображению swap chain: dynamic rendering или
+ * собственный render pass с загрузкой содержимого, если рендерер работает без dynamic rendering.
+ * Здесь же измеряется время кадра на GPU: timestamp в начале и в конце команд кадра.
+ */
+class VulkanHud
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param framesInFlight Количество кадров в обработке (областей вершин и пар timestamp)
+   */
+  VulkanHud(VulkanDevice& device, uint32_t framesInFlight);
+  ~VulkanHud();
+
+  /**
+   * @brief Создание атласа, буфера вершин, конвейера и пула запросов
+   * @param colorFormat Формат изображения, поверх которого рисуется оверлей
+   * @param commandPool Пул для однократной загрузки атласа (графическая очередь)
+   * @param dynamicRendering false - конвейер под собственный render pass оверлея
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init(vk::Format colorFormat, vk::CommandPool commandPool, bool dynamicRendering);
+
+  /**
+   * @brief Framebuffers render pass оверлея, по одному на изображение цели
+   * (только без dynamic rendering, пересоздаются вместе с swap chain)
+   * @param targets Изображения, поверх которых рисуется оверлей
+   * @param extent Размер изображений
+   */
+  void createFramebuffers(const std::vector<vk::ImageView>& targets, vk::Extent2D extent);
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Timestamp начала команд кадра (первая команда буфера кадра)
+   */
+  void beginFrame(vk::CommandBuffer commandBuffer, uint32_t frameSlot);
+
+  /**
+   * @brief Timestamp конца команд кадра (последняя команда буфера кадра)
+   */
+  void endFrame(vk::CommandBuffer commandBuffer, uint32_t frameSlot);
+
+  /**
+   * @brief Чтение времени GPU кадра, завершённого в слоте frameSlot
+   */
+  void collectTimings(uint32_t frameSlot);
+
+  /**
+   * @brief Добавление показателей кадра и построение вершин в области слота
+   */
+  void update(uint32_t frameSlot, const HudFrameStats& stats);
+
+  /**
+   * @brief Запись прохода оверлея: содержимое цели сохраняется, оверлей смешивается поверх.
+   * Переход цели в layout цветового вложения обеспечивает граф кадра.
+   * @param commandBuffer Командный буфер кадра
+   * @param frameSlot Индекс кадра в обработке
+   * @param target Изображение, поверх которого рисуется оверлей
+   * @param extent Размер изображения
+   */
+  void record(vk::CommandBuffer commandBuffer, uint32_t frameSlot, vk::ImageView target,
+              vk::Extent2D extent);
+
+  /**
+   * @brief Целочисленный масштаб шрифта и графика
+   */
+  void setScale(uint32_t scale) { m_hud.setScale(scale); }
+
+  double getGpuFrameMs() const { return m_gpuFrameMs; }
+
+private:
+  // Push-константы вершинного шейдера
+  struct HudParams
+  {
+    float scale[2];  // 2 / размер цели: перевод пикселей в NDC
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  uint32_t       m_framesInFlight;
+  PerformanceHud m_hud;
+
+  // Атлас шрифта
+  vk::UniqueImage     m_vkAtlasImage;   // Изображение атласа (RAII)
+  TrackedDeviceMemory m_vkAtlasMemory;  // Память атласа (RAII)
+  vk::UniqueImageView m_vkAtlasView;    // Image view атласа (RAII)
+  vk::UniqueSampler   m_vkSampler;      // Сэмплер без фильтрации (RAII)
+
+  // Набор дескрипторов с атласом
+  vk::UniqueDescriptorSetLayout m_vkDescriptorSetLayout;  // Layout набора (RAII)
+  vk::UniqueDescriptorPool      m_vkDescriptorPool;       // Пул дескрипторов (RAII)
+  vk::DescriptorSet             m_vkDescriptorSet;        // Набор (освобождается с пулом)
+
+  // Вершины: по MAX_VERTICES на слот кадра, память отображена постоянно
+  vk::UniqueBuffer      m_vkVertexBuffer;  // Буфер вершин (RAII)
+  TrackedDeviceMemory   m_vkVertexMemory;  // Память буфера вершин (RAII)
+  HudVertex*            m_pVertices = nullptr;
+  std::vector<uint32_t> m_vertexCounts;  // Вершин в области каждого слота
+
+  // Конвейер оверлея
+  vk::UniquePipelineLayout m_vkPipelineLayout;  // Layout конвейера (RAII)
+  vk::UniquePipeline       m_vkPipeline;        // Графический конвейер (RAII)
+
+  // Путь без dynamic rendering: render pass и framebuffer на каждое изображение цели
+  vk::UniqueRenderPass               m_vkRenderPass;      // Render pass оверлея (RAII)
+  std::vector<vk::UniqueFramebuffer> m_vkFramebuffers;    // Framebuffers (RAII)
+  std::vector<vk::ImageView>         m_framebufferViews;  // Изображение каждого framebuffer
+
+  // Время кадра на GPU: от первой до последней команды буфера кадра
+  VulkanGpuTimer m_gpuTimer;
+  double         m_gpuFrameMs    = 0.0;  // Сглаженное время кадра на GPU
+  uint64_t       m_timingSamples = 0;
+
+  const uint32_t   MAX_VERTICES = PerformanceHud::MAX_VERTICES;
+  const vk::Format ATLAS_FORMAT = vk::Format::eR8Unorm;
+
+  void createAtlas(vk::CommandPool commandPool);
+  void createDescriptorSet();
+  void createVertexBuffer();
+  void createRenderPass(vk::Format colorFormat);
+  void createPipeline(vk::Format colorFormat);
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Категория выделения видеопамяти
+enum class MemoryCategory : uint32_t
+{
+  Buffer,  // Буферы (вершины, uniform, storage)
+  Image,   // Изображения (текстуры, цели рендеринга)
+  Staging  // Буферы копирования между CPU и GPU
+};
+
+const uint32_t MEMORY_CATEGORY_COUNT = 3;
+
+// Байты по категориям (индекс - MemoryCategory)
+using MemoryCategoryBytes = std::array<vk::DeviceSize, MEMORY_CATEGORY_COUNT>;
+
+// Идентификатор обработчика порога для снятия регистрации
+using MemoryThresholdHandle = uint32_t;
+
+const MemoryThresholdHandle INVALID_MEMORY_THRESHOLD = 0;
+
+// Снимок использования одной кучи
+struct MemoryHeapReport
+{
+  uint32_t            heapIndex        = 0;
+  bool                deviceLocal      = false;
+  vk::DeviceSize      size             = 0;  // Размер кучи
+  vk::DeviceSize      budget           = 0;  // Сколько процесс может занять без вытеснения
+  vk::DeviceSize      usage            = 0;  // Занято процессом (по драйверу, иначе - по учёту)
+  vk::DeviceSize      tracked          = 0;  // Выделено через VulkanDevice
+  MemoryCategoryBytes byCategory       = {};
+  uint32_t            allocationCount  = 0;
+  bool                budgetFromDriver = false;  // Бюджет из VK_EXT_memory_budget, а не оценка
+
+  float getUsageFraction() const
+  {
+    return budget > 0 ? static_cast<float>(usage) / static_cast<float>(budget) : 0.0f;
+  }
+};
+
+/**
+ * @brief Учёт видеопамяти по кучам и категориям.
+ * Выделения через VulkanDevice учитываются атомарно из любого потока. Раз в кадр
+ * update() запрашивает бюджет у драйвера (VK_EXT_memory_budget; без расширения
+ * бюджетом считается 80% кучи), вызывает обработчики порогов и печатает отчёт.
+ * Обработчик порога срабатывает один раз при пересечении вверх и снова становится
+ * активным, когда заполнение опустится ниже порога на HYSTERESIS.
+ */
+class VulkanMemoryTracker
+{
+public:
+  // Обработчик порога: куча, заполнение которой пересекло threshold
+  using ThresholdCallback = std::function<void(const MemoryHeapReport& heap, float threshold)>;
+
+  /**
+   * @brief Конструктор
+   * @param physicalDevice Физическое устройство
+   * @param budgetSupported Включено ли VK_EXT_memory_budget
+   */
+  VulkanMemoryTracker(vk::PhysicalDevice physicalDevice, bool budgetSupported);
+
+  VulkanMemoryTracker(const VulkanMemoryTracker&)            = delete;
+  VulkanMemoryTracker& operator=(const VulkanMemoryTracker&) = delete;
+
+  // Учёт выделения и освобождения (потокобезопасно)
+  void onAllocate(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size);
+  void onFree(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size);
+
+  /**
+   * @brief Текущее использование всех куч против бюджета
+   */
+  std::vector<MemoryHeapReport> query() const;
+
+  /**
+   * @brief Регистрация обработчика порога для локальных куч устройства
+   * @param threshold Доля бюджета (например, 0.9)
+   * @param callback Обработчик (вызывается из update() в потоке рендеринга без блокировки,
+   * поэтому может сам регистрировать и снимать обработчики)
+   * @return Идентификатор для removeThresholdCallback
+   */
+  MemoryThresholdHandle addThresholdCallback(float threshold, ThresholdCallback callback);
+
+  /**
+   * @brief Снятие обработчика порога (неизвестный идентификатор игнорируется)
+   * @param handle Идентификатор из addThresholdCallback
+   */
+  void removeThresholdCallback(MemoryThresholdHandle handle);
+
+  /**
+   * @brief Период отчёта в update() (0 - без отчётов)
+   */
+  void setReportInterval(double seconds) { m_reportIntervalSec = seconds; }
+
+  /**
+   * @brief Проверка порогов и периодический отчёт (раз в кадр)
+   */
+  void update();
+
+  /**
+   * @brief Вывод отчёта по всем кучам
+   */
+  void printReport(std::ostream& out) const;
+
+  bool isBudgetSupported() const { return m_budgetSupported; }
+
+private:
+  struct Threshold
+  {
+    MemoryThresholdHandle                 handle;
+    float                                 threshold;
+    ThresholdCallback                     callback;
+    std::array<bool, VK_MAX_MEMORY_HEAPS> triggered = {};  // Сработал и ждёт спада
+  };
+
+  // Счётчики кучи (меняются из любого потока)
+  struct HeapCounters
+  {
+    std::array<std::atomic<uint64_t>, MEMORY_CATEGORY_COUNT> bytes = {};
+    std::atomic<uint32_t>                                    count{0};
+  };
+
+  vk::PhysicalDevice                            m_vkPhysicalDevice;
+  vk::PhysicalDeviceMemoryProperties            m_vkMemoryProperties;
+  bool                                          m_budgetSupported;
+  std::array<HeapCounters, VK_MAX_MEMORY_HEAPS> m_heaps;
+
+  std::mutex             m_thresholdMutex;  // Защищает m_thresholds и m_nextThresholdHandle
+  std::vector<Threshold> m_thresholds;
+  MemoryThresholdHandle  m_nextThresholdHandle = INVALID_MEMORY_THRESHOLD + 1;
+
+  double                                m_reportIntervalSec = 0.0;
+  std::chrono::steady_clock::time_point m_lastReport;
+
+  const float HYSTERESIS             = 0.05f;  // Повторное срабатывание после спада на 5%
+  const float ESTIMATED_BUDGET_SHARE = 0.8f;   // Оценка бюджета без расширения
+};
+
+/**
+ * @brief Память устройства с учётом в VulkanMemoryTracker.
+ * Владеет vk::DeviceMemory как vk::UniqueDeviceMemory и при освобождении
+ * вычитает свой размер из счётчиков кучи и категории.
+ */
+class TrackedDeviceMemory
+{
+public:
+  TrackedDeviceMemory() = default;
+  TrackedDeviceMemory(vk::UniqueDeviceMemory memory, VulkanMemoryTracker* tracker,
+                      uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size);
+  ~TrackedDeviceMemory();
+
+  TrackedDeviceMemory(TrackedDeviceMemory&& other) noexcept;
+  TrackedDeviceMemory& operator=(TrackedDeviceMemory&& other) noexcept;
+
+  TrackedDeviceMemory(const TrackedDeviceMemory&)            = delete;
+  TrackedDeviceMemory& operator=(const TrackedDeviceMemory&) = delete;
+
+  // Освобождение памяти (повторный вызов безопасен)
+  void reset();
+
+  vk::DeviceMemory get() const { return *m_memory; }
+  vk::DeviceMemory operator*() const { return *m_memory; }
+  explicit         operator bool() const { return static_cast<bool>(m_memory); }
+  vk::DeviceSize   getSize() const { return m_size; }
+
+private:
+  vk::UniqueDeviceMemory m_memory;
+  VulkanMemoryTracker*   m_tracker   = nullptr;
+  uint32_t               m_heapIndex = 0;
+  MemoryCategory         m_category  = MemoryCategory::Buffer;
+  vk::DeviceSize         m_size      = 0;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanComputePipeline.h"
+#include "VulkanDevice.h"
+#include "VulkanGpuTimer.h"
+#include "VulkanRenderQueue.h"
+
+// Частица в storage-буфере (раскладка std430, 32 байта); тот же буфер - буфер вершин
+struct Particle
+{
+  glm::vec2 position;
+  glm::vec2 velocity;
+  glm::vec4 color;
+};
+
+// Параметры цели рендеринга, с которой должен быть совместим конвейер частиц
+struct ParticleRenderTarget
+{
+  vk::RenderPass          renderPass;      // Пустой - dynamic rendering
+  vk::Format              colorFormat = vk::Format::eUndefined;
+  vk::Format              depthFormat = vk::Format::eUndefined;
+  vk::SampleCountFlagBits samples     = vk::SampleCountFlagBits::e1;
+  vk::DescriptorSetLayout frameSetLayout;  // Layout набора с константами кадра (set = 0)
+};
+
+/**
+ * @brief Система частиц, полностью живущая на GPU.
+ * Частицы создаются и обновляются вычислительным шейдером в одном storage-буфере,
+ * который затем читается как буфер вершин и рисуется точками. CPU не обращается
+ * к отдельным частицам. Время симуляции измеряется timestamp-запросами.
+ */
+class VulkanParticleSystem
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param particleCount Количество частиц
+   * @param framesInFlight Количество кадров в обработке (для timestamp-запросов)
+   */
+  VulkanParticleSystem(VulkanDevice& device, uint32_t particleCount, uint32_t framesInFlight);
+  ~VulkanParticleSystem();
+
+  /**
+   * @brief Создание буфера частиц, вычислительного и графического конвейеров
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init(const ParticleRenderTarget& target);
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Запись шага симуляции (в первый раз - начальное заполнение буфера).
+   * Барьеры до и после обеспечивает граф кадра.
+   * @param commandBuffer Командный буфер кадра
+   * @param frameSlot Индекс кадра в обработке
+   * @param deltaTime Шаг симуляции в секундах
+   */
+  void simulate(vk::CommandBuffer commandBuffer, uint32_t frameSlot, float deltaTime);
+
+  /**
+   * @brief Чтение времени симуляции кадра, завершённого в слоте frameSlot
+   */
+  void collectTimings(uint32_t frameSlot);
+
+  /**
+   * @brief Заполнение конвейера, буфера вершин и количества точек пакета отрисовки
+   */
+  void fillDrawPacket(DrawPacket& packet) const;
+
+  // Геттеры
+  vk::Buffer getBuffer() const { return *m_vkParticleBuffer; }
+  uint32_t   getParticleCount() const { return m_particleCount; }
+  double     getSimulationMs() const { return m_simulationMs; }
+  double     getParticlesPerMs() const
+  {
+    return m_simulationMs > 0.0 ? m_particleCount / m_simulationMs : 0.0;
+  }
+
+private:
+  // Push-константы вычислительного шейдера
+  struct SimulationParams
+  {
+    float    deltaTime;
+    float    time;
+    uint32_t count;
+    uint32_t seed;  // Не ноль - начальное заполнение
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  uint32_t m_particleCount;
+  uint32_t m_framesInFlight;
+
+  // Буфер частиц (storage + vertex)
+  TrackedDeviceMemory m_vkParticleMemory;  // Память буфера частиц (RAII)
+  vk::UniqueBuffer    m_vkParticleBuffer;  // Буфер частиц (RAII)
+
+  // Симуляция
+  std::unique_ptr<VulkanComputePipeline> m_computePipeline;
+  vk::DescriptorSet                      m_vkComputeSet;
+
+  // Отрисовка точками
+  vk::UniquePipelineLayout m_vkGraphicsLayout;    // Layout графического конвейера (RAII)
+  vk::UniquePipeline       m_vkGraphicsPipeline;  // Графический конвейер (RAII)
+
+  // Замер времени симуляции
+  VulkanGpuTimer m_gpuTimer;
+  double         m_simulationMs  = 0.0;  // Сглаженное время симуляции
+  uint64_t       m_timingSamples = 0;
+
+  bool  m_seeded = false;
+  float m_time   = 0.0f;
+
+  const uint32_t LOCAL_SIZE      = 256;  // Размер рабочей группы в particles.comp
+  const uint64_t REPORT_INTERVAL = 300;  // Кадров между отчётами в лог
+
+  void createParticleBuffer();
+  void createComputePipeline();
+  void createGraphicsPipeline(const ParticleRenderTarget& target);
+};
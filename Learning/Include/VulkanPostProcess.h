@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanComputePipeline.h"
+#include "VulkanDevice.h"
+#include "VulkanRenderGraph.h"
+
+// Push-константы всех шейдеров постобработки (32 байта)
+struct PostProcessParams
+{
+  uint32_t width;
+  uint32_t height;
+  float    exposure;
+  float    bloomThreshold;
+  float    bloomIntensity;
+  float    sharpness;
+  int32_t  directionX;  // Направление размытия (только blur.comp)
+  int32_t  directionY;
+};
+
+/**
+ * @brief Постобработка на асинхронной вычислительной очереди.
+ * Сцена рисуется в HDR-изображение слота кадра; цепочка bloom (выделение ярких областей,
+ * раздельное размытие), тональная компрессия и повышение резкости выполняется отдельной
+ * отправкой в вычислительную очередь и пишет LDR-изображение слота. Графика следующего
+ * кадра выполняется параллельно с ней и копирует готовый результат в swap chain, поэтому
+ * на экран попадает кадр с задержкой в один кадр.
+ * Синхронизация между очередями - только timeline-семафоры: вычисления кадра N ждут
+ * графику кадра N, копирование результата в кадре N+1 ждёт вычислений кадра N.
+ */
+class VulkanPostProcess
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param framesInFlight Количество кадров в обработке (изображений сцены и результата)
+   * @param extent Размер кадра
+   */
+  VulkanPostProcess(VulkanDevice& device, uint32_t framesInFlight, vk::Extent2D extent);
+  ~VulkanPostProcess();
+
+  /**
+   * @brief Создание изображений, конвейеров, графа и объектов синхронизации
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init();
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Запись и отправка постобработки кадра в вычислительную очередь
+   * @param frameSlot Индекс кадра в обработке
+   * @param frameNumber Номер кадра: ожидается graphicsTimeline >= frameNumber,
+   *                    по завершении timeline постобработки получает то же значение
+   * @param graphicsTimeline Timeline-семафор графической очереди
+   */
+  void submit(uint32_t frameSlot, uint64_t frameNumber, vk::Semaphore graphicsTimeline);
+
+  // Формат HDR-сцены известен до создания изображений (нужен конвейерам сцены)
+  static vk::Format getSceneFormat() { return vk::Format::eR16G16B16A16Sfloat; }
+
+  // Геттеры
+  vk::Image     getSceneImage(uint32_t slot) const { return *m_slots[slot].sceneImage; }
+  vk::ImageView getSceneView(uint32_t slot) const { return *m_slots[slot].sceneView; }
+  vk::Image     getOutputImage(uint32_t slot) const { return *m_slots[slot].outputImage; }
+  vk::ImageView getOutputView(uint32_t slot) const { return *m_slots[slot].outputView; }
+  vk::Extent2D  getExtent() const { return m_extent; }
+  vk::Semaphore getTimeline() const { return *m_vkTimeline; }
+
+private:
+  // Изображения и наборы дескрипторов одного слота кадра
+  struct FrameSlot
+  {
+    vk::UniqueImage     sceneImage;  // HDR-сцена (цветовое вложение, затем сэмплер)
+    TrackedDeviceMemory sceneMemory;
+    vk::UniqueImageView sceneView;
+
+    vk::UniqueImage     outputImage;  // Итоговое LDR-изображение (storage, источник blit)
+    TrackedDeviceMemory outputMemory;
+    vk::UniqueImageView outputView;
+
+    vk::DescriptorSet extractSet;
+    vk::DescriptorSet tonemapSet;
+    vk::DescriptorSet sharpenSet;
+
+    vk::UniqueCommandBuffer commandBuffer;
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  uint32_t     m_framesInFlight;
+  vk::Extent2D m_extent;
+  vk::Extent2D m_bloomExtent;  // Половинное разрешение
+
+  std::vector<FrameSlot> m_slots;
+  uint32_t               m_currentSlot = 0;  // Слот, записываемый графом
+
+  // Конвейеры цепочки и общий сэмплер
+  std::unique_ptr<VulkanComputePipeline> m_extractPipeline;
+  std::unique_ptr<VulkanComputePipeline> m_blurPipeline;
+  std::unique_ptr<VulkanComputePipeline> m_tonemapPipeline;
+  std::unique_ptr<VulkanComputePipeline> m_sharpenPipeline;
+  vk::UniqueSampler                      m_vkSampler;  // Линейный, clamp to edge (RAII)
+  vk::DescriptorSet                      m_blurHorizontalSet;
+  vk::DescriptorSet                      m_blurVerticalSet;
+
+  // Граф вычислительной очереди
+  std::unique_ptr<VulkanRenderGraph> m_graph;
+  RenderGraphResource                m_sceneResource  = 0;
+  RenderGraphResource                m_outputResource = 0;
+  RenderGraphResource                m_bloomA         = 0;
+  RenderGraphResource                m_bloomB         = 0;
+  RenderGraphResource                m_toneResource   = 0;
+
+  // Отправка: собственный пул команд и timeline (значение - номер кадра)
+  vk::UniqueCommandPool m_vkCommandPool;  // Пул семейства вычислительной очереди (RAII)
+  vk::UniqueSemaphore   m_vkTimeline;     // Timeline постобработки (RAII)
+
+  PostProcessParams m_params = {};
+
+  const vk::Format BLOOM_FORMAT  = vk::Format::eR16G16B16A16Sfloat;
+  const vk::Format OUTPUT_FORMAT = vk::Format::eR8G8B8A8Unorm;
+  const uint32_t   LOCAL_SIZE    = 8;  // Размер рабочей группы шейдеров (8x8)
+
+  void createImages();
+  void createPipelines();
+  void createGraph();
+  void createDescriptorSets();
+  void createCommandObjects();
+  void transitionOutputs();  // Перевод результатов в General до первого кадра
+
+  // Создание изображения в памяти устройства, общего для графической и вычислительной очереди
+  void createSharedImage(vk::Format format, vk::ImageUsageFlags usage, vk::UniqueImage& image,
+                         TrackedDeviceMemory& memory, vk::UniqueImageView& view);
+
+  void dispatchPass(vk::CommandBuffer commandBuffer, const VulkanComputePipeline& pipeline,
+                    vk::DescriptorSet set, vk::Extent2D extent, int32_t directionX = 0,
+                    int32_t directionY = 0);
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+
+// Идентификатор ресурса графа
+using RenderGraphResource = uint32_t;
+
+/**
+ * @brief Способ использования ресурса проходом.
+ * Определяет стадию, доступ и layout, из которых граф строит барьеры.
+ */
+enum class RenderGraphAccess
+{
+  ColorAttachmentWrite,  // Цветовое вложение (в том числе resolve)
+  DepthAttachmentWrite,  // Вложение глубины
+  SampledRead,           // Чтение через сэмплер во фрагментном или вычислительном шейдере
+  StorageRead,           // Чтение storage-ресурса в вычислительном шейдере
+  StorageWrite,          // Запись storage-ресурса в вычислительном шейдере
+  TransferRead,          // Источник копирования или blit
+  TransferWrite,         // Приёмник копирования или blit
+  VertexBufferRead,      // Буфер вершин
+  Present                // Презентация (только как конечное состояние)
+};
+
+// Описание временного изображения, память которого принадлежит графу
+struct RenderGraphImageDesc
+{
+  vk::Format              format  = vk::Format::eUndefined;
+  vk::Extent2D            extent  = {};
+  vk::ImageUsageFlags     usage   = {};
+  vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+  vk::ImageAspectFlags    aspect  = vk::ImageAspectFlagBits::eColor;
+};
+
+/**
+ * @brief Граф кадра.
+ * Проходы объявляют, какие ресурсы и как они читают и пишут. При компиляции граф
+ * отбрасывает проходы, результат которых никому не нужен, планирует минимальный набор
+ * барьеров synchronization2 и переходов layout, а временным изображениям с
+ * непересекающимися временами жизни выдаёт одну и ту же память.
+ */
+class VulkanRenderGraph
+{
+public:
+  // Запись команд прохода
+  using ExecuteFn = std::function<void(vk::CommandBuffer)>;
+
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param queueFlags Возможности очереди, в которую записывается граф: стадии, которых
+   *                   у очереди нет (например, фрагментные на вычислительной), не попадают
+   *                   в барьеры
+   */
+  explicit VulkanRenderGraph(VulkanDevice&  device,
+                             vk::QueueFlags queueFlags = vk::QueueFlagBits::eGraphics |
+                                                         vk::QueueFlagBits::eCompute);
+  ~VulkanRenderGraph();
+
+  /**
+   * @brief Импорт внешнего изображения (например, из swap chain)
+   * @param name Имя ресурса
+   * @param aspect Аспект изображения
+   * @param initialStage Стадия, после которой изображение доступно в начале кадра
+   * @param finalAccess Состояние, в которое изображение переводится в конце кадра
+   * @param initialLayout Layout в начале кадра (eUndefined - прежнее содержимое не сохраняется)
+   */
+  RenderGraphResource importImage(const std::string& name, vk::ImageAspectFlags aspect,
+                                  vk::PipelineStageFlags2 initialStage,
+                                  RenderGraphAccess       finalAccess,
+                                  vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined);
+
+  /**
+   * @brief Импорт внешнего буфера
+   * @param name Имя ресурса
+   * @param initialStage Стадия, после которой буфер можно использовать в начале кадра
+   */
+  RenderGraphResource importBuffer(const std::string& name, vk::PipelineStageFlags2 initialStage);
+
+  /**
+   * @brief Создание временного изображения, живущего в пределах кадра
+   */
+  RenderGraphResource createImage(const std::string& name, const RenderGraphImageDesc& desc);
+
+  /**
+   * @brief Добавление прохода
+   * @return Индекс прохода для объявления используемых ресурсов
+   */
+  uint32_t addPass(const std::string& name, ExecuteFn execute);
+
+  /**
+   * @brief Объявление использования ресурса проходом
+   */
+  void use(uint32_t pass, RenderGraphResource resource, RenderGraphAccess access);
+
+  /**
+   * @brief Пометить ресурс как результат кадра (проходы, пишущие в него, не отбрасываются).
+   * Импортированные изображения с конечным состоянием считаются результатом автоматически.
+   */
+  void markOutput(RenderGraphResource resource);
+
+  /**
+   * @brief Отсечение проходов, выделение памяти и планирование барьеров
+   */
+  void compile();
+
+  /**
+   * @brief Подстановка внешних объектов текущего кадра
+   */
+  void setImportedImage(RenderGraphResource resource, vk::Image image, vk::ImageView view);
+  void setImportedBuffer(RenderGraphResource resource, vk::Buffer buffer);
+
+  /**
+   * @brief Запись всех проходов кадра с барьерами между ними
+   */
+  void execute(vk::CommandBuffer commandBuffer);
+
+  // Геттеры
+  vk::Image      getImage(RenderGraphResource resource) const;
+  vk::ImageView  getImageView(RenderGraphResource resource) const;
+  vk::Buffer     getBuffer(RenderGraphResource resource) const;
+  vk::DeviceSize getTransientMemorySize() const { return m_transientMemorySize; }
+  uint32_t       getCulledPassCount() const { return m_culledPassCount; }
+
+private:
+  // Стадия, доступ и layout одного использования
+  struct AccessInfo
+  {
+    vk::PipelineStageFlags2 stage;
+    vk::AccessFlags2        access;
+    vk::ImageLayout         layout;
+    bool                    isWrite;
+  };
+
+  struct Resource
+  {
+    std::string          name;
+    bool                 isBuffer = false;
+    bool                 imported = false;
+    bool                 isOutput = false;
+    RenderGraphImageDesc desc;
+
+    // Текущие объекты
+    vk::Image     image;
+    vk::ImageView view;
+    vk::Buffer    buffer;
+
+    // Собственные объекты временного изображения
+    vk::UniqueImage     ownedImage;
+    vk::UniqueImageView ownedView;
+
+    // Начальное и конечное состояние импортированного ресурса
+    vk::PipelineStageFlags2 initialStage  = vk::PipelineStageFlagBits2::eNone;
+    vk::ImageLayout         initialLayout = vk::ImageLayout::eUndefined;
+    bool                    hasFinal      = false;
+    RenderGraphAccess       finalAccess  = RenderGraphAccess::Present;
+
+    // Время жизни в проходах и блок памяти
+    int32_t firstPass   = -1;
+    int32_t lastPass    = -1;
+    int32_t memoryBlock = -1;
+  };
+
+  struct Pass
+  {
+    std::string name;
+    ExecuteFn   execute;
+    std::vector<std::pair<RenderGraphResource, RenderGraphAccess>> uses;
+    bool        culled = false;
+  };
+
+  // Запланированный барьер (объекты подставляются при записи)
+  struct PlannedBarrier
+  {
+    RenderGraphResource     resource;
+    vk::PipelineStageFlags2 srcStage;
+    vk::AccessFlags2        srcAccess;
+    vk::PipelineStageFlags2 dstStage;
+    vk::AccessFlags2        dstAccess;
+    vk::ImageLayout         oldLayout;
+    vk::ImageLayout         newLayout;
+  };
+
+  // Блок памяти, разделяемый временными изображениями
+  struct MemoryBlock
+  {
+    TrackedDeviceMemory   memory;
+    vk::DeviceSize        size      = 0;
+    uint32_t              typeBits  = ~0u;
+    bool                  lazy      = false;  // Лениво выделяемая память
+    std::vector<uint32_t> resources;  // Ресурсы, живущие в блоке
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  // Стадии, поддерживаемые очередью графа
+  vk::PipelineStageFlags2 m_supportedStages;
+
+  std::vector<Resource>    m_resources;
+  std::vector<Pass>        m_passes;
+  std::vector<MemoryBlock> m_memoryBlocks;
+
+  // План барьеров: перед каждым проходом и после последнего
+  std::vector<std::vector<PlannedBarrier>> m_passBarriers;
+  std::vector<PlannedBarrier>              m_finalBarriers;
+
+  // Переиспользуемые массивы для записи барьеров
+  std::vector<vk::ImageMemoryBarrier2>  m_imageBarriers;
+  std::vector<vk::BufferMemoryBarrier2> m_bufferBarriers;
+
+  vk::DeviceSize m_transientMemorySize = 0;  // Без учёта лениво выделяемых блоков
+  uint32_t       m_culledPassCount     = 0;
+  bool           m_compiled            = false;
+
+  // Этапы компиляции
+  void cullPasses();            // Отсечение неиспользуемых проходов
+  void computeLifetimes();      // Первый и последний проход каждого ресурса
+  void allocateTransients();    // Создание временных изображений и алиасинг памяти
+  void planBarriers();          // Построение списка барьеров
+  void recordBarriers(vk::CommandBuffer                  commandBuffer,
+                      const std::vector<PlannedBarrier>& barriers);  // Запись барьеров
+
+  static AccessInfo getAccessInfo(RenderGraphAccess access);
+  AccessInfo        getQueueAccessInfo(RenderGraphAccess access) const;  // С учётом очереди
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "RadixSort.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Пакет отрисовки: всё состояние, нужное для одного draw-вызова.
+ * Пакеты сортируются по key, поэтому порядок отправки не важен.
+ */
+struct DrawPacket
+{
+  uint64_t           key = 0;              // Ключ сортировки (см. RenderKey)
+  vk::Pipeline       pipeline;             // Графический конвейер
+  vk::PipelineLayout pipelineLayout;       // Layout конвейера
+  vk::DescriptorSet  descriptorSet;        // Набор дескрипторов (set = 0)
+  uint32_t           dynamicOffsetCount = 0;
+  uint32_t           dynamicOffsets[2]  = {};
+  vk::Buffer         vertexBuffer;         // Буфер вершин (binding = 0)
+  vk::Buffer         indexBuffer;          // Буфер индексов (пустой - draw без индексов)
+  uint32_t           count         = 0;    // Количество вершин или индексов
+  uint32_t           instanceCount = 1;
+  uint32_t           firstVertex   = 0;    // Первая вершина или первый индекс
+  int32_t            vertexOffset  = 0;    // Смещение вершин для индексированного draw
+
+  // Топология учитывается только в статистике (количество треугольников)
+  vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+};
+
+/**
+ * @brief Построение 64-битных ключей сортировки.
+ * Поля: проход (4 бита), конвейер (12), материал (12), глубина (24), меш (12).
+ * Для непрозрачной геометрии глубина идёт после состояния и растёт от камеры -
+ * внутри одного состояния объекты рисуются спереди назад (раннее отсечение по Z).
+ * Для прозрачной глубина стоит сразу за проходом и инвертирована (сзади вперёд).
+ */
+namespace RenderKey
+{
+  const uint32_t PASS_BITS     = 4;
+  const uint32_t PIPELINE_BITS = 12;
+  const uint32_t MATERIAL_BITS = 12;
+  const uint32_t DEPTH_BITS    = 24;
+  const uint32_t MESH_BITS     = 12;
+
+  // Квантование нормализованной глубины [0, 1] в DEPTH_BITS бит
+  inline uint64_t quantizeDepth(float depth01)
+  {
+    const uint64_t maxDepth = (1ull << DEPTH_BITS) - 1;
+    float          clamped  = depth01 < 0.0f ? 0.0f : (depth01 > 1.0f ? 1.0f : depth01);
+    return static_cast<uint64_t>(clamped * static_cast<float>(maxDepth));
+  }
+
+  inline uint64_t field(uint32_t value, uint32_t bits) { return value & ((1ull << bits) - 1); }
+
+  // Ключ непрозрачного объекта: проход | конвейер | материал | глубина | меш
+  inline uint64_t makeOpaque(uint32_t pass, uint32_t pipeline, uint32_t material, float depth01,
+                             uint32_t mesh)
+  {
+    return field(pass, PASS_BITS) << 60 | field(pipeline, PIPELINE_BITS) << 48 |
+           field(material, MATERIAL_BITS) << 36 | quantizeDepth(depth01) << 12 |
+           field(mesh, MESH_BITS);
+  }
+
+  // Ключ прозрачного объекта: проход | инвертированная глубина | конвейер | материал | меш
+  inline uint64_t makeTransparent(uint32_t pass, uint32_t pipeline, uint32_t material,
+                                  float depth01, uint32_t mesh)
+  {
+    const uint64_t maxDepth = (1ull << DEPTH_BITS) - 1;
+    return field(pass, PASS_BITS) << 60 | (maxDepth - quantizeDepth(depth01)) << 36 |
+           field(pipeline, PIPELINE_BITS) << 24 | field(material, MATERIAL_BITS) << 12 |
+           field(mesh, MESH_BITS);
+  }
+}  // namespace RenderKey
+
+// Статистика воспроизведения очереди
+struct RenderQueueStats
+{
+  uint32_t draws              = 0;
+  uint32_t pipelineBinds      = 0;
+  uint32_t descriptorSetBinds = 0;
+  uint32_t vertexBufferBinds  = 0;
+  uint32_t indexBufferBinds   = 0;
+  uint64_t triangles          = 0;  // Только пакеты со списком треугольников
+};
+
+/**
+ * @brief Очередь отрисовки кадра.
+ * Пакеты собираются в произвольном порядке, сортируются поразрядной сортировкой
+ * по ключу и воспроизводятся в командный буфер без повторных привязок состояния.
+ */
+class VulkanRenderQueue
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param pool Пул потоков для параллельной сортировки (nullptr - однопоточно)
+   */
+  explicit VulkanRenderQueue(ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Очистка очереди перед новым кадром (память сохраняется)
+   */
+  void clear();
+
+  /**
+   * @brief Резервирование памяти под ожидаемое количество пакетов
+   */
+  void reserve(size_t packetCount);
+
+  /**
+   * @brief Добавление пакета отрисовки
+   */
+  void push(const DrawPacket& packet);
+
+  /**
+   * @brief Сортировка пакетов по ключу
+   */
+  void sort();
+
+  /**
+   * @brief Запись отсортированных пакетов в командный буфер
+   * @param commandBuffer Командный буфер внутри прохода рендеринга
+   * @return Статистика привязок и draw-вызовов
+   */
+  RenderQueueStats execute(vk::CommandBuffer commandBuffer) const;
+
+  size_t size() const { return m_packets.size(); }
+
+  /**
+   * @brief Пакет на позиции position в порядке воспроизведения (после sort())
+   */
+  const DrawPacket& getSorted(size_t position) const
+  {
+    return m_packets[m_entries[position].index];
+  }
+
+private:
+  ThreadPool*             m_pool;
+  std::vector<DrawPacket> m_packets;  // Пакеты в порядке добавления
+  std::vector<SortEntry>  m_entries;  // Ключи и индексы пакетов
+  std::vector<SortEntry>  m_scratch;  // Временный буфер сортировки
+};
@@ -1,10 +1,28 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "CommandTraceRecorder.h"
+#include "FrameSnapshot.h"
+#include "FrustumCuller.h"
+#include "LodSelector.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
 #include "VulkanDevice.h"
+#include "VulkanFrameCapture.h"
+#include "VulkanFrameContext.h"
+#include "VulkanHud.h"
+#include "VulkanParticleSystem.h"
+#include "VulkanPostProcess.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanRenderQueue.h"
+#include "VulkanSpriteBatch.h"
 #include "VulkanSwapChain.h"
+#include "VulkanTextureManager.h"
+#include "VulkanUniformBuffer.h"
 #include "VulkanUtils.h"
 
 struct Vertex
@@ -52,16 +70,31 @@ public:
    * @brief Конструктор
    * @param device Ссылка на объект VulkanDevice
    * @param swapChain Ссылка на объект VulkanSwapChain
+   * @param threadPool Пул потоков для параллельной работы на CPU
    */
-  VulkanRenderer(VulkanDevice& device, VulkanSwapChain& swapChain);
+  VulkanRenderer(VulkanDevice& device, VulkanSwapChain& swapChain, ThreadPool& threadPool);
   ~VulkanRenderer();
 
   /**
-   * @brief Инициализация renderer и связанных ресурсов
+   * @brief Инициализация renderer и связанных ресурсов (обе стадии подряд)
    * @return Статус инициализации (0 - успешно)
    */
   int init();
 
+  /**
+   * @brief Первая стадия: ресурсы, которым нужно только устройство (конвейеры,
+   * буферы, пулы команд). Swap chain может создаваться параллельно с ней
+   * @return Статус инициализации (0 - успешно)
+   */
+  int initDeviceResources();
+
+  /**
+   * @brief Вторая стадия: ресурсы, зависящие от размера и изображений swap chain
+   * (после initDeviceResources и инициализации swap chain)
+   * @return Статус инициализации (0 - успешно)
+   */
+  int initSwapChainResources();
+
   /**
    * @brief Очистка ресурсов
    */
@@ -69,44 +102,168 @@ public:
 
   /**
    * @brief Отрисовка одного кадра
+   * @param snapshot Состояние симуляции, которое показывает кадр
    * @return true, если рендеринг выполнен успешно
    */
-  bool drawFrame();
+  bool drawFrame(const FrameSnapshot& snapshot);
+
+  /**
+   * @brief Запрос количества семплов MSAA (вызывать до init).
+   * Значение ограничивается поддержкой устройства, VKAPI_MSAA имеет приоритет.
+   */
+  void setSampleCount(vk::SampleCountFlagBits samples) { m_requestedSamples = samples; }
+
+  // Фактически используемое количество семплов
+  vk::SampleCountFlagBits getSampleCount() const { return m_msaaSamples; }
+
+  // Используется ли dynamic rendering вместо render pass
+  bool usesDynamicRendering() const { return m_useDynamicRendering; }
+
+  /**
+   * @brief Получить подсистему текстур
+   */
+  VulkanTextureManager& getTextureManager() { return *m_textureManager; }
 
 private:
   // Ссылки на зависимые объекты (не владеет ими)
   VulkanDevice&    m_device;
   VulkanSwapChain& m_swapChain;
+  ThreadPool&      m_threadPool;
 
-  // Render pass и графический конвейер
+  // Render pass (только без dynamic rendering) и графический конвейер
   vk::UniqueRenderPass     m_vkRenderPass;        // Render pass (RAII)
   vk::UniquePipelineLayout m_vkPipelineLayout;    // Layout графического конвейера (RAII)
   vk::UniquePipeline       m_vkGraphicsPipeline;  // Графический конвейер (RAII)
 
-  // Framebuffers
-  std::vector<vk::UniqueFramebuffer> m_vkSwapChainFramebuffers;  // Framebuffers (RAII)
+  // Framebuffers (по слоту кадра: цель - HDR-изображение сцены слота)
+  std::vector<vk::UniqueFramebuffer> m_vkSceneFramebuffers;  // Framebuffers (RAII)
 
-  // Командные буферы
-  vk::UniqueCommandPool                m_vkCommandPool;     // Пул командных буферов (RAII)
-  std::vector<vk::UniqueCommandBuffer> m_vkCommandBuffers;  // Командные буферы (RAII)
+  // Пул команд для однократных загрузок при инициализации
+  vk::UniqueCommandPool m_vkCommandPool;  // Пул командных буферов (RAII)
+
+  // Кадры в обработке: команды, семафор получения изображения, временная память
+  std::vector<std::unique_ptr<VulkanFrameContext>> m_frames;
 
   // Синхронизация
+  vk::UniqueSemaphore m_vkGraphicsTimeline;  // Timeline графической очереди (номер кадра)
   std::vector<vk::UniqueSemaphore>
-      m_vkImageAvailableSemaphores;  // Семафоры для доступных изображений
-  std::vector<vk::UniqueSemaphore>
-                               m_vkRenderFinishedSemaphores;  // Семафоры для завершения рендеринга
-  std::vector<vk::UniqueFence> m_vkInFlightFences;            // Заборы для кадров в полёте
+      m_vkRenderFinishedSemaphores;  // Семафоры для презентации (по изображению swap chain)
+
+  // Буферы меша: вершины общие для всех уровней детализации, индексы уровней - подряд
+  vk::UniqueBuffer    m_vkVertexBuffer;        // Буфер вершин (RAII)
+  TrackedDeviceMemory m_vkVertexBufferMemory;  // Память буфера вершин (RAII)
+  vk::UniqueBuffer    m_vkIndexBuffer;         // Буфер индексов всех уровней (RAII)
+  TrackedDeviceMemory m_vkIndexBufferMemory;   // Память буфера индексов (RAII)
+  LodChain            m_triangleLods;          // Уровни детализации треугольника
+
+  // Константы кадра и объектов (динамический uniform-буфер)
+  std::unique_ptr<VulkanUniformBuffer> m_uniformBuffer;
+
+  // Очередь отрисовки кадра и статистика её последнего воспроизведения
+  VulkanRenderQueue m_renderQueue;
+  RenderQueueStats  m_renderQueueStats;
 
-  // Вершинный буфер
-  vk::UniqueBuffer       m_vkVertexBuffer;        // Буфер вершин (RAII)
-  vk::UniqueDeviceMemory m_vkVertexBufferMemory;  // Память буфера вершин (RAII)
+  // Отсечение объектов кадра по пирамиде видимости (границы - в пространстве мира)
+  FrustumCuller m_culler;
+
+  // Выбор уровней детализации по ошибке на экране
+  LodSelector m_lodSelector;
+
+  // Метрики кадра: запись в drawFrame, экспорт в файл - в потоке MetricsExporter
+  MetricsRegistry                  m_metrics;
+  std::unique_ptr<MetricsExporter> m_metricsExporter;  // nullptr без VKAPI_METRICS_FILE
+  LatencyHistogram*                m_pFrameTimeMetric    = nullptr;
+  LatencyHistogram*                m_pAcquireWaitMetric  = nullptr;
+  LatencyHistogram*                m_pTimelineWaitMetric = nullptr;
+  LatencyHistogram*                m_pSubmitMetric       = nullptr;
+  MetricsCounter*                  m_pDrawsMetric        = nullptr;
+  MetricsCounter*                  m_pTrianglesMetric    = nullptr;
+  MetricsCounter*                  m_pUploadBytesMetric  = nullptr;
+  LatencyHistogram*                m_pCullMetric         = nullptr;
+  MetricsCounter*                  m_pCulledMetric       = nullptr;
+  MetricsCounter*                  m_pVisibleMetric      = nullptr;
+  MetricsCounter*                  m_pLodSwitchesMetric  = nullptr;
+  MetricsCounter*                  m_pLodSavedMetric     = nullptr;
+
+  // Граф кадра: проходы, барьеры и временные вложения
+  std::unique_ptr<VulkanRenderGraph> m_renderGraph;
+  RenderGraphResource                m_swapChainTarget   = 0;  // Изображение swap chain в графе
+  RenderGraphResource                m_sceneTarget       = 0;  // HDR-сцена текущего слота
+  RenderGraphResource                m_postOutputTarget  = 0;  // Результат постобработки
+  RenderGraphResource                m_msaaColorTarget   = 0;  // Многосемпловый цвет
+  RenderGraphResource                m_depthTarget       = 0;  // Буфер глубины
+  uint32_t                           m_currentImageIndex = 0;  // Изображение текущего кадра
+
+  // Мультисемплинг и формат глубины
+  vk::SampleCountFlagBits m_requestedSamples = vk::SampleCountFlagBits::e4;
+  vk::SampleCountFlagBits m_msaaSamples      = vk::SampleCountFlagBits::e1;
+  vk::Format              m_depthFormat      = vk::Format::eUndefined;
+
+  // Путь рендеринга: beginRendering или render pass с framebuffer
+  bool m_useDynamicRendering = true;
+
+  // Частицы, симулируемые на GPU (nullptr без VKAPI_PARTICLES)
+  std::unique_ptr<VulkanParticleSystem> m_particleSystem;
+  RenderGraphResource                   m_particleBuffer = 0;  // Буфер частиц в графе
+
+  // Постобработка на вычислительной очереди (результат показывается кадром позже)
+  std::unique_ptr<VulkanPostProcess> m_postProcess;
+
+  // Захват кадров на диск (nullptr без VKAPI_CAPTURE_DIR)
+  std::unique_ptr<VulkanFrameCapture> m_frameCapture;
+
+  // Подсистема текстур со стримингом мип-уровней
+  std::unique_ptr<VulkanTextureManager> m_textureManager;
+
+  // Пакетная отрисовка спрайтов (nullptr при VKAPI_SPRITES=0), страницы - из подсистемы текстур
+  std::unique_ptr<VulkanSpriteBatch> m_spriteBatch;
+  uint32_t                           m_spriteCount = 0;  // Спрайтов демонстрационной сетки
+
+  // Оверлей производительности (nullptr при VKAPI_HUD=0 и без dynamic rendering)
+  std::unique_ptr<VulkanHud> m_hud;
+  HudFrameStats              m_hudStats;  // Показатели, собираемые в течение кадра
+
+  // Запись трассы команд для vkapireplay (nullptr без VKAPI_TRACE_FILE и после записи)
+  std::unique_ptr<CommandTraceRecorder> m_commandTrace;
 
   // Параметры рендеринга
   const int MAX_FRAMES_IN_FLIGHT = 2;     // Максимальное количество кадров в обработке
   size_t    m_currentFrame       = 0;     // Текущий индекс кадра
-  float     m_animationTime      = 0.0f;  // Время для анимации
+  uint64_t  m_frameNumber        = 0;     // Сквозной номер кадра (с 1)
+  float     m_frameDeltaTime     = 0.0f;  // Время симуляции между кадрами в секундах
+  double    m_lastSimulationTime = 0.0;   // Время симуляции предыдущего кадра
+
+  std::chrono::steady_clock::time_point m_lastFrameTime;  // Начало предыдущего кадра
+
+  // Телеметрия видеопамяти
+  const double         DEFAULT_MEMORY_REPORT_SEC = 10.0;         // Период отчёта по умолчанию
+  const float          MEMORY_PRESSURE_THRESHOLD = 0.9f;         // Доля бюджета для сжатия кэшей
+  const vk::DeviceSize MIN_TEXTURE_BUDGET        = 64ull << 20;  // Нижняя граница бюджета текстур
+
+  // Обработчик нехватки видеопамяти в VulkanMemoryTracker (снимается в cleanup)
+  MemoryThresholdHandle m_memoryPressureHandle = INVALID_MEMORY_THRESHOLD;
+
+  // Период записи метрик в файл по умолчанию
+  const double DEFAULT_METRICS_INTERVAL_SEC = 10.0;
+
+  // Разбиение треугольника для уровней детализации и допустимая ошибка LOD на экране
+  const uint32_t TRIANGLE_SUBDIVISIONS = 32;
+  const float    LOD_THRESHOLD_PX      = 1.0f;
+
+  // Кадров между обновлениями видеопамяти на оверлее (запрос бюджета не бесплатен)
+  const uint64_t HUD_MEMORY_INTERVAL = 30;
+
+  // Страницы атласа спрайтов: количество и размер стороны в пикселях
+  const uint32_t SPRITE_PAGE_COUNT = 2;
+  const uint32_t SPRITE_PAGE_SIZE  = 256;
+
+  // Кадров в трассе команд по умолчанию (VKAPI_TRACE_FRAMES)
+  const uint32_t DEFAULT_TRACE_FRAMES = 600;
+
+  // Начальный размер арены кадра (растёт сама, если кадру не хватило)
+  const size_t FRAME_ARENA_BYTES = 256 * 1024;
 
-  // Данные о вершинах (для простоты - встроенные в класс)
+  // Углы треугольника (для простоты - встроенные в класс, сетка строится в createMeshBuffers)
   std::vector<Vertex> m_vertices = {
       {{-0.8f, 0.8f}, {1.0f, 0.0f, 0.0f}},  // Верхний левый угол (красный)
       {{0.8f, 0.8f}, {0.0f, 1.0f, 0.0f}},   // Верхний правый угол (зеленый)
@@ -114,19 +271,36 @@ private:
   };
 
   // Методы инициализации
-  void createRenderPass();        // Создание render pass
-  void createGraphicsPipeline();  // Создание графического конвейера
-  void createFramebuffers();      // Создание framebuffers
-  void createCommandPool();       // Создание пула командных буферов
-  void createCommandBuffers();    // Создание командных буферов
-  void createSyncObjects();       // Создание объектов синхронизации
-  void createVertexBuffer();      // Создание буфера вершин
+  void chooseSampleCount();        // Выбор количества семплов MSAA и формата глубины
+  void chooseRenderingBackend();   // Выбор между dynamic rendering и render pass
+  void createPostProcess();        // Создание постобработки и HDR-целей сцены
+  void createRenderPass();         // Создание render pass
+  void createGraphicsPipeline();   // Создание графического конвейера
+  void createFramebuffers();       // Создание framebuffers
+  void createRenderGraph();        // Создание графа кадра
+  void createCommandPool();        // Создание пула командных буферов
+  void createFrameContexts();      // Создание контекстов кадров в обработке
+  void createSyncObjects();        // Создание объектов синхронизации кадров
+  void createPresentSemaphores();  // Создание семафоров презентации (по изображению)
+  void createMeshBuffers();        // Создание буферов вершин и индексов с уровнями LOD
+  void createParticleSystem();     // Создание системы частиц
+  void createTextureManager();     // Создание подсистемы текстур
+  void createSpriteBatch();        // Создание пакетной отрисовки спрайтов и страниц атласа
+  void createHud();                // Создание оверлея производительности
+  void createFrameCapture();       // Создание захвата кадров
+  void createUniformBuffer();      // Создание uniform-буфера констант
+  void createCommandTrace();       // Начало записи трассы команд
+  void createMemoryTelemetry();    // Отчёты о видеопамяти и реакция на нехватку бюджета
+  void createMetrics();            // Регистрация метрик кадра и запуск экспорта
 
   // Вспомогательные методы
+  vk::Format findDepthFormat() const;  // Поиск поддерживаемого формата глубины
   vk::UniqueShaderModule createShaderModule(
       const std::vector<char>& code);  // Создание шейдерного модуля
-  uint32_t findMemoryType(uint32_t                typeFilter,
-                          vk::MemoryPropertyFlags properties);  // Поиск типа памяти
-  void     recordCommandBuffer(vk::CommandBuffer commandBuffer,
-                               uint32_t          imageIndex);  // Запись команд в буфер
+  void recordMainPass(vk::CommandBuffer commandBuffer);     // Запись основного прохода
+  void recordPresentPass(vk::CommandBuffer commandBuffer);  // Копирование результата в swap chain
+  void recordHudPass(vk::CommandBuffer commandBuffer);      // Оверлей поверх swap chain
+  void fillSprites(float animationTime, vk::Extent2D extent);  // Анимированная сетка спрайтов
+  void recordCommandBuffer(vk::CommandBuffer commandBuffer,
+                           uint32_t          imageIndex);  // Запись команд в буфер
 };
\ No newline at end of file
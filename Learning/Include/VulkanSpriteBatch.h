@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "SpriteBatcher.h"
+#include "VulkanDevice.h"
+#include "VulkanParticleSystem.h"
+#include "VulkanRenderQueue.h"
+#include "VulkanTextureManager.h"
+
+/**
+ * @brief Отрисовка большого количества спрайтов пачками по страницам атласа.
+ * Вершины кадра SpriteBatcher пишет прямо в постоянно отображённую область слота
+ * кадра, а каждая пачка становится одним пакетом очереди отрисовки: индексированный
+ * draw со смещением вершин пачки и общим статическим буфером индексов квадов.
+ * Страницы атласа - текстуры VulkanTextureManager; наборы дескрипторов заведены на
+ * каждый слот кадра и перезаписываются, когда у страницы меняется image view.
+ */
+class VulkanSpriteBatch
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param textures Подсистема текстур, в которой лежат страницы атласа
+   * @param pool Пул потоков для параллельной сборки вершин (nullptr - однопоточно)
+   * @param maxSprites Наибольшее количество спрайтов в кадре
+   * @param pageCount Количество страниц атласа
+   * @param framesInFlight Количество кадров в обработке
+   */
+  VulkanSpriteBatch(VulkanDevice& device, VulkanTextureManager& textures, ThreadPool* pool,
+                    uint32_t maxSprites, uint32_t pageCount, uint32_t framesInFlight);
+  ~VulkanSpriteBatch();
+
+  /**
+   * @brief Создание буферов вершин и индексов, наборов дескрипторов и конвейера
+   * @param target Цель основного прохода (та же, что у системы частиц)
+   * @param commandPool Пул для однократной загрузки буфера индексов
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init(const ParticleRenderTarget& target, vk::CommandPool commandPool);
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Назначение текстуры странице атласа
+   */
+  void setPage(uint32_t page, TextureHandle texture);
+
+  /**
+   * @brief Сборщик спрайтов кадра (очищается вызывающим в начале кадра)
+   */
+  SpriteBatcher& getBatcher() { return m_batcher; }
+
+  /**
+   * @brief Запись вершин кадра в область слота и добавление пачек в очередь отрисовки.
+   * Пачки страниц, которые ещё не загружены на GPU, в этом кадре пропускаются
+   * @param frameSlot Индекс кадра в обработке
+   * @param extent Размер цели в пикселях
+   * @param queue Очередь отрисовки кадра
+   */
+  void submit(uint32_t frameSlot, vk::Extent2D extent, VulkanRenderQueue& queue);
+
+  // Пачек и спрайтов, отправленных последним submit()
+  uint32_t getBatchCount() const { return m_batchCount; }
+  uint32_t getSubmittedSprites() const { return m_submittedSprites; }
+
+private:
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice&         m_device;
+  VulkanTextureManager& m_textures;
+
+  uint32_t      m_maxSprites;
+  uint32_t      m_pageCount;
+  uint32_t      m_framesInFlight;
+  SpriteBatcher m_batcher;
+
+  // Страницы атласа и версии текстур, записанные в наборы [слот][страница]
+  std::vector<TextureHandle> m_pages;
+  std::vector<bool>          m_pageAssigned;
+  std::vector<uint32_t>      m_setVersions;
+
+  // Буферы: индексы квадов в памяти устройства, вершины - по области на слот кадра
+  vk::UniqueBuffer    m_vkIndexBuffer;   // Статический буфер индексов (RAII)
+  TrackedDeviceMemory m_vkIndexMemory;   // Память буфера индексов (RAII)
+  vk::UniqueBuffer    m_vkVertexBuffer;  // Буфер вершин всех слотов (RAII)
+  TrackedDeviceMemory m_vkVertexMemory;  // Память буфера вершин (RAII)
+  SpriteVertex*       m_pVertices = nullptr;
+
+  // Наборы дескрипторов страниц [слот][страница]
+  vk::UniqueDescriptorSetLayout  m_vkDescriptorSetLayout;  // Layout набора (RAII)
+  vk::UniqueDescriptorPool       m_vkDescriptorPool;       // Пул дескрипторов (RAII)
+  std::vector<vk::DescriptorSet> m_vkDescriptorSets;       // Освобождаются с пулом
+
+  // Конвейер спрайтов
+  vk::UniquePipelineLayout m_vkPipelineLayout;  // Layout конвейера (RAII)
+  vk::UniquePipeline       m_vkPipeline;        // Графический конвейер (RAII)
+
+  uint32_t m_batchCount       = 0;
+  uint32_t m_submittedSprites = 0;
+
+  const uint32_t NOT_WRITTEN = ~0u;  // Версия набора, в который ещё ничего не записано
+
+  void createIndexBuffer(vk::CommandPool commandPool);
+  void createVertexBuffer();
+  void createDescriptorSets();
+  void createPipeline(const ParticleRenderTarget& target);
+
+  /**
+   * @brief Набор страницы для слота с актуальным image view текстуры
+   */
+  vk::DescriptorSet getPageSet(uint32_t frameSlot, uint32_t page);
+};
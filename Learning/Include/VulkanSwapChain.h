@@ -24,7 +24,7 @@ public:
    * @brief Конструктор
    * @param device Ссылка на объект VulkanDevice
    * @param surface Поверхность для презентации
-   * @param window Окно SDL для определения размеров
+   * @param window Окно SDL для определения размеров (nullptr - размер по умолчанию)
    */
   VulkanSwapChain(VulkanDevice& device, vk::SurfaceKHR surface, SDL_Window* window);
   ~VulkanSwapChain();
@@ -67,6 +67,10 @@ private:
   vk::Extent2D               m_vkSwapChainExtent;       // Размеры изображений
   std::vector<vk::ImageView> m_vkSwapChainImageViews;   // Image views (не RAII)
 
+  // Размер по умолчанию, если поверхность не задаёт его, а окна нет
+  const int DEFAULT_WIDTH  = 800;
+  const int DEFAULT_HEIGHT = 600;
+
   // Вспомогательные методы выбора параметров swap chain
   vk::SurfaceFormatKHR chooseSwapSurfaceFormat(
       const std::vector<vk::SurfaceFormatKHR>& availableFormats);
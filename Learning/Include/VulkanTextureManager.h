@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+#include "VulkanFrameContext.h"
+
+// Идентификатор текстуры внутри VulkanTextureManager
+using TextureHandle = uint32_t;
+
+/**
+ * @brief Загрузчик одного мип-уровня текстуры.
+ * Должен вернуть RGBA8 пиксели уровня mipLevel размером width x height.
+ */
+using TextureMipLoader =
+    std::function<std::vector<uint8_t>(uint32_t mipLevel, uint32_t width, uint32_t height)>;
+
+/**
+ * @brief Подсистема текстур с потоковой подгрузкой мип-уровней.
+ * На GPU держится только хвост мип-цепочки, нужный по экранному размеру текстуры.
+ * Детализация наращивается по одному уровню за шаг, младшие уровни генерируются
+ * blit-цепочкой, а при превышении бюджета видеопамяти вытесняются верхние уровни
+ * давно не используемых текстур (LRU).
+ */
+class VulkanTextureManager
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param framesInFlight Количество кадров в обработке
+   * @param budgetBytes Бюджет видеопамяти под текстуры в байтах
+   */
+  VulkanTextureManager(VulkanDevice& device, uint32_t framesInFlight, vk::DeviceSize budgetBytes);
+  ~VulkanTextureManager();
+
+  /**
+   * @brief Инициализация сэмплера
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init();
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Регистрация текстуры. Данные загружаются позже, в update()
+   * @param width Ширина нулевого мип-уровня
+   * @param height Высота нулевого мип-уровня
+   * @param loader Загрузчик мип-уровней
+   * @return Идентификатор текстуры
+   * @throws std::invalid_argument если ширина или высота равна нулю
+   */
+  TextureHandle createTexture(uint32_t width, uint32_t height, TextureMipLoader loader);
+
+  /**
+   * @brief Регистрация текстуры по готовым RGBA8 пикселям нулевого уровня.
+   * Запрошенные уровни уменьшаются на CPU, поэтому для больших наборов текстур
+   * лучше передавать загрузчик с заранее подготовленными мип-уровнями.
+   */
+  TextureHandle createTextureFromPixels(uint32_t width, uint32_t height,
+                                        std::vector<uint8_t> pixels);
+
+  /**
+   * @brief Сообщает экранный размер текстуры в текущем кадре
+   * @param handle Идентификатор текстуры
+   * @param screenSizePixels Размер текстуры на экране в пикселях (по большей стороне)
+   */
+  void requestScreenSize(TextureHandle handle, float screenSizePixels);
+
+  /**
+   * @brief Потоковая подгрузка и вытеснение мип-уровней.
+   * Вызывается после VulkanFrameContext::begin() кадра frame.
+   * @param frame Контекст кадра: буфер загрузок, временная память, отложенное освобождение
+   * @param frameNumber Номер текущего кадра
+   * @return Командный буфер с копированиями (пустой, если работы нет).
+   *         Должен быть отправлен раньше командного буфера кадра.
+   */
+  vk::CommandBuffer update(VulkanFrameContext& frame, uint64_t frameNumber);
+
+  // Геттеры
+  vk::Sampler    getSampler() const { return *m_vkSampler; }
+  vk::DeviceSize getBudget() const { return m_budgetBytes; }
+  vk::DeviceSize getResidentBytes() const { return m_residentBytes; }
+  void           setBudget(vk::DeviceSize budgetBytes) { m_budgetBytes = budgetBytes; }
+  vk::DeviceSize getUploadedBytes() const { return m_uploadedBytes; }  // За последний update()
+
+  /**
+   * @brief Проверка наличия хотя бы одного мип-уровня на GPU
+   */
+  bool isResident(TextureHandle handle) const;
+
+  /**
+   * @brief Описание текстуры для записи в дескриптор.
+   * Image view меняется при каждой смене резидентности, см. getVersion()
+   */
+  vk::DescriptorImageInfo getDescriptorInfo(TextureHandle handle) const;
+
+  /**
+   * @brief Счётчик изменений резидентности текстуры (для обновления дескрипторов)
+   */
+  uint32_t getVersion(TextureHandle handle) const;
+
+private:
+  // Изображение на GPU с хвостом мип-цепочки, начиная с baseMip
+  struct GpuImage
+  {
+    TrackedDeviceMemory memory;
+    vk::UniqueImage     image;
+    vk::UniqueImageView view;
+    vk::DeviceSize      size   = 0;
+    uint32_t            levels = 0;
+  };
+
+  struct Texture
+  {
+    uint32_t         width  = 0;
+    uint32_t         height = 0;
+    uint32_t         mipCount;
+    uint32_t         tailMip;        // Самый грубый уровень, с которого начинается загрузка
+    uint32_t         residentMip;    // Первый резидентный уровень (mipCount - ничего нет)
+    uint32_t         desiredMip;     // Уровень, нужный по экранному размеру
+    uint64_t         lastUsedFrame;  // Последний кадр, в котором текстура запрашивалась
+    uint32_t         version = 0;
+    TextureMipLoader loader;
+    GpuImage         gpu;
+  };
+
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  // Сэмплер
+  vk::UniqueSampler m_vkSampler;  // Общий трилинейный сэмплер
+
+  // Текстуры; старые изображения и стадийные буферы удерживает контекст кадра
+  std::vector<Texture> m_textures;
+  VulkanFrameContext*  m_pFrame = nullptr;  // Кадр текущего update()
+
+  // Параметры стриминга
+  const uint32_t    TAIL_SIZE           = 64;  // Размер уровня, с которого начинается загрузка
+  const uint32_t    MAX_STEPS_PER_FRAME = 4;   // Максимум смен резидентности за кадр
+  const vk::Format  TEXTURE_FORMAT      = vk::Format::eR8G8B8A8Unorm;
+  uint32_t          m_framesInFlight;
+  vk::DeviceSize    m_budgetBytes;
+  vk::DeviceSize    m_residentBytes = 0;
+  vk::DeviceSize    m_uploadedBytes = 0;
+  uint64_t          m_frameNumber   = 0;
+
+  // Вспомогательные методы
+  void createSampler();  // Создание сэмплера
+  GpuImage createGpuImage(uint32_t width, uint32_t height,
+                          uint32_t levels);  // Создание изображения и image view
+  vk::DeviceSize estimateBytes(const Texture& texture,
+                               uint32_t       baseMip) const;  // Оценка памяти хвоста цепочки
+  bool makeRoom(vk::CommandBuffer cmd, vk::DeviceSize bytes,
+                uint64_t protectedFrame);  // Вытеснение LRU под бюджет
+  void loadTail(vk::CommandBuffer cmd, Texture& texture);    // Первая загрузка хвоста
+  void stepUp(vk::CommandBuffer cmd, Texture& texture);      // Добавить один уровень сверху
+  void dropTop(vk::CommandBuffer cmd, Texture& texture);     // Вытеснить верхний уровень
+  void replaceImage(Texture& texture, GpuImage image,
+                    uint32_t residentMip);  // Замена изображения с отложенным удалением
+  void uploadLevel(vk::CommandBuffer cmd, Texture& texture, uint32_t mipLevel,
+                   vk::Image dstImage);  // Копирование уровня из загрузчика в mip 0
+  void copyLevels(vk::CommandBuffer cmd, vk::Image srcImage, uint32_t srcBaseLevel,
+                  vk::Image dstImage, uint32_t dstBaseLevel, uint32_t levelCount,
+                  uint32_t width, uint32_t height);  // Копирование общих уровней
+  void generateMipChain(vk::CommandBuffer cmd, vk::Image image, uint32_t width,
+                        uint32_t height, uint32_t levels);  // Blit-цепочка до конца
+  void transitionImage(vk::CommandBuffer cmd, vk::Image image, vk::ImageLayout oldLayout,
+                       vk::ImageLayout newLayout, uint32_t baseLevel, uint32_t levelCount,
+                       vk::PipelineStageFlags srcStage, vk::AccessFlags srcAccess,
+                       vk::PipelineStageFlags dstStage,
+                       vk::AccessFlags        dstAccess);  // Барьер смены layout
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstring>
+#include <glm/glm.hpp>
+#include <stdexcept>
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanDevice.h"
+
+// Константы кадра (раскладка std140, binding = 0)
+struct FrameConstants
+{
+  glm::mat4 viewProj;  // Матрица камеры
+  glm::vec4 params;    // x - время анимации [0, 1)
+};
+
+// Константы объекта (раскладка std140, binding = 1)
+struct ObjectConstants
+{
+  glm::mat4 model;  // Матрица объекта
+};
+
+/**
+ * @brief Кольцевой uniform-буфер с динамическими смещениями.
+ * Буфер постоянно отображён в память хоста и разбит на области по кадрам в обработке.
+ * Внутри области данные выделяются линейно с выравниванием minUniformBufferOffsetAlignment,
+ * а шейдеры получают их через один набор дескрипторов и динамические смещения.
+ */
+class VulkanUniformBuffer
+{
+public:
+  /**
+   * @brief Конструктор
+   * @param device Ссылка на объект VulkanDevice
+   * @param framesInFlight Количество кадров в обработке
+   * @param bytesPerFrame Размер области одного кадра в байтах
+   */
+  VulkanUniformBuffer(VulkanDevice& device, uint32_t framesInFlight, vk::DeviceSize bytesPerFrame);
+  ~VulkanUniformBuffer();
+
+  /**
+   * @brief Создание буфера, layout'а и набора дескрипторов
+   * @return Статус инициализации (0 - успешно)
+   */
+  int init();
+
+  /**
+   * @brief Очистка ресурсов
+   */
+  void cleanup();
+
+  /**
+   * @brief Начало кадра: сброс линейного выделения в области кадра
+   * @param frameSlot Индекс кадра в обработке (его область уже не читается GPU)
+   */
+  void beginFrame(uint32_t frameSlot);
+
+  /**
+   * @brief Копирование данных в текущую область кадра
+   * @return Динамическое смещение для vkCmdBindDescriptorSets
+   */
+  template <typename T>
+  uint32_t push(const T& data)
+  {
+    return pushBytes(&data, sizeof(T));
+  }
+
+  /**
+   * @brief Копирование size байт в текущую область кадра (например, блоков из трассы)
+   * @return Динамическое смещение для vkCmdBindDescriptorSets
+   */
+  uint32_t pushBytes(const void* data, size_t size)
+  {
+    vk::DeviceSize offset = (m_offset + m_alignment - 1) & ~(m_alignment - 1);
+    if (offset + size > m_frameEnd)
+    {
+      throw std::runtime_error("Переполнение uniform-буфера кадра");
+    }
+
+    memcpy(m_pMapped + offset, data, size);
+    m_offset = offset + size;
+    return static_cast<uint32_t>(offset);
+  }
+
+  // Геттеры
+  vk::DescriptorSetLayout getDescriptorSetLayout() const { return *m_vkDescriptorSetLayout; }
+  vk::DescriptorSet       getDescriptorSet() const { return m_vkDescriptorSet; }
+  vk::DeviceSize          getFrameBytes() const { return m_offset + m_bytesPerFrame - m_frameEnd; }
+  vk::DeviceSize          getFrameBase() const { return m_frameEnd - m_bytesPerFrame; }
+
+private:
+  // Ссылки на зависимые объекты (не владеет ими)
+  VulkanDevice& m_device;
+
+  // Буфер и дескрипторы
+  TrackedDeviceMemory           m_vkMemory;               // Память буфера (RAII)
+  vk::UniqueBuffer              m_vkBuffer;               // Uniform-буфер (RAII)
+  vk::UniqueDescriptorSetLayout m_vkDescriptorSetLayout;  // Layout набора (RAII)
+  vk::UniqueDescriptorPool      m_vkDescriptorPool;       // Пул дескрипторов (RAII)
+  vk::DescriptorSet             m_vkDescriptorSet;        // Набор (освобождается с пулом)
+
+  // Параметры линейного выделения
+  uint32_t       m_framesInFlight;
+  vk::DeviceSize m_bytesPerFrame;
+  vk::DeviceSize m_alignment = 256;
+  vk::DeviceSize m_offset    = 0;  // Текущая позиция в области кадра
+  vk::DeviceSize m_frameEnd  = 0;  // Конец области кадра
+  uint8_t*       m_pMapped   = nullptr;
+
+  // Вспомогательные методы
+  void createBuffer();         // Создание и отображение буфера
+  void createDescriptorSet();  // Создание layout'а, пула и набора дескрипторов
+};
@@ -20,4 +20,24 @@ namespace VulkanUtils
    * @return Вектор с содержимым файла
    */
   std::vector<char> readFile(const std::string& filename);
+
+  /**
+   * @brief Чтение всех файлов SPIR-V (*.spv) каталога в кэш шейдеров.
+   * Потокобезопасно: вызывается параллельно с остальной инициализацией
+   * @param directory Каталог шейдеров
+   * @return Количество загруженных файлов
+   */
+  size_t preloadShaders(const std::string& directory);
+
+  /**
+   * @brief Байт-код шейдера из кэша предзагрузки, а если его там нет - с диска
+   * @param filename Имя файла
+   * @return Вектор с содержимым файла
+   */
+  std::vector<char> loadShader(const std::string& filename);
+
+  /**
+   * @brief Освобождение кэша шейдеров (после создания всех конвейеров)
+   */
+  void releaseShaderCache();
 }  // namespace VulkanUtils
\ No newline at end of file
@@ -0,0 +1,665 @@
+// Воспроизведение трассы команд рендерера (VKAPI_TRACE_FILE) без окна и без сцены.
+// Запуск из корня репозитория (пути к шейдерам в трассе относительные); поверхность
+// создаётся через VK_EXT_headless_surface, поэтому подходит любое устройство, включая lavapipe.
+//   vkapireplay <трасса> [--loops <N>]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "CommandTrace.h"
+#include "VulkanDevice.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanRenderQueue.h"
+#include "VulkanUniformBuffer.h"
+#include "VulkanUtils.h"
+
+namespace
+{
+  const uint32_t FRAMES_IN_FLIGHT = 2;
+  const uint32_t DEFAULT_LOOPS    = 10;
+
+  // Итоги одного прохода по кадрам трассы
+  struct ReplayStats
+  {
+    uint32_t frames    = 0;
+    uint64_t draws     = 0;
+    uint64_t triangles = 0;
+    double   seconds   = 0.0;
+  };
+
+  vk::UniqueInstance createHeadlessInstance()
+  {
+    vk::ApplicationInfo appInfo = {};
+    appInfo.pApplicationName    = "vkapireplay";
+    appInfo.applicationVersion  = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.pEngineName         = "No Engine";
+    appInfo.engineVersion       = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.apiVersion          = VK_API_VERSION_1_3;
+
+    const char* extensions[] = {VK_KHR_SURFACE_EXTENSION_NAME,
+                                VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+
+    vk::InstanceCreateInfo createInfo  = {};
+    createInfo.pApplicationInfo        = &appInfo;
+    createInfo.enabledExtensionCount   = 2;
+    createInfo.ppEnabledExtensionNames = extensions;
+
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
+    try
+    {
+      vk::UniqueInstance instance = vk::createInstanceUnique(createInfo);
+      VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+      return instance;
+    }
+    catch (const vk::SystemError& e)
+    {
+      throw std::runtime_error("Не удалось создать экземпляр Vulkan: " + std::string(e.what()));
+    }
+  }
+
+  vk::UniqueSurfaceKHR createHeadlessSurface(vk::Instance instance)
+  {
+    // Функция расширения не экспортируется загрузчиком напрямую
+    auto createFn = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+        instance.getProcAddr("vkCreateHeadlessSurfaceEXT"));
+    if (!createFn)
+    {
+      throw std::runtime_error("VK_EXT_headless_surface недоступно");
+    }
+
+    VkHeadlessSurfaceCreateInfoEXT createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    if (createFn(static_cast<VkInstance>(instance), &createInfo, nullptr, &surface) != VK_SUCCESS)
+    {
+      throw std::runtime_error("Не удалось создать headless-поверхность");
+    }
+    return vk::UniqueSurfaceKHR(surface, instance);
+  }
+
+  vk::UniqueShaderModule loadShader(vk::Device device, const std::string& path)
+  {
+    std::vector<char>          code       = VulkanUtils::readFile(path);
+    vk::ShaderModuleCreateInfo createInfo = {};
+    createInfo.codeSize                   = code.size();
+    createInfo.pCode                      = reinterpret_cast<const uint32_t*>(code.data());
+    return device.createShaderModuleUnique(createInfo);
+  }
+
+  /**
+   * @brief Воспроизведение кадров трассы в цель основного прохода вне экрана.
+   * Буферы загружаются один раз, конвейеры пересоздаются по записанному состоянию,
+   * а каждый кадр - это uniform-данные и draw-вызовы в записанном порядке (без сортировки),
+   * выполненные той же VulkanRenderQueue, что и в рендерере.
+   */
+  class TraceReplayer
+  {
+  public:
+    TraceReplayer(VulkanDevice& device, const CommandTrace& trace)
+        : m_device(device),
+          m_trace(trace),
+          m_uniformBuffer(device, FRAMES_IN_FLIGHT, 64 * 1024),
+          m_graph(device)
+    {
+      if (m_uniformBuffer.init() != 0)
+      {
+        throw std::runtime_error("Не удалось инициализировать uniform-буфер");
+      }
+      createCommands();
+      uploadBuffers();
+      createPipelines();
+      createRenderGraph();
+    }
+
+    ~TraceReplayer()
+    {
+      m_device.getDevice().waitIdle();
+      m_uniformBuffer.cleanup();
+    }
+
+    /**
+     * @brief Один проход по всем кадрам трассы
+     * @return Время до завершения последнего кадра на GPU и объём работы
+     */
+    ReplayStats run()
+    {
+      ReplayStats stats;
+      auto        start = std::chrono::steady_clock::now();
+      for (const TraceFrame& frame : m_trace.frames)
+      {
+        replayFrame(frame);
+        stats.frames++;
+        stats.draws += m_frameStats.draws;
+        stats.triangles += m_frameStats.triangles;
+      }
+      m_device.getGraphicsQueue().waitIdle();
+      stats.seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return stats;
+    }
+
+  private:
+    // Конвейер трассы с собственным layout'ом
+    struct ReplayPipeline
+    {
+      vk::UniquePipelineLayout layout;
+      vk::UniquePipeline       pipeline;
+      bool                     frameUniforms = false;
+    };
+
+    VulkanDevice&       m_device;
+    const CommandTrace& m_trace;
+    VulkanUniformBuffer m_uniformBuffer;
+    VulkanRenderGraph   m_graph;
+    VulkanRenderQueue   m_renderQueue;
+
+    vk::UniqueCommandPool          m_vkCommandPool;
+    std::vector<vk::CommandBuffer> m_vkCommandBuffers;  // По кадру в обработке
+    std::vector<vk::UniqueFence>   m_vkFences;
+    uint32_t                       m_frameSlot = 0;
+
+    std::vector<vk::UniqueBuffer>    m_vkBuffers;  // Индекс - идентификатор буфера трассы
+    std::vector<TrackedDeviceMemory> m_vkBufferMemory;
+    std::vector<ReplayPipeline>      m_pipelines;  // Индекс - идентификатор конвейера трассы
+
+    RenderGraphResource m_colorTarget;
+    RenderGraphResource m_depthTarget;
+    bool                m_hasDepth = false;
+    vk::Extent2D        m_extent;  // Размер текущего кадра трассы
+    RenderQueueStats    m_frameStats;
+
+    // Смещения блоков трассы -> смещения в uniform-буфере воспроизведения
+    std::vector<std::pair<uint32_t, uint32_t>> m_uniformOffsets;
+
+    void createCommands()
+    {
+      vk::Device vkDevice = m_device.getDevice();
+
+      vk::CommandPoolCreateInfo poolInfo = {};
+      poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+      poolInfo.queueFamilyIndex          = m_device.getQueueFamilyIndices().graphicsFamily.value();
+      m_vkCommandPool                    = vkDevice.createCommandPoolUnique(poolInfo);
+
+      vk::CommandBufferAllocateInfo allocInfo = {};
+      allocInfo.commandPool                   = *m_vkCommandPool;
+      allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+      allocInfo.commandBufferCount            = FRAMES_IN_FLIGHT;
+      m_vkCommandBuffers                      = vkDevice.allocateCommandBuffers(allocInfo);
+
+      for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+      {
+        m_vkFences.push_back(
+            vkDevice.createFenceUnique(vk::FenceCreateInfo(vk::FenceCreateFlagBits::eSignaled)));
+      }
+    }
+
+    void uploadBuffers()
+    {
+      vk::Device vkDevice = m_device.getDevice();
+
+      // Все буферы копируются через один стадийный буфер одной отправкой
+      vk::DeviceSize totalSize = 0;
+      for (const TraceBuffer& buffer : m_trace.buffers)
+      {
+        totalSize += buffer.data.size();
+      }
+      if (totalSize == 0)
+      {
+        return;
+      }
+
+      vk::UniqueBuffer    stagingBuffer;
+      TrackedDeviceMemory stagingMemory;
+      m_device.createBuffer(
+          totalSize, vk::BufferUsageFlagBits::eTransferSrc,
+          vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+          stagingBuffer, stagingMemory, MemoryCategory::Staging);
+
+      auto* mapped =
+          static_cast<uint8_t*>(vkDevice.mapMemory(*stagingMemory, 0, totalSize, {}));
+
+      vk::CommandBuffer commandBuffer = m_vkCommandBuffers[0];
+      commandBuffer.begin(
+          vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+      m_vkBuffers.resize(m_trace.buffers.size());
+      m_vkBufferMemory.resize(m_trace.buffers.size());
+      vk::DeviceSize offset = 0;
+      for (const TraceBuffer& buffer : m_trace.buffers)
+      {
+        if (buffer.id >= m_trace.buffers.size() || buffer.data.empty())
+        {
+          throw std::runtime_error("Неверный буфер трассы " + std::to_string(buffer.id));
+        }
+
+        vk::BufferUsageFlags usage =
+            vk::BufferUsageFlags(buffer.usage) | vk::BufferUsageFlagBits::eTransferDst;
+        m_device.createBuffer(buffer.data.size(), usage, vk::MemoryPropertyFlagBits::eDeviceLocal,
+                              m_vkBuffers[buffer.id], m_vkBufferMemory[buffer.id]);
+
+        memcpy(mapped + offset, buffer.data.data(), buffer.data.size());
+        vk::BufferCopy region = {};
+        region.srcOffset      = offset;
+        region.size           = buffer.data.size();
+        commandBuffer.copyBuffer(*stagingBuffer, *m_vkBuffers[buffer.id], region);
+        offset += buffer.data.size();
+      }
+
+      vkDevice.unmapMemory(*stagingMemory);
+      commandBuffer.end();
+
+      vk::SubmitInfo submitInfo     = {};
+      submitInfo.commandBufferCount = 1;
+      submitInfo.pCommandBuffers    = &commandBuffer;
+      m_device.getGraphicsQueue().submit(submitInfo, nullptr);
+      m_device.getGraphicsQueue().waitIdle();
+      commandBuffer.reset();
+    }
+
+    void createPipelines()
+    {
+      vk::Device              vkDevice    = m_device.getDevice();
+      vk::Format              colorFormat = static_cast<vk::Format>(m_trace.target.colorFormat);
+      vk::Format              depthFormat = static_cast<vk::Format>(m_trace.target.depthFormat);
+      vk::DescriptorSetLayout setLayout   = m_uniformBuffer.getDescriptorSetLayout();
+
+      m_pipelines.resize(m_trace.pipelines.size());
+      for (const TracePipeline& traced : m_trace.pipelines)
+      {
+        if (traced.id >= m_trace.pipelines.size())
+        {
+          throw std::runtime_error("Неверный конвейер трассы " + std::to_string(traced.id));
+        }
+
+        vk::UniqueShaderModule vertModule = loadShader(vkDevice, traced.vertexShader);
+        vk::UniqueShaderModule fragModule = loadShader(vkDevice, traced.fragmentShader);
+
+        vk::PipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].stage                             = vk::ShaderStageFlagBits::eVertex;
+        stages[0].module                            = *vertModule;
+        stages[0].pName                             = "main";
+        stages[1].stage                             = vk::ShaderStageFlagBits::eFragment;
+        stages[1].module                            = *fragModule;
+        stages[1].pName                             = "main";
+
+        vk::VertexInputBindingDescription bindingDescription(0, traced.vertexStride);
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions;
+        for (const TraceVertexAttribute& attribute : traced.attributes)
+        {
+          attributeDescriptions.emplace_back(
+              attribute.location, 0, static_cast<vk::Format>(attribute.format), attribute.offset);
+        }
+
+        vk::PipelineVertexInputStateCreateInfo vertexInput = {};
+        if (traced.vertexStride > 0)
+        {
+          vertexInput.vertexBindingDescriptionCount = 1;
+          vertexInput.pVertexBindingDescriptions    = &bindingDescription;
+        }
+        vertexInput.vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(attributeDescriptions.size());
+        vertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
+        inputAssembly.topology = static_cast<vk::PrimitiveTopology>(traced.topology);
+
+        vk::PipelineViewportStateCreateInfo viewportState = {};
+        viewportState.viewportCount                       = 1;
+        viewportState.scissorCount                        = 1;
+
+        vk::PipelineRasterizationStateCreateInfo rasterizer = {};
+        rasterizer.polygonMode                              = vk::PolygonMode::eFill;
+        rasterizer.cullMode  = static_cast<vk::CullModeFlags>(traced.cullMode);
+        rasterizer.frontFace = static_cast<vk::FrontFace>(traced.frontFace);
+        rasterizer.lineWidth = 1.0f;
+
+        vk::PipelineMultisampleStateCreateInfo multisampling = {};
+        multisampling.rasterizationSamples =
+            static_cast<vk::SampleCountFlagBits>(m_trace.target.samples);
+
+        vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
+        depthStencil.depthTestEnable                         = traced.depthTest;
+        depthStencil.depthWriteEnable                        = traced.depthWrite;
+        depthStencil.depthCompareOp = static_cast<vk::CompareOp>(traced.depthCompareOp);
+
+        vk::PipelineColorBlendAttachmentState blendAttachment = {};
+        blendAttachment.blendEnable                           = traced.blendEnable;
+        blendAttachment.srcColorBlendFactor = static_cast<vk::BlendFactor>(traced.srcColorFactor);
+        blendAttachment.dstColorBlendFactor = static_cast<vk::BlendFactor>(traced.dstColorFactor);
+        blendAttachment.colorBlendOp        = static_cast<vk::BlendOp>(traced.colorBlendOp);
+        blendAttachment.srcAlphaBlendFactor = static_cast<vk::BlendFactor>(traced.srcAlphaFactor);
+        blendAttachment.dstAlphaBlendFactor = static_cast<vk::BlendFactor>(traced.dstAlphaFactor);
+        blendAttachment.alphaBlendOp        = static_cast<vk::BlendOp>(traced.alphaBlendOp);
+        blendAttachment.colorWriteMask =
+            static_cast<vk::ColorComponentFlags>(traced.colorWriteMask);
+
+        vk::PipelineColorBlendStateCreateInfo colorBlending = {};
+        colorBlending.attachmentCount                       = 1;
+        colorBlending.pAttachments                          = &blendAttachment;
+
+        vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                              vk::DynamicState::eScissor};
+        vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+        dynamicState.dynamicStateCount                     = 2;
+        dynamicState.pDynamicStates                        = dynamicStates;
+
+        vk::PipelineRenderingCreateInfo renderingInfo = {};
+        renderingInfo.colorAttachmentCount            = 1;
+        renderingInfo.pColorAttachmentFormats         = &colorFormat;
+        renderingInfo.depthAttachmentFormat           = depthFormat;
+
+        ReplayPipeline& pipeline = m_pipelines[traced.id];
+        pipeline.frameUniforms   = traced.frameUniforms != 0;
+
+        vk::PipelineLayoutCreateInfo layoutInfo = {};
+        if (pipeline.frameUniforms)
+        {
+          layoutInfo.setLayoutCount = 1;
+          layoutInfo.pSetLayouts    = &setLayout;
+        }
+        pipeline.layout = vkDevice.createPipelineLayoutUnique(layoutInfo);
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.pNext                          = &renderingInfo;
+        pipelineInfo.stageCount                     = 2;
+        pipelineInfo.pStages                        = stages;
+        pipelineInfo.pVertexInputState              = &vertexInput;
+        pipelineInfo.pInputAssemblyState            = &inputAssembly;
+        pipelineInfo.pViewportState                 = &viewportState;
+        pipelineInfo.pRasterizationState            = &rasterizer;
+        pipelineInfo.pMultisampleState              = &multisampling;
+        pipelineInfo.pDepthStencilState             = &depthStencil;
+        pipelineInfo.pColorBlendState               = &colorBlending;
+        pipelineInfo.pDynamicState                  = &dynamicState;
+        pipelineInfo.layout                         = *pipeline.layout;
+
+        pipeline.pipeline =
+            std::move(vkDevice.createGraphicsPipelineUnique(nullptr, pipelineInfo).value);
+      }
+    }
+
+    void createRenderGraph()
+    {
+      // Цель - по наибольшему кадру трассы, меньшие кадры рисуются в её угол
+      vk::Extent2D targetExtent = {1, 1};
+      for (const TraceFrame& frame : m_trace.frames)
+      {
+        targetExtent.width  = std::max(targetExtent.width, frame.width);
+        targetExtent.height = std::max(targetExtent.height, frame.height);
+      }
+
+      vk::SampleCountFlagBits samples =
+          static_cast<vk::SampleCountFlagBits>(m_trace.target.samples);
+
+      RenderGraphImageDesc colorDesc = {};
+      colorDesc.format               = static_cast<vk::Format>(m_trace.target.colorFormat);
+      colorDesc.extent               = targetExtent;
+      colorDesc.usage                = vk::ImageUsageFlagBits::eColorAttachment;
+      colorDesc.samples              = samples;
+      m_colorTarget                  = m_graph.createImage("color", colorDesc);
+
+      m_hasDepth = m_trace.target.depthFormat != static_cast<uint32_t>(vk::Format::eUndefined);
+      if (m_hasDepth)
+      {
+        RenderGraphImageDesc depthDesc = {};
+        depthDesc.format               = static_cast<vk::Format>(m_trace.target.depthFormat);
+        depthDesc.extent               = targetExtent;
+        depthDesc.usage                = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+        depthDesc.samples              = samples;
+        depthDesc.aspect               = vk::ImageAspectFlagBits::eDepth;
+        m_depthTarget                  = m_graph.createImage("depth", depthDesc);
+      }
+
+      uint32_t pass = m_graph.addPass("replay", [this](vk::CommandBuffer cmd) {
+        vk::ClearValue clearColor;
+        clearColor.color = vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
+        vk::ClearValue clearDepth;
+        clearDepth.depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
+
+        vk::RenderingAttachmentInfo colorAttachment = {};
+        colorAttachment.imageView                   = m_graph.getImageView(m_colorTarget);
+        colorAttachment.imageLayout                 = vk::ImageLayout::eColorAttachmentOptimal;
+        colorAttachment.loadOp                      = vk::AttachmentLoadOp::eClear;
+        colorAttachment.storeOp                     = vk::AttachmentStoreOp::eStore;
+        colorAttachment.clearValue                  = clearColor;
+
+        vk::RenderingAttachmentInfo depthAttachment = {};
+        if (m_hasDepth)
+        {
+          depthAttachment.imageView   = m_graph.getImageView(m_depthTarget);
+          depthAttachment.imageLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+          depthAttachment.loadOp      = vk::AttachmentLoadOp::eClear;
+          depthAttachment.storeOp     = vk::AttachmentStoreOp::eDontCare;
+          depthAttachment.clearValue  = clearDepth;
+        }
+
+        vk::RenderingInfo renderingInfo    = {};
+        renderingInfo.renderArea.extent    = m_extent;
+        renderingInfo.layerCount           = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments    = &colorAttachment;
+        renderingInfo.pDepthAttachment     = m_hasDepth ? &depthAttachment : nullptr;
+
+        vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(m_extent.width),
+                              static_cast<float>(m_extent.height), 0.0f, 1.0f);
+        vk::Rect2D   scissor({0, 0}, m_extent);
+
+        cmd.beginRendering(renderingInfo);
+        cmd.setViewport(0, viewport);
+        cmd.setScissor(0, scissor);
+        m_frameStats = m_renderQueue.execute(cmd);
+        cmd.endRendering();
+      });
+      m_graph.use(pass, m_colorTarget, RenderGraphAccess::ColorAttachmentWrite);
+      if (m_hasDepth)
+      {
+        m_graph.use(pass, m_depthTarget, RenderGraphAccess::DepthAttachmentWrite);
+      }
+      m_graph.markOutput(m_colorTarget);
+      m_graph.compile();
+    }
+
+    uint32_t remapUniform(uint32_t traceOffset) const
+    {
+      for (const auto& [from, to] : m_uniformOffsets)
+      {
+        if (from == traceOffset)
+        {
+          return to;
+        }
+      }
+      throw std::runtime_error("Смещение " + std::to_string(traceOffset) +
+                               " не указывает на uniform-данные кадра трассы");
+    }
+
+    const vk::UniqueBuffer& getBuffer(uint32_t id) const
+    {
+      if (id >= m_vkBuffers.size())
+      {
+        throw std::runtime_error("Draw-вызов ссылается на неизвестный буфер " + std::to_string(id));
+      }
+      return m_vkBuffers[id];
+    }
+
+    void replayFrame(const TraceFrame& frame)
+    {
+      vk::Device vkDevice = m_device.getDevice();
+      vk::Fence  fence    = *m_vkFences[m_frameSlot];
+      if (vkDevice.waitForFences(fence, VK_TRUE, UINT64_MAX) != vk::Result::eSuccess)
+      {
+        throw std::runtime_error("Ошибка ожидания кадра");
+      }
+      vkDevice.resetFences(fence);
+
+      // Область слота свободна: блоки кадра копируются заново с выравниванием этого устройства
+      m_uniformBuffer.beginFrame(m_frameSlot);
+      m_uniformOffsets.clear();
+      for (const TraceUniformBlock& block : frame.uniforms)
+      {
+        uint32_t offset = m_uniformBuffer.pushBytes(block.data.data(), block.data.size());
+        m_uniformOffsets.emplace_back(block.offset, offset);
+      }
+
+      // Порядок трассы уже отсортирован рендерером, поэтому очередь не сортируется
+      m_renderQueue.clear();
+      for (const TraceDraw& draw : frame.draws)
+      {
+        if (draw.pipeline >= m_pipelines.size())
+        {
+          throw std::runtime_error("Draw-вызов ссылается на неизвестный конвейер " +
+                                   std::to_string(draw.pipeline));
+        }
+        const ReplayPipeline& pipeline = m_pipelines[draw.pipeline];
+
+        DrawPacket packet     = {};
+        packet.pipeline       = *pipeline.pipeline;
+        packet.pipelineLayout = *pipeline.layout;
+        packet.topology       = static_cast<vk::PrimitiveTopology>(
+            m_trace.pipelines[draw.pipeline].topology);
+        if (pipeline.frameUniforms)
+        {
+          packet.descriptorSet      = m_uniformBuffer.getDescriptorSet();
+          packet.dynamicOffsetCount = draw.dynamicOffsetCount;
+          for (uint32_t i = 0; i < draw.dynamicOffsetCount; i++)
+          {
+            packet.dynamicOffsets[i] = remapUniform(draw.dynamicOffsets[i]);
+          }
+        }
+        if (draw.vertexBuffer != TraceDraw::NO_BUFFER)
+        {
+          packet.vertexBuffer = *getBuffer(draw.vertexBuffer);
+        }
+        if (draw.indexBuffer != TraceDraw::NO_BUFFER)
+        {
+          packet.indexBuffer = *getBuffer(draw.indexBuffer);
+        }
+        packet.count         = draw.count;
+        packet.instanceCount = draw.instanceCount;
+        packet.firstVertex   = draw.firstVertex;
+        packet.vertexOffset  = draw.vertexOffset;
+        m_renderQueue.push(packet);
+      }
+
+      m_extent = vk::Extent2D{std::max(frame.width, 1u), std::max(frame.height, 1u)};
+
+      vk::CommandBuffer commandBuffer = m_vkCommandBuffers[m_frameSlot];
+      commandBuffer.reset();
+      commandBuffer.begin(
+          vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+      m_graph.execute(commandBuffer);
+      commandBuffer.end();
+
+      vk::SubmitInfo submitInfo     = {};
+      submitInfo.commandBufferCount = 1;
+      submitInfo.pCommandBuffers    = &commandBuffer;
+      m_device.getGraphicsQueue().submit(submitInfo, fence);
+
+      m_frameSlot = (m_frameSlot + 1) % FRAMES_IN_FLIGHT;
+    }
+  };
+
+  void printUsage()
+  {
+    std::cout << "Использование: vkapireplay <трасса> [--loops <N>]" << std::endl
+              << "  Трасса записывается рендерером при VKAPI_TRACE_FILE=<файл>" << std::endl
+              << "  (VKAPI_TRACE_FRAMES - количество кадров). Запуск из корня репозитория."
+              << std::endl;
+  }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string tracePath;
+  uint32_t    loops = DEFAULT_LOOPS;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+    {
+      loops = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+    }
+    else if (tracePath.empty() && argv[i][0] != '-')
+    {
+      tracePath = argv[i];
+    }
+    else
+    {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (tracePath.empty())
+  {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    CommandTrace trace = CommandTrace::load(tracePath);
+    if (trace.frames.empty())
+    {
+      throw std::runtime_error("В трассе нет кадров");
+    }
+
+    vk::UniqueInstance   instance = createHeadlessInstance();
+    vk::UniqueSurfaceKHR surface  = createHeadlessSurface(*instance);
+
+    VulkanDevice device(*instance, *surface);
+    if (device.init() != 0)
+    {
+      throw std::runtime_error("Не удалось инициализировать VulkanDevice");
+    }
+
+    vk::PhysicalDeviceProperties properties = device.getPhysicalDevice().getProperties();
+    std::cout << "Трасса " << tracePath << ": " << trace.frames.size() << " кадров, "
+              << trace.pipelines.size() << " конвейеров, " << trace.buffers.size()
+              << " буферов" << std::endl;
+    std::cout << "Устройство: " << properties.deviceName.data() << std::endl;
+
+    TraceReplayer replayer(device, trace);
+
+    // Первый проход прогревает драйвер (компиляция шейдеров, выделение памяти) и не учитывается
+    replayer.run();
+
+    ReplayStats total;
+    double      bestSeconds = 0.0;
+    for (uint32_t loop = 0; loop < loops; loop++)
+    {
+      ReplayStats stats = replayer.run();
+      total.frames += stats.frames;
+      total.draws += stats.draws;
+      total.triangles += stats.triangles;
+      total.seconds += stats.seconds;
+      bestSeconds = loop == 0 ? stats.seconds : std::min(bestSeconds, stats.seconds);
+    }
+
+    double framesPerLoop = static_cast<double>(trace.frames.size());
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Проходов: " << loops << ", кадров: " << total.frames << std::endl;
+    std::cout << "Среднее время кадра: " << total.seconds * 1000.0 / total.frames << " мс ("
+              << std::setprecision(1) << total.frames / total.seconds << " кадров/с)" << std::endl;
+    std::cout << std::setprecision(3) << "Лучший проход: " << bestSeconds * 1000.0 / framesPerLoop
+              << " мс/кадр" << std::endl;
+    std::cout << "На кадр: " << total.draws / total.frames << " draw-вызовов, "
+              << total.triangles / total.frames << " треугольников" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка воспроизведения: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,9 @@
+#version 450
+// Атлас шрифта (R8): покрытие символа умножается на альфу цвета вершины
+layout(set = 0, binding = 0) uniform sampler2D fontAtlas;
+layout(location = 0) in vec2 fragUv;
+layout(location = 1) in vec4 fragColor;
+layout(location = 0) out vec4 outColor;
+void main() {
+    outColor = vec4(fragColor.rgb, fragColor.a * texture(fontAtlas, fragUv).r);
+}
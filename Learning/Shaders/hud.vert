@@ -0,0 +1,15 @@
+#version 450
+// Пиксели от левого верхнего угла переводятся в NDC: scale = 2 / размер цели
+layout(push_constant) uniform HudParams {
+    vec2 scale;
+} params;
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUv;
+layout(location = 2) in vec4 inColor;
+layout(location = 0) out vec2 fragUv;
+layout(location = 1) out vec4 fragColor;
+void main() {
+    gl_Position = vec4(inPosition * params.scale - 1.0, 0.0, 1.0);
+    fragUv = inUv;
+    fragColor = inColor;
+}
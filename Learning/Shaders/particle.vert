@@ -0,0 +1,17 @@
+#version 450
+layout(set = 0, binding = 0) uniform FrameConstants {
+    mat4 viewProj;
+    vec4 params;
+} frame;
+layout(set = 0, binding = 1) uniform ObjectConstants {
+    mat4 model;
+} object;
+// Буфер частиц, прочитанный как буфер вершин
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 0) out vec3 fragColor;
+void main() {
+    gl_Position = frame.viewProj * object.model * vec4(inPosition, 0.0, 1.0);
+    gl_PointSize = 1.0;
+    fragColor = inColor.rgb;
+}
\ No newline at end of file
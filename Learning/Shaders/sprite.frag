@@ -0,0 +1,9 @@
+#version 450
+// Страница атласа спрайтов, цвет вершины умножается на текстуру
+layout(set = 0, binding = 0) uniform sampler2D atlasPage;
+layout(location = 0) in vec2 fragUv;
+layout(location = 1) in vec4 fragColor;
+layout(location = 0) out vec4 outColor;
+void main() {
+    outColor = fragColor * texture(atlasPage, fragUv);
+}
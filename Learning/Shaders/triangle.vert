@@ -1,8 +1,18 @@
 #version 450
+layout(set = 0, binding = 0) uniform FrameConstants {
+    mat4 viewProj;
+    vec4 params;
+} frame;
+layout(set = 0, binding = 1) uniform ObjectConstants {
+    mat4 model;
+} object;
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 0) out vec3 fragColor;
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
-    fragColor = inColor;
-} 
\ No newline at end of file
+    gl_Position = frame.viewProj * object.model * vec4(inPosition, 0.0, 1.0);
+    // Пульсация каналов цвета со сдвигом фазы на треть периода: результат линеен
+    // по inColor, поэтому не зависит от того, на сколько треугольников разбит меш
+    vec3 phase = frame.params.x * 6.28 + vec3(0.0, 2.09, 4.18);
+    fragColor = inColor * (0.5 + 0.5 * sin(phase));
+}
\ No newline at end of file
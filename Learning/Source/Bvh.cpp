@@ -0,0 +1,693 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "FrustumCuller.h"
+
+namespace
+{
+  const uint32_t BIN_COUNT      = 16;    // Корзин SAH на ось
+  const float    TRAVERSAL_COST = 2.0f;  // Спуск в узел относительно проверки примитива
+
+  struct Bin
+  {
+    Aabb     bounds;     // Границы примитивов корзины
+    Aabb     centroids;  // Границы их центров (центры детей после разбиения)
+    uint32_t count = 0;
+  };
+
+  using BinSet = std::array<Bin, 3 * BIN_COUNT>;
+
+  // Примитив при сборке: границы переставляются вместе с индексом и читаются подряд
+  struct BuildItem
+  {
+    Aabb     bounds;
+    uint32_t primitive;
+
+    glm::vec3 getCentroid() const { return (bounds.min + bounds.max) * 0.5f; }
+  };
+
+  // Корзина центра по оси: scale = BIN_COUNT / протяжённость центров (0 - ось вырождена)
+  uint32_t binIndex(float value, float origin, float scale)
+  {
+    return std::min(BIN_COUNT - 1, static_cast<uint32_t>((value - origin) * scale));
+  }
+
+  void binRange(const BuildItem* items, uint32_t begin, uint32_t end, const glm::vec3& origin,
+                const glm::vec3& scale, BinSet& bins)
+  {
+    for (uint32_t i = begin; i < end; i++)
+    {
+      glm::vec3 centroid = items[i].getCentroid();
+      for (uint32_t axis = 0; axis < 3; axis++)
+      {
+        Bin& bin = bins[axis * BIN_COUNT + binIndex(centroid[axis], origin[axis], scale[axis])];
+        bin.bounds.grow(items[i].bounds);
+        bin.centroids.grow(centroid);
+        bin.count++;
+      }
+    }
+  }
+
+  // parallelFor в пуле или весь диапазон одним блоком
+  uint32_t runChunks(ThreadPool* pool, uint32_t count, uint32_t minChunk,
+                     const std::function<void(uint32_t, uint32_t, uint32_t)>& fn)
+  {
+    if (!pool)
+    {
+      fn(0, count, 0);
+      return 1;
+    }
+    return pool->parallelFor(count, minChunk, fn);
+  }
+
+  Aabb getNodeBounds(const BvhNode& node)
+  {
+    Aabb bounds;
+    bounds.min = glm::vec3(node.min[0], node.min[1], node.min[2]);
+    bounds.max = glm::vec3(node.max[0], node.max[1], node.max[2]);
+    return bounds;
+  }
+
+  void setNodeBounds(BvhNode& node, const Aabb& bounds)
+  {
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      node.min[axis] = bounds.min[axis];
+      node.max[axis] = bounds.max[axis];
+    }
+  }
+
+  // Положение параллелепипеда относительно пирамиды видимости
+  enum class FrustumSide
+  {
+    Outside,
+    Intersects,
+    Inside
+  };
+
+  FrustumSide classify(const float planes[6][4], const float* min, const float* max)
+  {
+    FrustumSide side = FrustumSide::Inside;
+    for (uint32_t p = 0; p < 6; p++)
+    {
+      const float* plane    = planes[p];
+      float        distance = plane[3];
+      float        reach    = 0.0f;
+      for (uint32_t axis = 0; axis < 3; axis++)
+      {
+        float center  = (min[axis] + max[axis]) * 0.5f;
+        float extent  = (max[axis] - min[axis]) * 0.5f;
+        distance     += plane[axis] * center;
+        reach        += std::fabs(plane[axis]) * extent;
+      }
+
+      if (distance + reach < 0.0f)
+      {
+        return FrustumSide::Outside;
+      }
+      if (distance - reach < 0.0f)
+      {
+        side = FrustumSide::Intersects;
+      }
+    }
+    return side;
+  }
+
+  // Вход луча в параллелепипед (метод плит): tEntry в [0, maxDistance]
+  bool intersectRay(const float* min, const float* max, const glm::vec3& origin,
+                    const glm::vec3& inverseDirection, float maxDistance, float& tEntry)
+  {
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      float t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+      float t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+      tMin     = std::max(tMin, std::min(t0, t1));
+      tMax     = std::min(tMax, std::max(t0, t1));
+    }
+    tEntry = tMin;
+    return tMin <= tMax;
+  }
+
+  /**
+   * @brief Стек обхода дерева: на месте при обычной глубине, в куче - для вырожденных
+   * деревьев. Обход кладёт не больше одного отложенного узла на уровень
+   */
+  template <typename T>
+  class TraversalStack
+  {
+  public:
+    explicit TraversalStack(uint32_t depth)
+    {
+      if (depth + 1 > INLINE_SIZE)
+      {
+        m_heap.resize(depth + 1);
+        m_data = m_heap.data();
+      }
+    }
+
+    TraversalStack(const TraversalStack&)            = delete;
+    TraversalStack& operator=(const TraversalStack&) = delete;
+
+    void push(const T& value) { m_data[m_size++] = value; }
+    T    pop() { return m_data[--m_size]; }
+    bool empty() const { return m_size == 0; }
+
+  private:
+    static const uint32_t INLINE_SIZE = 64;
+
+    T              m_inline[INLINE_SIZE];
+    std::vector<T> m_heap;
+    T*             m_data = m_inline;
+    uint32_t       m_size = 0;
+  };
+
+  struct FrustumEntry
+  {
+    uint32_t node;
+    bool     inside;  // Узел целиком внутри: потомки принимаются без проверок
+  };
+
+  struct RayEntry
+  {
+    uint32_t node;
+    float    tEntry;
+  };
+}  // namespace
+
+// Общее состояние сборки: примитивы в порядке листьев и узлы в порядке выделения
+struct Bvh::BuildContext
+{
+  std::vector<BuildItem>     items;
+  std::unique_ptr<BvhNode[]> nodes;  // 2N - 1 узлов без инициализации: страницы по мере записи
+  std::atomic<uint32_t>      nodeCount{1};
+};
+
+// Узел, ожидающий разбиения, с границами примитивов и их центров
+struct Bvh::BuildTask
+{
+  uint32_t node  = 0;
+  uint32_t first = 0;
+  uint32_t count = 0;
+  Aabb     bounds;
+  Aabb     centroids;
+};
+
+Bvh::Bvh(ThreadPool* pool) : m_pool(pool) {}
+
+void Bvh::build(const std::vector<Aabb>& bounds)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  uint32_t count = static_cast<uint32_t>(bounds.size());
+  m_bounds       = bounds;
+  m_primitives.resize(count);
+  m_leafOf.assign(count, 0);
+  m_nodes.clear();
+  m_parents.clear();
+  m_dirty.clear();
+  m_stats = {};
+  if (count == 0)
+  {
+    return;
+  }
+
+  BuildContext context;
+  context.items.resize(count);
+  context.nodes.reset(new BvhNode[2 * static_cast<size_t>(count) - 1]);
+
+  // Примитивы сборки и границы корня
+  std::vector<BuildTask> chunkRoots(m_pool ? m_pool->getMaxChunks() : 1);
+  uint32_t               chunks = runChunks(
+      m_pool, count, PARALLEL_BINNING,
+      [&](uint32_t begin, uint32_t end, uint32_t chunk)
+      {
+        BuildTask& root = chunkRoots[chunk];
+        for (uint32_t i = begin; i < end; i++)
+        {
+          context.items[i] = {m_bounds[i], i};
+          root.bounds.grow(m_bounds[i]);
+          root.centroids.grow(context.items[i].getCentroid());
+        }
+      });
+
+  BuildTask root;
+  root.count = count;
+  for (uint32_t chunk = 0; chunk < chunks; chunk++)
+  {
+    root.bounds.grow(chunkRoots[chunk].bounds);
+    root.centroids.grow(chunkRoots[chunk].centroids);
+  }
+
+  buildSubtree(context, root);
+  flatten(context);
+
+  m_stats.primitives = count;
+  m_stats.nodes      = static_cast<uint32_t>(m_nodes.size());
+  m_stats.buildMs    =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Bvh::setBounds(uint32_t primitive, const Aabb& bounds)
+{
+  m_bounds[primitive]          = bounds;
+  m_dirty[m_leafOf[primitive]] = 1;
+}
+
+void Bvh::refit()
+{
+  auto start = std::chrono::steady_clock::now();
+
+  // Дети всегда лежат дальше родителя: проход с конца видит их уже пересчитанными
+  for (uint32_t i = static_cast<uint32_t>(m_nodes.size()); i-- > 0;)
+  {
+    if (!m_dirty[i])
+    {
+      continue;
+    }
+    m_dirty[i] = 0;
+
+    BvhNode& node = m_nodes[i];
+    Aabb     bounds;
+    if (node.count > 0)
+    {
+      for (uint32_t k = node.leftOrFirst; k < node.leftOrFirst + node.count; k++)
+      {
+        bounds.grow(m_bounds[m_primitives[k]]);
+      }
+    }
+    else
+    {
+      bounds.grow(getNodeBounds(m_nodes[node.leftOrFirst]));
+      bounds.grow(getNodeBounds(m_nodes[node.leftOrFirst + 1]));
+    }
+    setNodeBounds(node, bounds);
+
+    if (i > 0)
+    {
+      m_dirty[m_parents[i]] = 1;
+    }
+  }
+
+  m_stats.refitMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Bvh::queryFrustum(const glm::mat4& viewProj, std::vector<uint32_t>& result) const
+{
+  result.clear();
+  if (m_nodes.empty())
+  {
+    return;
+  }
+
+  float planes[6][4];
+  FrustumCuller::extractPlanes(viewProj, planes);
+
+  TraversalStack<FrustumEntry> stack(m_stats.depth);
+  stack.push({0, false});
+  while (!stack.empty())
+  {
+    FrustumEntry   entry  = stack.pop();
+    const BvhNode& node   = m_nodes[entry.node];
+    bool           inside = entry.inside;
+    if (!inside)
+    {
+      FrustumSide side = classify(planes, node.min, node.max);
+      if (side == FrustumSide::Outside)
+      {
+        continue;
+      }
+      inside = side == FrustumSide::Inside;
+    }
+
+    if (node.count == 0)
+    {
+      stack.push({node.leftOrFirst + 1, inside});
+      stack.push({node.leftOrFirst, inside});
+      continue;
+    }
+
+    for (uint32_t k = node.leftOrFirst; k < node.leftOrFirst + node.count; k++)
+    {
+      uint32_t    primitive = m_primitives[k];
+      const Aabb& bounds    = m_bounds[primitive];
+      if (inside || classify(planes, &bounds.min.x, &bounds.max.x) != FrustumSide::Outside)
+      {
+        result.push_back(primitive);
+      }
+    }
+  }
+}
+
+uint32_t Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                      float* hitDistance) const
+{
+  glm::vec3 inverseDirection = 1.0f / direction;
+  float     best             = maxDistance;
+  uint32_t  hit              = BVH_NO_HIT;
+  float     tEntry           = 0.0f;
+  if (m_nodes.empty() ||
+      !intersectRay(m_nodes[0].min, m_nodes[0].max, origin, inverseDirection, best, tEntry))
+  {
+    return BVH_NO_HIT;
+  }
+
+  TraversalStack<RayEntry> stack(m_stats.depth);
+  stack.push({0, tEntry});
+  while (!stack.empty())
+  {
+    // Узел дальше уже найденного попадания отбрасывается без чтения
+    RayEntry entry = stack.pop();
+    if (entry.tEntry > best)
+    {
+      continue;
+    }
+
+    const BvhNode& node = m_nodes[entry.node];
+    if (node.count > 0)
+    {
+      for (uint32_t k = node.leftOrFirst; k < node.leftOrFirst + node.count; k++)
+      {
+        const Aabb& bounds = m_bounds[m_primitives[k]];
+        if (intersectRay(&bounds.min.x, &bounds.max.x, origin, inverseDirection, best, tEntry) &&
+            (hit == BVH_NO_HIT || tEntry < best))
+        {
+          best = tEntry;
+          hit  = m_primitives[k];
+        }
+      }
+      continue;
+    }
+
+    // Ближний ребёнок кладётся последним и обходится первым
+    RayEntry children[2] = {{node.leftOrFirst, 0.0f}, {node.leftOrFirst + 1, 0.0f}};
+    bool     hits[2];
+    for (uint32_t c = 0; c < 2; c++)
+    {
+      const BvhNode& child = m_nodes[children[c].node];
+      hits[c] = intersectRay(child.min, child.max, origin, inverseDirection, best,
+                             children[c].tEntry);
+    }
+    uint32_t nearest = hits[1] && (!hits[0] || children[1].tEntry < children[0].tEntry) ? 1 : 0;
+    if (hits[1 - nearest])
+    {
+      stack.push(children[1 - nearest]);
+    }
+    if (hits[nearest])
+    {
+      stack.push(children[nearest]);
+    }
+  }
+
+  if (hitDistance && hit != BVH_NO_HIT)
+  {
+    *hitDistance = best;
+  }
+  return hit;
+}
+
+void Bvh::queryAabb(const Aabb& area, std::vector<uint32_t>& result) const
+{
+  result.clear();
+  if (m_nodes.empty())
+  {
+    return;
+  }
+
+  TraversalStack<uint32_t> stack(m_stats.depth);
+  stack.push(0);
+  while (!stack.empty())
+  {
+    const BvhNode& node = m_nodes[stack.pop()];
+    if (!getNodeBounds(node).overlaps(area))
+    {
+      continue;
+    }
+
+    if (node.count == 0)
+    {
+      stack.push(node.leftOrFirst + 1);
+      stack.push(node.leftOrFirst);
+      continue;
+    }
+
+    for (uint32_t k = node.leftOrFirst; k < node.leftOrFirst + node.count; k++)
+    {
+      if (m_bounds[m_primitives[k]].overlaps(area))
+      {
+        result.push_back(m_primitives[k]);
+      }
+    }
+  }
+}
+
+void Bvh::buildSubtree(BuildContext& context, const BuildTask& root)
+{
+  // Мелкие поддеревья достраиваются на месте явным стеком, крупные - параллельно
+  std::vector<BuildTask> stack = {root};
+  while (!stack.empty())
+  {
+    BuildTask task = stack.back();
+    stack.pop_back();
+
+    BuildTask children[2];
+    if (!splitNode(context, task, children))
+    {
+      continue;
+    }
+
+    if (m_pool && task.count >= PARALLEL_SUBTREE)
+    {
+      m_pool->parallelFor(2, 1,
+                          [&](uint32_t begin, uint32_t end, uint32_t)
+                          {
+                            for (uint32_t c = begin; c < end; c++)
+                            {
+                              buildSubtree(context, children[c]);
+                            }
+                          });
+    }
+    else
+    {
+      stack.push_back(children[1]);
+      stack.push_back(children[0]);
+    }
+  }
+}
+
+bool Bvh::splitNode(BuildContext& context, const BuildTask& task, BuildTask* children)
+{
+  // Узел записывается листом; если разбиение выгодно, он станет внутренним
+  BvhNode& node = context.nodes[task.node];
+  setNodeBounds(node, task.bounds);
+  node.leftOrFirst = task.first;
+  node.count       = task.count;
+  if (task.count == 1)
+  {
+    return false;
+  }
+
+  glm::vec3 origin = task.centroids.min;
+  glm::vec3 extent = task.centroids.max - task.centroids.min;
+  glm::vec3 scale(0.0f);
+  for (uint32_t axis = 0; axis < 3; axis++)
+  {
+    scale[axis] = extent[axis] > 0.0f ? static_cast<float>(BIN_COUNT) / extent[axis] : 0.0f;
+  }
+
+  // Раскладка центров по корзинам всех трёх осей
+  BinSet bins;
+  if (m_pool && task.count >= PARALLEL_BINNING)
+  {
+    std::vector<BinSet> chunkBins(m_pool->getMaxChunks());
+    uint32_t            chunks = m_pool->parallelFor(
+        task.count, PARALLEL_BINNING / 4,
+        [&](uint32_t begin, uint32_t end, uint32_t chunk)
+        {
+          binRange(context.items.data(), task.first + begin, task.first + end, origin, scale,
+                   chunkBins[chunk]);
+        });
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+      for (uint32_t b = 0; b < bins.size(); b++)
+      {
+        bins[b].bounds.grow(chunkBins[chunk][b].bounds);
+        bins[b].centroids.grow(chunkBins[chunk][b].centroids);
+        bins[b].count += chunkBins[chunk][b].count;
+      }
+    }
+  }
+  else
+  {
+    binRange(context.items.data(), task.first, task.first + task.count, origin, scale, bins);
+  }
+
+  // SAH: стоимость разбиения - площади детей, умноженные на количество примитивов
+  float    bestCost  = std::numeric_limits<float>::max();
+  uint32_t bestAxis  = 0;
+  uint32_t bestSplit = 0;
+  for (uint32_t axis = 0; axis < 3; axis++)
+  {
+    if (scale[axis] == 0.0f)
+    {
+      continue;
+    }
+
+    const Bin* axisBins = &bins[axis * BIN_COUNT];
+    float      rightCost[BIN_COUNT];
+    Aabb       right;
+    uint32_t   rightCount = 0;
+    for (uint32_t b = BIN_COUNT - 1; b > 0; b--)
+    {
+      right.grow(axisBins[b].bounds);
+      rightCount   += axisBins[b].count;
+      rightCost[b]  = rightCount > 0 ? right.halfArea() * static_cast<float>(rightCount) : -1.0f;
+    }
+
+    Aabb     left;
+    uint32_t leftCount = 0;
+    for (uint32_t split = 1; split < BIN_COUNT; split++)
+    {
+      left.grow(axisBins[split - 1].bounds);
+      leftCount += axisBins[split - 1].count;
+      if (leftCount == 0 || rightCost[split] < 0.0f)
+      {
+        continue;
+      }
+
+      float cost = left.halfArea() * static_cast<float>(leftCount) + rightCost[split];
+      if (cost < bestCost)
+      {
+        bestCost  = cost;
+        bestAxis  = axis;
+        bestSplit = split;
+      }
+    }
+  }
+
+  // Центры совпадают: разбиение по корзинам невозможно, большой узел делится пополам
+  bool     binned = bestSplit > 0;
+  uint32_t middle = task.first;
+  if (binned)
+  {
+    float leafCost  = task.bounds.halfArea() * static_cast<float>(task.count);
+    float splitCost = task.bounds.halfArea() * TRAVERSAL_COST + bestCost;
+    if (splitCost >= leafCost && task.count <= MAX_LEAF_SIZE)
+    {
+      return false;
+    }
+
+    auto first = context.items.begin() + task.first;
+    auto split = std::partition(first, first + task.count,
+                                [&](const BuildItem& item)
+                                {
+                                  float value = item.getCentroid()[bestAxis];
+                                  return binIndex(value, origin[bestAxis], scale[bestAxis]) <
+                                         bestSplit;
+                                });
+    middle     = task.first + static_cast<uint32_t>(split - first);
+  }
+  else
+  {
+    if (task.count <= MAX_LEAF_SIZE)
+    {
+      return false;
+    }
+    middle = task.first + task.count / 2;
+  }
+
+  uint32_t left    = context.nodeCount.fetch_add(2);
+  node.leftOrFirst = left;
+  node.count       = 0;
+
+  children[0]       = {};
+  children[0].node  = left;
+  children[0].first = task.first;
+  children[0].count = middle - task.first;
+  children[1]       = {};
+  children[1].node  = left + 1;
+  children[1].first = middle;
+  children[1].count = task.first + task.count - middle;
+
+  // Границы детей: объединение корзин по сторонам разбиения или прямой подсчёт
+  for (uint32_t c = 0; c < 2; c++)
+  {
+    BuildTask& child = children[c];
+    if (binned)
+    {
+      uint32_t begin = c == 0 ? 0 : bestSplit;
+      uint32_t end   = c == 0 ? bestSplit : BIN_COUNT;
+      for (uint32_t b = begin; b < end; b++)
+      {
+        child.bounds.grow(bins[bestAxis * BIN_COUNT + b].bounds);
+        child.centroids.grow(bins[bestAxis * BIN_COUNT + b].centroids);
+      }
+    }
+    else
+    {
+      for (uint32_t k = child.first; k < child.first + child.count; k++)
+      {
+        child.bounds.grow(context.items[k].bounds);
+      }
+      child.centroids = task.centroids;
+    }
+  }
+  return true;
+}
+
+void Bvh::flatten(const BuildContext& context)
+{
+  // Перекладка в порядок обхода в глубину: пара детей, затем поддерево левого, затем правого
+  struct Entry
+  {
+    uint32_t source;
+    uint32_t target;
+    uint32_t depth;
+  };
+
+  uint32_t nodeCount = context.nodeCount.load();
+  m_nodes.clear();
+  m_nodes.reserve(nodeCount);
+  m_nodes.push_back(context.nodes[0]);
+  m_parents.assign(1, 0);
+
+  std::vector<Entry> stack = {{0, 0, 1}};
+  while (!stack.empty())
+  {
+    Entry entry = stack.back();
+    stack.pop_back();
+    m_stats.depth = std::max(m_stats.depth, entry.depth);
+
+    const BvhNode& source = context.nodes[entry.source];
+    if (source.count > 0)
+    {
+      m_stats.leaves++;
+      for (uint32_t k = source.leftOrFirst; k < source.leftOrFirst + source.count; k++)
+      {
+        m_primitives[k]           = context.items[k].primitive;
+        m_leafOf[m_primitives[k]] = entry.target;
+      }
+      continue;
+    }
+
+    uint32_t left                     = static_cast<uint32_t>(m_nodes.size());
+    m_nodes[entry.target].leftOrFirst = left;
+    m_nodes.push_back(context.nodes[source.leftOrFirst]);
+    m_nodes.push_back(context.nodes[source.leftOrFirst + 1]);
+    m_parents.push_back(entry.target);
+    m_parents.push_back(entry.target);
+
+    stack.push_back({source.leftOrFirst + 1, left + 1, entry.depth + 1});
+    stack.push_back({source.leftOrFirst, left, entry.depth + 1});
+  }
+
+  m_dirty.assign(m_nodes.size(), 0);
+}
@@ -0,0 +1,339 @@
+#include "CommandTrace.h"
+
+#include <stdexcept>
+
+namespace
+{
+  // Запись uint32 в little-endian независимо от порядка байтов хоста
+  void encodeU32(uint32_t value, uint8_t* out)
+  {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+  }
+
+  // Последовательное чтение блока с проверкой границ
+  class ChunkReader
+  {
+  public:
+    ChunkReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint32_t u32()
+    {
+      const uint8_t* bytes = take(4);
+      return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+             static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+    }
+
+    std::vector<uint8_t> bytes()
+    {
+      uint32_t       size = u32();
+      const uint8_t* data = take(size);
+      return std::vector<uint8_t>(data, data + size);
+    }
+
+    std::string string()
+    {
+      uint32_t       size = u32();
+      const uint8_t* data = take(size);
+      return std::string(reinterpret_cast<const char*>(data), size);
+    }
+
+  private:
+    const uint8_t* m_data;
+    size_t         m_size;
+    size_t         m_position = 0;
+
+    const uint8_t* take(size_t size)
+    {
+      if (size > m_size - m_position)
+      {
+        throw std::runtime_error("Блок трассы обрезан");
+      }
+      const uint8_t* data = m_data + m_position;
+      m_position += size;
+      return data;
+    }
+  };
+
+  TraceBuffer readBuffer(ChunkReader& reader)
+  {
+    TraceBuffer buffer = {};
+    buffer.id          = reader.u32();
+    buffer.usage       = reader.u32();
+    buffer.data        = reader.bytes();
+    return buffer;
+  }
+
+  TracePipeline readPipeline(ChunkReader& reader)
+  {
+    TracePipeline pipeline  = {};
+    pipeline.id             = reader.u32();
+    pipeline.vertexShader   = reader.string();
+    pipeline.fragmentShader = reader.string();
+    pipeline.topology       = reader.u32();
+    pipeline.vertexStride   = reader.u32();
+
+    uint32_t attributeCount = reader.u32();
+    for (uint32_t i = 0; i < attributeCount; i++)
+    {
+      TraceVertexAttribute attribute = {};
+      attribute.location             = reader.u32();
+      attribute.format               = reader.u32();
+      attribute.offset               = reader.u32();
+      pipeline.attributes.push_back(attribute);
+    }
+
+    pipeline.cullMode       = reader.u32();
+    pipeline.frontFace      = reader.u32();
+    pipeline.depthTest      = reader.u32();
+    pipeline.depthWrite     = reader.u32();
+    pipeline.depthCompareOp = reader.u32();
+    pipeline.blendEnable    = reader.u32();
+    pipeline.srcColorFactor = reader.u32();
+    pipeline.dstColorFactor = reader.u32();
+    pipeline.colorBlendOp   = reader.u32();
+    pipeline.srcAlphaFactor = reader.u32();
+    pipeline.dstAlphaFactor = reader.u32();
+    pipeline.alphaBlendOp   = reader.u32();
+    pipeline.colorWriteMask = reader.u32();
+    pipeline.frameUniforms  = reader.u32();
+    return pipeline;
+  }
+
+  TraceFrame readFrame(ChunkReader& reader)
+  {
+    TraceFrame frame = {};
+    frame.width      = reader.u32();
+    frame.height     = reader.u32();
+
+    uint32_t uniformCount = reader.u32();
+    frame.uniforms.resize(uniformCount);
+    for (TraceUniformBlock& block : frame.uniforms)
+    {
+      block.offset = reader.u32();
+      block.data   = reader.bytes();
+    }
+
+    uint32_t drawCount = reader.u32();
+    frame.draws.resize(drawCount);
+    for (TraceDraw& draw : frame.draws)
+    {
+      draw.pipeline           = reader.u32();
+      draw.vertexBuffer       = reader.u32();
+      draw.indexBuffer        = reader.u32();
+      draw.count              = reader.u32();
+      draw.instanceCount      = reader.u32();
+      draw.firstVertex        = reader.u32();
+      draw.vertexOffset       = static_cast<int32_t>(reader.u32());
+      draw.dynamicOffsetCount = reader.u32();
+      draw.dynamicOffsets[0]  = reader.u32();
+      draw.dynamicOffsets[1]  = reader.u32();
+      if (draw.dynamicOffsetCount > 2)
+      {
+        throw std::runtime_error("Неверное количество динамических смещений в трассе");
+      }
+    }
+    return frame;
+  }
+}  // namespace
+
+CommandTrace CommandTrace::load(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+  {
+    throw std::runtime_error("Не удалось открыть трассу " + path);
+  }
+
+  std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+  if (!file)
+  {
+    throw std::runtime_error("Не удалось прочитать трассу " + path);
+  }
+
+  ChunkReader header(data.data(), data.size());
+  if (header.u32() != MAGIC)
+  {
+    throw std::runtime_error(path + " - не трасса команд");
+  }
+  uint32_t version = header.u32();
+  if (version != VERSION)
+  {
+    throw std::runtime_error("Неподдерживаемая версия трассы: " + std::to_string(version));
+  }
+
+  // Блоки: тег, размер данных, данные
+  CommandTrace trace    = {};
+  size_t       position = 8;
+  while (position < data.size())
+  {
+    ChunkReader chunkHeader(data.data() + position, data.size() - position);
+    uint32_t    tag  = chunkHeader.u32();
+    uint32_t    size = chunkHeader.u32();
+    position += 8;
+    if (size > data.size() - position)
+    {
+      throw std::runtime_error("Трасса обрезана");
+    }
+
+    ChunkReader reader(data.data() + position, size);
+    switch (tag)
+    {
+      case TAG_TARGET:
+        trace.target.colorFormat = reader.u32();
+        trace.target.depthFormat = reader.u32();
+        trace.target.samples     = reader.u32();
+        break;
+      case TAG_BUFFER:
+        trace.buffers.push_back(readBuffer(reader));
+        break;
+      case TAG_PIPELINE:
+        trace.pipelines.push_back(readPipeline(reader));
+        break;
+      case TAG_FRAME:
+        trace.frames.push_back(readFrame(reader));
+        break;
+      default:
+        break;  // Блок более новой версии формата
+    }
+    position += size;
+  }
+  return trace;
+}
+
+CommandTraceWriter::CommandTraceWriter(const std::string& path, const TraceTarget& target)
+    : m_file(path, std::ios::binary | std::ios::trunc)
+{
+  if (!m_file)
+  {
+    throw std::runtime_error("Не удалось создать файл трассы " + path);
+  }
+
+  uint8_t header[8];
+  encodeU32(CommandTrace::MAGIC, header);
+  encodeU32(CommandTrace::VERSION, header + 4);
+  m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  m_bytesWritten += sizeof(header);
+
+  putU32(target.colorFormat);
+  putU32(target.depthFormat);
+  putU32(target.samples);
+  flushChunk(CommandTrace::TAG_TARGET);
+}
+
+void CommandTraceWriter::writeBuffer(const TraceBuffer& buffer)
+{
+  putU32(buffer.id);
+  putU32(buffer.usage);
+  putBytes(buffer.data.data(), buffer.data.size());
+  flushChunk(CommandTrace::TAG_BUFFER);
+}
+
+void CommandTraceWriter::writePipeline(const TracePipeline& pipeline)
+{
+  putU32(pipeline.id);
+  putString(pipeline.vertexShader);
+  putString(pipeline.fragmentShader);
+  putU32(pipeline.topology);
+  putU32(pipeline.vertexStride);
+  putU32(static_cast<uint32_t>(pipeline.attributes.size()));
+  for (const TraceVertexAttribute& attribute : pipeline.attributes)
+  {
+    putU32(attribute.location);
+    putU32(attribute.format);
+    putU32(attribute.offset);
+  }
+  putU32(pipeline.cullMode);
+  putU32(pipeline.frontFace);
+  putU32(pipeline.depthTest);
+  putU32(pipeline.depthWrite);
+  putU32(pipeline.depthCompareOp);
+  putU32(pipeline.blendEnable);
+  putU32(pipeline.srcColorFactor);
+  putU32(pipeline.dstColorFactor);
+  putU32(pipeline.colorBlendOp);
+  putU32(pipeline.srcAlphaFactor);
+  putU32(pipeline.dstAlphaFactor);
+  putU32(pipeline.alphaBlendOp);
+  putU32(pipeline.colorWriteMask);
+  putU32(pipeline.frameUniforms);
+  flushChunk(CommandTrace::TAG_PIPELINE);
+}
+
+void CommandTraceWriter::writeFrame(const TraceFrame& frame)
+{
+  putU32(frame.width);
+  putU32(frame.height);
+  putU32(static_cast<uint32_t>(frame.uniforms.size()));
+  for (const TraceUniformBlock& block : frame.uniforms)
+  {
+    putU32(block.offset);
+    putBytes(block.data.data(), block.data.size());
+  }
+
+  // Запись фиксированного размера: 40 байт на draw-вызов
+  putU32(static_cast<uint32_t>(frame.draws.size()));
+  for (const TraceDraw& draw : frame.draws)
+  {
+    putU32(draw.pipeline);
+    putU32(draw.vertexBuffer);
+    putU32(draw.indexBuffer);
+    putU32(draw.count);
+    putU32(draw.instanceCount);
+    putU32(draw.firstVertex);
+    putU32(static_cast<uint32_t>(draw.vertexOffset));
+    putU32(draw.dynamicOffsetCount);
+    putU32(draw.dynamicOffsets[0]);
+    putU32(draw.dynamicOffsets[1]);
+  }
+  flushChunk(CommandTrace::TAG_FRAME);
+}
+
+void CommandTraceWriter::close()
+{
+  if (m_file.is_open())
+  {
+    m_file.close();
+  }
+}
+
+void CommandTraceWriter::putU32(uint32_t value)
+{
+  uint8_t bytes[4];
+  encodeU32(value, bytes);
+  m_chunk.insert(m_chunk.end(), bytes, bytes + 4);
+}
+
+void CommandTraceWriter::putBytes(const void* data, size_t size)
+{
+  putU32(static_cast<uint32_t>(size));
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  m_chunk.insert(m_chunk.end(), bytes, bytes + size);
+}
+
+void CommandTraceWriter::putString(const std::string& value)
+{
+  putBytes(value.data(), value.size());
+}
+
+void CommandTraceWriter::flushChunk(uint32_t tag)
+{
+  uint8_t header[8];
+  encodeU32(tag, header);
+  encodeU32(static_cast<uint32_t>(m_chunk.size()), header + 4);
+  m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  m_file.write(reinterpret_cast<const char*>(m_chunk.data()),
+               static_cast<std::streamsize>(m_chunk.size()));
+  if (!m_file)
+  {
+    throw std::runtime_error("Ошибка записи трассы");
+  }
+  m_bytesWritten += sizeof(header) + m_chunk.size();
+
+  // Память блока сохраняется, чтобы не выделять её на каждый кадр
+  m_chunk.clear();
+}
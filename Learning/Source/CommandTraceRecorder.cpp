@@ -0,0 +1,183 @@
+#include "CommandTraceRecorder.h"
+
+#include <iostream>
+#include <stdexcept>
+
+CommandTraceRecorder::CommandTraceRecorder(const std::string& path, const TraceTarget& target,
+                                           uint32_t frameCount)
+    : m_writer(path, target), m_frameCount(frameCount)
+{
+  std::cout << "Запись трассы команд в " << path << ": " << frameCount << " кадров" << std::endl;
+}
+
+void CommandTraceRecorder::addBuffer(vk::Buffer buffer, vk::BufferUsageFlags usage,
+                                     const void* data, size_t size)
+{
+  TraceBuffer traceBuffer = {};
+  traceBuffer.id          = static_cast<uint32_t>(m_bufferIds.size());
+  traceBuffer.usage       = static_cast<uint32_t>(usage);
+  traceBuffer.data.assign(static_cast<const uint8_t*>(data),
+                          static_cast<const uint8_t*>(data) + size);
+  m_writer.writeBuffer(traceBuffer);
+  m_bufferIds[static_cast<VkBuffer>(buffer)] = traceBuffer.id;
+}
+
+void CommandTraceRecorder::addPipeline(vk::Pipeline pipeline,
+                                       const vk::GraphicsPipelineCreateInfo& info,
+                                       const std::string& vertexShader,
+                                       const std::string& fragmentShader, bool frameUniforms)
+{
+  TracePipeline tracePipeline  = {};
+  tracePipeline.id             = static_cast<uint32_t>(m_pipelineIds.size());
+  tracePipeline.vertexShader   = vertexShader;
+  tracePipeline.fragmentShader = fragmentShader;
+  tracePipeline.frameUniforms  = frameUniforms ? 1 : 0;
+
+  // Состояние берётся из той же структуры, по которой создан конвейер
+  const vk::PipelineVertexInputStateCreateInfo& vertexInput = *info.pVertexInputState;
+  if (vertexInput.vertexBindingDescriptionCount > 0)
+  {
+    tracePipeline.vertexStride = vertexInput.pVertexBindingDescriptions[0].stride;
+  }
+  for (uint32_t i = 0; i < vertexInput.vertexAttributeDescriptionCount; i++)
+  {
+    const vk::VertexInputAttributeDescription& attribute =
+        vertexInput.pVertexAttributeDescriptions[i];
+    tracePipeline.attributes.push_back(
+        {attribute.location, static_cast<uint32_t>(attribute.format), attribute.offset});
+  }
+
+  tracePipeline.topology  = static_cast<uint32_t>(info.pInputAssemblyState->topology);
+  tracePipeline.cullMode  = static_cast<uint32_t>(info.pRasterizationState->cullMode);
+  tracePipeline.frontFace = static_cast<uint32_t>(info.pRasterizationState->frontFace);
+
+  if (info.pDepthStencilState)
+  {
+    tracePipeline.depthTest      = info.pDepthStencilState->depthTestEnable;
+    tracePipeline.depthWrite     = info.pDepthStencilState->depthWriteEnable;
+    tracePipeline.depthCompareOp = static_cast<uint32_t>(info.pDepthStencilState->depthCompareOp);
+  }
+
+  const vk::PipelineColorBlendAttachmentState& blend = info.pColorBlendState->pAttachments[0];
+
+  tracePipeline.blendEnable    = blend.blendEnable;
+  tracePipeline.srcColorFactor = static_cast<uint32_t>(blend.srcColorBlendFactor);
+  tracePipeline.dstColorFactor = static_cast<uint32_t>(blend.dstColorBlendFactor);
+  tracePipeline.colorBlendOp   = static_cast<uint32_t>(blend.colorBlendOp);
+  tracePipeline.srcAlphaFactor = static_cast<uint32_t>(blend.srcAlphaBlendFactor);
+  tracePipeline.dstAlphaFactor = static_cast<uint32_t>(blend.dstAlphaBlendFactor);
+  tracePipeline.alphaBlendOp   = static_cast<uint32_t>(blend.alphaBlendOp);
+  tracePipeline.colorWriteMask = static_cast<uint32_t>(blend.colorWriteMask);
+
+  m_writer.writePipeline(tracePipeline);
+  m_pipelineIds[static_cast<VkPipeline>(pipeline)] = tracePipeline.id;
+}
+
+void CommandTraceRecorder::beginFrame(vk::DeviceSize uniformBase)
+{
+  m_uniformBase = uniformBase;
+  m_frame.uniforms.clear();
+  m_frame.draws.clear();
+}
+
+void CommandTraceRecorder::addUniform(uint32_t offset, const void* data, size_t size)
+{
+  TraceUniformBlock block = {};
+  block.offset            = static_cast<uint32_t>(offset - m_uniformBase);
+  block.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+  m_frame.uniforms.push_back(std::move(block));
+}
+
+bool CommandTraceRecorder::translate(const DrawPacket& packet, TraceDraw& draw) const
+{
+  auto pipeline = m_pipelineIds.find(static_cast<VkPipeline>(packet.pipeline));
+  if (pipeline == m_pipelineIds.end())
+  {
+    return false;
+  }
+  draw.pipeline = pipeline->second;
+
+  // Поддерживается только набор констант кадра: другие наборы ссылаются на ресурсы,
+  // которых нет в трассе
+  if (packet.descriptorSet && packet.descriptorSet != m_vkFrameUniforms)
+  {
+    return false;
+  }
+
+  if (packet.vertexBuffer)
+  {
+    auto vertexBuffer = m_bufferIds.find(static_cast<VkBuffer>(packet.vertexBuffer));
+    if (vertexBuffer == m_bufferIds.end())
+    {
+      return false;
+    }
+    draw.vertexBuffer = vertexBuffer->second;
+  }
+  if (packet.indexBuffer)
+  {
+    auto indexBuffer = m_bufferIds.find(static_cast<VkBuffer>(packet.indexBuffer));
+    if (indexBuffer == m_bufferIds.end())
+    {
+      return false;
+    }
+    draw.indexBuffer = indexBuffer->second;
+  }
+
+  draw.count              = packet.count;
+  draw.instanceCount      = packet.instanceCount;
+  draw.firstVertex        = packet.firstVertex;
+  draw.vertexOffset       = packet.vertexOffset;
+  draw.dynamicOffsetCount = packet.dynamicOffsetCount;
+  for (uint32_t i = 0; i < packet.dynamicOffsetCount; i++)
+  {
+    draw.dynamicOffsets[i] = static_cast<uint32_t>(packet.dynamicOffsets[i] - m_uniformBase);
+  }
+  return true;
+}
+
+bool CommandTraceRecorder::endFrame(const VulkanRenderQueue& queue, vk::Extent2D extent)
+{
+  m_frame.width  = extent.width;
+  m_frame.height = extent.height;
+  for (size_t i = 0; i < queue.size(); i++)
+  {
+    TraceDraw draw = {};
+    if (translate(queue.getSorted(i), draw))
+    {
+      m_frame.draws.push_back(draw);
+    }
+    else
+    {
+      m_skippedDraws++;
+    }
+  }
+  m_recordedDraws += m_frame.draws.size();
+
+  // Ошибка записи не должна останавливать кадр: трасса просто обрывается
+  try
+  {
+    m_writer.writeFrame(m_frame);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Запись трассы прервана: " << e.what() << std::endl;
+    m_writer.close();
+    return true;
+  }
+
+  m_recordedFrames++;
+  if (m_recordedFrames < m_frameCount)
+  {
+    return false;
+  }
+
+  m_writer.close();
+  std::cout << "Трасса команд записана: " << m_recordedFrames << " кадров, " << m_recordedDraws
+            << " draw-вызовов, " << (m_writer.getBytesWritten() >> 10) << " КБ";
+  if (m_skippedDraws > 0)
+  {
+    std::cout << ", пропущено пакетов без записанных ресурсов: " << m_skippedDraws;
+  }
+  std::cout << std::endl;
+  return true;
+}
@@ -0,0 +1,207 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+  // Кратность блоков parallelFor: скалярные хвосты остаются только в конце набора
+  const uint32_t BLOCK_SIZE = 8;
+}  // namespace
+
+FrustumCuller::FrustumCuller(ThreadPool* pool) : m_pool(pool)
+{
+  m_chunks.resize(m_pool ? m_pool->getMaxChunks() : 1);
+}
+
+uint32_t FrustumCuller::addSphere(const glm::vec3& center, float radius)
+{
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_sphereCenter[i].push_back(center[i]);
+  }
+  m_sphereRadius.push_back(radius);
+  return getSphereCount() - 1;
+}
+
+uint32_t FrustumCuller::addBox(const glm::vec3& min, const glm::vec3& max)
+{
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_boxCenter[i].push_back((min[i] + max[i]) * 0.5f);
+    m_boxExtent[i].push_back((max[i] - min[i]) * 0.5f);
+  }
+  return getBoxCount() - 1;
+}
+
+void FrustumCuller::setSphere(uint32_t index, const glm::vec3& center, float radius)
+{
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_sphereCenter[i][index] = center[i];
+  }
+  m_sphereRadius[index] = radius;
+}
+
+void FrustumCuller::setBox(uint32_t index, const glm::vec3& min, const glm::vec3& max)
+{
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_boxCenter[i][index] = (min[i] + max[i]) * 0.5f;
+    m_boxExtent[i][index] = (max[i] - min[i]) * 0.5f;
+  }
+}
+
+void FrustumCuller::clear()
+{
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_sphereCenter[i].clear();
+    m_boxCenter[i].clear();
+    m_boxExtent[i].clear();
+  }
+  m_sphereRadius.clear();
+  m_visibleSpheres.clear();
+  m_visibleBoxes.clear();
+}
+
+void FrustumCuller::cull(const glm::mat4& viewProj)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  CullingSoa soa = {};
+  extractPlanes(viewProj, soa.planes);
+
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    soa.center[i] = m_sphereCenter[i].data();
+  }
+  soa.radius = m_sphereRadius.data();
+  cullSet<false>(soa, getSphereCount(), m_visibleSpheres);
+
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    soa.center[i] = m_boxCenter[i].data();
+    soa.extent[i] = m_boxExtent[i].data();
+  }
+  cullSet<true>(soa, getBoxCount(), m_visibleBoxes);
+
+  m_stats.tested  = getSphereCount() + getBoxCount();
+  m_stats.visible = static_cast<uint32_t>(m_visibleSpheres.size() + m_visibleBoxes.size());
+  m_stats.culled  = m_stats.tested - m_stats.visible;
+  m_stats.timeMs  =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+const char* FrustumCuller::getKernelName() const
+{
+#if defined(VKAPI_AVX2)
+  if (m_simdEnabled && Simd::hasAvx2())
+  {
+    return "AVX2";  // Avx2Lanes виден только в FrustumCullerAvx2.cpp
+  }
+#endif
+#if defined(__ARM_NEON)
+  if (m_simdEnabled)
+  {
+    return Simd::NeonLanes::NAME;
+  }
+#endif
+  return Simd::ScalarLanes::NAME;
+}
+
+// Плоскости из строк матрицы (метод Грибба - Хартманна)
+void FrustumCuller::extractPlanes(const glm::mat4& viewProj, float planes[6][4])
+{
+  glm::vec4 rows[4];
+  for (uint32_t row = 0; row < 4; row++)
+  {
+    rows[row] = glm::vec4(viewProj[0][row], viewProj[1][row], viewProj[2][row], viewProj[3][row]);
+  }
+
+  glm::vec4 frustum[6] = {
+      rows[3] + rows[0],  // Левая
+      rows[3] - rows[0],  // Правая
+      rows[3] + rows[1],  // Нижняя
+      rows[3] - rows[1],  // Верхняя
+      rows[2],            // Ближняя (z >= 0)
+      rows[3] - rows[2]   // Дальняя
+  };
+
+  // Нормированные плоскости дают расстояния, сравнимые с радиусами
+  for (uint32_t p = 0; p < 6; p++)
+  {
+    float length = glm::length(glm::vec3(frustum[p]));
+    for (uint32_t k = 0; k < 4; k++)
+    {
+      planes[p][k] = frustum[p][k] / length;
+    }
+  }
+}
+
+uint32_t FrustumCuller::getSphereCount() const
+{
+  return static_cast<uint32_t>(m_sphereRadius.size());
+}
+
+uint32_t FrustumCuller::getBoxCount() const
+{
+  return static_cast<uint32_t>(m_boxExtent[0].size());
+}
+
+template <bool BOX>
+void FrustumCuller::cullSet(const CullingSoa& soa, uint32_t count, std::vector<uint32_t>& visible)
+{
+  // Каждый блок пишет индексы видимых в свой участок списка, начиная со своего begin
+  visible.resize(count);
+  if (!m_pool)
+  {
+    visible.resize(cullRange<BOX>(soa, 0, count, visible.data()));
+    return;
+  }
+
+  // Пустые блоки parallelFor не вызываются, поэтому результаты обнуляются заранее
+  std::fill(m_chunks.begin(), m_chunks.end(), ChunkResult());
+  uint32_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  uint32_t chunks = m_pool->parallelFor(
+      blocks, MIN_CHUNK / BLOCK_SIZE,
+      [&](uint32_t blockBegin, uint32_t blockEnd, uint32_t chunk)
+      {
+        uint32_t begin  = blockBegin * BLOCK_SIZE;
+        uint32_t end    = std::min(count, blockEnd * BLOCK_SIZE);
+        m_chunks[chunk] = {begin, cullRange<BOX>(soa, begin, end, visible.data() + begin)};
+      });
+
+  // Сжатие: участки блоков сдвигаются вплотную, порядок индексов сохраняется
+  uint32_t total = 0;
+  for (uint32_t chunk = 0; chunk < chunks; chunk++)
+  {
+    const ChunkResult& result = m_chunks[chunk];
+    std::memmove(visible.data() + total, visible.data() + result.begin,
+                 result.count * sizeof(uint32_t));
+    total += result.count;
+  }
+  visible.resize(total);
+}
+
+template <bool BOX>
+uint32_t FrustumCuller::cullRange(const CullingSoa& soa, uint32_t begin, uint32_t end,
+                                  uint32_t* visible) const
+{
+#if defined(VKAPI_AVX2)
+  if (m_simdEnabled && Simd::hasAvx2())
+  {
+    return BOX ? CullingKernel::cullBoxesAvx2(soa, begin, end, visible)
+               : CullingKernel::cullSpheresAvx2(soa, begin, end, visible);
+  }
+#endif
+#if defined(__ARM_NEON)
+  if (m_simdEnabled)
+  {
+    return CullingKernel::cullRange<Simd::NeonLanes, BOX>(soa, begin, end, visible);
+  }
+#endif
+  return CullingKernel::cullRange<Simd::ScalarLanes, BOX>(soa, begin, end, visible);
+}
@@ -0,0 +1,14 @@
+// Собирается с -mavx2 -mfma (/arch:AVX2) только при VKAPI_ENABLE_AVX2, см. CMakeLists.txt
+#include "CullingKernel.h"
+
+uint32_t CullingKernel::cullSpheresAvx2(const CullingSoa& soa, uint32_t begin, uint32_t end,
+                                        uint32_t* visible)
+{
+  return cullRange<Simd::Avx2Lanes, false>(soa, begin, end, visible);
+}
+
+uint32_t CullingKernel::cullBoxesAvx2(const CullingSoa& soa, uint32_t begin, uint32_t end,
+                                      uint32_t* visible)
+{
+  return cullRange<Simd::Avx2Lanes, true>(soa, begin, end, visible);
+}
@@ -0,0 +1,74 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+
+LinearArena::LinearArena(size_t capacity)
+    : m_buffer(capacity > 0 ? std::make_unique<std::byte[]>(capacity) : nullptr),
+      m_capacity(capacity)
+{
+}
+
+LinearArena::LinearArena(LinearArena&& other) noexcept
+    : m_buffer(std::move(other.m_buffer)),
+      m_overflow(std::move(other.m_overflow)),
+      m_capacity(other.m_capacity),
+      m_offset(other.m_offset),
+      m_overflowBytes(other.m_overflowBytes),
+      m_overflowCount(other.m_overflowCount),
+      m_peak(other.m_peak)
+{
+  other.m_capacity      = 0;
+  other.m_offset        = 0;
+  other.m_overflowBytes = 0;
+  other.m_overflowCount = 0;
+  other.m_peak          = 0;
+}
+
+LinearArena& LinearArena::operator=(LinearArena&& other) noexcept
+{
+  if (this != &other)
+  {
+    m_buffer              = std::move(other.m_buffer);
+    m_overflow            = std::move(other.m_overflow);
+    m_capacity            = other.m_capacity;
+    m_offset              = other.m_offset;
+    m_overflowBytes       = other.m_overflowBytes;
+    m_overflowCount       = other.m_overflowCount;
+    m_peak                = other.m_peak;
+    other.m_capacity      = 0;
+    other.m_offset        = 0;
+    other.m_overflowBytes = 0;
+    other.m_overflowCount = 0;
+    other.m_peak          = 0;
+  }
+  return *this;
+}
+
+void LinearArena::reset()
+{
+  m_peak = std::max(m_peak, getUsed());
+
+  // Переполнение: блок растёт сразу до пика (с запасом), чтобы следующий кадр поместился
+  if (!m_overflow.empty())
+  {
+    m_overflow.clear();
+    m_capacity = std::max(m_capacity * 2, m_peak + m_peak / 2);
+    m_buffer   = std::make_unique<std::byte[]>(m_capacity);
+  }
+
+  m_offset        = 0;
+  m_overflowBytes = 0;
+}
+
+void* LinearArena::allocateOverflow(size_t size, size_t alignment)
+{
+  // Запас на выравнивание: new гарантирует только выравнивание по умолчанию
+  size_t chunkSize = size + alignment;
+  m_overflow.push_back(std::make_unique<std::byte[]>(chunkSize));
+  m_overflowBytes += chunkSize;
+  m_overflowCount++;
+
+  uintptr_t base    = reinterpret_cast<uintptr_t>(m_overflow.back().get());
+  uintptr_t aligned = (base + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  return reinterpret_cast<void*>(aligned);
+}
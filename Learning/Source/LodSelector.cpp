@@ -0,0 +1,141 @@
+#include "LodSelector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+  // Ближе этой глубины (камера внутри сферы) объект рисуется с полной детализацией
+  const float MIN_DEPTH = 1e-4f;
+}  // namespace
+
+LodSelector::LodSelector(ThreadPool* pool) : m_pool(pool)
+{
+  m_chunks.resize(m_pool ? m_pool->getMaxChunks() : 1);
+}
+
+uint32_t LodSelector::addMesh(const LodChain& chain)
+{
+  MeshLevels mesh = {};
+  mesh.first      = static_cast<uint32_t>(m_levelErrors.size());
+  mesh.count      = std::min(static_cast<uint32_t>(chain.levels.size()), MAX_LEVELS);
+  for (uint32_t i = 0; i < mesh.count; i++)
+  {
+    m_levelErrors.push_back(chain.levels[i].error);
+    m_levelTriangles.push_back(chain.levels[i].indexCount / 3);
+  }
+  m_meshes.push_back(mesh);
+  return static_cast<uint32_t>(m_meshes.size() - 1);
+}
+
+uint32_t LodSelector::addObject(uint32_t mesh, const glm::vec3& center, float radius, float scale)
+{
+  m_centerX.push_back(center.x);
+  m_centerY.push_back(center.y);
+  m_centerZ.push_back(center.z);
+  m_radius.push_back(radius);
+  m_scale.push_back(scale);
+  m_mesh.push_back(mesh);
+  m_levels.push_back(0);
+  return getObjectCount() - 1;
+}
+
+void LodSelector::setObject(uint32_t index, const glm::vec3& center, float radius)
+{
+  m_centerX[index] = center.x;
+  m_centerY[index] = center.y;
+  m_centerZ[index] = center.z;
+  m_radius[index]  = radius;
+}
+
+void LodSelector::clear()
+{
+  m_meshes.clear();
+  m_levelErrors.clear();
+  m_levelTriangles.clear();
+  m_centerX.clear();
+  m_centerY.clear();
+  m_centerZ.clear();
+  m_radius.clear();
+  m_scale.clear();
+  m_mesh.clear();
+  m_levels.clear();
+}
+
+void LodSelector::select(const glm::mat4& viewProj, const glm::vec2& viewport)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  // Длина в мире переходит в NDC с множителем |строка x или y| / w, а NDC в пиксели -
+  // с множителем половины области вывода; берётся ось с большим разрешением
+  glm::vec4 depthRow(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+  float     scaleX = glm::length(glm::vec3(viewProj[0][0], viewProj[1][0], viewProj[2][0]));
+  float     scaleY = glm::length(glm::vec3(viewProj[0][1], viewProj[1][1], viewProj[2][1]));
+  float     pixelScale = 0.5f * std::max(scaleX * viewport.x, scaleY * viewport.y);
+
+  ChunkResult total;
+  if (!m_pool)
+  {
+    total = selectRange(depthRow, pixelScale, 0, getObjectCount());
+  }
+  else
+  {
+    // Пустые блоки parallelFor не вызываются, поэтому результаты обнуляются заранее
+    std::fill(m_chunks.begin(), m_chunks.end(), ChunkResult());
+    uint32_t chunks = m_pool->parallelFor(
+        getObjectCount(), MIN_CHUNK, [&](uint32_t begin, uint32_t end, uint32_t chunk)
+        { m_chunks[chunk] = selectRange(depthRow, pixelScale, begin, end); });
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+      total.switches += m_chunks[chunk].switches;
+      total.triangles += m_chunks[chunk].triangles;
+      total.saved += m_chunks[chunk].saved;
+    }
+  }
+
+  m_stats.objects   = getObjectCount();
+  m_stats.switches  = total.switches;
+  m_stats.triangles = total.triangles;
+  m_stats.saved     = total.saved;
+  m_stats.timeMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+LodSelector::ChunkResult LodSelector::selectRange(const glm::vec4& depthRow, float pixelScale,
+                                                  uint32_t begin, uint32_t end)
+{
+  ChunkResult result;
+  float       depthScale = glm::length(glm::vec3(depthRow));
+  for (uint32_t i = begin; i < end; i++)
+  {
+    const MeshLevels& mesh    = m_meshes[m_mesh[i]];
+    const float*      errors  = m_levelErrors.data() + mesh.first;
+    uint32_t          current = m_levels[i];
+    uint32_t          level   = 0;
+
+    // Глубина ближайшей к камере точки сферы
+    float depth = depthRow[0] * m_centerX[i] + depthRow[1] * m_centerY[i] +
+                  depthRow[2] * m_centerZ[i] + depthRow[3] - m_radius[i] * depthScale;
+    if (depth > MIN_DEPTH)
+    {
+      // Порог переводится из пикселей в единицы меша, чтобы не делить для каждого уровня
+      float limit       = m_threshold * depth / (pixelScale * m_scale[i]);
+      float coarseLimit = limit * (1.0f - m_hysteresis);
+      for (uint32_t k = mesh.count; k-- > 0;)
+      {
+        if (errors[k] <= (k > current ? coarseLimit : limit))
+        {
+          level = k;
+          break;
+        }
+      }
+    }
+
+    m_levels[i] = static_cast<uint8_t>(level);
+    result.switches += level != current;
+    result.triangles += m_levelTriangles[mesh.first + level];
+    result.saved += m_levelTriangles[mesh.first] - m_levelTriangles[mesh.first + level];
+  }
+  return result;
+}
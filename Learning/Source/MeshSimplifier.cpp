@@ -0,0 +1,450 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+  // Граница весит больше граней, чтобы контур меша не стягивался внутрь
+  const double BOUNDARY_WEIGHT = 10.0;
+
+  // Наименьший косинус между нормалями треугольника до и после стягивания
+  const double MIN_NORMAL_COS = 0.2;
+
+  enum class VertexKind : uint8_t
+  {
+    Interior,  // Стягивается в любую соседнюю вершину
+    Border,    // Стягивается только вдоль граничного ребра
+    Locked     // Не удаляется
+  };
+
+  /**
+   * @brief Квадрика ошибки: взвешенная сумма квадратов расстояний до плоскостей.
+   * Q(p) = p^T A p + 2 b^T p + c, A - симметричная 3x3 (хранится верхний треугольник)
+   */
+  struct Quadric
+  {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0, c = 0.0;
+    double weight = 0.0;
+
+    // Плоскость n * p + d = 0 с единичной нормалью
+    void addPlane(double nx, double ny, double nz, double d, double w)
+    {
+      a00 += w * nx * nx;
+      a11 += w * ny * ny;
+      a22 += w * nz * nz;
+      a01 += w * nx * ny;
+      a02 += w * nx * nz;
+      a12 += w * ny * nz;
+      b0 += w * nx * d;
+      b1 += w * ny * d;
+      b2 += w * nz * d;
+      c += w * d * d;
+      weight += w;
+    }
+
+    void add(const Quadric& other)
+    {
+      a00 += other.a00;
+      a11 += other.a11;
+      a22 += other.a22;
+      a01 += other.a01;
+      a02 += other.a02;
+      a12 += other.a12;
+      b0 += other.b0;
+      b1 += other.b1;
+      b2 += other.b2;
+      c += other.c;
+      weight += other.weight;
+    }
+
+    double evaluate(const glm::vec3& p) const
+    {
+      double x = p.x, y = p.y, z = p.z;
+      return a00 * x * x + a11 * y * y + a22 * z * z +
+             2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + b0 * x + b1 * y + b2 * z) + c;
+    }
+  };
+
+  // Ребро треугольника: ключ - пара вершин по возрастанию, corner - индекс в списке индексов
+  struct Edge
+  {
+    uint64_t key;
+    uint32_t corner;
+  };
+
+  // Кандидат на стягивание вершины from в вершину to
+  struct Collapse
+  {
+    float    cost;
+    uint32_t from;
+    uint32_t to;
+  };
+
+  uint64_t edgeKey(uint32_t a, uint32_t b)
+  {
+    return a < b ? (uint64_t(a) << 32 | b) : (uint64_t(b) << 32 | a);
+  }
+
+  // Рёбра всех треугольников, отсортированные по ключу (одинаковые рёбра идут подряд)
+  void collectEdges(const std::vector<uint32_t>& indices, std::vector<Edge>& edges)
+  {
+    edges.resize(indices.size());
+    for (uint32_t corner = 0; corner < indices.size(); corner++)
+    {
+      uint32_t next = corner % 3 == 2 ? corner - 2 : corner + 1;
+      edges[corner] = {edgeKey(indices[corner], indices[next]), corner};
+    }
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge& a, const Edge& b) { return a.key < b.key; });
+  }
+
+  // Конец группы одинаковых рёбер, начинающейся с begin (размер группы - число треугольников)
+  size_t findEdgeEnd(const std::vector<Edge>& edges, size_t begin)
+  {
+    size_t end = begin + 1;
+    while (end < edges.size() && edges[end].key == edges[begin].key)
+    {
+      end++;
+    }
+    return end;
+  }
+
+  glm::vec3 triangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+  {
+    return glm::cross(b - a, c - a);
+  }
+
+  // Квадрики граней (вес - площадь) и граничных рёбер (плоскость через ребро поперёк грани)
+  void computeQuadrics(const std::vector<glm::vec3>& positions,
+                       const std::vector<uint32_t>& indices, const std::vector<Edge>& edges,
+                       std::vector<Quadric>& quadrics)
+  {
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+      const glm::vec3& p0     = positions[indices[i]];
+      const glm::vec3& p1     = positions[indices[i + 1]];
+      const glm::vec3& p2     = positions[indices[i + 2]];
+      glm::vec3        normal = triangleNormal(p0, p1, p2);
+      double           length = glm::length(normal);
+      if (length == 0.0)
+      {
+        continue;
+      }
+
+      double nx = normal.x / length, ny = normal.y / length, nz = normal.z / length;
+      double d  = -(nx * p0.x + ny * p0.y + nz * p0.z);
+      for (uint32_t k = 0; k < 3; k++)
+      {
+        quadrics[indices[i + k]].addPlane(nx, ny, nz, d, length * 0.5);
+      }
+    }
+
+    for (size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+    {
+      end = findEdgeEnd(edges, begin);
+      if (end - begin != 1)
+      {
+        continue;
+      }
+
+      uint32_t  corner   = edges[begin].corner;
+      uint32_t  triangle = corner - corner % 3;
+      uint32_t  a        = indices[corner];
+      uint32_t  b        = indices[corner % 3 == 2 ? corner - 2 : corner + 1];
+      glm::vec3 edge     = positions[b] - positions[a];
+      glm::vec3 normal   = glm::cross(edge, triangleNormal(positions[indices[triangle]],
+                                                            positions[indices[triangle + 1]],
+                                                            positions[indices[triangle + 2]]));
+      double    length   = glm::length(normal);
+      if (length == 0.0)
+      {
+        continue;
+      }
+
+      double nx = normal.x / length, ny = normal.y / length, nz = normal.z / length;
+      double d  = -(nx * positions[a].x + ny * positions[a].y + nz * positions[a].z);
+      double w  = glm::dot(edge, edge) * BOUNDARY_WEIGHT;
+      quadrics[a].addPlane(nx, ny, nz, d, w);
+      quadrics[b].addPlane(nx, ny, nz, d, w);
+    }
+  }
+
+  // Вершины, положение которых повторяется (швы нормалей, цветов, текстурных координат)
+  void lockSeams(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                 std::vector<uint8_t>& seam)
+  {
+    struct PositionHash
+    {
+      size_t operator()(const glm::vec3& p) const
+      {
+        uint32_t bits[3];
+        std::memcpy(bits, &p, sizeof(bits));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+      }
+    };
+
+    std::unordered_map<glm::vec3, uint32_t, PositionHash> first;
+    first.reserve(indices.size() / 2);
+    for (uint32_t index : indices)
+    {
+      auto [it, inserted] = first.emplace(positions[index], index);
+      if (!inserted && it->second != index)
+      {
+        seam[index]      = 1;
+        seam[it->second] = 1;
+      }
+    }
+  }
+}  // namespace
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<glm::vec3>& positions,
+                                               const std::vector<uint32_t>& indices,
+                                               size_t targetIndexCount, float maxError,
+                                               float* resultError)
+{
+  std::vector<uint32_t> result(indices);
+  float                 error           = 0.0f;
+  size_t                targetTriangles = targetIndexCount / 3;
+
+  std::vector<Edge> edges;
+  collectEdges(result, edges);
+
+  std::vector<Quadric> quadrics(positions.size());
+  computeQuadrics(positions, result, edges, quadrics);
+
+  std::vector<uint8_t> seam(positions.size(), 0);
+  lockSeams(positions, result, seam);
+
+  std::vector<VertexKind> kinds(positions.size());
+  std::vector<uint32_t>   adjacencyOffsets(positions.size() + 1);
+  std::vector<uint32_t>   adjacency;
+  std::vector<uint32_t>   remap(positions.size());
+  std::vector<uint8_t>    touched(positions.size());
+  std::vector<Collapse>   collapses;
+
+  // Проходы: стягивания выбираются по возрастанию стоимости так, чтобы окрестности
+  // не пересекались, затем индексы переписываются и рёбра собираются заново
+  while (result.size() / 3 > targetTriangles)
+  {
+    if (edges.empty())
+    {
+      collectEdges(result, edges);
+    }
+
+    // Вид вершин по числу треугольников на их рёбрах
+    for (uint32_t index : result)
+    {
+      kinds[index] = seam[index] ? VertexKind::Locked : VertexKind::Interior;
+    }
+    for (size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+    {
+      end = findEdgeEnd(edges, begin);
+
+      uint32_t vertices[2] = {uint32_t(edges[begin].key >> 32), uint32_t(edges[begin].key)};
+      for (uint32_t vertex : vertices)
+      {
+        if (end - begin > 2)
+        {
+          kinds[vertex] = VertexKind::Locked;
+        }
+        else if (end - begin == 1 && kinds[vertex] == VertexKind::Interior)
+        {
+          kinds[vertex] = VertexKind::Border;
+        }
+      }
+    }
+
+    // Треугольники каждой вершины (смежность в сжатом виде)
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (uint32_t index : result)
+    {
+      adjacencyOffsets[index + 1]++;
+    }
+    for (size_t i = 1; i < adjacencyOffsets.size(); i++)
+    {
+      adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+    }
+    adjacency.resize(result.size());
+    for (uint32_t corner = 0; corner < result.size(); corner++)
+    {
+      adjacency[adjacencyOffsets[result[corner]]++] = corner / 3;
+    }
+    for (size_t i = adjacencyOffsets.size() - 1; i > 0; i--)
+    {
+      adjacencyOffsets[i] = adjacencyOffsets[i - 1];
+    }
+    adjacencyOffsets[0] = 0;
+
+    // Кандидаты: для каждого ребра - более дешёвое из допустимых направлений
+    collapses.clear();
+    for (size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+    {
+      end = findEdgeEnd(edges, begin);
+      if (end - begin > 2)
+      {
+        continue;
+      }
+
+      uint32_t a    = uint32_t(edges[begin].key >> 32);
+      uint32_t b    = uint32_t(edges[begin].key);
+      Collapse best = {std::numeric_limits<float>::max(), 0, 0};
+      for (auto [from, to] : {std::pair(a, b), std::pair(b, a)})
+      {
+        if (kinds[from] == VertexKind::Locked ||
+            (kinds[from] == VertexKind::Border && end - begin != 1))
+        {
+          continue;
+        }
+
+        Quadric quadric = quadrics[from];
+        quadric.add(quadrics[to]);
+        double cost     = quadric.weight > 0.0 ? quadric.evaluate(positions[to]) / quadric.weight
+                                               : 0.0;
+        float  distance = static_cast<float>(std::sqrt(std::max(cost, 0.0)));
+        if (distance < best.cost)
+        {
+          best = {distance, from, to};
+        }
+      }
+      if (best.cost <= maxError)
+      {
+        collapses.push_back(best);
+      }
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+    for (size_t i = 0; i < remap.size(); i++)
+    {
+      remap[i] = static_cast<uint32_t>(i);
+    }
+    std::fill(touched.begin(), touched.end(), 0);
+
+    size_t triangleCount = result.size() / 3;
+    size_t applied       = 0;
+    for (const Collapse& collapse : collapses)
+    {
+      if (triangleCount <= targetTriangles)
+      {
+        break;
+      }
+      if (touched[collapse.from] || touched[collapse.to])
+      {
+        continue;
+      }
+
+      // Треугольники вокруг from не должны вывернуться после переноса вершины
+      uint32_t first   = adjacencyOffsets[collapse.from];
+      uint32_t last    = adjacencyOffsets[collapse.from + 1];
+      size_t   removed = 0;
+      bool     flips   = false;
+      for (uint32_t k = first; k < last && !flips; k++)
+      {
+        const uint32_t* triangle = &result[adjacency[k] * 3];
+        if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+        {
+          removed++;
+          continue;
+        }
+
+        glm::vec3 before[3];
+        glm::vec3 after[3];
+        for (uint32_t j = 0; j < 3; j++)
+        {
+          before[j] = positions[triangle[j]];
+          after[j]  = triangle[j] == collapse.from ? positions[collapse.to] : before[j];
+        }
+        glm::vec3 normalBefore = triangleNormal(before[0], before[1], before[2]);
+        glm::vec3 normalAfter  = triangleNormal(after[0], after[1], after[2]);
+        flips = glm::dot(normalBefore, normalAfter) <=
+                MIN_NORMAL_COS * glm::length(normalBefore) * glm::length(normalAfter);
+      }
+      if (flips)
+      {
+        continue;
+      }
+
+      // Окрестность from блокируется до конца прохода: её треугольники меняются
+      for (uint32_t k = first; k < last; k++)
+      {
+        const uint32_t* triangle = &result[adjacency[k] * 3];
+        touched[triangle[0]]     = 1;
+        touched[triangle[1]]     = 1;
+        touched[triangle[2]]     = 1;
+      }
+      touched[collapse.to] = 1;
+
+      remap[collapse.from] = collapse.to;
+      quadrics[collapse.to].add(quadrics[collapse.from]);
+      triangleCount -= removed;
+      error = std::max(error, collapse.cost);
+      applied++;
+    }
+
+    if (applied == 0)
+    {
+      break;
+    }
+
+    // Перезапись индексов без выродившихся треугольников
+    size_t write = 0;
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+      uint32_t a = remap[result[i]];
+      uint32_t b = remap[result[i + 1]];
+      uint32_t c = remap[result[i + 2]];
+      if (a != b && b != c && c != a)
+      {
+        result[write++] = a;
+        result[write++] = b;
+        result[write++] = c;
+      }
+    }
+    result.resize(write);
+    edges.clear();
+  }
+
+  if (resultError)
+  {
+    *resultError = error;
+  }
+  return result;
+}
+
+LodChain MeshSimplifier::buildLodChain(const std::vector<glm::vec3>& positions,
+                                       const std::vector<uint32_t>& indices,
+                                       const LodChainOptions&       options)
+{
+  LodChain chain;
+  chain.indices = indices;
+  chain.levels.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+  std::vector<uint32_t> current = indices;
+  float                 error   = 0.0f;
+  while (chain.levels.size() < options.maxLevels)
+  {
+    size_t target    = static_cast<size_t>(current.size() / 3 * options.ratio) * 3;
+    float  stepError = 0.0f;
+    std::vector<uint32_t> next =
+        simplify(positions, current, target, options.maxError - error, &stepError);
+
+    // Меш больше не упрощается в пределах ошибки - цепочка закончена
+    float savings = 1.0f - static_cast<float>(next.size()) / static_cast<float>(current.size());
+    if (next.empty() || savings < options.minSavings)
+    {
+      break;
+    }
+
+    error += stepError;
+    chain.levels.push_back(
+        {static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(next.size()), error});
+    chain.indices.insert(chain.indices.end(), next.begin(), next.end());
+    current = std::move(next);
+  }
+  return chain;
+}
@@ -0,0 +1,250 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+  // Номер старшего установленного бита (value > 0)
+  uint32_t highestBit(uint64_t value)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+  }
+
+  // Границы histogram в экспорте (мс): от 1/4 мс до секунды, с отметками 60/30 FPS
+  const double EXPORT_BOUNDS_MS[] = {0.25, 0.5,  1.0,  2.0,   4.0,   8.0,   12.0,  16.7,
+                                     20.0, 33.3, 50.0, 100.0, 250.0, 500.0, 1000.0};
+
+  const double EXPORT_QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+  std::string formatDouble(double value)
+  {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+  }
+
+  std::string nsToSeconds(uint64_t valueNs)
+  {
+    return formatDouble(static_cast<double>(valueNs) * 1e-9);
+  }
+}  // namespace
+
+uint32_t LatencyHistogram::getBucketIndex(uint64_t valueNs)
+{
+  // Значения меньше SUB_BUCKET_COUNT хранятся точно, дальше - SUB_BUCKET_COUNT корзин
+  // на каждую степень двойки
+  if (valueNs < SUB_BUCKET_COUNT)
+  {
+    return static_cast<uint32_t>(valueNs);
+  }
+
+  uint32_t msb = highestBit(valueNs);
+  if (msb >= MAX_VALUE_BITS)
+  {
+    return BUCKET_COUNT - 1;
+  }
+
+  uint32_t octave   = msb - SUB_BUCKET_BITS + 1;
+  uint32_t mantissa = static_cast<uint32_t>(valueNs >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+  return octave * SUB_BUCKET_COUNT + mantissa;
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(uint32_t index)
+{
+  uint32_t octave   = index / SUB_BUCKET_COUNT;
+  uint64_t mantissa = index % SUB_BUCKET_COUNT;
+  if (octave == 0)
+  {
+    return mantissa;
+  }
+  return ((SUB_BUCKET_COUNT + mantissa + 1) << (octave - 1)) - 1;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+  // Счётчики читаются не одновременно, поэтому count берётся как сумма корзин
+  Snapshot result;
+  result.counts.resize(BUCKET_COUNT);
+  for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+  {
+    result.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    result.count += result.counts[i];
+  }
+  result.sumNs = m_sumNs.load(std::memory_order_relaxed);
+  result.maxNs = m_maxNs.load(std::memory_order_relaxed);
+  return result;
+}
+
+uint64_t LatencyHistogram::Snapshot::getPercentile(double fraction) const
+{
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  uint64_t rank =
+      std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(count) + 0.5));
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < counts.size(); i++)
+  {
+    seen += counts[i];
+    if (seen >= rank)
+    {
+      // Верхняя граница корзины не может превышать наблюдавшийся максимум
+      return std::min(getBucketUpperBound(i), maxNs);
+    }
+  }
+  return maxNs;
+}
+
+uint64_t LatencyHistogram::Snapshot::countAtOrBelow(uint64_t boundNs) const
+{
+  uint64_t result = 0;
+  for (uint32_t i = 0; i < counts.size() && getBucketUpperBound(i) <= boundNs; i++)
+  {
+    result += counts[i];
+  }
+  return result;
+}
+
+LatencyHistogram& MetricsRegistry::addHistogram(const std::string& name, const std::string& help)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_histograms.push_back({name, help, std::make_unique<LatencyHistogram>()});
+  return *m_histograms.back().metric;
+}
+
+MetricsCounter& MetricsRegistry::addCounter(const std::string& name, const std::string& help)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_counters.push_back({name, help, std::make_unique<MetricsCounter>()});
+  return *m_counters.back().metric;
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (const auto& entry : m_histograms)
+  {
+    LatencyHistogram::Snapshot snapshot = entry.metric->snapshot();
+
+    out << "# HELP " << entry.name << " " << entry.help << "\n";
+    out << "# TYPE " << entry.name << " histogram\n";
+    for (double boundMs : EXPORT_BOUNDS_MS)
+    {
+      uint64_t boundNs = static_cast<uint64_t>(boundMs * 1e6);
+      out << entry.name << "_bucket{le=\"" << formatDouble(boundMs * 1e-3) << "\"} "
+          << snapshot.countAtOrBelow(boundNs) << "\n";
+    }
+    out << entry.name << "_bucket{le=\"+Inf\"} " << snapshot.count << "\n";
+    out << entry.name << "_sum " << nsToSeconds(snapshot.sumNs) << "\n";
+    out << entry.name << "_count " << snapshot.count << "\n";
+
+    // Перцентили по полному разрешению: у histogram выше точность ограничена границами
+    out << "# HELP " << entry.name << "_quantile " << entry.help << " (перцентили)\n";
+    out << "# TYPE " << entry.name << "_quantile gauge\n";
+    for (double quantile : EXPORT_QUANTILES)
+    {
+      out << entry.name << "_quantile{quantile=\"" << formatDouble(quantile) << "\"} "
+          << nsToSeconds(snapshot.getPercentile(quantile)) << "\n";
+    }
+    out << entry.name << "_quantile{quantile=\"1\"} " << nsToSeconds(snapshot.maxNs) << "\n";
+  }
+
+  for (const auto& entry : m_counters)
+  {
+    out << "# HELP " << entry.name << " " << entry.help << "\n";
+    out << "# TYPE " << entry.name << " counter\n";
+    out << entry.name << " " << entry.metric->get() << "\n";
+  }
+}
+
+MetricsExporter::MetricsExporter(const MetricsRegistry& registry, const std::string& path,
+                                 double intervalSec)
+    : m_registry(registry), m_path(path), m_intervalSec(intervalSec)
+{
+}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+void MetricsExporter::start()
+{
+  m_stopping = false;
+  m_thread   = std::thread(&MetricsExporter::exportLoop, this);
+}
+
+void MetricsExporter::stop()
+{
+  if (!m_thread.joinable())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wakeUp.notify_all();
+  m_thread.join();
+}
+
+bool MetricsExporter::writeSnapshot() const
+{
+  // Запись рядом с целевым файлом: rename атомарен только в пределах одной файловой системы
+  std::string temporaryPath = m_path + ".tmp";
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      std::cerr << "Не удалось открыть файл метрик: " << temporaryPath << std::endl;
+      return false;
+    }
+    m_registry.writePrometheus(file);
+    if (!file)
+    {
+      std::cerr << "Не удалось записать файл метрик: " << temporaryPath << std::endl;
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, m_path, error);
+  if (error)
+  {
+    std::cerr << "Не удалось заменить файл метрик " << m_path << ": " << error.message()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void MetricsExporter::exportLoop()
+{
+  auto interval = std::chrono::duration<double>(m_intervalSec);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stopping)
+  {
+    m_wakeUp.wait_for(lock, interval, [this] { return m_stopping; });
+
+    // Снимок пишется и при остановке: последний интервал не теряется
+    lock.unlock();
+    writeSnapshot();
+    lock.lock();
+  }
+}
@@ -0,0 +1,267 @@
+#include "PerformanceHud.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+  // Первый символ шрифта и количество символов (пробел..'Z', строчные выводятся прописными)
+  const char     FIRST_CHAR = ' ';
+  const uint32_t CHAR_COUNT = 59;
+
+  // Ячейка атласа: символ 5x7 и промежуток в один пиксель справа и снизу
+  const uint32_t CELL_WIDTH    = 6;
+  const uint32_t CELL_HEIGHT   = 8;
+  const uint32_t GLYPH_WIDTH   = 5;
+  const uint32_t GLYPH_HEIGHT  = 7;
+  const uint32_t ATLAS_COLUMNS = 16;
+  const uint32_t SOLID_CELL    = 63;  // Последняя ячейка атласа полностью заполнена
+
+  // Строки символов сверху вниз, старший из пяти битов - левый пиксель
+  const uint8_t FONT_5X7[CHAR_COUNT][GLYPH_HEIGHT] = {
+      {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+      {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},  // '!'
+      {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00},  // '"'
+      {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A},  // '#'
+      {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04},  // '$'
+      {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03},  // '%'
+      {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D},  // '&'
+      {0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00},  // '''
+      {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02},  // '('
+      {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08},  // ')'
+      {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00},  // '*'
+      {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00},  // '+'
+      {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08},  // ','
+      {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},  // '-'
+      {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},  // '.'
+      {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00},  // '/'
+      {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},  // '0'
+      {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},  // '1'
+      {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},  // '2'
+      {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},  // '3'
+      {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},  // '4'
+      {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},  // '5'
+      {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},  // '6'
+      {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},  // '7'
+      {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},  // '8'
+      {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},  // '9'
+      {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},  // ':'
+      {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08},  // ';'
+      {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02},  // '<'
+      {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00},  // '='
+      {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08},  // '>'
+      {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04},  // '?'
+      {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E},  // '@'
+      {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11},  // 'A'
+      {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},  // 'B'
+      {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},  // 'C'
+      {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},  // 'D'
+      {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},  // 'E'
+      {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},  // 'F'
+      {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},  // 'G'
+      {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // 'H'
+      {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},  // 'I'
+      {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // 'J'
+      {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},  // 'K'
+      {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},  // 'L'
+      {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},  // 'M'
+      {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},  // 'N'
+      {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // 'O'
+      {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},  // 'P'
+      {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},  // 'Q'
+      {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},  // 'R'
+      {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},  // 'S'
+      {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},  // 'T'
+      {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // 'U'
+      {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},  // 'V'
+      {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},  // 'W'
+      {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},  // 'X'
+      {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04},  // 'Y'
+      {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},  // 'Z'
+  };
+
+  // Цвета оверлея
+  const uint32_t BACKGROUND_COLOR = PerformanceHud::packColor(0, 0, 0, 160);
+  const uint32_t TEXT_COLOR       = PerformanceHud::packColor(230, 230, 230);
+  const uint32_t GOOD_COLOR       = PerformanceHud::packColor(80, 200, 80);
+  const uint32_t SLOW_COLOR       = PerformanceHud::packColor(230, 200, 60);
+  const uint32_t BAD_COLOR        = PerformanceHud::packColor(230, 70, 60);
+  const uint32_t TARGET_COLOR     = PerformanceHud::packColor(255, 255, 255, 96);
+
+  // Ячейка атласа символа (неизвестные символы показываются как '?')
+  uint32_t glyphCell(char c)
+  {
+    if (c >= 'a' && c <= 'z')
+    {
+      c = static_cast<char>(c - 'a' + 'A');
+    }
+    uint32_t cell = static_cast<uint32_t>(static_cast<unsigned char>(c)) - FIRST_CHAR;
+    return cell < CHAR_COUNT ? cell : static_cast<uint32_t>('?' - FIRST_CHAR);
+  }
+
+  // Мегабайты без дробной части
+  unsigned long long toMegabytes(uint64_t bytes)
+  {
+    return static_cast<unsigned long long>(bytes >> 20);
+  }
+}  // namespace
+
+std::vector<uint8_t> PerformanceHud::buildFontAtlas()
+{
+  std::vector<uint8_t> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+  for (uint32_t cell = 0; cell <= SOLID_CELL; cell++)
+  {
+    uint32_t originX = (cell % ATLAS_COLUMNS) * CELL_WIDTH;
+    uint32_t originY = (cell / ATLAS_COLUMNS) * CELL_HEIGHT;
+    for (uint32_t y = 0; y < CELL_HEIGHT; y++)
+    {
+      for (uint32_t x = 0; x < CELL_WIDTH; x++)
+      {
+        bool set = cell == SOLID_CELL;
+        if (cell < CHAR_COUNT && x < GLYPH_WIDTH && y < GLYPH_HEIGHT)
+        {
+          set = (FONT_5X7[cell][y] >> (GLYPH_WIDTH - 1 - x)) & 1;
+        }
+        pixels[(originY + y) * ATLAS_WIDTH + originX + x] = set ? 255 : 0;
+      }
+    }
+  }
+  return pixels;
+}
+
+uint32_t PerformanceHud::packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+  return static_cast<uint32_t>(r) | static_cast<uint32_t>(g) << 8 |
+         static_cast<uint32_t>(b) << 16 | static_cast<uint32_t>(a) << 24;
+}
+
+void PerformanceHud::addFrame(const HudFrameStats& stats)
+{
+  m_stats                  = stats;
+  m_history[m_historyHead] = stats.frameMs;
+  m_historyHead            = (m_historyHead + 1) % HISTORY_SIZE;
+  m_historyCount           = std::min(m_historyCount + 1, static_cast<uint32_t>(HISTORY_SIZE));
+}
+
+uint32_t PerformanceHud::build(HudVertex* vertices, uint32_t capacity) const
+{
+  VertexWriter writer = {vertices, capacity, 0};
+
+  // Строки показателей (snprintf обрезает их до MAX_LINE_CHARS символов)
+  char  lines[LINE_COUNT][MAX_LINE_CHARS + 1];
+  float fps = m_stats.frameMs > 0.0f ? 1000.0f / m_stats.frameMs : 0.0f;
+  std::snprintf(lines[0], sizeof(lines[0]), "FRAME %6.2f MS %5.0f FPS", m_stats.frameMs, fps);
+  std::snprintf(lines[1], sizeof(lines[1]), "CPU %5.2f MS  GPU %5.2f MS", m_stats.cpuMs,
+                m_stats.gpuMs);
+  std::snprintf(lines[2], sizeof(lines[2]), "CULL %4.2f LOD %4.2f PART %4.2f", m_stats.cullMs,
+                m_stats.lodMs, m_stats.particlesMs);
+  std::snprintf(lines[3], sizeof(lines[3]), "DRAWS %u  TRIS %llu", m_stats.draws,
+                static_cast<unsigned long long>(m_stats.triangles));
+  std::snprintf(lines[4], sizeof(lines[4]), "VRAM %llu / %llu MB",
+                toMegabytes(m_stats.memoryUsage), toMegabytes(m_stats.memoryBudget));
+
+  // Раскладка в пикселях шрифта, умноженных на масштаб
+  float scale       = static_cast<float>(m_scale);
+  float margin      = 4.0f * scale;
+  float lineHeight  = (CELL_HEIGHT + 2) * scale;
+  float graphWidth  = HISTORY_SIZE * scale * 0.5f;
+  float graphTop    = margin + LINE_COUNT * lineHeight;
+  float graphHeight = 24.0f * scale;
+
+  size_t longestLine = 0;
+  for (const char* line : lines)
+  {
+    longestLine = std::max(longestLine, std::strlen(line));
+  }
+  float panelWidth = std::max(graphWidth, longestLine * CELL_WIDTH * scale) + 2.0f * margin;
+
+  emitRect(writer, 0.0f, 0.0f, panelWidth, graphTop + graphHeight + margin, BACKGROUND_COLOR);
+  for (uint32_t line = 0; line < LINE_COUNT; line++)
+  {
+    emitText(writer, margin, margin + line * lineHeight, lines[line], TEXT_COLOR);
+  }
+
+  // График: столбец на кадр, самый новый справа. Шкала - не меньше двух целевых кадров,
+  // поэтому нормальные кадры не растягиваются на всю высоту
+  float peak = 2.0f * TARGET_FRAME_MS;
+  for (uint32_t i = 0; i < m_historyCount; i++)
+  {
+    peak = std::max(peak, m_history[i]);
+  }
+  float barWidth  = graphWidth / HISTORY_SIZE;
+  float graphLeft = margin + graphWidth - m_historyCount * barWidth;
+  float graphBase = graphTop + graphHeight;
+  for (uint32_t i = 0; i < m_historyCount; i++)
+  {
+    float    ms     = m_history[(m_historyHead + HISTORY_SIZE - m_historyCount + i) % HISTORY_SIZE];
+    float    height = std::max(ms / peak * graphHeight, 1.0f);
+    uint32_t color  = ms <= TARGET_FRAME_MS          ? GOOD_COLOR
+                      : ms <= 2.0f * TARGET_FRAME_MS ? SLOW_COLOR
+                                                     : BAD_COLOR;
+    emitRect(writer, graphLeft + i * barWidth, graphBase - height, barWidth, height, color);
+  }
+
+  // Линия целевого времени кадра
+  float targetY = graphBase - TARGET_FRAME_MS / peak * graphHeight;
+  emitRect(writer, margin, targetY, graphWidth, 1.0f, TARGET_COLOR);
+
+  return writer.count;
+}
+
+void PerformanceHud::emitQuad(VertexWriter& writer, float x0, float y0, float x1, float y1,
+                              float u0, float v0, float u1, float v1, uint32_t color) const
+{
+  if (writer.count + 6 > writer.capacity)
+  {
+    return;
+  }
+
+  // Вершины собираются на стеке: буфер может быть отображённой памятью GPU, которую
+  // нельзя читать обратно (копирование out[3] = out[0] читало бы её)
+  HudVertex topLeft     = {{x0, y0}, {u0, v0}, color};
+  HudVertex topRight    = {{x1, y0}, {u1, v0}, color};
+  HudVertex bottomRight = {{x1, y1}, {u1, v1}, color};
+  HudVertex bottomLeft  = {{x0, y1}, {u0, v1}, color};
+
+  HudVertex* out = writer.vertices + writer.count;
+  out[0]         = topLeft;
+  out[1]         = topRight;
+  out[2]         = bottomRight;
+  out[3]         = topLeft;
+  out[4]         = bottomRight;
+  out[5]         = bottomLeft;
+  writer.count += 6;
+}
+
+void PerformanceHud::emitRect(VertexWriter& writer, float x, float y, float width, float height,
+                              uint32_t color) const
+{
+  // Центр сплошной ячейки: при любой фильтрации выборка даёт полную яркость
+  float u = ((SOLID_CELL % ATLAS_COLUMNS) * CELL_WIDTH + CELL_WIDTH * 0.5f) / ATLAS_WIDTH;
+  float v = ((SOLID_CELL / ATLAS_COLUMNS) * CELL_HEIGHT + CELL_HEIGHT * 0.5f) / ATLAS_HEIGHT;
+  emitQuad(writer, x, y, x + width, y + height, u, v, u, v, color);
+}
+
+void PerformanceHud::emitText(VertexWriter& writer, float x, float y, const char* text,
+                              uint32_t color) const
+{
+  float scale  = static_cast<float>(m_scale);
+  float width  = GLYPH_WIDTH * scale;
+  float height = GLYPH_HEIGHT * scale;
+  for (; *text; text++, x += CELL_WIDTH * scale)
+  {
+    // Пробел не рисуется
+    uint32_t cell = glyphCell(*text);
+    if (cell == 0)
+    {
+      continue;
+    }
+
+    float u0 = static_cast<float>((cell % ATLAS_COLUMNS) * CELL_WIDTH) / ATLAS_WIDTH;
+    float v0 = static_cast<float>((cell / ATLAS_COLUMNS) * CELL_HEIGHT) / ATLAS_HEIGHT;
+    float u1 = u0 + static_cast<float>(GLYPH_WIDTH) / ATLAS_WIDTH;
+    float v1 = v0 + static_cast<float>(GLYPH_HEIGHT) / ATLAS_HEIGHT;
+    emitQuad(writer, x, y, x + width, y + height, u0, v0, u1, v1, color);
+  }
+}
@@ -0,0 +1,126 @@
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <array>
+
+#include "ThreadPool.h"
+
+namespace RadixSort
+{
+  namespace
+  {
+    // Меньшие массивы быстрее сортировать в одном потоке
+    const uint32_t PARALLEL_THRESHOLD = 16384;
+    const uint32_t MAX_CHUNKS         = 64;
+
+    using Histogram = std::array<uint32_t, 256>;
+  }  // namespace
+
+  void sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch, ThreadPool* pool)
+  {
+    uint32_t count = static_cast<uint32_t>(entries.size());
+    if (count < 2)
+    {
+      return;
+    }
+    scratch.resize(count);
+
+    // Разбиение на блоки фиксировано на все проходы, чтобы раскладка оставалась стабильной
+    uint32_t chunks = 1;
+    if (pool && count >= PARALLEL_THRESHOLD)
+    {
+      chunks = std::min(pool->getMaxChunks(), MAX_CHUNKS);
+    }
+    uint32_t chunkSize = (count + chunks - 1) / chunks;
+
+    std::array<Histogram, MAX_CHUNKS> histograms;
+    SortEntry*                        src = entries.data();
+    SortEntry*                        dst = scratch.data();
+
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+      // Гистограммы байта по блокам
+      auto countChunk = [&](uint32_t chunk)
+      {
+        Histogram& histogram = histograms[chunk];
+        histogram.fill(0);
+        uint32_t end = std::min(count, (chunk + 1) * chunkSize);
+        for (uint32_t i = chunk * chunkSize; i < end; i++)
+        {
+          histogram[(src[i].key >> shift) & 0xFF]++;
+        }
+      };
+
+      if (chunks > 1)
+      {
+        pool->parallelFor(chunks, 1, [&](uint32_t begin, uint32_t end, uint32_t)
+                          {
+                            for (uint32_t chunk = begin; chunk < end; chunk++)
+                            {
+                              countChunk(chunk);
+                            }
+                          });
+      }
+      else
+      {
+        countChunk(0);
+      }
+
+      // Префиксные суммы: по корзинам, внутри корзины - по блокам в исходном порядке
+      uint32_t offset       = 0;
+      bool     singleBucket = false;
+      for (uint32_t bucket = 0; bucket < 256; bucket++)
+      {
+        uint32_t bucketTotal = 0;
+        for (uint32_t chunk = 0; chunk < chunks; chunk++)
+        {
+          uint32_t value             = histograms[chunk][bucket];
+          histograms[chunk][bucket]  = offset + bucketTotal;
+          bucketTotal               += value;
+        }
+        singleBucket = singleBucket || bucketTotal == count;
+        offset += bucketTotal;
+      }
+
+      // Все ключи совпадают в этом байте - проход ничего не меняет
+      if (singleBucket)
+      {
+        continue;
+      }
+
+      // Стабильная раскладка
+      auto scatterChunk = [&](uint32_t chunk)
+      {
+        Histogram& offsets = histograms[chunk];
+        uint32_t   end     = std::min(count, (chunk + 1) * chunkSize);
+        for (uint32_t i = chunk * chunkSize; i < end; i++)
+        {
+          dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+      };
+
+      if (chunks > 1)
+      {
+        pool->parallelFor(chunks, 1, [&](uint32_t begin, uint32_t end, uint32_t)
+                          {
+                            for (uint32_t chunk = begin; chunk < end; chunk++)
+                            {
+                              scatterChunk(chunk);
+                            }
+                          });
+      }
+      else
+      {
+        scatterChunk(0);
+      }
+
+      std::swap(src, dst);
+    }
+
+    // После нечётного числа выполненных проходов результат лежит в scratch
+    if (src != entries.data())
+    {
+      entries.swap(scratch);
+    }
+  }
+}  // namespace RadixSort
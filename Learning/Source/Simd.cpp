@@ -0,0 +1,45 @@
+#include "Simd.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace
+{
+  bool detectAvx2()
+  {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    // Лист 1: FMA, OSXSAVE и AVX; лист 7: AVX2
+    int info[4];
+    __cpuid(info, 1);
+    bool fma     = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx)
+    {
+      return false;
+    }
+
+    // ОС должна сохранять регистры YMM при переключении контекста
+    if ((_xgetbv(0) & 0x6) != 0x6)
+    {
+      return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+  }
+}  // namespace
+
+bool Simd::hasAvx2()
+{
+  static const bool supported = detectAvx2();
+  return supported;
+}
@@ -0,0 +1,152 @@
+#include "SpriteBatcher.h"
+
+#include <algorithm>
+
+namespace
+{
+  // Нормализованная координата в unorm16
+  uint16_t toUnorm16(float value)
+  {
+    float clamped = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint16_t>(clamped * 65535.0f + 0.5f);
+  }
+}  // namespace
+
+SpriteBatcher::SpriteBatcher(uint32_t pageCount, ThreadPool* pool)
+    : m_pageCount(std::max(pageCount, 1u)), m_pool(pool)
+{
+  m_chunkOffsets.resize((m_pool ? m_pool->getMaxChunks() : 1) * m_pageCount);
+}
+
+std::vector<uint32_t> SpriteBatcher::buildQuadIndices(uint32_t quadCount)
+{
+  std::vector<uint32_t> indices(static_cast<size_t>(quadCount) * 6);
+  for (uint32_t quad = 0; quad < quadCount; quad++)
+  {
+    uint32_t  first = quad * 4;
+    uint32_t* out   = indices.data() + static_cast<size_t>(quad) * 6;
+    out[0]          = first;
+    out[1]          = first + 1;
+    out[2]          = first + 2;
+    out[3]          = first + 2;
+    out[4]          = first + 3;
+    out[5]          = first;
+  }
+  return indices;
+}
+
+Sprite* SpriteBatcher::allocate(uint32_t count)
+{
+  size_t first = m_sprites.size();
+  m_sprites.resize(first + count);
+  return m_sprites.data() + first;
+}
+
+void SpriteBatcher::setViewport(float width, float height)
+{
+  m_scaleX = 2.0f / width;
+  m_scaleY = 2.0f / height;
+}
+
+const std::vector<SpriteBatch>& SpriteBatcher::build(SpriteVertex* vertices, uint32_t maxQuads)
+{
+  m_batches.clear();
+  uint32_t count = getSpriteCount();
+  if (count == 0)
+  {
+    return m_batches;
+  }
+
+  // Подсчёт спрайтов каждой страницы в каждом блоке. Пустые блоки parallelFor
+  // не вызываются, поэтому счётчики обнуляются заранее
+  std::fill(m_chunkOffsets.begin(), m_chunkOffsets.end(), 0u);
+  auto countRange = [&](uint32_t begin, uint32_t end, uint32_t chunk)
+  {
+    uint32_t* counts = m_chunkOffsets.data() + chunk * m_pageCount;
+    for (uint32_t i = begin; i < end; i++)
+    {
+      counts[m_sprites[i].page]++;
+    }
+  };
+  uint32_t chunks = 1;
+  if (m_pool)
+  {
+    chunks = m_pool->parallelFor(count, MIN_CHUNK, countRange);
+  }
+  else
+  {
+    countRange(0, count, 0);
+  }
+
+  // Префиксная сумма по страницам, внутри страницы - по блокам: каждый блок пишет в
+  // свой непрерывный участок пачки, и порядок добавления сохраняется
+  uint32_t quad = 0;
+  for (uint32_t page = 0; page < m_pageCount; page++)
+  {
+    SpriteBatch batch = {};
+    batch.page        = page;
+    batch.firstQuad   = quad;
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+      uint32_t& slot = m_chunkOffsets[chunk * m_pageCount + page];
+      uint32_t  size = slot;
+      slot           = quad;
+      quad += size;
+    }
+
+    // Спрайты сверх вместимости отбрасываются с конца
+    batch.quadCount = std::min(quad, maxQuads) - std::min(batch.firstQuad, maxQuads);
+    if (batch.quadCount > 0)
+    {
+      m_batches.push_back(batch);
+    }
+  }
+
+  // Тот же count и MIN_CHUNK дают то же разбиение на блоки, что и при подсчёте
+  auto writeChunk = [&](uint32_t begin, uint32_t end, uint32_t chunk)
+  { writeRange(vertices, maxQuads, begin, end, m_chunkOffsets.data() + chunk * m_pageCount); };
+  if (m_pool)
+  {
+    m_pool->parallelFor(count, MIN_CHUNK, writeChunk);
+  }
+  else
+  {
+    writeChunk(0, count, 0);
+  }
+  return m_batches;
+}
+
+void SpriteBatcher::writeRange(SpriteVertex* vertices, uint32_t maxQuads, uint32_t begin,
+                               uint32_t end, uint32_t* offsets) const
+{
+  for (uint32_t i = begin; i < end; i++)
+  {
+    const Sprite& sprite = m_sprites[i];
+    uint32_t      quad   = offsets[sprite.page]++;
+    if (quad >= maxQuads)
+    {
+      continue;
+    }
+
+    float    x0 = sprite.x * m_scaleX - 1.0f;
+    float    y0 = sprite.y * m_scaleY - 1.0f;
+    float    x1 = x0 + sprite.width * m_scaleX;
+    float    y1 = y0 + sprite.height * m_scaleY;
+    uint16_t u0 = toUnorm16(sprite.u0);
+    uint16_t v0 = toUnorm16(sprite.v0);
+    uint16_t u1 = toUnorm16(sprite.u1);
+    uint16_t v1 = toUnorm16(sprite.v1);
+
+    // Вершины собираются на стеке и пишутся один раз: отображённую память GPU не читаем
+    SpriteVertex topLeft     = {{x0, y0}, {u0, v0}, sprite.color};
+    SpriteVertex topRight    = {{x1, y0}, {u1, v0}, sprite.color};
+    SpriteVertex bottomRight = {{x1, y1}, {u1, v1}, sprite.color};
+    SpriteVertex bottomLeft  = {{x0, y1}, {u0, v1}, sprite.color};
+
+    SpriteVertex* out = vertices + static_cast<size_t>(quad) * 4;
+    out[0]            = topLeft;
+    out[1]            = topRight;
+    out[2]            = bottomRight;
+    out[3]            = bottomLeft;
+  }
+}
@@ -0,0 +1,217 @@
+#include "StartupGraph.h"
+
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
+uint32_t StartupGraph::addStage(const std::string& name, StartupThread thread,
+                                const std::vector<uint32_t>& dependencies, StageFn fn)
+{
+  uint32_t index = static_cast<uint32_t>(m_stages.size());
+  for (uint32_t dependency : dependencies)
+  {
+    // Зависимости только на уже добавленные стадии: циклы невозможны
+    if (dependency >= index)
+    {
+      throw std::invalid_argument("Стадия " + name + " зависит от ещё не добавленной стадии");
+    }
+  }
+
+  Stage stage;
+  stage.name         = name;
+  stage.thread       = thread;
+  stage.dependencies = dependencies;
+  stage.fn           = std::move(fn);
+  m_stages.push_back(std::move(stage));
+  return index;
+}
+
+bool StartupGraph::isReady(const Stage& stage) const
+{
+  for (uint32_t dependency : stage.dependencies)
+  {
+    if (m_stages[dependency].state != StageState::Done)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StartupGraph::execute(uint32_t index, std::string& error)
+{
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  Stage&                                stage = m_stages[index];
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  stage.startMs                               = Milliseconds(start - m_startTime).count();
+
+  try
+  {
+    stage.fn();
+  }
+  catch (const std::exception& e)
+  {
+    error = stage.name + ": " + e.what();
+  }
+  catch (...)
+  {
+    error = stage.name + ": неизвестная ошибка";
+  }
+
+  stage.timeMs = Milliseconds(std::chrono::steady_clock::now() - start).count();
+}
+
+bool StartupGraph::run(ThreadPool& pool)
+{
+  m_startTime = std::chrono::steady_clock::now();
+  m_error.clear();
+
+  // Состояния стадий меняются только под mutex; тело стадии выполняется без него
+  std::mutex              mutex;
+  std::condition_variable stageFinished;
+  uint32_t                running = 0;
+  bool                    failed  = false;
+
+  auto finish = [&](uint32_t index, const std::string& error)
+  {
+    m_stages[index].state = error.empty() ? StageState::Done : StageState::Failed;
+    if (!error.empty() && !failed)
+    {
+      failed  = true;
+      m_error = error;
+    }
+    running--;
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    // Рабочие стадии отправляются в пул сразу, стадия главного потока - одна за проход
+    int32_t mainStage = -1;
+    for (uint32_t i = 0; i < m_stages.size(); i++)
+    {
+      Stage& stage = m_stages[i];
+      if (stage.state != StageState::Pending)
+      {
+        continue;
+      }
+      if (failed)
+      {
+        stage.state = StageState::Skipped;
+        continue;
+      }
+
+      if (!isReady(stage))
+      {
+        continue;
+      }
+
+      if (stage.thread == StartupThread::Worker)
+      {
+        stage.state = StageState::Running;
+        running++;
+        pool.submit(
+            [this, i, &mutex, &stageFinished, &finish]
+            {
+              std::string error;
+              execute(i, error);
+
+              std::lock_guard<std::mutex> guard(mutex);
+              finish(i, error);
+              stageFinished.notify_all();
+            });
+      }
+      else if (mainStage < 0)
+      {
+        mainStage = static_cast<int32_t>(i);
+      }
+    }
+
+    if (mainStage >= 0)
+    {
+      m_stages[mainStage].state = StageState::Running;
+      running++;
+
+      lock.unlock();
+      std::string error;
+      execute(static_cast<uint32_t>(mainStage), error);
+      lock.lock();
+
+      finish(static_cast<uint32_t>(mainStage), error);
+      continue;
+    }
+
+    if (running == 0)
+    {
+      // Ждать больше нечего: все стадии выполнены или пропущены
+      break;
+    }
+    stageFinished.wait(lock);
+  }
+
+  m_totalMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime)
+          .count();
+  return !failed;
+}
+
+void StartupGraph::printReport(std::ostream& out) const
+{
+  std::ios_base::fmtflags flags = out.flags();
+
+  out << "Время запуска по стадиям (мс):" << std::endl;
+  double serialMs = 0.0;
+  for (const auto& stage : m_stages)
+  {
+    out << "  " << std::left << std::setw(22) << stage.name << std::right
+        << (stage.thread == StartupThread::Main ? " главный" : " пул    ");
+    if (stage.state == StageState::Skipped || stage.state == StageState::Pending)
+    {
+      out << "  пропущена" << std::endl;
+      continue;
+    }
+    out << std::fixed << std::setprecision(2) << "  начало " << std::setw(9) << stage.startMs
+        << "  длительность " << std::setw(9) << stage.timeMs
+        << (stage.state == StageState::Failed ? "  ОШИБКА" : "") << std::endl;
+    serialMs += stage.timeMs;
+  }
+
+  // Критический путь: от стадии, завершившейся последней, назад по самой поздней зависимости
+  std::vector<const Stage*> path;
+  const Stage*              current = nullptr;
+  for (const auto& stage : m_stages)
+  {
+    if (stage.state == StageState::Done &&
+        (!current || stage.startMs + stage.timeMs > current->startMs + current->timeMs))
+    {
+      current = &stage;
+    }
+  }
+  while (current)
+  {
+    path.push_back(current);
+    const Stage* latest = nullptr;
+    for (uint32_t dependency : current->dependencies)
+    {
+      const Stage& candidate = m_stages[dependency];
+      if (!latest || candidate.startMs + candidate.timeMs > latest->startMs + latest->timeMs)
+      {
+        latest = &candidate;
+      }
+    }
+    current = latest;
+  }
+
+  out << "  Критический путь:";
+  for (auto it = path.rbegin(); it != path.rend(); ++it)
+  {
+    out << (it == path.rbegin() ? " " : " -> ") << (*it)->name;
+  }
+  out << std::endl;
+
+  out << std::fixed << std::setprecision(2) << "  Итого " << m_totalMs
+      << " мс, последовательно было бы " << serialMs << " мс" << std::endl;
+  out.flags(flags);
+}
@@ -0,0 +1,134 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+  if (workerCount == 0)
+  {
+    uint32_t cores = std::thread::hardware_concurrency();
+    workerCount    = cores > 1 ? cores - 1 : 1;
+  }
+
+  m_workers.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    m_workers.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_taskAvailable.notify_all();
+
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+  }
+  m_taskAvailable.notify_one();
+}
+
+uint32_t ThreadPool::parallelFor(uint32_t count, uint32_t minChunk,
+                                 const std::function<void(uint32_t, uint32_t, uint32_t)>& fn)
+{
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  // Количество блоков ограничено числом потоков и минимальным размером блока
+  uint32_t chunks = std::min(getThreadCount(), (count + minChunk - 1) / std::max(minChunk, 1u));
+  chunks          = std::max(chunks, 1u);
+  if (chunks == 1)
+  {
+    fn(0, count, 0);
+    return 1;
+  }
+
+  uint32_t              chunkSize = (count + chunks - 1) / chunks;
+  std::atomic<uint32_t> remaining(chunks - 1);
+
+  // Блоки 1..N-1 уходят в очередь, нулевой выполняется на месте
+  for (uint32_t chunk = 1; chunk < chunks; chunk++)
+  {
+    submit(
+        [&, chunk]
+        {
+          uint32_t begin = chunk * chunkSize;
+          uint32_t end   = std::min(count, begin + chunkSize);
+          if (begin < end)
+          {
+            fn(begin, end, chunk);
+          }
+
+          if (remaining.fetch_sub(1) == 1)
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_taskFinished.notify_all();
+          }
+        });
+  }
+
+  fn(0, std::min(count, chunkSize), 0);
+
+  // Пока ждём, помогаем выполнять очередь
+  while (remaining.load() != 0)
+  {
+    if (!runPendingTask())
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_taskFinished.wait(lock, [&] { return remaining.load() == 0 || !m_tasks.empty(); });
+    }
+  }
+
+  return chunks;
+}
+
+bool ThreadPool::runPendingTask()
+{
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_tasks.empty())
+    {
+      return false;
+    }
+    task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+  }
+
+  task();
+  return true;
+}
+
+void ThreadPool::workerLoop()
+{
+  while (true)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+      if (m_stopping && m_tasks.empty())
+      {
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+  }
+}
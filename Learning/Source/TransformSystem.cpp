@@ -0,0 +1,387 @@
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+TransformSystem::TransformSystem(ThreadPool* pool) : m_pool(pool)
+{
+  // Узел 0 - единичный корень: мировая матрица не меняется, флаг изменения всегда 0
+  for (auto& component : m_position)
+  {
+    component.push_back(0.0f);
+  }
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    m_rotation[i].push_back(i == 3 ? 1.0f : 0.0f);
+  }
+  for (auto& component : m_scale)
+  {
+    component.push_back(1.0f);
+  }
+  for (uint32_t i = 0; i < 12; i++)
+  {
+    m_world[i].push_back(i == 0 || i == 4 || i == 8 ? 1.0f : 0.0f);
+  }
+  m_parent.push_back(0);
+  m_localDirty.push_back(0);
+  m_changed.push_back(0);
+  m_indexToHandle.push_back(INVALID_TRANSFORM);
+  m_levelStart.push_back(1);
+
+  m_chunkChanged.resize(m_pool ? m_pool->getMaxChunks() : 1);
+}
+
+TransformHandle TransformSystem::create(TransformHandle parent)
+{
+  uint32_t parentIndex = parent == INVALID_TRANSFORM ? 0 : getIndex(parent);
+  uint32_t index       = static_cast<uint32_t>(m_parent.size());
+
+  // Новый узел дописывается в конец, место по глубине он получит в rebuildOrder()
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_position[i].push_back(0.0f);
+    m_scale[i].push_back(1.0f);
+  }
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    m_rotation[i].push_back(i == 3 ? 1.0f : 0.0f);
+  }
+  for (auto& component : m_world)
+  {
+    component.push_back(0.0f);
+  }
+  m_parent.push_back(parentIndex);
+  m_localDirty.push_back(1);
+  m_changed.push_back(0);
+
+  TransformHandle handle;
+  if (!m_freeHandles.empty())
+  {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+    m_handleToIndex[handle] = index;
+  }
+  else
+  {
+    handle = static_cast<TransformHandle>(m_handleToIndex.size());
+    m_handleToIndex.push_back(index);
+  }
+  m_indexToHandle.push_back(handle);
+
+  m_orderDirty = true;
+  return handle;
+}
+
+void TransformSystem::destroy(TransformHandle handle)
+{
+  uint32_t index  = getIndex(handle);
+  uint32_t parent = m_parent[index];
+
+  // Дети переходят к деду; их мировые матрицы изменятся при следующем update()
+  for (uint32_t i = 1; i < m_parent.size(); i++)
+  {
+    if (m_parent[i] == index)
+    {
+      m_parent[i]     = parent;
+      m_localDirty[i] = 1;
+    }
+  }
+
+  // Сам узел отсоединяется от дерева и исчезнет из массивов в rebuildOrder()
+  m_parent[index]         = INVALID_INDEX;
+  m_indexToHandle[index]  = INVALID_TRANSFORM;
+  m_handleToIndex[handle] = INVALID_INDEX;
+  m_freeHandles.push_back(handle);
+  m_orderDirty = true;
+}
+
+void TransformSystem::setParent(TransformHandle handle, TransformHandle parent)
+{
+  uint32_t index       = getIndex(handle);
+  uint32_t parentIndex = parent == INVALID_TRANSFORM ? 0 : getIndex(parent);
+
+  // Цикл: новый родитель лежит в поддереве узла
+  for (uint32_t ancestor = parentIndex; ancestor != 0; ancestor = m_parent[ancestor])
+  {
+    if (ancestor == index)
+    {
+      throw std::invalid_argument("Родитель узла преобразований не может быть его потомком");
+    }
+  }
+
+  m_parent[index]     = parentIndex;
+  m_localDirty[index] = 1;
+  m_orderDirty        = true;
+}
+
+void TransformSystem::setLocal(TransformHandle handle, const glm::vec3& position,
+                               const glm::quat& rotation, const glm::vec3& scale)
+{
+  setPosition(handle, position);
+  setRotation(handle, rotation);
+  setScale(handle, scale);
+}
+
+void TransformSystem::setPosition(TransformHandle handle, const glm::vec3& position)
+{
+  uint32_t index = getIndex(handle);
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_position[i][index] = position[i];
+  }
+  m_localDirty[index] = 1;
+}
+
+void TransformSystem::setRotation(TransformHandle handle, const glm::quat& rotation)
+{
+  uint32_t  index      = getIndex(handle);
+  glm::quat normalized = glm::normalize(rotation);
+  m_rotation[0][index] = normalized.x;
+  m_rotation[1][index] = normalized.y;
+  m_rotation[2][index] = normalized.z;
+  m_rotation[3][index] = normalized.w;
+  m_localDirty[index]  = 1;
+}
+
+void TransformSystem::setScale(TransformHandle handle, const glm::vec3& scale)
+{
+  uint32_t index = getIndex(handle);
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    m_scale[i][index] = scale[i];
+  }
+  m_localDirty[index] = 1;
+}
+
+void TransformSystem::update()
+{
+  auto start = std::chrono::steady_clock::now();
+
+  m_stats = {};
+  if (m_orderDirty)
+  {
+    rebuildOrder();
+    m_stats.reordered = true;
+  }
+
+  TransformSoa soa = {};
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    soa.position[i] = m_position[i].data();
+    soa.scale[i]    = m_scale[i].data();
+  }
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    soa.rotation[i] = m_rotation[i].data();
+  }
+  for (uint32_t i = 0; i < 12; i++)
+  {
+    soa.world[i] = m_world[i].data();
+  }
+  soa.parent     = m_parent.data();
+  soa.localDirty = m_localDirty.data();
+  soa.changed    = m_changed.data();
+
+  // Уровни строго по очереди: ядро читает мировые матрицы уже обновлённых родителей
+  uint32_t changed = 0;
+  uint32_t levels  = static_cast<uint32_t>(m_levelStart.size()) - 1;
+  for (uint32_t level = 0; level < levels; level++)
+  {
+    uint32_t begin = m_levelStart[level];
+    uint32_t end   = m_levelStart[level + 1];
+    if (!m_pool)
+    {
+      changed += updateRange(soa, begin, end);
+      continue;
+    }
+
+    // Границы блоков кратны BLOCK_SIZE, чтобы скалярные хвосты были только в конце уровня.
+    // Пустые блоки parallelFor не вызываются, поэтому счётчики обнуляются заранее
+    uint32_t blocks = (end - begin + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::fill(m_chunkChanged.begin(), m_chunkChanged.end(), 0u);
+    uint32_t chunks = m_pool->parallelFor(
+        blocks, MIN_CHUNK / BLOCK_SIZE,
+        [&](uint32_t blockBegin, uint32_t blockEnd, uint32_t chunk)
+        {
+          m_chunkChanged[chunk] = updateRange(soa, begin + blockBegin * BLOCK_SIZE,
+                                              std::min(end, begin + blockEnd * BLOCK_SIZE));
+        });
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+      changed += m_chunkChanged[chunk];
+    }
+  }
+
+  m_stats.nodes   = size();
+  m_stats.changed = changed;
+  m_stats.levels  = levels;
+  m_stats.timeMs  =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+glm::mat4 TransformSystem::getWorldMatrix(TransformHandle handle) const
+{
+  uint32_t  index = getIndex(handle);
+  glm::mat4 result(1.0f);
+  for (uint32_t col = 0; col < 4; col++)
+  {
+    for (uint32_t row = 0; row < 3; row++)
+    {
+      result[col][row] = m_world[col * 3 + row][index];
+    }
+  }
+  return result;
+}
+
+bool TransformSystem::isWorldChanged(TransformHandle handle) const
+{
+  return m_changed[getIndex(handle)] != 0;
+}
+
+const char* TransformSystem::getKernelName() const
+{
+#if defined(VKAPI_AVX2)
+  if (m_simdEnabled && Simd::hasAvx2())
+  {
+    return "AVX2";  // Avx2Lanes виден только в TransformSystemAvx2.cpp
+  }
+#endif
+#if defined(__ARM_NEON)
+  if (m_simdEnabled)
+  {
+    return Simd::NeonLanes::NAME;
+  }
+#endif
+  return Simd::ScalarLanes::NAME;
+}
+
+uint32_t TransformSystem::size() const
+{
+  return static_cast<uint32_t>(m_handleToIndex.size() - m_freeHandles.size());
+}
+
+uint32_t TransformSystem::getIndex(TransformHandle handle) const
+{
+  if (handle >= m_handleToIndex.size() || m_handleToIndex[handle] == INVALID_INDEX)
+  {
+    throw std::out_of_range("Неверный идентификатор узла преобразований");
+  }
+  return m_handleToIndex[handle];
+}
+
+void TransformSystem::rebuildOrder()
+{
+  uint32_t count = static_cast<uint32_t>(m_parent.size());
+
+  // Списки детей в CSR-раскладке; дети сохраняют взаимный порядок
+  std::vector<uint32_t> childStart(count + 1, 0);
+  for (uint32_t i = 1; i < count; i++)
+  {
+    if (m_parent[i] != INVALID_INDEX)
+    {
+      childStart[m_parent[i] + 1]++;
+    }
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    childStart[i + 1] += childStart[i];
+  }
+
+  std::vector<uint32_t> children(childStart[count]);
+  std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+  for (uint32_t i = 1; i < count; i++)
+  {
+    if (m_parent[i] != INVALID_INDEX)
+    {
+      children[fill[m_parent[i]]++] = i;
+    }
+  }
+
+  // Обход в ширину от единичного корня: уровни подряд, братья рядом
+  std::vector<uint32_t> order;
+  order.reserve(count);
+  order.push_back(0);
+  m_levelStart.clear();
+  size_t levelBegin = 0;
+  size_t levelEnd   = 1;
+  while (levelBegin < levelEnd)
+  {
+    for (size_t k = levelBegin; k < levelEnd; k++)
+    {
+      uint32_t node = order[k];
+      order.insert(order.end(), children.begin() + childStart[node],
+                   children.begin() + childStart[node + 1]);
+    }
+    levelBegin = levelEnd;
+    levelEnd   = order.size();
+    m_levelStart.push_back(static_cast<uint32_t>(levelBegin));
+  }
+
+  // Перестановка всех массивов; удалённые узлы в обход не попали и исчезают
+  std::vector<uint32_t> newIndex(count, INVALID_INDEX);
+  for (uint32_t k = 0; k < order.size(); k++)
+  {
+    newIndex[order[k]] = k;
+  }
+
+  auto permute = [&order](auto& values)
+  {
+    std::remove_reference_t<decltype(values)> permuted(order.size());
+    for (size_t k = 0; k < order.size(); k++)
+    {
+      permuted[k] = values[order[k]];
+    }
+    values.swap(permuted);
+  };
+
+  for (auto& component : m_position)
+  {
+    permute(component);
+  }
+  for (auto& component : m_rotation)
+  {
+    permute(component);
+  }
+  for (auto& component : m_scale)
+  {
+    permute(component);
+  }
+  for (auto& component : m_world)
+  {
+    permute(component);
+  }
+  permute(m_localDirty);
+  permute(m_indexToHandle);
+
+  std::vector<uint32_t> parent(order.size());
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    parent[k] = newIndex[m_parent[order[k]]];
+  }
+  m_parent.swap(parent);
+  m_changed.assign(order.size(), 0);
+
+  for (uint32_t k = 1; k < m_indexToHandle.size(); k++)
+  {
+    m_handleToIndex[m_indexToHandle[k]] = k;
+  }
+  m_orderDirty = false;
+}
+
+uint32_t TransformSystem::updateRange(const TransformSoa& soa, uint32_t begin, uint32_t end) const
+{
+#if defined(VKAPI_AVX2)
+  if (m_simdEnabled && Simd::hasAvx2())
+  {
+    return TransformKernel::updateRangeAvx2(soa, begin, end);
+  }
+#endif
+#if defined(__ARM_NEON)
+  if (m_simdEnabled)
+  {
+    return TransformKernel::updateRange<Simd::NeonLanes>(soa, begin, end);
+  }
+#endif
+  return TransformKernel::updateRange<Simd::ScalarLanes>(soa, begin, end);
+}
@@ -0,0 +1,7 @@
+// Собирается с -mavx2 -mfma (/arch:AVX2) только при VKAPI_ENABLE_AVX2, см. CMakeLists.txt
+#include "TransformKernel.h"
+
+uint32_t TransformKernel::updateRangeAvx2(const TransformSoa& soa, uint32_t begin, uint32_t end)
+{
+  return updateRange<Simd::Avx2Lanes>(soa, begin, end);
+}
@@ -1,7 +1,14 @@
 #include "VulkanApp.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+
+#include "StartupGraph.h"
+#include "VulkanUtils.h"
 
 VulkanApp::VulkanApp()
 {
@@ -39,36 +46,88 @@ bool VulkanApp::initComponents()
 {
   try
   {
-    // Инициализация базового компонента Vulkan
-    m_core = std::make_unique<VulkanCore>();
-    if (m_core->init() != 0)
-    {
-      std::cerr << "Ошибка при инициализации VulkanCore" << std::endl;
-      return false;
-    }
-
-    // Инициализация компонента управления устройством
-    m_device = std::make_unique<VulkanDevice>(m_core->getInstance(), m_core->getSurface());
-    if (m_device->init() != 0)
-    {
-      std::cerr << "Ошибка при инициализации VulkanDevice" << std::endl;
-      return false;
-    }
-
-    // Инициализация компонента управления swap chain
-    m_swapChain =
-        std::make_unique<VulkanSwapChain>(*m_device, m_core->getSurface(), m_core->getWindow());
-    if (m_swapChain->init() != 0)
-    {
-      std::cerr << "Ошибка при инициализации VulkanSwapChain" << std::endl;
-      return false;
-    }
-
-    // Инициализация компонента рендеринга
-    m_renderer = std::make_unique<VulkanRenderer>(*m_device, *m_swapChain);
-    if (m_renderer->init() != 0)
+    // Пул рабочих потоков для параллельной работы на CPU
+    m_threadPool = std::make_unique<ThreadPool>();
+
+    // Запуск - граф стадий: SDL (окно, поверхность) и swap chain остаются в главном
+    // потоке, чтение шейдеров, создание устройства и ресурсов рендерера, которым
+    // нужно только устройство (в том числе компиляция конвейеров), идут в пуле
+    StartupGraph startup;
+
+    uint32_t shadersStage = startup.addStage(
+        "shaders", StartupThread::Worker, {},
+        []
+        {
+          size_t count = VulkanUtils::preloadShaders("Learning/Shaders");
+          std::cout << "Предзагружено шейдеров: " << count << std::endl;
+        });
+
+    // Окно, экземпляр Vulkan и поверхность
+    uint32_t coreStage = startup.addStage(
+        "core", StartupThread::Main, {},
+        [this]
+        {
+          m_core = std::make_unique<VulkanCore>();
+          if (m_core->init() != 0)
+          {
+            throw std::runtime_error("Ошибка при инициализации VulkanCore");
+          }
+        });
+
+    // Устройство; объекты swap chain и рендерера только конструируются (без ресурсов),
+    // чтобы следующие стадии могли инициализировать их параллельно
+    uint32_t deviceStage = startup.addStage(
+        "device", StartupThread::Worker, {coreStage},
+        [this]
+        {
+          m_device = std::make_unique<VulkanDevice>(m_core->getInstance(), m_core->getSurface());
+          if (m_device->init() != 0)
+          {
+            throw std::runtime_error("Ошибка при инициализации VulkanDevice");
+          }
+          m_swapChain = std::make_unique<VulkanSwapChain>(*m_device, m_core->getSurface(),
+                                                          m_core->getWindow());
+          m_renderer  = std::make_unique<VulkanRenderer>(*m_device, *m_swapChain, *m_threadPool);
+        });
+
+    // Swap chain запрашивает размер окна у SDL
+    uint32_t swapChainStage = startup.addStage(
+        "swapchain", StartupThread::Main, {deviceStage},
+        [this]
+        {
+          if (m_swapChain->init() != 0)
+          {
+            throw std::runtime_error("Ошибка при инициализации VulkanSwapChain");
+          }
+        });
+
+    uint32_t rendererDeviceStage = startup.addStage(
+        "renderer.device", StartupThread::Worker, {deviceStage, shadersStage},
+        [this]
+        {
+          if (m_renderer->initDeviceResources() != 0)
+          {
+            throw std::runtime_error("Ошибка при инициализации VulkanRenderer");
+          }
+        });
+
+    // Цели и граф кадра зависят от размера swap chain
+    startup.addStage(
+        "renderer.swapchain", StartupThread::Main, {swapChainStage, rendererDeviceStage},
+        [this]
+        {
+          if (m_renderer->initSwapChainResources() != 0)
+          {
+            throw std::runtime_error("Ошибка при инициализации VulkanRenderer");
+          }
+          VulkanUtils::releaseShaderCache();
+        });
+
+    bool success = startup.run(*m_threadPool);
+    startup.printReport(std::cout);
+    if (!success)
     {
-      std::cerr << "Ошибка при инициализации VulkanRenderer" << std::endl;
+      std::cerr << "Ошибка при инициализации компонентов: " << startup.getError() << std::endl;
       return false;
     }
 
@@ -86,14 +145,85 @@ void VulkanApp::mainLoop()
 {
   std::cout << "Запуск основного цикла..." << std::endl;
 
-  // Цикл обработки событий и рендеринга
-  int frameCount = 0;
-  while (m_core->processEvents())
+  m_running = true;
+  std::thread simulationThread(&VulkanApp::simulationLoop, this);
+  std::thread renderThread(&VulkanApp::renderLoop, this);
+
+  // Главный поток только обрабатывает события SDL: окно отвечает, даже пока
+  // поток рендеринга ждёт GPU или swap chain
+  while (m_running && m_core->waitEvents(EVENT_WAIT_MS))
+  {
+  }
+  m_running = false;
+
+  renderThread.join();
+  simulationThread.join();
+
+  // Ожидание завершения всех операций перед выходом
+  m_device->getDevice().waitIdle();
+
+  std::cout << "Основной цикл завершен" << std::endl;
+}
+
+void VulkanApp::simulationLoop()
+{
+  double frequency = DEFAULT_SIMULATION_HZ;
+  if (const char* frequencyEnv = std::getenv("VKAPI_SIMULATION_HZ"))
   {
+    frequency = std::max(std::strtod(frequencyEnv, nullptr), 1.0);
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  const double          stepSec  = 1.0 / frequency;
+  const Clock::duration step     = std::chrono::nanoseconds(static_cast<int64_t>(stepSec * 1e9));
+  Clock::time_point     nextStep = Clock::now();
+  FrameSnapshot         state;
+
+  while (m_running)
+  {
+    // Шаг симуляции: время и фаза анимации продвигаются на фиксированный шаг
+    state.simulationStep++;
+    state.simulationTime += stepSec;
+    state.animationTime  += 0.01f;
+    if (state.animationTime > 1.0f)
+    {
+      state.animationTime = 0.0f;
+    }
+
+    m_snapshots.getWriteSlot() = state;
+    m_snapshots.publish();
+
+    // После долгой паузы (отладчик, сон системы) шаги не догоняются пачкой
+    nextStep += step;
+    Clock::time_point now = Clock::now();
+    if (now - nextStep > step * 4)
+    {
+      nextStep = now;
+    }
+    std::this_thread::sleep_until(nextStep);
+  }
+}
+
+void VulkanApp::renderLoop()
+{
+  // Цикл рендеринга: кадр рисует последний снимок, пропуская промежуточные
+  int  frameCount  = 0;
+  bool hasSnapshot = false;
+  while (m_running)
+  {
+    hasSnapshot = m_snapshots.acquire() || hasSnapshot;
+    if (!hasSnapshot)
+    {
+      // Первый шаг симуляции ещё не опубликован
+      std::this_thread::yield();
+      continue;
+    }
+
     std::cout << "Отрисовка кадра " << frameCount++ << std::endl;
 
     // Отрисовка кадра
-    if (!m_renderer->drawFrame())
+    if (!m_renderer->drawFrame(m_snapshots.getReadSlot()))
     {
       std::cout << "Ошибка при отрисовке кадра, завершение..." << std::endl;
       break;
@@ -103,15 +233,13 @@ void VulkanApp::mainLoop()
     SDL_Delay(100);
 
     // Ограничим число кадров для тестирования
-    if (frameCount > 300)
+    if (frameCount > MAX_FRAMES)
     {
       std::cout << "Достигнуто максимальное число кадров, завершение..." << std::endl;
       break;
     }
   }
 
-  // Ожидание завершения всех операций перед выходом
-  m_device->getDevice().waitIdle();
-
-  std::cout << "Основной цикл завершен" << std::endl;
-}
\ No newline at end of file
+  // Завершение рендеринга останавливает и главный цикл
+  m_running = false;
+}
@@ -0,0 +1,187 @@
+#include "VulkanComputePipeline.h"
+
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "VulkanUtils.h"
+
+VulkanComputePipeline::VulkanComputePipeline(VulkanDevice& device) : m_device(device) {}
+
+VulkanComputePipeline::~VulkanComputePipeline()
+{
+  cleanup();
+}
+
+int VulkanComputePipeline::init(const std::string&                                shaderPath,
+                                const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+                                uint32_t pushConstantSize, uint32_t maxSets)
+{
+  try
+  {
+    vk::Device device = m_device.getDevice();
+
+    // Layout набора дескрипторов
+    vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.bindingCount                      = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings                         = bindings.data();
+    m_vkDescriptorSetLayout = device.createDescriptorSetLayoutUnique(layoutInfo);
+
+    // Пул дескрипторов: по maxSets дескрипторов каждого используемого типа
+    std::map<vk::DescriptorType, uint32_t> typeCounts;
+    for (const auto& binding : bindings)
+    {
+      typeCounts[binding.descriptorType] += binding.descriptorCount * maxSets;
+    }
+
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    for (const auto& [type, count] : typeCounts)
+    {
+      poolSizes.emplace_back(type, count);
+    }
+
+    vk::DescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.maxSets                      = maxSets;
+    poolInfo.poolSizeCount                = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes                   = poolSizes.data();
+    m_vkDescriptorPool                    = device.createDescriptorPoolUnique(poolInfo);
+
+    // Layout конвейера
+    vk::PushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags            = vk::ShaderStageFlagBits::eCompute;
+    pushConstantRange.offset                = 0;
+    pushConstantRange.size                  = pushConstantSize;
+
+    vk::DescriptorSetLayout      setLayout          = *m_vkDescriptorSetLayout;
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.setLayoutCount               = 1;
+    pipelineLayoutInfo.pSetLayouts                  = &setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount       = pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges          = &pushConstantRange;
+    m_vkPipelineLayout = device.createPipelineLayoutUnique(pipelineLayoutInfo);
+
+    // Шейдер и конвейер
+    auto shaderCode = VulkanUtils::loadShader(shaderPath);
+
+    vk::ShaderModuleCreateInfo moduleInfo = {};
+    moduleInfo.codeSize                   = shaderCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+    vk::UniqueShaderModule shaderModule = device.createShaderModuleUnique(moduleInfo);
+
+    vk::ComputePipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.stage.stage                   = vk::ShaderStageFlagBits::eCompute;
+    pipelineInfo.stage.module                  = *shaderModule;
+    pipelineInfo.stage.pName                   = "main";
+    pipelineInfo.layout                        = *m_vkPipelineLayout;
+
+    auto result  = device.createComputePipelineUnique(nullptr, pipelineInfo);
+    m_vkPipeline = std::move(result.value);
+
+    std::cout << "Вычислительный конвейер создан: " << shaderPath << std::endl;
+    return 0;
+  }
+  catch (const vk::SystemError& e)
+  {
+    std::cerr << "Не удалось создать вычислительный конвейер: " << e.what() << std::endl;
+    return -1;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanComputePipeline: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanComputePipeline::cleanup()
+{
+  // Наборы дескрипторов освобождаются вместе с пулом
+  m_vkPipeline.reset();
+  m_vkPipelineLayout.reset();
+  m_vkDescriptorPool.reset();
+  m_vkDescriptorSetLayout.reset();
+}
+
+vk::DescriptorSet VulkanComputePipeline::allocateDescriptorSet()
+{
+  vk::DescriptorSetLayout       setLayout = *m_vkDescriptorSetLayout;
+  vk::DescriptorSetAllocateInfo allocInfo = {};
+  allocInfo.descriptorPool                = *m_vkDescriptorPool;
+  allocInfo.descriptorSetCount            = 1;
+  allocInfo.pSetLayouts                   = &setLayout;
+
+  try
+  {
+    return m_device.getDevice().allocateDescriptorSets(allocInfo)[0];
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось выделить набор дескрипторов: " + std::string(e.what()));
+  }
+}
+
+void VulkanComputePipeline::writeStorageBuffer(vk::DescriptorSet set, uint32_t binding,
+                                               vk::Buffer buffer, vk::DeviceSize range) const
+{
+  vk::DescriptorBufferInfo bufferInfo = {};
+  bufferInfo.buffer                   = buffer;
+  bufferInfo.offset                   = 0;
+  bufferInfo.range                    = range;
+
+  vk::WriteDescriptorSet write = {};
+  write.dstSet                 = set;
+  write.dstBinding             = binding;
+  write.descriptorCount        = 1;
+  write.descriptorType         = vk::DescriptorType::eStorageBuffer;
+  write.pBufferInfo            = &bufferInfo;
+
+  m_device.getDevice().updateDescriptorSets(write, nullptr);
+}
+
+void VulkanComputePipeline::writeStorageImage(vk::DescriptorSet set, uint32_t binding,
+                                              vk::ImageView view) const
+{
+  vk::DescriptorImageInfo imageInfo = {};
+  imageInfo.imageView               = view;
+  imageInfo.imageLayout             = vk::ImageLayout::eGeneral;
+
+  vk::WriteDescriptorSet write = {};
+  write.dstSet                 = set;
+  write.dstBinding             = binding;
+  write.descriptorCount        = 1;
+  write.descriptorType         = vk::DescriptorType::eStorageImage;
+  write.pImageInfo             = &imageInfo;
+
+  m_device.getDevice().updateDescriptorSets(write, nullptr);
+}
+
+void VulkanComputePipeline::writeSampledImage(vk::DescriptorSet set, uint32_t binding,
+                                              vk::ImageView view, vk::Sampler sampler,
+                                              vk::ImageLayout layout) const
+{
+  vk::DescriptorImageInfo imageInfo = {};
+  imageInfo.sampler                 = sampler;
+  imageInfo.imageView               = view;
+  imageInfo.imageLayout             = layout;
+
+  vk::WriteDescriptorSet write = {};
+  write.dstSet                 = set;
+  write.dstBinding             = binding;
+  write.descriptorCount        = 1;
+  write.descriptorType         = vk::DescriptorType::eCombinedImageSampler;
+  write.pImageInfo             = &imageInfo;
+
+  m_device.getDevice().updateDescriptorSets(write, nullptr);
+}
+
+void VulkanComputePipeline::bind(vk::CommandBuffer commandBuffer, vk::DescriptorSet set) const
+{
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *m_vkPipeline);
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *m_vkPipelineLayout, 0, set,
+                                   nullptr);
+}
+
+void VulkanComputePipeline::dispatch(vk::CommandBuffer commandBuffer, uint32_t groupsX,
+                                     uint32_t groupsY, uint32_t groupsZ) const
+{
+  commandBuffer.dispatch(groupsX, groupsY, groupsZ);
+}
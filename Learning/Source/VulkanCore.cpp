@@ -64,6 +64,17 @@ bool VulkanCore::processEvents()
   return true;
 }
 
+bool VulkanCore::waitEvents(int timeoutMs)
+{
+  // Поток событий спит, пока окно молчит, но раз в timeoutMs возвращается к вызывающему
+  SDL_Event event;
+  if (SDL_WaitEventTimeout(&event, timeoutMs) && event.type == SDL_QUIT)
+  {
+    return false;
+  }
+  return processEvents();
+}
+
 // Инициализация окна SDL
 void VulkanCore::initWindow()
 {
@@ -119,7 +130,7 @@ void VulkanCore::createInstance()
   appInfo.applicationVersion  = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName         = "No Engine";
   appInfo.engineVersion       = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion          = VK_API_VERSION_1_2;
+  appInfo.apiVersion          = VK_API_VERSION_1_3;  // synchronization2 в ядре
 
   // Получение расширений для SDL2
   unsigned int extCount = 0;
@@ -134,6 +145,9 @@ void VulkanCore::createInstance()
     throw std::runtime_error("Не удалось получить расширения Vulkan через SDL2");
   }
 
+  // Глобальные функции (vkCreateInstance и др.) берутся из загрузчика
+  VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
+
   // Создание экземпляра Vulkan
   vk::InstanceCreateInfo createInfo  = {};
   createInfo.pApplicationInfo        = &appInfo;
@@ -143,6 +157,7 @@ void VulkanCore::createInstance()
   try
   {
     m_vkInstance = vk::createInstanceUnique(createInfo);
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_vkInstance);
     std::cout << "Экземпляр Vulkan создан успешно" << std::endl;
   }
   catch (const vk::SystemError& e)
@@ -1,5 +1,9 @@
 #include "VulkanDevice.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -51,24 +55,260 @@ void VulkanDevice::pickPhysicalDevice()
     throw std::runtime_error("Не найдено физических устройств с поддержкой Vulkan");
   }
 
-  // Выбор первого подходящего устройства
+  // VKAPI_DEVICE переопределяет предпочтение, заданное в коде
+  std::string preference = m_preferredDevice;
+  if (const char* deviceEnv = std::getenv("VKAPI_DEVICE"))
+  {
+    preference = deviceEnv;
+  }
+
+  // Оценка всех устройств с выводом слагаемых, чтобы выбор можно было объяснить
+  std::vector<DeviceCandidate> candidates;
+  std::cout << "Физические устройства:" << std::endl;
   for (const auto& device : physicalDevices)
   {
-    if (isDeviceSuitable(device))
+    candidates.push_back(evaluateDevice(device));
+    const DeviceCandidate& candidate = candidates.back();
+
+    std::cout << "  [" << candidates.size() - 1 << "] " << candidate.name << " (UUID "
+              << candidate.uuid << "): ";
+    if (candidate.suitable)
+    {
+      std::cout << candidate.score << " баллов";
+    }
+    else
+    {
+      std::cout << "не подходит";
+    }
+    for (size_t i = 0; i < candidate.reasons.size(); i++)
+    {
+      std::cout << (i == 0 ? "\n      " : "; ") << candidate.reasons[i];
+    }
+    std::cout << std::endl;
+  }
+
+  // Явно запрошенное устройство, если оно подходит
+  const DeviceCandidate* selected = nullptr;
+  if (!preference.empty())
+  {
+    for (const auto& candidate : candidates)
+    {
+      if (matchesPreference(candidate, preference))
+      {
+        if (candidate.suitable)
+        {
+          selected = &candidate;
+          std::cout << "Устройство задано явно (\"" << preference << "\")" << std::endl;
+        }
+        else
+        {
+          std::cout << "Запрошенное устройство " << candidate.name
+                    << " не подходит, выбор по оценке" << std::endl;
+        }
+        break;
+      }
+    }
+    if (!selected)
     {
-      m_vkPhysicalDevice = device;
+      std::cout << "Устройство \"" << preference << "\" не найдено среди подходящих"
+                << std::endl;
+    }
+  }
 
-      // Вывод информации о выбранном устройстве
-      vk::PhysicalDeviceProperties deviceProperties = m_vkPhysicalDevice.getProperties();
-      std::cout << "Выбрано устройство: " << deviceProperties.deviceName << std::endl;
-      break;
+  // Иначе - подходящее устройство с наибольшей оценкой (при равенстве - первое)
+  if (!selected)
+  {
+    for (const auto& candidate : candidates)
+    {
+      if (candidate.suitable && (!selected || candidate.score > selected->score))
+      {
+        selected = &candidate;
+      }
     }
   }
 
-  if (m_vkPhysicalDevice == vk::PhysicalDevice(nullptr))
+  if (!selected)
   {
     throw std::runtime_error("Не удалось найти подходящее GPU");
   }
+
+  m_vkPhysicalDevice   = selected->device;
+  m_vkMemoryProperties = m_vkPhysicalDevice.getMemoryProperties();
+  std::cout << "Выбрано устройство: " << selected->name << std::endl;
+}
+
+// Оценка устройства: тип важнее всего, остальные слагаемые различают устройства одного типа
+VulkanDevice::DeviceCandidate VulkanDevice::evaluateDevice(vk::PhysicalDevice device)
+{
+  DeviceCandidate candidate;
+  candidate.device = device;
+
+  auto properties2 =
+      device.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+  const vk::PhysicalDeviceProperties& properties =
+      properties2.get<vk::PhysicalDeviceProperties2>().properties;
+  const vk::PhysicalDeviceIDProperties& idProperties =
+      properties2.get<vk::PhysicalDeviceIDProperties>();
+
+  candidate.name = properties.deviceName.data();
+
+  // UUID в каноническом виде 8-4-4-4-12
+  char  uuid[40];
+  char* out = uuid;
+  for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+  {
+    if (i == 4 || i == 6 || i == 8 || i == 10)
+    {
+      *out++ = '-';
+    }
+    out += std::snprintf(out, 3, "%02x", idProperties.deviceUUID[i]);
+  }
+  candidate.uuid = uuid;
+
+  std::string reason;
+  candidate.suitable = isDeviceSuitable(device, reason);
+  if (!candidate.suitable)
+  {
+    candidate.reasons.push_back(reason);
+    return candidate;
+  }
+
+  auto addScore = [&candidate](int64_t points, const std::string& what)
+  {
+    candidate.score += points;
+    candidate.reasons.push_back(what + " +" + std::to_string(points));
+  };
+
+  // Тип устройства
+  switch (properties.deviceType)
+  {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+      addScore(100000, "дискретный GPU");
+      break;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+      addScore(30000, "интегрированный GPU");
+      break;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+      addScore(20000, "виртуальный GPU");
+      break;
+    case vk::PhysicalDeviceType::eCpu:
+      addScore(1000, "программная реализация (CPU)");
+      break;
+    default:
+      addScore(0, "неизвестный тип");
+      break;
+  }
+
+  // Самая большая локальная куча: 1 балл за 16 МБ, не более 2048 (32 ГБ)
+  vk::PhysicalDeviceMemoryProperties memoryProperties = device.getMemoryProperties();
+  vk::DeviceSize                     localHeap        = 0;
+  for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+  {
+    if (memoryProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+    {
+      localHeap = std::max(localHeap, memoryProperties.memoryHeaps[i].size);
+    }
+  }
+  addScore(static_cast<int64_t>(std::min<vk::DeviceSize>(localHeap >> 24, 2048)),
+           "локальная память " + std::to_string(localHeap >> 20) + " МБ");
+
+  // Лениво выделяемая память: transient-вложения графа кадра не занимают память
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+  {
+    if (memoryProperties.memoryTypes[i].propertyFlags &
+        vk::MemoryPropertyFlagBits::eLazilyAllocated)
+    {
+      addScore(100, "lazily allocated память");
+      break;
+    }
+  }
+
+  // Очереди: отдельные семейства для асинхронных вычислений и копирований
+  bool asyncCompute = false;
+  bool transferOnly = false;
+  for (const auto& family : device.getQueueFamilyProperties())
+  {
+    bool graphics = static_cast<bool>(family.queueFlags & vk::QueueFlagBits::eGraphics);
+    bool compute  = static_cast<bool>(family.queueFlags & vk::QueueFlagBits::eCompute);
+    asyncCompute |= compute && !graphics;
+    transferOnly |= !compute && !graphics &&
+                    static_cast<bool>(family.queueFlags & vk::QueueFlagBits::eTransfer);
+  }
+  if (asyncCompute)
+  {
+    addScore(500, "асинхронные вычисления");
+  }
+  if (transferOnly)
+  {
+    addScore(200, "отдельная очередь копирования");
+  }
+
+  // Возможности, которые использует или может использовать движок
+  vk::PhysicalDeviceFeatures features = device.getFeatures();
+  if (features.samplerAnisotropy)
+  {
+    addScore(50, "анизотропная фильтрация");
+  }
+  if (features.multiDrawIndirect)
+  {
+    addScore(50, "multiDrawIndirect");
+  }
+  if (properties.limits.timestampComputeAndGraphics)
+  {
+    addScore(50, "timestamp-запросы");
+  }
+
+  std::set<std::string> extensions;
+  for (const auto& extension : device.enumerateDeviceExtensionProperties())
+  {
+    extensions.insert(extension.extensionName.data());
+  }
+  if (extensions.count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+  {
+    addScore(100, "VK_EXT_memory_budget");
+  }
+
+  // Лимиты: максимальный размер изображения и MSAA
+  addScore(properties.limits.maxImageDimension2D / 1024,
+           "maxImageDimension2D " + std::to_string(properties.limits.maxImageDimension2D));
+  uint32_t maxSamples = 1;
+  for (uint32_t count = 64; count > 1; count >>= 1)
+  {
+    if (properties.limits.framebufferColorSampleCounts &
+        static_cast<vk::SampleCountFlagBits>(count))
+    {
+      maxSamples = count;
+      break;
+    }
+  }
+  addScore(maxSamples * 10, "MSAA до " + std::to_string(maxSamples) + "x");
+
+  return candidate;
+}
+
+// Совпадение с предпочтением: UUID целиком (дефисы не важны) или подстрока имени
+bool VulkanDevice::matchesPreference(const DeviceCandidate& candidate,
+                                     const std::string&     preference)
+{
+  auto normalize = [](const std::string& text, bool dropDashes)
+  {
+    std::string result;
+    for (char c : text)
+    {
+      if (!(dropDashes && c == '-'))
+      {
+        result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      }
+    }
+    return result;
+  };
+
+  if (normalize(preference, true) == normalize(candidate.uuid, true))
+  {
+    return true;
+  }
+  return normalize(candidate.name, false).find(normalize(preference, false)) !=
+         std::string::npos;
 }
 
 // Создание логического устройства
@@ -81,6 +321,10 @@ void VulkanDevice::createLogicalDevice()
   std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
   std::set<uint32_t> uniqueQueueFamilies = {m_queueFamilyIndices.graphicsFamily.value(),
                                             m_queueFamilyIndices.presentFamily.value()};
+  if (m_queueFamilyIndices.computeFamily.has_value())
+  {
+    uniqueQueueFamilies.insert(m_queueFamilyIndices.computeFamily.value());
+  }
 
   float queuePriority = 1.0f;
   for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -92,16 +336,39 @@ void VulkanDevice::createLogicalDevice()
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
-  // Указание используемых функций устройства
-  vk::PhysicalDeviceFeatures deviceFeatures = {};
+  // Указание используемых функций устройства (цепочка pNext вместо pEnabledFeatures)
+  vk::PhysicalDeviceVulkan13Features vulkan13Features = {};
+  vulkan13Features.synchronization2                   = VK_TRUE;  // Барьеры графа кадра
+  vulkan13Features.dynamicRendering                   = VK_TRUE;  // Проходы без VkRenderPass
+
+  vk::PhysicalDeviceVulkan12Features vulkan12Features = {};
+  vulkan12Features.pNext                              = &vulkan13Features;
+  vulkan12Features.timelineSemaphore                  = VK_TRUE;  // Синхронизация кадров
+
+  vk::PhysicalDeviceFeatures2 deviceFeatures = {};
+  deviceFeatures.pNext                       = &vulkan12Features;
+
+  // Бюджет памяти - необязательное расширение: без него бюджет оценивается по размеру куч
+  std::vector<const char*> extensions      = m_deviceExtensions;
+  bool                     budgetSupported = false;
+  for (const auto& extension : m_vkPhysicalDevice.enumerateDeviceExtensionProperties())
+  {
+    if (std::string(extension.extensionName.data()) == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)
+    {
+      extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+      budgetSupported = true;
+      break;
+    }
+  }
 
   // Создание логического устройства
   vk::DeviceCreateInfo createInfo    = {};
+  createInfo.pNext                   = &deviceFeatures;
   createInfo.pQueueCreateInfos       = queueCreateInfos.data();
   createInfo.queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size());
-  createInfo.pEnabledFeatures        = &deviceFeatures;
-  createInfo.enabledExtensionCount   = static_cast<uint32_t>(m_deviceExtensions.size());
-  createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+  createInfo.pEnabledFeatures        = nullptr;
+  createInfo.enabledExtensionCount   = static_cast<uint32_t>(extensions.size());
+  createInfo.ppEnabledExtensionNames = extensions.data();
 
   // Создание логического устройства
   try
@@ -114,21 +381,59 @@ void VulkanDevice::createLogicalDevice()
     throw std::runtime_error("Не удалось создать логическое устройство: " + std::string(e.what()));
   }
 
+  // Функции устройства загружаются через vkGetDeviceProcAddr: запись и отправка команд
+  // идут прямо в драйвер, без трамплина загрузчика (диспетчер один на программу,
+  // поэтому он привязан к последнему созданному устройству)
+  VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_vkDevice);
+
   // Получение очередей
   m_vkGraphicsQueue = m_vkDevice->getQueue(m_queueFamilyIndices.graphicsFamily.value(), 0);
   m_vkPresentQueue  = m_vkDevice->getQueue(m_queueFamilyIndices.presentFamily.value(), 0);
+  m_vkComputeQueue  = m_vkDevice->getQueue(getComputeFamily(), 0);
+
+  m_memoryTracker = std::make_unique<VulkanMemoryTracker>(m_vkPhysicalDevice, budgetSupported);
+  std::cout << "Бюджет видеопамяти: "
+            << (budgetSupported ? "VK_EXT_memory_budget" : "оценка по размеру куч") << std::endl;
+
+  std::cout << "Асинхронные вычисления: "
+            << (hasAsyncCompute() ? "отдельная очередь, семейство " +
+                                        std::to_string(getComputeFamily())
+                                  : std::string("нет, используется графическая очередь"))
+            << std::endl;
 }
 
 // Проверка пригодности устройства
-bool VulkanDevice::isDeviceSuitable(vk::PhysicalDevice device)
+bool VulkanDevice::isDeviceSuitable(vk::PhysicalDevice device, std::string& reason)
 {
-  // Поиск необходимых семейств очередей
-  QueueFamilyIndices indices = findQueueFamilies(device);
+  // Граф кадра использует барьеры synchronization2 из ядра Vulkan 1.3
+  if (device.getProperties().apiVersion < VK_API_VERSION_1_3)
+  {
+    reason = "нет Vulkan 1.3";
+    return false;
+  }
+  auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                      vk::PhysicalDeviceVulkan13Features>();
+  if (features.get<vk::PhysicalDeviceVulkan13Features>().synchronization2 != VK_TRUE)
+  {
+    reason = "нет synchronization2";
+    return false;
+  }
 
   // Проверка поддержки расширений для swap chain
-  bool extensionsSupported = checkDeviceExtensionSupport(device);
+  if (!checkDeviceExtensionSupport(device))
+  {
+    reason = "нет расширения " + std::string(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    return false;
+  }
 
-  return indices.isComplete() && extensionsSupported;
+  // Поиск необходимых семейств очередей
+  if (!findQueueFamilies(device).isComplete())
+  {
+    reason = "нет очереди графики или презентации на эту поверхность";
+    return false;
+  }
+
+  return true;
 }
 
 // Проверка поддержки расширений устройством
@@ -162,22 +467,33 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(vk::PhysicalDevice device)
   uint32_t i = 0;
   for (const auto& queueFamily : queueFamilyProperties)
   {
+    // Графика и презентация уже найдены - ищется только вычислительное семейство
+    const bool graphicsAndPresentFound = indices.isComplete();
+
     // Проверка поддержки графических операций
-    if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
+    if ((queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) && !graphicsAndPresentFound)
     {
       indices.graphicsFamily = i;
     }
 
+    // Отдельное вычислительное семейство без графики - очередь для async compute
+    if ((queueFamily.queueFlags & vk::QueueFlagBits::eCompute) &&
+        !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) &&
+        !indices.computeFamily.has_value())
+    {
+      indices.computeFamily = i;
+    }
+
     // Проверка поддержки презентации
     VkBool32 presentSupport = false;
     device.getSurfaceSupportKHR(i, m_vkSurface, &presentSupport);
-    if (presentSupport)
+    if (presentSupport && !graphicsAndPresentFound)
     {
       indices.presentFamily = i;
     }
 
-    // Если оба индекса найдены, выход из цикла
-    if (indices.isComplete())
+    // Если все индексы найдены, выход из цикла
+    if (indices.isComplete() && indices.computeFamily.has_value())
     {
       break;
     }
@@ -186,4 +502,83 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(vk::PhysicalDevice device)
   }
 
   return indices;
+}
+
+// Поиск типа памяти
+uint32_t VulkanDevice::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+  // Поиск подходящего типа памяти среди закэшированных свойств
+  for (uint32_t i = 0; i < m_vkMemoryProperties.memoryTypeCount; i++)
+  {
+    if ((typeFilter & (1 << i)) &&
+        (m_vkMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+    {
+      return i;
+    }
+  }
+
+  throw std::runtime_error("Не удалось найти подходящий тип памяти");
+}
+
+// Проверка наличия типа памяти
+bool VulkanDevice::hasMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+  for (uint32_t i = 0; i < m_vkMemoryProperties.memoryTypeCount; i++)
+  {
+    if ((typeFilter & (1 << i)) &&
+        (m_vkMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Выделение памяти с учётом
+TrackedDeviceMemory VulkanDevice::allocateMemory(const vk::MemoryAllocateInfo& allocInfo,
+                                                 MemoryCategory                category) const
+{
+  uint32_t heapIndex = m_vkMemoryProperties.memoryTypes[allocInfo.memoryTypeIndex].heapIndex;
+  return TrackedDeviceMemory(m_vkDevice->allocateMemoryUnique(allocInfo), m_memoryTracker.get(),
+                             heapIndex, category, allocInfo.allocationSize);
+}
+
+// Создание буфера с выделением памяти
+void VulkanDevice::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage,
+                                vk::MemoryPropertyFlags properties, vk::UniqueBuffer& buffer,
+                                TrackedDeviceMemory& memory, MemoryCategory category) const
+{
+  vk::BufferCreateInfo bufferInfo = {};
+  bufferInfo.size                 = size;
+  bufferInfo.usage                = usage;
+  bufferInfo.sharingMode          = vk::SharingMode::eExclusive;
+
+  try
+  {
+    buffer = m_vkDevice->createBufferUnique(bufferInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать буфер: " + std::string(e.what()));
+  }
+
+  // Выделение памяти под буфер
+  vk::MemoryRequirements memRequirements = m_vkDevice->getBufferMemoryRequirements(*buffer);
+
+  vk::MemoryAllocateInfo allocInfo = {};
+  allocInfo.allocationSize         = memRequirements.size;
+  allocInfo.memoryTypeIndex        = findMemoryType(memRequirements.memoryTypeBits, properties);
+
+  try
+  {
+    memory = allocateMemory(allocInfo, category);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось выделить память для буфера: " + std::string(e.what()));
+  }
+
+  // Связывание буфера с памятью
+  m_vkDevice->bindBufferMemory(*buffer, *memory, 0);
 }
\ No newline at end of file
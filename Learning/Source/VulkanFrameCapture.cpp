@@ -0,0 +1,434 @@
+#include "VulkanFrameCapture.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+  // Таблица CRC-32 (полином 0xEDB88320) для блоков PNG
+  const std::array<uint32_t, 256>& crcTable()
+  {
+    static const std::array<uint32_t, 256> table = []
+    {
+      std::array<uint32_t, 256> result = {};
+      for (uint32_t n = 0; n < 256; n++)
+      {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+        {
+          c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        result[n] = c;
+      }
+      return result;
+    }();
+    return table;
+  }
+
+  uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+  {
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+      crc = crcTable()[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+  }
+
+  void appendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+  {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+  }
+
+  // Блок PNG: длина, тип, данные, CRC типа и данных
+  void writePngChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data)
+  {
+    std::vector<uint8_t> header;
+    appendBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+
+    uint32_t crc = crc32(header.data() + 4, 4);
+    crc          = crc32(data.data(), data.size(), crc);
+
+    std::vector<uint8_t> footer;
+    appendBigEndian(footer, crc);
+
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+  }
+
+  /**
+   * @brief Запись RGB-изображения в PNG.
+   * Поток zlib состоит из stored-блоков deflate: сжатия нет, зато кодирование
+   * сводится к копированию и двум контрольным суммам
+   */
+  void writePng(std::ofstream& file, const uint8_t* rgb, uint32_t width, uint32_t height)
+  {
+    static const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> ihdr;
+    appendBigEndian(ihdr, width);
+    appendBigEndian(ihdr, height);
+    ihdr.push_back(8);  // Бит на канал
+    ihdr.push_back(2);  // Тип цвета: RGB
+    ihdr.push_back(0);  // Сжатие deflate
+    ihdr.push_back(0);  // Фильтрация по умолчанию
+    ihdr.push_back(0);  // Без чередования строк
+    writePngChunk(file, "IHDR", ihdr);
+
+    // Несжатые данные: каждая строка начинается с байта фильтра (0 - без фильтра)
+    size_t rowSize = static_cast<size_t>(width) * 3;
+    size_t rawSize = (rowSize + 1) * height;
+
+    const size_t         MAX_STORED = 65535;
+    std::vector<uint8_t> idat;
+    idat.reserve(rawSize + rawSize / MAX_STORED * 5 + 16);
+    idat.push_back(0x78);  // Заголовок zlib: deflate, окно 32 КБ
+    idat.push_back(0x01);
+
+    uint32_t adlerA         = 1;
+    uint32_t adlerB         = 0;
+    size_t   blockRemaining = 0;
+    size_t   written        = 0;
+
+    auto putByte = [&](uint8_t value)
+    {
+      if (blockRemaining == 0)
+      {
+        // Заголовок stored-блока: признак последнего блока, LEN и NLEN
+        size_t  length = std::min(MAX_STORED, rawSize - written);
+        uint8_t last   = written + length == rawSize ? 1 : 0;
+        idat.push_back(last);
+        idat.push_back(static_cast<uint8_t>(length));
+        idat.push_back(static_cast<uint8_t>(length >> 8));
+        idat.push_back(static_cast<uint8_t>(~length));
+        idat.push_back(static_cast<uint8_t>(~length >> 8));
+        blockRemaining = length;
+      }
+
+      idat.push_back(value);
+      adlerA = (adlerA + value) % 65521;
+      adlerB = (adlerB + adlerA) % 65521;
+      blockRemaining--;
+      written++;
+    };
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+      putByte(0);
+      const uint8_t* row = rgb + y * rowSize;
+      for (size_t x = 0; x < rowSize; x++)
+      {
+        putByte(row[x]);
+      }
+    }
+    appendBigEndian(idat, (adlerB << 16) | adlerA);
+    writePngChunk(file, "IDAT", idat);
+
+    writePngChunk(file, "IEND", {});
+  }
+}  // namespace
+
+VulkanFrameCapture::VulkanFrameCapture(VulkanDevice& device, vk::Extent2D extent,
+                                       const std::string& directory, CaptureFormat format,
+                                       uint32_t ringSize)
+    : m_device(device), m_extent(extent), m_directory(directory), m_format(format),
+      m_ringSize(ringSize)
+{
+  m_frameSize = static_cast<vk::DeviceSize>(extent.width) * extent.height * 4;
+}
+
+VulkanFrameCapture::~VulkanFrameCapture()
+{
+  cleanup();
+}
+
+int VulkanFrameCapture::init()
+{
+  try
+  {
+    std::filesystem::create_directories(m_directory);
+
+    // Допустимые типы памяти зависят от буфера: проверяются на буфере того же вида
+    vk::BufferCreateInfo probeInfo = {};
+    probeInfo.size                 = m_frameSize;
+    probeInfo.usage                = vk::BufferUsageFlagBits::eTransferDst;
+    probeInfo.sharingMode          = vk::SharingMode::eExclusive;
+
+    vk::Device       device   = m_device.getDevice();
+    vk::UniqueBuffer probe    = device.createBufferUnique(probeInfo);
+    uint32_t         typeBits = device.getBufferMemoryRequirements(*probe).memoryTypeBits;
+
+    // Кэшируемая память хоста быстрее читается процессором; без неё - когерентная
+    vk::MemoryPropertyFlags properties =
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached;
+    if (!m_device.hasMemoryType(typeBits, properties))
+    {
+      properties = vk::MemoryPropertyFlagBits::eHostVisible |
+                   vk::MemoryPropertyFlagBits::eHostCoherent;
+    }
+
+    m_slots.resize(m_ringSize);
+    for (auto& slot : m_slots)
+    {
+      m_device.createBuffer(m_frameSize, vk::BufferUsageFlagBits::eTransferDst, properties,
+                            slot.buffer, slot.memory, MemoryCategory::Staging);
+      slot.pixels = static_cast<const uint8_t*>(
+          m_device.getDevice().mapMemory(*slot.memory, 0, m_frameSize, {}));
+    }
+
+    m_stopping      = false;
+    m_encoderThread = std::thread(&VulkanFrameCapture::encoderLoop, this);
+
+    std::cout << "Захват кадров в " << m_directory << ": " << m_extent.width << "x"
+              << m_extent.height << ", кольцо из " << m_ringSize << " буферов по "
+              << (m_frameSize >> 10) << " КБ" << std::endl;
+    return 0;
+  }
+  catch (const vk::SystemError& e)
+  {
+    std::cerr << "Не удалось создать буферы захвата кадров: " << e.what() << std::endl;
+    return -1;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanFrameCapture: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanFrameCapture::cleanup()
+{
+  if (m_encoderThread.joinable())
+  {
+    // GPU свободен: все записанные копии готовы и уходят в очередь кодирования
+    poll(~0ull);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_jobAvailable.notify_one();
+    m_encoderThread.join();
+
+    m_capturedCount += m_finished.size();
+    m_finished.clear();
+    std::cout << "Захват кадров завершён: записано " << m_capturedCount << ", пропущено "
+              << m_droppedCount << std::endl;
+  }
+
+  for (auto& slot : m_slots)
+  {
+    if (slot.pixels)
+    {
+      m_device.getDevice().unmapMemory(*slot.memory);
+      slot.pixels = nullptr;
+    }
+  }
+  m_slots.clear();
+}
+
+CaptureFormat VulkanFrameCapture::parseFormat(const char* name)
+{
+  std::string value = name ? name : "";
+  if (value == "raw")
+  {
+    return CaptureFormat::Raw;
+  }
+  if (value == "png")
+  {
+    return CaptureFormat::Png;
+  }
+  return CaptureFormat::Ppm;
+}
+
+bool VulkanFrameCapture::record(vk::CommandBuffer commandBuffer, vk::Image image,
+                                uint64_t frameIndex, uint64_t timelineValue)
+{
+  // Поиск свободного буфера по кругу, начиная со следующего за последним занятым
+  int32_t slotIndex = -1;
+  for (uint32_t i = 0; i < m_ringSize && slotIndex < 0; i++)
+  {
+    uint32_t candidate = (m_nextSlot + i) % m_ringSize;
+    if (m_slots[candidate].state == SlotState::Free)
+    {
+      slotIndex = static_cast<int32_t>(candidate);
+    }
+  }
+
+  if (slotIndex < 0)
+  {
+    m_droppedCount++;
+    return false;
+  }
+
+  ReadbackSlot& slot = m_slots[slotIndex];
+  slot.state         = SlotState::Pending;
+  slot.frameIndex    = frameIndex;
+  slot.timelineValue = timelineValue;
+  m_nextSlot         = (slotIndex + 1) % m_ringSize;
+
+  vk::BufferImageCopy region = {};
+  region.bufferOffset        = 0;
+  region.bufferRowLength     = 0;  // Строки плотно упакованы
+  region.bufferImageHeight   = 0;
+  region.imageSubresource    = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+  region.imageOffset         = vk::Offset3D{0, 0, 0};
+  region.imageExtent         = vk::Extent3D{m_extent.width, m_extent.height, 1};
+  commandBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, *slot.buffer,
+                                  region);
+
+  // Запись копирования должна стать видимой для чтения хостом
+  vk::BufferMemoryBarrier2 barrier = {};
+  barrier.srcStageMask             = vk::PipelineStageFlagBits2::eAllTransfer;
+  barrier.srcAccessMask            = vk::AccessFlagBits2::eTransferWrite;
+  barrier.dstStageMask             = vk::PipelineStageFlagBits2::eHost;
+  barrier.dstAccessMask            = vk::AccessFlagBits2::eHostRead;
+  barrier.srcQueueFamilyIndex      = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex      = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer                   = *slot.buffer;
+  barrier.offset                   = 0;
+  barrier.size                     = VK_WHOLE_SIZE;
+
+  vk::DependencyInfo dependencyInfo       = {};
+  dependencyInfo.bufferMemoryBarrierCount = 1;
+  dependencyInfo.pBufferMemoryBarriers    = &barrier;
+  commandBuffer.pipelineBarrier2(dependencyInfo);
+
+  return true;
+}
+
+void VulkanFrameCapture::poll(uint64_t completedValue)
+{
+  std::vector<EncodeJob> ready;
+  for (uint32_t i = 0; i < m_ringSize; i++)
+  {
+    ReadbackSlot& slot = m_slots[i];
+    if (slot.state != SlotState::Pending || slot.timelineValue > completedValue)
+    {
+      continue;
+    }
+
+    // Некогерентная память: данные GPU нужно явно сделать видимыми для CPU
+    vk::MappedMemoryRange range = {};
+    range.memory                = *slot.memory;
+    range.offset                = 0;
+    range.size                  = VK_WHOLE_SIZE;
+    m_device.getDevice().invalidateMappedMemoryRanges(range);
+
+    slot.state = SlotState::Encoding;
+    ready.push_back({i, slot.frameIndex});
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& job : ready)
+    {
+      m_jobs.push_back(job);
+    }
+
+    // Буферы, которые поток кодирования уже отпустил
+    for (uint32_t slot : m_finished)
+    {
+      m_slots[slot].state = SlotState::Free;
+    }
+    m_capturedCount += m_finished.size();
+    m_finished.clear();
+  }
+
+  if (!ready.empty())
+  {
+    m_jobAvailable.notify_one();
+  }
+}
+
+void VulkanFrameCapture::encoderLoop()
+{
+  std::vector<uint8_t> scratch;
+  for (;;)
+  {
+    EncodeJob job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+      if (m_jobs.empty())
+      {
+        return;  // Остановка после записи всех заданий
+      }
+      job = m_jobs.front();
+      m_jobs.pop_front();
+    }
+
+    try
+    {
+      encode(job, scratch);
+    }
+    catch (const std::exception& e)
+    {
+      std::cerr << "Не удалось записать кадр " << job.frameIndex << ": " << e.what()
+                << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished.push_back(job.slot);
+  }
+}
+
+std::string VulkanFrameCapture::makeFileName(uint64_t frameIndex) const
+{
+  const char* extension = m_format == CaptureFormat::Raw   ? "rgba"
+                          : m_format == CaptureFormat::Png ? "png"
+                                                           : "ppm";
+
+  char name[64];
+  std::snprintf(name, sizeof(name), "frame_%06llu.%s",
+                static_cast<unsigned long long>(frameIndex), extension);
+  return (std::filesystem::path(m_directory) / name).string();
+}
+
+void VulkanFrameCapture::encode(const EncodeJob& job, std::vector<uint8_t>& scratch) const
+{
+  const uint8_t* rgba       = m_slots[job.slot].pixels;
+  size_t         pixelCount = static_cast<size_t>(m_extent.width) * m_extent.height;
+
+  std::ofstream file(makeFileName(job.frameIndex), std::ios::binary);
+  if (!file)
+  {
+    throw std::runtime_error("не удалось открыть файл");
+  }
+
+  // Сырые пиксели пишутся прямо из отображённой памяти
+  if (m_format == CaptureFormat::Raw)
+  {
+    file.write(reinterpret_cast<const char*>(rgba), static_cast<std::streamsize>(m_frameSize));
+    return;
+  }
+
+  // PPM и PNG хранят RGB: альфа-канал отбрасывается
+  scratch.resize(pixelCount * 3);
+  for (size_t i = 0; i < pixelCount; i++)
+  {
+    std::memcpy(&scratch[i * 3], &rgba[i * 4], 3);
+  }
+
+  if (m_format == CaptureFormat::Png)
+  {
+    writePng(file, scratch.data(), m_extent.width, m_extent.height);
+    return;
+  }
+
+  file << "P6\n" << m_extent.width << " " << m_extent.height << "\n255\n";
+  file.write(reinterpret_cast<const char*>(scratch.data()),
+             static_cast<std::streamsize>(scratch.size()));
+}
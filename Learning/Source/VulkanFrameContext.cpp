@@ -0,0 +1,93 @@
+#include "VulkanFrameContext.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+VulkanFrameContext::VulkanFrameContext(VulkanDevice& device, size_t arenaBytes)
+    : m_device(device), m_arena(arenaBytes)
+{
+}
+
+VulkanFrameContext::~VulkanFrameContext()
+{
+  // Очистка ресурсов
+  cleanup();
+}
+
+int VulkanFrameContext::init()
+{
+  // Буферы слота сбрасываются только вместе с пулом, поэтому флаг сброса по одному не нужен
+  vk::CommandPoolCreateInfo poolInfo = {};
+  poolInfo.queueFamilyIndex          = m_device.getQueueFamilyIndices().graphicsFamily.value();
+  poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eTransient;
+
+  try
+  {
+    m_vkCommandPool = m_device.getDevice().createCommandPoolUnique(poolInfo);
+
+    vk::CommandBufferAllocateInfo allocInfo = {};
+    allocInfo.commandPool                   = *m_vkCommandPool;
+    allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount            = 2;
+
+    std::vector<vk::CommandBuffer> commandBuffers =
+        m_device.getDevice().allocateCommandBuffers(allocInfo);
+    m_vkCommandBuffer       = commandBuffers[0];
+    m_vkUploadCommandBuffer = commandBuffers[1];
+
+    m_vkImageAvailableSemaphore =
+        m_device.getDevice().createSemaphoreUnique(vk::SemaphoreCreateInfo());
+    return 0;
+  }
+  catch (const vk::SystemError& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanFrameContext: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanFrameContext::cleanup()
+{
+  // Ресурсы, удерживаемые до конца кадра, освобождаются до пула и устройства
+  runDeferred();
+  m_arena.reset();
+
+  m_vkImageAvailableSemaphore.reset();
+  m_vkCommandBuffer       = nullptr;
+  m_vkUploadCommandBuffer = nullptr;
+  m_vkCommandPool.reset();
+}
+
+void VulkanFrameContext::begin()
+{
+  // Кадр слота завершён на GPU: его ресурсы и команды больше не используются
+  runDeferred();
+
+  try
+  {
+    m_device.getDevice().resetCommandPool(*m_vkCommandPool);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось сбросить пул команд кадра: " + std::string(e.what()));
+  }
+
+  m_arena.reset();
+}
+
+void VulkanFrameContext::runDeferred()
+{
+  // Узлы живут в арене: после выполнения их память освобождает reset()
+  DeferredWork* work = m_pDeferredHead;
+  while (work)
+  {
+    DeferredWork* next = work->pNext;
+    work->run(work);
+    work = next;
+  }
+
+  m_pDeferredHead = nullptr;
+  m_pDeferredTail = nullptr;
+  m_deferredCount = 0;
+}
@@ -0,0 +1,71 @@
+#include "VulkanGpuTimer.h"
+
+VulkanGpuTimer::VulkanGpuTimer(VulkanDevice& device, uint32_t framesInFlight)
+    : m_device(device), m_framesInFlight(framesInFlight)
+{
+}
+
+int VulkanGpuTimer::init()
+{
+  // Timestamp-запросы поддерживаются не всеми очередями
+  uint32_t graphicsFamily = m_device.getQueueFamilyIndices().graphicsFamily.value();
+  auto     families       = m_device.getPhysicalDevice().getQueueFamilyProperties();
+  if (families[graphicsFamily].timestampValidBits == 0)
+  {
+    return -1;
+  }
+  m_timestampPeriod = m_device.getPhysicalDevice().getProperties().limits.timestampPeriod;
+
+  vk::QueryPoolCreateInfo queryPoolInfo = {};
+  queryPoolInfo.queryType               = vk::QueryType::eTimestamp;
+  queryPoolInfo.queryCount              = 2 * m_framesInFlight;
+
+  m_vkQueryPool = m_device.getDevice().createQueryPoolUnique(queryPoolInfo);
+  m_slotRecorded.assign(m_framesInFlight, false);
+  return 0;
+}
+
+void VulkanGpuTimer::cleanup()
+{
+  m_vkQueryPool.reset();
+  m_slotRecorded.clear();
+}
+
+void VulkanGpuTimer::begin(vk::CommandBuffer commandBuffer, uint32_t frameSlot,
+                           vk::PipelineStageFlags2 stage)
+{
+  if (m_vkQueryPool)
+  {
+    commandBuffer.resetQueryPool(*m_vkQueryPool, 2 * frameSlot, 2);
+    commandBuffer.writeTimestamp2(stage, *m_vkQueryPool, 2 * frameSlot);
+  }
+}
+
+void VulkanGpuTimer::end(vk::CommandBuffer commandBuffer, uint32_t frameSlot,
+                         vk::PipelineStageFlags2 stage)
+{
+  if (m_vkQueryPool)
+  {
+    commandBuffer.writeTimestamp2(stage, *m_vkQueryPool, 2 * frameSlot + 1);
+    m_slotRecorded[frameSlot] = true;
+  }
+}
+
+std::optional<double> VulkanGpuTimer::read(uint32_t frameSlot) const
+{
+  if (!m_vkQueryPool || !m_slotRecorded[frameSlot])
+  {
+    return std::nullopt;
+  }
+
+  // Кадр слота уже завершён, поэтому ожидание не нужно
+  auto result = m_device.getDevice().getQueryPoolResults<uint64_t>(
+      *m_vkQueryPool, 2 * frameSlot, 2, 2 * sizeof(uint64_t), sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64);
+  if (result.result != vk::Result::eSuccess)
+  {
+    return std::nullopt;
+  }
+
+  return static_cast<double>(result.value[1] - result.value[0]) * m_timestampPeriod * 1e-6;
+}
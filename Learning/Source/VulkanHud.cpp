@@ -0,0 +1,523 @@
+#include "VulkanHud.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "VulkanUtils.h"
+
+VulkanHud::VulkanHud(VulkanDevice& device, uint32_t framesInFlight)
+    : m_device(device), m_framesInFlight(framesInFlight), m_gpuTimer(device, framesInFlight)
+{
+}
+
+VulkanHud::~VulkanHud()
+{
+  cleanup();
+}
+
+int VulkanHud::init(vk::Format colorFormat, vk::CommandPool commandPool, bool dynamicRendering)
+{
+  try
+  {
+    createAtlas(commandPool);
+    createDescriptorSet();
+    createVertexBuffer();
+    if (!dynamicRendering)
+    {
+      createRenderPass(colorFormat);
+    }
+    createPipeline(colorFormat);
+    if (m_gpuTimer.init() != 0)
+    {
+      std::cout << "Timestamp-запросы недоступны, время кадра на GPU не измеряется" << std::endl;
+    }
+
+    std::cout << "Оверлей производительности создан: до " << MAX_VERTICES
+              << " вершин на кадр, атлас " << PerformanceHud::ATLAS_WIDTH << "x"
+              << PerformanceHud::ATLAS_HEIGHT << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanHud: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanHud::cleanup()
+{
+  m_gpuTimer.cleanup();
+  m_vkFramebuffers.clear();
+  m_framebufferViews.clear();
+  m_vkPipeline.reset();
+  m_vkPipelineLayout.reset();
+  m_vkRenderPass.reset();
+  if (m_pVertices)
+  {
+    m_device.getDevice().unmapMemory(*m_vkVertexMemory);
+    m_pVertices = nullptr;
+  }
+  m_vkVertexBuffer.reset();
+  m_vkVertexMemory.reset();
+  m_vkDescriptorPool.reset();
+  m_vkDescriptorSetLayout.reset();
+  m_vkSampler.reset();
+  m_vkAtlasView.reset();
+  m_vkAtlasImage.reset();
+  m_vkAtlasMemory.reset();
+}
+
+void VulkanHud::createAtlas(vk::CommandPool commandPool)
+{
+  vk::Device           device = m_device.getDevice();
+  std::vector<uint8_t> pixels = PerformanceHud::buildFontAtlas();
+
+  vk::ImageCreateInfo imageInfo = {};
+  imageInfo.imageType           = vk::ImageType::e2D;
+  imageInfo.format              = ATLAS_FORMAT;
+  imageInfo.extent = vk::Extent3D{PerformanceHud::ATLAS_WIDTH, PerformanceHud::ATLAS_HEIGHT, 1};
+  imageInfo.mipLevels     = 1;
+  imageInfo.arrayLayers   = 1;
+  imageInfo.samples       = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling        = vk::ImageTiling::eOptimal;
+  imageInfo.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+  imageInfo.sharingMode   = vk::SharingMode::eExclusive;
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+  m_vkAtlasImage          = device.createImageUnique(imageInfo);
+
+  vk::MemoryRequirements memRequirements = device.getImageMemoryRequirements(*m_vkAtlasImage);
+  vk::MemoryAllocateInfo allocInfo       = {};
+  allocInfo.allocationSize               = memRequirements.size;
+  allocInfo.memoryTypeIndex              = m_device.findMemoryType(
+      memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+  m_vkAtlasMemory = m_device.allocateMemory(allocInfo, MemoryCategory::Image);
+  device.bindImageMemory(*m_vkAtlasImage, *m_vkAtlasMemory, 0);
+
+  vk::ImageViewCreateInfo viewInfo = {};
+  viewInfo.image                   = *m_vkAtlasImage;
+  viewInfo.viewType                = vk::ImageViewType::e2D;
+  viewInfo.format                  = ATLAS_FORMAT;
+  viewInfo.subresourceRange        = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor,
+                                                               0, 1, 0, 1);
+  m_vkAtlasView                    = device.createImageViewUnique(viewInfo);
+
+  // Пиксели шрифта должны оставаться чёткими, поэтому фильтрации нет
+  vk::SamplerCreateInfo samplerInfo = {};
+  samplerInfo.magFilter             = vk::Filter::eNearest;
+  samplerInfo.minFilter             = vk::Filter::eNearest;
+  samplerInfo.mipmapMode            = vk::SamplerMipmapMode::eNearest;
+  samplerInfo.addressModeU          = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV          = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW          = vk::SamplerAddressMode::eClampToEdge;
+  m_vkSampler                       = device.createSamplerUnique(samplerInfo);
+
+  // Загрузка через стадийный буфер
+  vk::UniqueBuffer    stagingBuffer;
+  TrackedDeviceMemory stagingBufferMemory;
+  m_device.createBuffer(
+      pixels.size(), vk::BufferUsageFlagBits::eTransferSrc,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      stagingBuffer, stagingBufferMemory, MemoryCategory::Staging);
+
+  void* data = device.mapMemory(*stagingBufferMemory, 0, pixels.size());
+  memcpy(data, pixels.data(), pixels.size());
+  device.unmapMemory(*stagingBufferMemory);
+
+  vk::CommandBufferAllocateInfo cmdBufAllocInfo = {};
+  cmdBufAllocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+  cmdBufAllocInfo.commandPool                   = commandPool;
+  cmdBufAllocInfo.commandBufferCount            = 1;
+
+  auto tempCommandBuffers = device.allocateCommandBuffersUnique(cmdBufAllocInfo);
+  vk::CommandBuffer cmd   = *tempCommandBuffers[0];
+
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  cmd.begin(beginInfo);
+
+  vk::ImageMemoryBarrier barrier = {};
+  barrier.oldLayout              = vk::ImageLayout::eUndefined;
+  barrier.newLayout              = vk::ImageLayout::eTransferDstOptimal;
+  barrier.srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image                  = *m_vkAtlasImage;
+  barrier.subresourceRange       = viewInfo.subresourceRange;
+  barrier.dstAccessMask          = vk::AccessFlagBits::eTransferWrite;
+  cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                      {}, nullptr, nullptr, barrier);
+
+  vk::BufferImageCopy region = {};
+  region.imageSubresource    = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+  region.imageExtent         = imageInfo.extent;
+  cmd.copyBufferToImage(*stagingBuffer, *m_vkAtlasImage, vk::ImageLayout::eTransferDstOptimal,
+                        region);
+
+  barrier.oldLayout     = vk::ImageLayout::eTransferDstOptimal;
+  barrier.newLayout     = vk::ImageLayout::eShaderReadOnlyOptimal;
+  barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+  cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                      vk::PipelineStageFlagBits::eFragmentShader, {}, nullptr, nullptr, barrier);
+
+  cmd.end();
+
+  vk::SubmitInfo submitInfo     = {};
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers    = &cmd;
+  m_device.getGraphicsQueue().submit(submitInfo, nullptr);
+  m_device.getGraphicsQueue().waitIdle();
+}
+
+void VulkanHud::createDescriptorSet()
+{
+  vk::Device device = m_device.getDevice();
+
+  vk::DescriptorSetLayoutBinding binding = {};
+  binding.binding                        = 0;
+  binding.descriptorType                 = vk::DescriptorType::eCombinedImageSampler;
+  binding.descriptorCount                = 1;
+  binding.stageFlags                     = vk::ShaderStageFlagBits::eFragment;
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
+  layoutInfo.bindingCount                      = 1;
+  layoutInfo.pBindings                         = &binding;
+  m_vkDescriptorSetLayout = device.createDescriptorSetLayoutUnique(layoutInfo);
+
+  vk::DescriptorPoolSize poolSize = {};
+  poolSize.type                   = vk::DescriptorType::eCombinedImageSampler;
+  poolSize.descriptorCount        = 1;
+
+  vk::DescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.maxSets                      = 1;
+  poolInfo.poolSizeCount                = 1;
+  poolInfo.pPoolSizes                   = &poolSize;
+  m_vkDescriptorPool                    = device.createDescriptorPoolUnique(poolInfo);
+
+  vk::DescriptorSetLayout       setLayout = *m_vkDescriptorSetLayout;
+  vk::DescriptorSetAllocateInfo allocInfo = {};
+  allocInfo.descriptorPool                = *m_vkDescriptorPool;
+  allocInfo.descriptorSetCount            = 1;
+  allocInfo.pSetLayouts                   = &setLayout;
+  m_vkDescriptorSet                       = device.allocateDescriptorSets(allocInfo)[0];
+
+  vk::DescriptorImageInfo imageInfo = {};
+  imageInfo.sampler                 = *m_vkSampler;
+  imageInfo.imageView               = *m_vkAtlasView;
+  imageInfo.imageLayout             = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+  vk::WriteDescriptorSet write = {};
+  write.dstSet                 = m_vkDescriptorSet;
+  write.dstBinding             = 0;
+  write.descriptorCount        = 1;
+  write.descriptorType         = vk::DescriptorType::eCombinedImageSampler;
+  write.pImageInfo             = &imageInfo;
+  device.updateDescriptorSets(write, nullptr);
+}
+
+void VulkanHud::createVertexBuffer()
+{
+  // Область на каждый кадр в обработке: CPU пишет слот, который GPU уже не читает
+  vk::DeviceSize size =
+      static_cast<vk::DeviceSize>(MAX_VERTICES) * m_framesInFlight * sizeof(HudVertex);
+  m_device.createBuffer(
+      size, vk::BufferUsageFlagBits::eVertexBuffer,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      m_vkVertexBuffer, m_vkVertexMemory);
+
+  // Постоянное отображение на всё время жизни буфера
+  m_pVertices = static_cast<HudVertex*>(m_device.getDevice().mapMemory(*m_vkVertexMemory, 0, size));
+  m_vertexCounts.assign(m_framesInFlight, 0);
+}
+
+void VulkanHud::createRenderPass(vk::Format colorFormat)
+{
+  // Содержимое кадра загружается, переходы layout выполняет граф кадра
+  vk::AttachmentDescription colorAttachment = {};
+  colorAttachment.format                    = colorFormat;
+  colorAttachment.samples                   = vk::SampleCountFlagBits::e1;
+  colorAttachment.loadOp                    = vk::AttachmentLoadOp::eLoad;
+  colorAttachment.storeOp                   = vk::AttachmentStoreOp::eStore;
+  colorAttachment.stencilLoadOp             = vk::AttachmentLoadOp::eDontCare;
+  colorAttachment.stencilStoreOp            = vk::AttachmentStoreOp::eDontCare;
+  colorAttachment.initialLayout             = vk::ImageLayout::eColorAttachmentOptimal;
+  colorAttachment.finalLayout               = vk::ImageLayout::eColorAttachmentOptimal;
+
+  vk::AttachmentReference colorAttachmentRef = {};
+  colorAttachmentRef.attachment              = 0;
+  colorAttachmentRef.layout                  = vk::ImageLayout::eColorAttachmentOptimal;
+
+  vk::SubpassDescription subpass = {};
+  subpass.pipelineBindPoint      = vk::PipelineBindPoint::eGraphics;
+  subpass.colorAttachmentCount   = 1;
+  subpass.pColorAttachments      = &colorAttachmentRef;
+
+  vk::RenderPassCreateInfo renderPassInfo = {};
+  renderPassInfo.attachmentCount          = 1;
+  renderPassInfo.pAttachments             = &colorAttachment;
+  renderPassInfo.subpassCount             = 1;
+  renderPassInfo.pSubpasses               = &subpass;
+
+  try
+  {
+    m_vkRenderPass = m_device.getDevice().createRenderPassUnique(renderPassInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать render pass оверлея: " + std::string(e.what()));
+  }
+}
+
+void VulkanHud::createFramebuffers(const std::vector<vk::ImageView>& targets, vk::Extent2D extent)
+{
+  m_vkFramebuffers.clear();
+  m_framebufferViews = targets;
+
+  for (vk::ImageView target : targets)
+  {
+    vk::FramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.renderPass                = *m_vkRenderPass;
+    framebufferInfo.attachmentCount           = 1;
+    framebufferInfo.pAttachments              = &target;
+    framebufferInfo.width                     = extent.width;
+    framebufferInfo.height                    = extent.height;
+    framebufferInfo.layers                    = 1;
+
+    try
+    {
+      m_vkFramebuffers.push_back(m_device.getDevice().createFramebufferUnique(framebufferInfo));
+    }
+    catch (const vk::SystemError& e)
+    {
+      throw std::runtime_error("Не удалось создать framebuffer оверлея: " +
+                               std::string(e.what()));
+    }
+  }
+}
+
+void VulkanHud::createPipeline(vk::Format colorFormat)
+{
+  vk::Device device = m_device.getDevice();
+
+  auto vertShaderCode = VulkanUtils::loadShader("Learning/Shaders/hud.vert.spv");
+  auto fragShaderCode = VulkanUtils::loadShader("Learning/Shaders/hud.frag.spv");
+
+  vk::ShaderModuleCreateInfo vertModuleInfo = {};
+  vertModuleInfo.codeSize                   = vertShaderCode.size();
+  vertModuleInfo.pCode = reinterpret_cast<const uint32_t*>(vertShaderCode.data());
+  vk::ShaderModuleCreateInfo fragModuleInfo = {};
+  fragModuleInfo.codeSize                   = fragShaderCode.size();
+  fragModuleInfo.pCode = reinterpret_cast<const uint32_t*>(fragShaderCode.data());
+
+  vk::UniqueShaderModule vertShaderModule = device.createShaderModuleUnique(vertModuleInfo);
+  vk::UniqueShaderModule fragShaderModule = device.createShaderModuleUnique(fragModuleInfo);
+
+  std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = {};
+  shaderStages[0].stage  = vk::ShaderStageFlagBits::eVertex;
+  shaderStages[0].module = *vertShaderModule;
+  shaderStages[0].pName  = "main";
+  shaderStages[1].stage  = vk::ShaderStageFlagBits::eFragment;
+  shaderStages[1].module = *fragShaderModule;
+  shaderStages[1].pName  = "main";
+
+  // Положение в пикселях, координаты атласа и цвет RGBA8
+  vk::VertexInputBindingDescription bindingDescription = {};
+  bindingDescription.binding                           = 0;
+  bindingDescription.stride                            = sizeof(HudVertex);
+  bindingDescription.inputRate                         = vk::VertexInputRate::eVertex;
+
+  std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions = {};
+  attributeDescriptions[0].location = 0;
+  attributeDescriptions[0].format   = vk::Format::eR32G32Sfloat;
+  attributeDescriptions[0].offset   = offsetof(HudVertex, position);
+  attributeDescriptions[1].location = 1;
+  attributeDescriptions[1].format   = vk::Format::eR32G32Sfloat;
+  attributeDescriptions[1].offset   = offsetof(HudVertex, uv);
+  attributeDescriptions[2].location = 2;
+  attributeDescriptions[2].format   = vk::Format::eR8G8B8A8Unorm;
+  attributeDescriptions[2].offset   = offsetof(HudVertex, color);
+
+  vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
+  vertexInputInfo.vertexBindingDescriptionCount          = 1;
+  vertexInputInfo.pVertexBindingDescriptions             = &bindingDescription;
+  vertexInputInfo.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(attributeDescriptions.size());
+  vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+  vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.topology                                 = vk::PrimitiveTopology::eTriangleList;
+
+  vk::PipelineViewportStateCreateInfo viewportState = {};
+  viewportState.viewportCount                       = 1;
+  viewportState.scissorCount                        = 1;
+
+  vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                        vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+  dynamicState.dynamicStateCount                     = 2;
+  dynamicState.pDynamicStates                        = dynamicStates;
+
+  vk::PipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.polygonMode                              = vk::PolygonMode::eFill;
+  rasterizer.lineWidth                                = 1.0f;
+  rasterizer.cullMode                                 = vk::CullModeFlagBits::eNone;
+
+  vk::PipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.rasterizationSamples                   = vk::SampleCountFlagBits::e1;
+
+  // Обычное альфа-смешивание поверх кадра, глубины нет
+  vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
+  colorBlendAttachment.colorWriteMask =
+      vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+      vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+  colorBlendAttachment.blendEnable         = VK_TRUE;
+  colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+  colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+  colorBlendAttachment.colorBlendOp        = vk::BlendOp::eAdd;
+  colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eZero;
+  colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.alphaBlendOp        = vk::BlendOp::eAdd;
+
+  vk::PipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.attachmentCount                       = 1;
+  colorBlending.pAttachments                          = &colorBlendAttachment;
+
+  vk::PushConstantRange pushConstantRange = {};
+  pushConstantRange.stageFlags            = vk::ShaderStageFlagBits::eVertex;
+  pushConstantRange.offset                = 0;
+  pushConstantRange.size                  = sizeof(HudParams);
+
+  vk::DescriptorSetLayout      setLayout  = *m_vkDescriptorSetLayout;
+  vk::PipelineLayoutCreateInfo layoutInfo = {};
+  layoutInfo.setLayoutCount               = 1;
+  layoutInfo.pSetLayouts                  = &setLayout;
+  layoutInfo.pushConstantRangeCount       = 1;
+  layoutInfo.pPushConstantRanges          = &pushConstantRange;
+  m_vkPipelineLayout                      = device.createPipelineLayoutUnique(layoutInfo);
+
+  vk::PipelineRenderingCreateInfo renderingInfo = {};
+  renderingInfo.colorAttachmentCount            = 1;
+  renderingInfo.pColorAttachmentFormats         = &colorFormat;
+
+  // С render pass формат вложения задаёт он, а не PipelineRenderingCreateInfo
+  vk::GraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.pNext                          = m_vkRenderPass ? nullptr : &renderingInfo;
+  pipelineInfo.renderPass                     = *m_vkRenderPass;
+  pipelineInfo.stageCount                     = static_cast<uint32_t>(shaderStages.size());
+  pipelineInfo.pStages                        = shaderStages.data();
+  pipelineInfo.pVertexInputState              = &vertexInputInfo;
+  pipelineInfo.pInputAssemblyState            = &inputAssembly;
+  pipelineInfo.pViewportState                 = &viewportState;
+  pipelineInfo.pRasterizationState            = &rasterizer;
+  pipelineInfo.pMultisampleState              = &multisampling;
+  pipelineInfo.pColorBlendState               = &colorBlending;
+  pipelineInfo.pDynamicState                  = &dynamicState;
+  pipelineInfo.layout                         = *m_vkPipelineLayout;
+
+  try
+  {
+    auto result  = device.createGraphicsPipelineUnique(nullptr, pipelineInfo);
+    m_vkPipeline = std::move(result.value);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать конвейер оверлея: " + std::string(e.what()));
+  }
+}
+
+void VulkanHud::beginFrame(vk::CommandBuffer commandBuffer, uint32_t frameSlot)
+{
+  m_gpuTimer.begin(commandBuffer, frameSlot, vk::PipelineStageFlagBits2::eTopOfPipe);
+}
+
+void VulkanHud::endFrame(vk::CommandBuffer commandBuffer, uint32_t frameSlot)
+{
+  m_gpuTimer.end(commandBuffer, frameSlot, vk::PipelineStageFlagBits2::eAllCommands);
+}
+
+void VulkanHud::collectTimings(uint32_t frameSlot)
+{
+  std::optional<double> ms = m_gpuTimer.read(frameSlot);
+  if (!ms)
+  {
+    return;
+  }
+
+  // Сглаживание, чтобы цифры на экране можно было прочитать
+  m_gpuFrameMs = m_timingSamples == 0 ? *ms : m_gpuFrameMs * 0.9 + *ms * 0.1;
+  m_timingSamples++;
+}
+
+void VulkanHud::update(uint32_t frameSlot, const HudFrameStats& stats)
+{
+  m_hud.addFrame(stats);
+  m_vertexCounts[frameSlot] = m_hud.build(m_pVertices + frameSlot * MAX_VERTICES, MAX_VERTICES);
+}
+
+void VulkanHud::record(vk::CommandBuffer commandBuffer, uint32_t frameSlot, vk::ImageView target,
+                       vk::Extent2D extent)
+{
+  // Содержимое кадра сохраняется, оверлей смешивается поверх
+  vk::RenderingAttachmentInfo colorAttachment = {};
+  colorAttachment.imageView                   = target;
+  colorAttachment.imageLayout                 = vk::ImageLayout::eColorAttachmentOptimal;
+  colorAttachment.loadOp                      = vk::AttachmentLoadOp::eLoad;
+  colorAttachment.storeOp                     = vk::AttachmentStoreOp::eStore;
+
+  vk::RenderingInfo renderingInfo    = {};
+  renderingInfo.renderArea.offset    = vk::Offset2D{0, 0};
+  renderingInfo.renderArea.extent    = extent;
+  renderingInfo.layerCount           = 1;
+  renderingInfo.colorAttachmentCount = 1;
+  renderingInfo.pColorAttachments    = &colorAttachment;
+
+  vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(extent.width),
+                        static_cast<float>(extent.height), 0.0f, 1.0f);
+  vk::Rect2D   scissor(vk::Offset2D{0, 0}, extent);
+
+  HudParams params = {};
+  params.scale[0]  = 2.0f / static_cast<float>(extent.width);
+  params.scale[1]  = 2.0f / static_cast<float>(extent.height);
+
+  vk::DeviceSize offset = static_cast<vk::DeviceSize>(frameSlot) * MAX_VERTICES * sizeof(HudVertex);
+
+  if (m_vkRenderPass)
+  {
+    // Framebuffer изображения, в которое рисуется кадр
+    auto it = std::find(m_framebufferViews.begin(), m_framebufferViews.end(), target);
+    if (it == m_framebufferViews.end())
+    {
+      return;
+    }
+
+    vk::RenderPassBeginInfo renderPassInfo = {};
+    renderPassInfo.renderPass              = *m_vkRenderPass;
+    renderPassInfo.framebuffer = *m_vkFramebuffers[it - m_framebufferViews.begin()];
+    renderPassInfo.renderArea  = renderingInfo.renderArea;
+    commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+  }
+  else
+  {
+    commandBuffer.beginRendering(renderingInfo);
+  }
+  commandBuffer.setViewport(0, viewport);
+  commandBuffer.setScissor(0, scissor);
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *m_vkPipeline);
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *m_vkPipelineLayout, 0,
+                                   m_vkDescriptorSet, nullptr);
+  commandBuffer.pushConstants(*m_vkPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
+                              sizeof(HudParams), &params);
+  commandBuffer.bindVertexBuffers(0, *m_vkVertexBuffer, offset);
+  commandBuffer.draw(m_vertexCounts[frameSlot], 1, 0, 0);
+  if (m_vkRenderPass)
+  {
+    commandBuffer.endRenderPass();
+  }
+  else
+  {
+    commandBuffer.endRendering();
+  }
+}
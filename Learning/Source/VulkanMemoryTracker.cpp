@@ -0,0 +1,255 @@
+#include "VulkanMemoryTracker.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+  const char* categoryName(uint32_t category)
+  {
+    switch (static_cast<MemoryCategory>(category))
+    {
+      case MemoryCategory::Buffer:
+        return "буферы";
+      case MemoryCategory::Image:
+        return "изображения";
+      case MemoryCategory::Staging:
+        return "staging";
+    }
+    return "?";
+  }
+
+  double toMegabytes(vk::DeviceSize bytes)
+  {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+  }
+}  // namespace
+
+VulkanMemoryTracker::VulkanMemoryTracker(vk::PhysicalDevice physicalDevice, bool budgetSupported)
+    : m_vkPhysicalDevice(physicalDevice),
+      m_vkMemoryProperties(physicalDevice.getMemoryProperties()),
+      m_budgetSupported(budgetSupported),
+      m_lastReport(std::chrono::steady_clock::now())
+{
+}
+
+void VulkanMemoryTracker::onAllocate(uint32_t heapIndex, MemoryCategory category,
+                                     vk::DeviceSize size)
+{
+  HeapCounters& heap = m_heaps[heapIndex];
+  heap.bytes[static_cast<uint32_t>(category)].fetch_add(size, std::memory_order_relaxed);
+  heap.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VulkanMemoryTracker::onFree(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size)
+{
+  HeapCounters& heap = m_heaps[heapIndex];
+  heap.bytes[static_cast<uint32_t>(category)].fetch_sub(size, std::memory_order_relaxed);
+  heap.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::vector<MemoryHeapReport> VulkanMemoryTracker::query() const
+{
+  // Бюджет драйвера учитывает и чужие процессы, и выделения мимо VulkanDevice
+  vk::PhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+  if (m_budgetSupported)
+  {
+    vk::PhysicalDeviceMemoryProperties2 properties = {};
+    properties.pNext                               = &budgetProperties;
+    m_vkPhysicalDevice.getMemoryProperties2(&properties);
+  }
+
+  std::vector<MemoryHeapReport> reports(m_vkMemoryProperties.memoryHeapCount);
+  for (uint32_t i = 0; i < m_vkMemoryProperties.memoryHeapCount; i++)
+  {
+    const vk::MemoryHeap& heap   = m_vkMemoryProperties.memoryHeaps[i];
+    MemoryHeapReport&     report = reports[i];
+
+    report.heapIndex   = i;
+    report.deviceLocal = static_cast<bool>(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    report.size        = heap.size;
+    for (uint32_t category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+    {
+      report.byCategory[category] = m_heaps[i].bytes[category].load(std::memory_order_relaxed);
+      report.tracked += report.byCategory[category];
+    }
+    report.allocationCount = m_heaps[i].count.load(std::memory_order_relaxed);
+
+    if (m_budgetSupported && budgetProperties.heapBudget[i] > 0)
+    {
+      report.budget           = budgetProperties.heapBudget[i];
+      report.usage            = std::max(budgetProperties.heapUsage[i], report.tracked);
+      report.budgetFromDriver = true;
+    }
+    else
+    {
+      report.budget = static_cast<vk::DeviceSize>(static_cast<double>(heap.size) *
+                                                   static_cast<double>(ESTIMATED_BUDGET_SHARE));
+      report.usage  = report.tracked;
+    }
+  }
+  return reports;
+}
+
+MemoryThresholdHandle VulkanMemoryTracker::addThresholdCallback(float threshold,
+                                                                ThresholdCallback callback)
+{
+  std::lock_guard<std::mutex> lock(m_thresholdMutex);
+  Threshold entry;
+  entry.handle    = m_nextThresholdHandle++;
+  entry.threshold = threshold;
+  entry.callback  = std::move(callback);
+  m_thresholds.push_back(std::move(entry));
+  return m_thresholds.back().handle;
+}
+
+void VulkanMemoryTracker::removeThresholdCallback(MemoryThresholdHandle handle)
+{
+  std::lock_guard<std::mutex> lock(m_thresholdMutex);
+  m_thresholds.erase(std::remove_if(m_thresholds.begin(), m_thresholds.end(),
+                                    [handle](const Threshold& entry)
+                                    { return entry.handle == handle; }),
+                     m_thresholds.end());
+}
+
+void VulkanMemoryTracker::update()
+{
+  std::vector<MemoryHeapReport> reports = query();
+
+  // Сработавшие обработчики копируются под блокировкой и вызываются после неё
+  struct PendingCallback
+  {
+    ThresholdCallback callback;
+    uint32_t          heapIndex;
+    float             threshold;
+  };
+  std::vector<PendingCallback> pending;
+
+  {
+    std::lock_guard<std::mutex> lock(m_thresholdMutex);
+    for (auto& entry : m_thresholds)
+    {
+      for (const auto& report : reports)
+      {
+        // Вытеснение страшно только для памяти устройства: системную драйвер не подкачивает
+        if (!report.deviceLocal)
+        {
+          continue;
+        }
+
+        float fraction  = report.getUsageFraction();
+        bool& triggered = entry.triggered[report.heapIndex];
+        if (!triggered && fraction >= entry.threshold)
+        {
+          triggered = true;
+          pending.push_back({entry.callback, report.heapIndex, entry.threshold});
+        }
+        else if (triggered && fraction < entry.threshold - HYSTERESIS)
+        {
+          triggered = false;
+        }
+      }
+    }
+  }
+
+  for (const PendingCallback& call : pending)
+  {
+    call.callback(reports[call.heapIndex], call.threshold);
+  }
+
+  if (m_reportIntervalSec > 0.0)
+  {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_lastReport).count() >= m_reportIntervalSec)
+    {
+      m_lastReport = now;
+      printReport(std::cout);
+    }
+  }
+}
+
+void VulkanMemoryTracker::printReport(std::ostream& out) const
+{
+  std::ios_base::fmtflags flags = out.flags();
+
+  out << "Видеопамять (МБ, "
+      << (m_budgetSupported ? "бюджет VK_EXT_memory_budget" : "бюджет - оценка 80% кучи")
+      << "):" << std::endl;
+  for (const auto& report : query())
+  {
+    out << std::fixed << std::setprecision(1) << "  куча " << report.heapIndex
+        << (report.deviceLocal ? " (устройство)" : " (система)   ") << "  занято "
+        << std::setw(8) << toMegabytes(report.usage) << " из " << std::setw(8)
+        << toMegabytes(report.budget) << " (" << std::setw(5)
+        << report.getUsageFraction() * 100.0f << "%), наши " << toMegabytes(report.tracked)
+        << " в " << report.allocationCount << " выделениях";
+    for (uint32_t category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+    {
+      out << (category == 0 ? ": " : ", ") << categoryName(category) << " "
+          << toMegabytes(report.byCategory[category]);
+    }
+    out << std::endl;
+  }
+  out.flags(flags);
+}
+
+TrackedDeviceMemory::TrackedDeviceMemory(vk::UniqueDeviceMemory memory,
+                                         VulkanMemoryTracker* tracker, uint32_t heapIndex,
+                                         MemoryCategory category, vk::DeviceSize size)
+    : m_memory(std::move(memory)),
+      m_tracker(tracker),
+      m_heapIndex(heapIndex),
+      m_category(category),
+      m_size(size)
+{
+  if (m_tracker && m_memory)
+  {
+    m_tracker->onAllocate(m_heapIndex, m_category, m_size);
+  }
+}
+
+TrackedDeviceMemory::~TrackedDeviceMemory() { reset(); }
+
+TrackedDeviceMemory::TrackedDeviceMemory(TrackedDeviceMemory&& other) noexcept
+    : m_memory(std::move(other.m_memory)),
+      m_tracker(other.m_tracker),
+      m_heapIndex(other.m_heapIndex),
+      m_category(other.m_category),
+      m_size(other.m_size)
+{
+  other.m_tracker = nullptr;
+  other.m_size    = 0;
+}
+
+TrackedDeviceMemory& TrackedDeviceMemory::operator=(TrackedDeviceMemory&& other) noexcept
+{
+  if (this != &other)
+  {
+    reset();
+    m_memory        = std::move(other.m_memory);
+    m_tracker       = other.m_tracker;
+    m_heapIndex     = other.m_heapIndex;
+    m_category      = other.m_category;
+    m_size          = other.m_size;
+    other.m_tracker = nullptr;
+    other.m_size    = 0;
+  }
+  return *this;
+}
+
+void TrackedDeviceMemory::reset()
+{
+  if (!m_memory)
+  {
+    return;
+  }
+
+  m_memory.reset();
+  if (m_tracker)
+  {
+    m_tracker->onFree(m_heapIndex, m_category, m_size);
+  }
+  m_tracker = nullptr;
+  m_size    = 0;
+}
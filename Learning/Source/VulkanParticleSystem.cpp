@@ -0,0 +1,266 @@
+#include "VulkanParticleSystem.h"
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+#include "VulkanUtils.h"
+
+VulkanParticleSystem::VulkanParticleSystem(VulkanDevice& device, uint32_t particleCount,
+                                           uint32_t framesInFlight)
+    : m_device(device),
+      m_particleCount(particleCount),
+      m_framesInFlight(framesInFlight),
+      m_gpuTimer(device, framesInFlight)
+{
+}
+
+VulkanParticleSystem::~VulkanParticleSystem()
+{
+  cleanup();
+}
+
+int VulkanParticleSystem::init(const ParticleRenderTarget& target)
+{
+  try
+  {
+    createParticleBuffer();
+    createComputePipeline();
+    createGraphicsPipeline(target);
+    if (m_gpuTimer.init() != 0)
+    {
+      std::cout << "Timestamp-запросы недоступны, время симуляции частиц не измеряется"
+                << std::endl;
+    }
+
+    std::cout << "Система частиц создана: " << m_particleCount << " частиц, "
+              << (static_cast<vk::DeviceSize>(m_particleCount) * sizeof(Particle) >> 20) << " МБ"
+              << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanParticleSystem: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanParticleSystem::cleanup()
+{
+  m_gpuTimer.cleanup();
+  m_vkGraphicsPipeline.reset();
+  m_vkGraphicsLayout.reset();
+  m_computePipeline.reset();
+  m_vkParticleBuffer.reset();
+  m_vkParticleMemory.reset();
+}
+
+void VulkanParticleSystem::createParticleBuffer()
+{
+  // Буфер только в памяти устройства: начальные данные генерирует шейдер
+  vk::DeviceSize size = static_cast<vk::DeviceSize>(m_particleCount) * sizeof(Particle);
+  m_device.createBuffer(size,
+                        vk::BufferUsageFlagBits::eStorageBuffer |
+                            vk::BufferUsageFlagBits::eVertexBuffer,
+                        vk::MemoryPropertyFlagBits::eDeviceLocal, m_vkParticleBuffer,
+                        m_vkParticleMemory);
+}
+
+void VulkanParticleSystem::createComputePipeline()
+{
+  vk::DescriptorSetLayoutBinding binding = {};
+  binding.binding                        = 0;
+  binding.descriptorType                 = vk::DescriptorType::eStorageBuffer;
+  binding.descriptorCount                = 1;
+  binding.stageFlags                     = vk::ShaderStageFlagBits::eCompute;
+
+  m_computePipeline = std::make_unique<VulkanComputePipeline>(m_device);
+  if (m_computePipeline->init("Learning/Shaders/particles.comp.spv", {binding},
+                              sizeof(SimulationParams)) != 0)
+  {
+    throw std::runtime_error("Не удалось создать конвейер симуляции частиц");
+  }
+
+  m_vkComputeSet = m_computePipeline->allocateDescriptorSet();
+  m_computePipeline->writeStorageBuffer(m_vkComputeSet, 0, *m_vkParticleBuffer);
+}
+
+void VulkanParticleSystem::createGraphicsPipeline(const ParticleRenderTarget& target)
+{
+  vk::Device device = m_device.getDevice();
+
+  // Шейдеры: точка со своим цветом, фрагментный шейдер общий с треугольником
+  auto vertShaderCode = VulkanUtils::loadShader("Learning/Shaders/particle.vert.spv");
+  auto fragShaderCode = VulkanUtils::loadShader("Learning/Shaders/triangle.frag.spv");
+
+  vk::ShaderModuleCreateInfo vertModuleInfo = {};
+  vertModuleInfo.codeSize                   = vertShaderCode.size();
+  vertModuleInfo.pCode = reinterpret_cast<const uint32_t*>(vertShaderCode.data());
+  vk::ShaderModuleCreateInfo fragModuleInfo = {};
+  fragModuleInfo.codeSize                   = fragShaderCode.size();
+  fragModuleInfo.pCode = reinterpret_cast<const uint32_t*>(fragShaderCode.data());
+
+  vk::UniqueShaderModule vertShaderModule = device.createShaderModuleUnique(vertModuleInfo);
+  vk::UniqueShaderModule fragShaderModule = device.createShaderModuleUnique(fragModuleInfo);
+
+  std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = {};
+  shaderStages[0].stage  = vk::ShaderStageFlagBits::eVertex;
+  shaderStages[0].module = *vertShaderModule;
+  shaderStages[0].pName  = "main";
+  shaderStages[1].stage  = vk::ShaderStageFlagBits::eFragment;
+  shaderStages[1].module = *fragShaderModule;
+  shaderStages[1].pName  = "main";
+
+  // Буфер частиц как буфер вершин: позиция и цвет
+  vk::VertexInputBindingDescription bindingDescription = {};
+  bindingDescription.binding                           = 0;
+  bindingDescription.stride                            = sizeof(Particle);
+  bindingDescription.inputRate                         = vk::VertexInputRate::eVertex;
+
+  std::array<vk::VertexInputAttributeDescription, 2> attributeDescriptions = {};
+  attributeDescriptions[0].location = 0;
+  attributeDescriptions[0].format   = vk::Format::eR32G32Sfloat;
+  attributeDescriptions[0].offset   = offsetof(Particle, position);
+  attributeDescriptions[1].location = 1;
+  attributeDescriptions[1].format   = vk::Format::eR32G32B32A32Sfloat;
+  attributeDescriptions[1].offset   = offsetof(Particle, color);
+
+  vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
+  vertexInputInfo.vertexBindingDescriptionCount          = 1;
+  vertexInputInfo.pVertexBindingDescriptions             = &bindingDescription;
+  vertexInputInfo.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(attributeDescriptions.size());
+  vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+  vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.topology                                 = vk::PrimitiveTopology::ePointList;
+
+  // Вьюпорт и ножницы выставляет основной проход рендерера
+  vk::PipelineViewportStateCreateInfo viewportState = {};
+  viewportState.viewportCount                       = 1;
+  viewportState.scissorCount                        = 1;
+
+  vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                        vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+  dynamicState.dynamicStateCount                     = 2;
+  dynamicState.pDynamicStates                        = dynamicStates;
+
+  vk::PipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.polygonMode                              = vk::PolygonMode::eFill;
+  rasterizer.lineWidth                                = 1.0f;
+  rasterizer.cullMode                                 = vk::CullModeFlagBits::eNone;
+
+  vk::PipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.rasterizationSamples                   = target.samples;
+
+  // Точки полупрозрачные и не пишут глубину: порядок внутри облака не важен
+  vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
+  depthStencil.depthTestEnable                         = VK_TRUE;
+  depthStencil.depthWriteEnable                        = VK_FALSE;
+  depthStencil.depthCompareOp                          = vk::CompareOp::eLessOrEqual;
+
+  vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
+  colorBlendAttachment.colorWriteMask =
+      vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+      vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+  colorBlendAttachment.blendEnable         = VK_TRUE;
+  colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.colorBlendOp        = vk::BlendOp::eAdd;
+  colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.alphaBlendOp        = vk::BlendOp::eAdd;
+
+  vk::PipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.attachmentCount                       = 1;
+  colorBlending.pAttachments                          = &colorBlendAttachment;
+
+  // Набор констант кадра тот же, что у остальной сцены
+  vk::PipelineLayoutCreateInfo layoutInfo = {};
+  layoutInfo.setLayoutCount               = 1;
+  layoutInfo.pSetLayouts                  = &target.frameSetLayout;
+  m_vkGraphicsLayout                      = device.createPipelineLayoutUnique(layoutInfo);
+
+  vk::PipelineRenderingCreateInfo renderingInfo = {};
+  renderingInfo.colorAttachmentCount            = 1;
+  renderingInfo.pColorAttachmentFormats         = &target.colorFormat;
+  renderingInfo.depthAttachmentFormat           = target.depthFormat;
+
+  vk::GraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.pNext                          = target.renderPass ? nullptr : &renderingInfo;
+  pipelineInfo.stageCount                     = static_cast<uint32_t>(shaderStages.size());
+  pipelineInfo.pStages                        = shaderStages.data();
+  pipelineInfo.pVertexInputState              = &vertexInputInfo;
+  pipelineInfo.pInputAssemblyState            = &inputAssembly;
+  pipelineInfo.pViewportState                 = &viewportState;
+  pipelineInfo.pRasterizationState            = &rasterizer;
+  pipelineInfo.pMultisampleState              = &multisampling;
+  pipelineInfo.pDepthStencilState             = &depthStencil;
+  pipelineInfo.pColorBlendState               = &colorBlending;
+  pipelineInfo.pDynamicState                  = &dynamicState;
+  pipelineInfo.layout                         = *m_vkGraphicsLayout;
+  pipelineInfo.renderPass                     = target.renderPass;
+  pipelineInfo.subpass                        = 0;
+
+  try
+  {
+    auto result          = device.createGraphicsPipelineUnique(nullptr, pipelineInfo);
+    m_vkGraphicsPipeline = std::move(result.value);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать конвейер отрисовки частиц: " +
+                             std::string(e.what()));
+  }
+}
+
+void VulkanParticleSystem::simulate(vk::CommandBuffer commandBuffer, uint32_t frameSlot,
+                                    float deltaTime)
+{
+  m_time += deltaTime;
+
+  SimulationParams params = {};
+  params.deltaTime        = deltaTime;
+  params.time             = m_time;
+  params.count            = m_particleCount;
+  params.seed             = m_seeded ? 0 : 0x9E3779B9u;
+  m_seeded                = true;
+
+  m_gpuTimer.begin(commandBuffer, frameSlot, vk::PipelineStageFlagBits2::eComputeShader);
+
+  m_computePipeline->bind(commandBuffer, m_vkComputeSet);
+  m_computePipeline->pushConstants(commandBuffer, params);
+  m_computePipeline->dispatch(commandBuffer,
+                              VulkanComputePipeline::groupCount(m_particleCount, LOCAL_SIZE));
+
+  m_gpuTimer.end(commandBuffer, frameSlot, vk::PipelineStageFlagBits2::eComputeShader);
+}
+
+void VulkanParticleSystem::collectTimings(uint32_t frameSlot)
+{
+  std::optional<double> ms = m_gpuTimer.read(frameSlot);
+  if (!ms)
+  {
+    return;
+  }
+
+  m_simulationMs = m_timingSamples == 0 ? *ms : m_simulationMs * 0.95 + *ms * 0.05;
+  m_timingSamples++;
+
+  if (m_timingSamples % REPORT_INTERVAL == 0)
+  {
+    std::cout << "Частицы: " << m_particleCount << ", симуляция " << m_simulationMs << " мс, "
+              << static_cast<uint64_t>(getParticlesPerMs()) << " частиц/мс" << std::endl;
+  }
+}
+
+void VulkanParticleSystem::fillDrawPacket(DrawPacket& packet) const
+{
+  packet.pipeline       = *m_vkGraphicsPipeline;
+  packet.pipelineLayout = *m_vkGraphicsLayout;
+  packet.vertexBuffer   = *m_vkParticleBuffer;
+  packet.count          = m_particleCount;
+  packet.topology       = vk::PrimitiveTopology::ePointList;
+}
@@ -0,0 +1,463 @@
+#include "VulkanPostProcess.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+VulkanPostProcess::VulkanPostProcess(VulkanDevice& device, uint32_t framesInFlight,
+                                     vk::Extent2D extent)
+    : m_device(device), m_framesInFlight(framesInFlight), m_extent(extent)
+{
+  m_bloomExtent = vk::Extent2D{std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u)};
+
+  m_params.exposure       = 1.0f;
+  m_params.bloomThreshold = 1.0f;
+  m_params.bloomIntensity = 0.6f;
+  m_params.sharpness      = 0.15f;
+}
+
+VulkanPostProcess::~VulkanPostProcess()
+{
+  cleanup();
+}
+
+int VulkanPostProcess::init()
+{
+  try
+  {
+    createImages();
+    createPipelines();
+    createGraph();
+    createDescriptorSets();
+    createCommandObjects();
+    transitionOutputs();
+
+    std::cout << "Постобработка создана: " << m_extent.width << "x" << m_extent.height
+              << ", очередь "
+              << (m_device.hasAsyncCompute() ? "асинхронных вычислений" : "графическая")
+              << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanPostProcess: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanPostProcess::cleanup()
+{
+  // Командные буферы освобождаются раньше пула, изображения графа - раньше его памяти
+  for (auto& slot : m_slots)
+  {
+    slot.commandBuffer.reset();
+  }
+  m_vkCommandPool.reset();
+  m_vkTimeline.reset();
+  m_graph.reset();
+  m_sharpenPipeline.reset();
+  m_tonemapPipeline.reset();
+  m_blurPipeline.reset();
+  m_extractPipeline.reset();
+  m_vkSampler.reset();
+  m_slots.clear();
+}
+
+void VulkanPostProcess::createSharedImage(vk::Format format, vk::ImageUsageFlags usage,
+                                          vk::UniqueImage&     image,
+                                          TrackedDeviceMemory& memory,
+                                          vk::UniqueImageView& view)
+{
+  vk::Device device = m_device.getDevice();
+
+  // Изображение используют обе очереди: при разных семействах - режим concurrent,
+  // чтобы обойтись без передачи владения между очередями
+  uint32_t families[] = {m_device.getQueueFamilyIndices().graphicsFamily.value(),
+                         m_device.getComputeFamily()};
+  bool     concurrent = families[0] != families[1];
+
+  vk::ImageCreateInfo imageInfo   = {};
+  imageInfo.imageType             = vk::ImageType::e2D;
+  imageInfo.format                = format;
+  imageInfo.extent                = vk::Extent3D{m_extent.width, m_extent.height, 1};
+  imageInfo.mipLevels             = 1;
+  imageInfo.arrayLayers           = 1;
+  imageInfo.samples               = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling                = vk::ImageTiling::eOptimal;
+  imageInfo.usage                 = usage;
+  imageInfo.sharingMode           = concurrent ? vk::SharingMode::eConcurrent
+                                               : vk::SharingMode::eExclusive;
+  imageInfo.queueFamilyIndexCount = concurrent ? 2 : 0;
+  imageInfo.pQueueFamilyIndices   = concurrent ? families : nullptr;
+  imageInfo.initialLayout         = vk::ImageLayout::eUndefined;
+
+  try
+  {
+    image = device.createImageUnique(imageInfo);
+
+    vk::MemoryRequirements memRequirements = device.getImageMemoryRequirements(*image);
+    vk::MemoryAllocateInfo allocInfo       = {};
+    allocInfo.allocationSize               = memRequirements.size;
+    allocInfo.memoryTypeIndex              = m_device.findMemoryType(
+        memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    memory = m_device.allocateMemory(allocInfo, MemoryCategory::Image);
+    device.bindImageMemory(*image, *memory, 0);
+
+    vk::ImageViewCreateInfo viewInfo = {};
+    viewInfo.image                   = *image;
+    viewInfo.viewType                = vk::ImageViewType::e2D;
+    viewInfo.format                  = format;
+    viewInfo.subresourceRange =
+        vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+    view = device.createImageViewUnique(viewInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать изображение постобработки: " +
+                             std::string(e.what()));
+  }
+}
+
+void VulkanPostProcess::createImages()
+{
+  m_slots.resize(m_framesInFlight);
+  for (auto& slot : m_slots)
+  {
+    // Сцена: цветовое вложение (в том числе цель resolve) графики, затем чтение сэмплером
+    createSharedImage(getSceneFormat(),
+                      vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+                      slot.sceneImage, slot.sceneMemory, slot.sceneView);
+
+    // Результат: запись шейдером, затем blit в swap chain
+    createSharedImage(OUTPUT_FORMAT,
+                      vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc,
+                      slot.outputImage, slot.outputMemory, slot.outputView);
+  }
+}
+
+void VulkanPostProcess::createPipelines()
+{
+  // Привязки: binding 0..N-2 - чтение, последний - запись
+  auto binding = [](uint32_t index, vk::DescriptorType type)
+  {
+    vk::DescriptorSetLayoutBinding layoutBinding = {};
+    layoutBinding.binding                        = index;
+    layoutBinding.descriptorType                 = type;
+    layoutBinding.descriptorCount                = 1;
+    layoutBinding.stageFlags                     = vk::ShaderStageFlagBits::eCompute;
+    return layoutBinding;
+  };
+
+  const auto sampled = vk::DescriptorType::eCombinedImageSampler;
+  const auto storage = vk::DescriptorType::eStorageImage;
+
+  auto create = [this](const char* shaderPath,
+                       const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+                       uint32_t                                           maxSets)
+  {
+    auto pipeline = std::make_unique<VulkanComputePipeline>(m_device);
+    if (pipeline->init(shaderPath, bindings, sizeof(PostProcessParams), maxSets) != 0)
+    {
+      throw std::runtime_error(std::string("Не удалось создать конвейер ") + shaderPath);
+    }
+    return pipeline;
+  };
+
+  m_extractPipeline = create("Learning/Shaders/bloom_extract.comp.spv",
+                             {binding(0, sampled), binding(1, storage)}, m_framesInFlight);
+  m_blurPipeline    = create("Learning/Shaders/blur.comp.spv",
+                             {binding(0, sampled), binding(1, storage)}, 2);
+  m_tonemapPipeline = create("Learning/Shaders/tonemap.comp.spv",
+                             {binding(0, sampled), binding(1, sampled), binding(2, storage)},
+                             m_framesInFlight);
+  m_sharpenPipeline = create("Learning/Shaders/sharpen.comp.spv",
+                             {binding(0, storage), binding(1, storage)}, m_framesInFlight);
+
+  // Линейная фильтрация нужна для уменьшения в bloom и для размытия
+  vk::SamplerCreateInfo samplerInfo = {};
+  samplerInfo.magFilter             = vk::Filter::eLinear;
+  samplerInfo.minFilter             = vk::Filter::eLinear;
+  samplerInfo.mipmapMode            = vk::SamplerMipmapMode::eNearest;
+  samplerInfo.addressModeU          = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV          = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW          = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.maxLod                = 0.0f;
+
+  try
+  {
+    m_vkSampler = m_device.getDevice().createSamplerUnique(samplerInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать сэмплер постобработки: " + std::string(e.what()));
+  }
+}
+
+void VulkanPostProcess::createGraph()
+{
+  vk::QueueFlags queueFlags = m_device.hasAsyncCompute()
+                                  ? vk::QueueFlags(vk::QueueFlagBits::eCompute)
+                                  : vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+  m_graph = std::make_unique<VulkanRenderGraph>(m_device, queueFlags);
+
+  // Сцену графика оставляет в layout для чтения, результат всегда живёт в General.
+  // Доступность обоих обеспечивает ожидание семафора при отправке
+  m_sceneResource  = m_graph->importImage("scene", vk::ImageAspectFlagBits::eColor,
+                                          vk::PipelineStageFlagBits2::eNone,
+                                          RenderGraphAccess::SampledRead,
+                                          vk::ImageLayout::eShaderReadOnlyOptimal);
+  m_outputResource = m_graph->importImage("output", vk::ImageAspectFlagBits::eColor,
+                                          vk::PipelineStageFlagBits2::eNone,
+                                          RenderGraphAccess::StorageWrite,
+                                          vk::ImageLayout::eGeneral);
+
+  // Промежуточные изображения: граф размещает непересекающиеся по времени в одной памяти
+  RenderGraphImageDesc bloomDesc = {};
+  bloomDesc.format               = BLOOM_FORMAT;
+  bloomDesc.extent               = m_bloomExtent;
+  bloomDesc.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+  m_bloomA        = m_graph->createImage("bloomA", bloomDesc);
+  m_bloomB        = m_graph->createImage("bloomB", bloomDesc);
+
+  RenderGraphImageDesc toneDesc = {};
+  toneDesc.format               = OUTPUT_FORMAT;
+  toneDesc.extent               = m_extent;
+  toneDesc.usage                = vk::ImageUsageFlagBits::eStorage;
+  m_toneResource                = m_graph->createImage("tonemapped", toneDesc);
+
+  uint32_t extractPass = m_graph->addPass(
+      "bloomExtract",
+      [this](vk::CommandBuffer commandBuffer)
+      {
+        dispatchPass(commandBuffer, *m_extractPipeline, m_slots[m_currentSlot].extractSet,
+                     m_bloomExtent);
+      });
+  m_graph->use(extractPass, m_sceneResource, RenderGraphAccess::SampledRead);
+  m_graph->use(extractPass, m_bloomA, RenderGraphAccess::StorageWrite);
+
+  uint32_t blurHorizontalPass = m_graph->addPass(
+      "blurHorizontal",
+      [this](vk::CommandBuffer commandBuffer)
+      { dispatchPass(commandBuffer, *m_blurPipeline, m_blurHorizontalSet, m_bloomExtent, 1, 0); });
+  m_graph->use(blurHorizontalPass, m_bloomA, RenderGraphAccess::SampledRead);
+  m_graph->use(blurHorizontalPass, m_bloomB, RenderGraphAccess::StorageWrite);
+
+  uint32_t blurVerticalPass = m_graph->addPass(
+      "blurVertical",
+      [this](vk::CommandBuffer commandBuffer)
+      { dispatchPass(commandBuffer, *m_blurPipeline, m_blurVerticalSet, m_bloomExtent, 0, 1); });
+  m_graph->use(blurVerticalPass, m_bloomB, RenderGraphAccess::SampledRead);
+  m_graph->use(blurVerticalPass, m_bloomA, RenderGraphAccess::StorageWrite);
+
+  uint32_t tonemapPass = m_graph->addPass(
+      "tonemap",
+      [this](vk::CommandBuffer commandBuffer)
+      {
+        dispatchPass(commandBuffer, *m_tonemapPipeline, m_slots[m_currentSlot].tonemapSet,
+                     m_extent);
+      });
+  m_graph->use(tonemapPass, m_sceneResource, RenderGraphAccess::SampledRead);
+  m_graph->use(tonemapPass, m_bloomA, RenderGraphAccess::SampledRead);
+  m_graph->use(tonemapPass, m_toneResource, RenderGraphAccess::StorageWrite);
+
+  uint32_t sharpenPass = m_graph->addPass(
+      "sharpen",
+      [this](vk::CommandBuffer commandBuffer)
+      {
+        dispatchPass(commandBuffer, *m_sharpenPipeline, m_slots[m_currentSlot].sharpenSet,
+                     m_extent);
+      });
+  m_graph->use(sharpenPass, m_toneResource, RenderGraphAccess::StorageRead);
+  m_graph->use(sharpenPass, m_outputResource, RenderGraphAccess::StorageWrite);
+
+  m_graph->compile();
+}
+
+void VulkanPostProcess::createDescriptorSets()
+{
+  // Промежуточные изображения созданы при компиляции графа и не меняются
+  vk::ImageView bloomA = m_graph->getImageView(m_bloomA);
+  vk::ImageView bloomB = m_graph->getImageView(m_bloomB);
+  vk::ImageView tone   = m_graph->getImageView(m_toneResource);
+
+  m_blurHorizontalSet = m_blurPipeline->allocateDescriptorSet();
+  m_blurPipeline->writeSampledImage(m_blurHorizontalSet, 0, bloomA, *m_vkSampler);
+  m_blurPipeline->writeStorageImage(m_blurHorizontalSet, 1, bloomB);
+
+  m_blurVerticalSet = m_blurPipeline->allocateDescriptorSet();
+  m_blurPipeline->writeSampledImage(m_blurVerticalSet, 0, bloomB, *m_vkSampler);
+  m_blurPipeline->writeStorageImage(m_blurVerticalSet, 1, bloomA);
+
+  for (auto& slot : m_slots)
+  {
+    slot.extractSet = m_extractPipeline->allocateDescriptorSet();
+    m_extractPipeline->writeSampledImage(slot.extractSet, 0, *slot.sceneView, *m_vkSampler);
+    m_extractPipeline->writeStorageImage(slot.extractSet, 1, bloomA);
+
+    slot.tonemapSet = m_tonemapPipeline->allocateDescriptorSet();
+    m_tonemapPipeline->writeSampledImage(slot.tonemapSet, 0, *slot.sceneView, *m_vkSampler);
+    m_tonemapPipeline->writeSampledImage(slot.tonemapSet, 1, bloomA, *m_vkSampler);
+    m_tonemapPipeline->writeStorageImage(slot.tonemapSet, 2, tone);
+
+    slot.sharpenSet = m_sharpenPipeline->allocateDescriptorSet();
+    m_sharpenPipeline->writeStorageImage(slot.sharpenSet, 0, tone);
+    m_sharpenPipeline->writeStorageImage(slot.sharpenSet, 1, *slot.outputView);
+  }
+}
+
+void VulkanPostProcess::createCommandObjects()
+{
+  vk::Device device = m_device.getDevice();
+
+  vk::CommandPoolCreateInfo poolInfo = {};
+  poolInfo.queueFamilyIndex          = m_device.getComputeFamily();
+  poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+
+  vk::SemaphoreTypeCreateInfo timelineTypeInfo = {};
+  timelineTypeInfo.semaphoreType               = vk::SemaphoreType::eTimeline;
+  timelineTypeInfo.initialValue                = 0;
+
+  vk::SemaphoreCreateInfo timelineInfo = {};
+  timelineInfo.pNext                   = &timelineTypeInfo;
+
+  try
+  {
+    m_vkCommandPool = device.createCommandPoolUnique(poolInfo);
+
+    vk::CommandBufferAllocateInfo allocInfo = {};
+    allocInfo.commandPool                   = *m_vkCommandPool;
+    allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount            = m_framesInFlight;
+
+    auto commandBuffers = device.allocateCommandBuffersUnique(allocInfo);
+    for (uint32_t i = 0; i < m_framesInFlight; i++)
+    {
+      m_slots[i].commandBuffer = std::move(commandBuffers[i]);
+    }
+
+    m_vkTimeline = device.createSemaphoreUnique(timelineInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать объекты отправки постобработки: " +
+                             std::string(e.what()));
+  }
+}
+
+void VulkanPostProcess::transitionOutputs()
+{
+  // Результат всегда находится в General между кадрами: граф графики переводит его
+  // в источник blit и обратно, граф постобработки пишет без переходов
+  vk::CommandBuffer commandBuffer = *m_slots[0].commandBuffer;
+
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  commandBuffer.begin(beginInfo);
+
+  std::vector<vk::ImageMemoryBarrier2> barriers;
+  for (const auto& slot : m_slots)
+  {
+    vk::ImageMemoryBarrier2 barrier = {};
+    barrier.srcStageMask            = vk::PipelineStageFlagBits2::eNone;
+    barrier.dstStageMask            = vk::PipelineStageFlagBits2::eComputeShader;
+    barrier.dstAccessMask           = vk::AccessFlagBits2::eShaderStorageWrite;
+    barrier.oldLayout               = vk::ImageLayout::eUndefined;
+    barrier.newLayout               = vk::ImageLayout::eGeneral;
+    barrier.srcQueueFamilyIndex     = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex     = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                   = *slot.outputImage;
+    barrier.subresourceRange =
+        vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+    barriers.push_back(barrier);
+  }
+
+  vk::DependencyInfo dependencyInfo      = {};
+  dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+  dependencyInfo.pImageMemoryBarriers    = barriers.data();
+  commandBuffer.pipelineBarrier2(dependencyInfo);
+  commandBuffer.end();
+
+  vk::CommandBufferSubmitInfo commandBufferInfo = {};
+  commandBufferInfo.commandBuffer               = commandBuffer;
+
+  vk::SubmitInfo2 submitInfo        = {};
+  submitInfo.commandBufferInfoCount = 1;
+  submitInfo.pCommandBufferInfos    = &commandBufferInfo;
+
+  m_device.getComputeQueue().submit2(submitInfo);
+  m_device.getComputeQueue().waitIdle();
+}
+
+void VulkanPostProcess::dispatchPass(vk::CommandBuffer            commandBuffer,
+                                     const VulkanComputePipeline& pipeline,
+                                     vk::DescriptorSet set, vk::Extent2D extent,
+                                     int32_t directionX, int32_t directionY)
+{
+  PostProcessParams params = m_params;
+  params.width             = extent.width;
+  params.height            = extent.height;
+  params.directionX        = directionX;
+  params.directionY        = directionY;
+
+  pipeline.bind(commandBuffer, set);
+  pipeline.pushConstants(commandBuffer, params);
+  pipeline.dispatch(commandBuffer, VulkanComputePipeline::groupCount(extent.width, LOCAL_SIZE),
+                    VulkanComputePipeline::groupCount(extent.height, LOCAL_SIZE));
+}
+
+void VulkanPostProcess::submit(uint32_t frameSlot, uint64_t frameNumber,
+                               vk::Semaphore graphicsTimeline)
+{
+  FrameSlot& slot = m_slots[frameSlot];
+
+  // Запись цепочки: слот свободен, так как вызывающий дождался кадра frameNumber - N
+  m_currentSlot = frameSlot;
+  m_graph->setImportedImage(m_sceneResource, *slot.sceneImage, *slot.sceneView);
+  m_graph->setImportedImage(m_outputResource, *slot.outputImage, *slot.outputView);
+
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+  try
+  {
+    slot.commandBuffer->reset();
+    slot.commandBuffer->begin(beginInfo);
+    m_graph->execute(*slot.commandBuffer);
+    slot.commandBuffer->end();
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось записать постобработку: " + std::string(e.what()));
+  }
+
+  // Сцена кадра готова, когда графика сигналит его номер
+  vk::SemaphoreSubmitInfo waitInfo = {};
+  waitInfo.semaphore               = graphicsTimeline;
+  waitInfo.value                   = frameNumber;
+  waitInfo.stageMask               = vk::PipelineStageFlagBits2::eComputeShader;
+
+  vk::SemaphoreSubmitInfo signalInfo = {};
+  signalInfo.semaphore               = *m_vkTimeline;
+  signalInfo.value                   = frameNumber;
+  signalInfo.stageMask               = vk::PipelineStageFlagBits2::eComputeShader;
+
+  vk::CommandBufferSubmitInfo commandBufferInfo = {};
+  commandBufferInfo.commandBuffer               = *slot.commandBuffer;
+
+  vk::SubmitInfo2 submitInfo          = {};
+  submitInfo.waitSemaphoreInfoCount   = 1;
+  submitInfo.pWaitSemaphoreInfos      = &waitInfo;
+  submitInfo.commandBufferInfoCount   = 1;
+  submitInfo.pCommandBufferInfos      = &commandBufferInfo;
+  submitInfo.signalSemaphoreInfoCount = 1;
+  submitInfo.pSignalSemaphoreInfos    = &signalInfo;
+
+  try
+  {
+    m_device.getComputeQueue().submit2(submitInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось отправить постобработку: " + std::string(e.what()));
+  }
+}
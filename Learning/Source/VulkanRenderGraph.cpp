@@ -0,0 +1,648 @@
+#include "VulkanRenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+  // Состояние ресурса при планировании барьеров
+  struct TrackedState
+  {
+    vk::ImageLayout         layout      = vk::ImageLayout::eUndefined;
+    vk::PipelineStageFlags2 writeStage  = vk::PipelineStageFlagBits2::eNone;
+    vk::AccessFlags2        writeAccess = vk::AccessFlagBits2::eNone;
+    vk::PipelineStageFlags2 readStages  = vk::PipelineStageFlagBits2::eNone;
+  };
+}  // namespace
+
+VulkanRenderGraph::VulkanRenderGraph(VulkanDevice& device, vk::QueueFlags queueFlags)
+    : m_device(device)
+{
+  using Stage = vk::PipelineStageFlagBits2;
+
+  // Очередь без графики выполняет только вычисления и копирование
+  m_supportedStages = (queueFlags & vk::QueueFlagBits::eGraphics)
+                          ? vk::PipelineStageFlags2(~VkPipelineStageFlags2(0))
+                          : Stage::eTopOfPipe | Stage::eBottomOfPipe | Stage::eDrawIndirect |
+                                Stage::eComputeShader | Stage::eAllTransfer | Stage::eAllCommands |
+                                Stage::eHost;
+}
+
+VulkanRenderGraph::~VulkanRenderGraph()
+{
+  // Изображения уничтожаются раньше памяти, к которой они привязаны
+  for (auto& resource : m_resources)
+  {
+    resource.ownedView.reset();
+    resource.ownedImage.reset();
+  }
+  m_memoryBlocks.clear();
+}
+
+RenderGraphResource VulkanRenderGraph::importImage(const std::string& name,
+                                                   vk::ImageAspectFlags    aspect,
+                                                   vk::PipelineStageFlags2 initialStage,
+                                                   RenderGraphAccess       finalAccess,
+                                                   vk::ImageLayout         initialLayout)
+{
+  Resource resource;
+  resource.name          = name;
+  resource.imported      = true;
+  resource.desc.aspect   = aspect;
+  resource.initialStage  = initialStage;
+  resource.initialLayout = initialLayout;
+  resource.hasFinal      = true;
+  resource.finalAccess   = finalAccess;
+  resource.isOutput      = true;
+
+  m_resources.push_back(std::move(resource));
+  return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphResource VulkanRenderGraph::importBuffer(const std::string&      name,
+                                                    vk::PipelineStageFlags2 initialStage)
+{
+  Resource resource;
+  resource.name         = name;
+  resource.isBuffer     = true;
+  resource.imported     = true;
+  resource.initialStage = initialStage;
+
+  m_resources.push_back(std::move(resource));
+  return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphResource VulkanRenderGraph::createImage(const std::string&          name,
+                                                   const RenderGraphImageDesc& desc)
+{
+  Resource resource;
+  resource.name = name;
+  resource.desc = desc;
+
+  m_resources.push_back(std::move(resource));
+  return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+uint32_t VulkanRenderGraph::addPass(const std::string& name, ExecuteFn execute)
+{
+  Pass pass;
+  pass.name    = name;
+  pass.execute = std::move(execute);
+
+  m_passes.push_back(std::move(pass));
+  return static_cast<uint32_t>(m_passes.size() - 1);
+}
+
+void VulkanRenderGraph::use(uint32_t pass, RenderGraphResource resource, RenderGraphAccess access)
+{
+  m_passes.at(pass).uses.emplace_back(resource, access);
+}
+
+void VulkanRenderGraph::markOutput(RenderGraphResource resource)
+{
+  m_resources.at(resource).isOutput = true;
+}
+
+void VulkanRenderGraph::compile()
+{
+  cullPasses();
+  computeLifetimes();
+  allocateTransients();
+  planBarriers();
+
+  m_compiled = true;
+  size_t lazyBlocks = std::count_if(m_memoryBlocks.begin(), m_memoryBlocks.end(),
+                                    [](const MemoryBlock& block) { return block.lazy; });
+  std::cout << "Граф кадра скомпилирован: проходов " << m_passes.size() - m_culledPassCount
+            << ", отброшено " << m_culledPassCount << ", память временных ресурсов "
+            << (m_transientMemorySize >> 10) << " КБ в " << m_memoryBlocks.size()
+            << " блоках (лениво выделяемых: " << lazyBlocks << ")" << std::endl;
+}
+
+void VulkanRenderGraph::cullPasses()
+{
+  // Проход нужен, если пишет в результат кадра или в ресурс, который читает нужный проход
+  std::vector<bool> needed(m_resources.size(), false);
+  for (size_t i = 0; i < m_resources.size(); i++)
+  {
+    needed[i] = m_resources[i].isOutput;
+  }
+
+  m_culledPassCount = 0;
+  for (size_t i = m_passes.size(); i-- > 0;)
+  {
+    Pass& pass  = m_passes[i];
+    pass.culled = true;
+    for (const auto& [resource, access] : pass.uses)
+    {
+      if (getAccessInfo(access).isWrite && needed[resource])
+      {
+        pass.culled = false;
+        break;
+      }
+    }
+
+    if (pass.culled)
+    {
+      m_culledPassCount++;
+      continue;
+    }
+
+    for (const auto& [resource, access] : pass.uses)
+    {
+      needed[resource] = true;
+    }
+  }
+}
+
+void VulkanRenderGraph::computeLifetimes()
+{
+  for (auto& resource : m_resources)
+  {
+    resource.firstPass = -1;
+    resource.lastPass  = -1;
+  }
+
+  for (size_t i = 0; i < m_passes.size(); i++)
+  {
+    if (m_passes[i].culled)
+    {
+      continue;
+    }
+
+    for (const auto& use : m_passes[i].uses)
+    {
+      Resource& resource = m_resources[use.first];
+      if (resource.firstPass < 0)
+      {
+        resource.firstPass = static_cast<int32_t>(i);
+      }
+      resource.lastPass = static_cast<int32_t>(i);
+    }
+  }
+}
+
+void VulkanRenderGraph::allocateTransients()
+{
+  vk::Device device = m_device.getDevice();
+
+  // Создание изображений для временных ресурсов, используемых оставшимися проходами
+  std::vector<uint32_t>               transients;
+  std::vector<vk::MemoryRequirements> requirements(m_resources.size());
+  for (uint32_t i = 0; i < m_resources.size(); i++)
+  {
+    Resource& resource = m_resources[i];
+    if (resource.imported || resource.firstPass < 0)
+    {
+      continue;
+    }
+
+    vk::ImageCreateInfo imageInfo = {};
+    imageInfo.imageType           = vk::ImageType::e2D;
+    imageInfo.format              = resource.desc.format;
+    imageInfo.extent = vk::Extent3D{resource.desc.extent.width, resource.desc.extent.height, 1};
+    imageInfo.mipLevels     = 1;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.samples       = resource.desc.samples;
+    imageInfo.tiling        = vk::ImageTiling::eOptimal;
+    imageInfo.usage         = resource.desc.usage;
+    imageInfo.sharingMode   = vk::SharingMode::eExclusive;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+
+    try
+    {
+      resource.ownedImage = device.createImageUnique(imageInfo);
+    }
+    catch (const vk::SystemError& e)
+    {
+      throw std::runtime_error("Не удалось создать изображение графа '" + resource.name +
+                               "': " + std::string(e.what()));
+    }
+
+    resource.image  = *resource.ownedImage;
+    requirements[i] = device.getImageMemoryRequirements(resource.image);
+    transients.push_back(i);
+  }
+
+  // Жадное распределение: крупные ресурсы первыми, в первый блок без пересечения времён жизни
+  std::sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b)
+            { return requirements[a].size > requirements[b].size; });
+
+  m_memoryBlocks.clear();
+  for (uint32_t index : transients)
+  {
+    Resource&                     resource = m_resources[index];
+    const vk::MemoryRequirements& req      = requirements[index];
+
+    int32_t blockIndex = -1;
+    for (size_t b = 0; b < m_memoryBlocks.size() && blockIndex < 0; b++)
+    {
+      MemoryBlock& block = m_memoryBlocks[b];
+      if (!(block.typeBits & req.memoryTypeBits))
+      {
+        continue;
+      }
+
+      bool overlaps = false;
+      for (uint32_t other : block.resources)
+      {
+        const Resource& o = m_resources[other];
+        if (resource.firstPass <= o.lastPass && o.firstPass <= resource.lastPass)
+        {
+          overlaps = true;
+          break;
+        }
+      }
+
+      if (!overlaps)
+      {
+        blockIndex = static_cast<int32_t>(b);
+      }
+    }
+
+    if (blockIndex < 0)
+    {
+      m_memoryBlocks.emplace_back();
+      blockIndex = static_cast<int32_t>(m_memoryBlocks.size() - 1);
+    }
+
+    MemoryBlock& block = m_memoryBlocks[blockIndex];
+    block.size         = std::max(block.size, req.size);
+    block.typeBits &= req.memoryTypeBits;
+    block.resources.push_back(index);
+    resource.memoryBlock = blockIndex;
+  }
+
+  // Выделение блоков и привязка изображений (все со смещением 0)
+  m_transientMemorySize = 0;
+  for (auto& block : m_memoryBlocks)
+  {
+    // Блок, в котором живут только transient-вложения, может получить лениво
+    // выделяемую память: на тайловых GPU она вообще не занимает VRAM
+    bool allTransient = true;
+    for (uint32_t index : block.resources)
+    {
+      allTransient = allTransient && (m_resources[index].desc.usage &
+                                      vk::ImageUsageFlagBits::eTransientAttachment);
+    }
+
+    vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+    if (allTransient &&
+        m_device.hasMemoryType(block.typeBits, properties |
+                                                   vk::MemoryPropertyFlagBits::eLazilyAllocated))
+    {
+      properties |= vk::MemoryPropertyFlagBits::eLazilyAllocated;
+      block.lazy = true;
+    }
+
+    vk::MemoryAllocateInfo allocInfo = {};
+    allocInfo.allocationSize         = block.size;
+    allocInfo.memoryTypeIndex        = m_device.findMemoryType(block.typeBits, properties);
+
+    try
+    {
+      block.memory = m_device.allocateMemory(allocInfo, MemoryCategory::Image);
+    }
+    catch (const vk::SystemError& e)
+    {
+      throw std::runtime_error("Не удалось выделить память графа: " + std::string(e.what()));
+    }
+    if (!block.lazy)
+    {
+      m_transientMemorySize += block.size;
+    }
+
+    for (uint32_t index : block.resources)
+    {
+      Resource& resource = m_resources[index];
+      device.bindImageMemory(resource.image, *block.memory, 0);
+
+      vk::ImageViewCreateInfo viewInfo = {};
+      viewInfo.image                   = resource.image;
+      viewInfo.viewType                = vk::ImageViewType::e2D;
+      viewInfo.format                  = resource.desc.format;
+      viewInfo.subresourceRange        = vk::ImageSubresourceRange(resource.desc.aspect, 0, 1, 0, 1);
+
+      resource.ownedView = device.createImageViewUnique(viewInfo);
+      resource.view      = *resource.ownedView;
+    }
+  }
+}
+
+void VulkanRenderGraph::planBarriers()
+{
+  m_passBarriers.assign(m_passes.size(), {});
+  m_finalBarriers.clear();
+
+  // Применение одного использования к состоянию; возвращает true, если нужен барьер
+  auto applyAccess = [](TrackedState& state, const AccessInfo& info, bool isBuffer,
+                        PlannedBarrier& barrier)
+  {
+    bool needLayout = !isBuffer && state.layout != info.layout;
+    bool needed     = false;
+
+    barrier.srcStage  = state.writeStage | state.readStages;
+    barrier.srcAccess = state.writeAccess;
+    barrier.dstStage  = info.stage;
+    barrier.dstAccess = info.access;
+    barrier.oldLayout = state.layout;
+    barrier.newLayout = isBuffer ? state.layout : info.layout;
+
+    if (info.isWrite)
+    {
+      // Запись ждёт все предыдущие чтения и записи
+      needed            = needLayout || state.writeStage || state.readStages;
+      state.writeStage  = info.stage;
+      state.writeAccess = info.access;
+      state.readStages  = vk::PipelineStageFlagBits2::eNone;
+    }
+    else if (needLayout)
+    {
+      // Переход layout сам является записью - дальнейшие чтения ждут его
+      needed            = true;
+      state.writeStage  = info.stage;
+      state.writeAccess = vk::AccessFlagBits2::eNone;
+      state.readStages  = info.stage;
+    }
+    else if ((info.stage & ~state.readStages) && state.writeStage)
+    {
+      // Чтение на новой стадии: достаточно сделать видимой последнюю запись
+      needed            = true;
+      barrier.srcStage  = state.writeStage;
+      state.readStages |= info.stage;
+    }
+    else
+    {
+      state.readStages |= info.stage;
+    }
+
+    if (!isBuffer)
+    {
+      state.layout = info.layout;
+    }
+    return needed;
+  };
+
+  // Начальное состояние импортированных изображений задано явно
+  auto initialState = [this](const Resource& resource)
+  {
+    TrackedState state;
+    if (resource.imported)
+    {
+      state.layout     = resource.initialLayout;
+      state.writeStage = resource.initialStage;
+    }
+    return state;
+  };
+
+  // Пробный проход: состояние каждого ресурса в конце кадра. Буферы и временные
+  // изображения разделяются с соседними кадрами в обработке, поэтому их первое
+  // использование должно ждать последнего использования в предыдущем кадре
+  std::vector<TrackedState> states(m_resources.size());
+  for (size_t i = 0; i < m_resources.size(); i++)
+  {
+    states[i] = initialState(m_resources[i]);
+  }
+  for (const auto& pass : m_passes)
+  {
+    if (pass.culled)
+    {
+      continue;
+    }
+    for (const auto& [resource, access] : pass.uses)
+    {
+      PlannedBarrier unused;
+      applyAccess(states[resource], getQueueAccessInfo(access), m_resources[resource].isBuffer,
+                  unused);
+    }
+  }
+
+  std::vector<TrackedState> endStates = states;
+  for (size_t i = 0; i < m_resources.size(); i++)
+  {
+    const Resource& resource = m_resources[i];
+    states[i]                = initialState(resource);
+
+    if (resource.isBuffer)
+    {
+      states[i]        = endStates[i];
+      states[i].layout = vk::ImageLayout::eUndefined;
+    }
+    else if (!resource.imported && resource.memoryBlock >= 0)
+    {
+      // Последний владелец блока памяти в кадре
+      const MemoryBlock& block = m_memoryBlocks[resource.memoryBlock];
+      uint32_t           last  = *std::max_element(block.resources.begin(), block.resources.end(),
+                                                   [this](uint32_t a, uint32_t b)
+                                                   { return m_resources[a].lastPass <
+                                                            m_resources[b].lastPass; });
+      states[i]        = endStates[last];
+      states[i].layout = vk::ImageLayout::eUndefined;
+    }
+  }
+
+  // Передача блока памяти внутри кадра: новый владелец ждёт прежнего
+  std::vector<int32_t> blockOwner(m_memoryBlocks.size(), -1);
+
+  for (size_t p = 0; p < m_passes.size(); p++)
+  {
+    if (m_passes[p].culled)
+    {
+      continue;
+    }
+
+    for (const auto& [resourceIndex, access] : m_passes[p].uses)
+    {
+      Resource& resource = m_resources[resourceIndex];
+      if (!resource.imported && resource.memoryBlock >= 0 &&
+          resource.firstPass == static_cast<int32_t>(p))
+      {
+        int32_t& owner = blockOwner[resource.memoryBlock];
+        if (owner >= 0)
+        {
+          states[resourceIndex]        = states[owner];
+          states[resourceIndex].layout = vk::ImageLayout::eUndefined;
+        }
+        owner = static_cast<int32_t>(resourceIndex);
+      }
+
+      PlannedBarrier barrier;
+      barrier.resource = resourceIndex;
+      if (applyAccess(states[resourceIndex], getQueueAccessInfo(access), resource.isBuffer,
+                      barrier))
+      {
+        m_passBarriers[p].push_back(barrier);
+      }
+    }
+  }
+
+  // Перевод импортированных ресурсов в конечное состояние. Если layout уже нужный,
+  // барьер не ставится: дальнейшую синхронизацию обеспечивает семафор отправки
+  for (uint32_t i = 0; i < m_resources.size(); i++)
+  {
+    const Resource& resource = m_resources[i];
+    AccessInfo      info     = getQueueAccessInfo(resource.finalAccess);
+    if (!resource.hasFinal || states[i].layout == info.layout)
+    {
+      continue;
+    }
+
+    PlannedBarrier barrier;
+    barrier.resource = i;
+    if (applyAccess(states[i], info, resource.isBuffer, barrier))
+    {
+      m_finalBarriers.push_back(barrier);
+    }
+  }
+}
+
+void VulkanRenderGraph::setImportedImage(RenderGraphResource resource, vk::Image image,
+                                         vk::ImageView view)
+{
+  m_resources[resource].image = image;
+  m_resources[resource].view  = view;
+}
+
+void VulkanRenderGraph::setImportedBuffer(RenderGraphResource resource, vk::Buffer buffer)
+{
+  m_resources[resource].buffer = buffer;
+}
+
+void VulkanRenderGraph::execute(vk::CommandBuffer commandBuffer)
+{
+  if (!m_compiled)
+  {
+    throw std::runtime_error("Граф кадра не скомпилирован");
+  }
+
+  for (size_t i = 0; i < m_passes.size(); i++)
+  {
+    if (m_passes[i].culled)
+    {
+      continue;
+    }
+
+    recordBarriers(commandBuffer, m_passBarriers[i]);
+    m_passes[i].execute(commandBuffer);
+  }
+
+  recordBarriers(commandBuffer, m_finalBarriers);
+}
+
+void VulkanRenderGraph::recordBarriers(vk::CommandBuffer                  commandBuffer,
+                                       const std::vector<PlannedBarrier>& barriers)
+{
+  if (barriers.empty())
+  {
+    return;
+  }
+
+  m_imageBarriers.clear();
+  m_bufferBarriers.clear();
+
+  for (const auto& planned : barriers)
+  {
+    const Resource& resource = m_resources[planned.resource];
+    if (resource.isBuffer)
+    {
+      vk::BufferMemoryBarrier2 barrier = {};
+      barrier.srcStageMask             = planned.srcStage;
+      barrier.srcAccessMask            = planned.srcAccess;
+      barrier.dstStageMask             = planned.dstStage;
+      barrier.dstAccessMask            = planned.dstAccess;
+      barrier.srcQueueFamilyIndex      = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex      = VK_QUEUE_FAMILY_IGNORED;
+      barrier.buffer                   = resource.buffer;
+      barrier.offset                   = 0;
+      barrier.size                     = VK_WHOLE_SIZE;
+      m_bufferBarriers.push_back(barrier);
+    }
+    else
+    {
+      vk::ImageMemoryBarrier2 barrier = {};
+      barrier.srcStageMask            = planned.srcStage;
+      barrier.srcAccessMask           = planned.srcAccess;
+      barrier.dstStageMask            = planned.dstStage;
+      barrier.dstAccessMask           = planned.dstAccess;
+      barrier.oldLayout               = planned.oldLayout;
+      barrier.newLayout               = planned.newLayout;
+      barrier.srcQueueFamilyIndex     = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex     = VK_QUEUE_FAMILY_IGNORED;
+      barrier.image                   = resource.image;
+      barrier.subresourceRange        = vk::ImageSubresourceRange(
+          resource.desc.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+      m_imageBarriers.push_back(barrier);
+    }
+  }
+
+  vk::DependencyInfo dependencyInfo       = {};
+  dependencyInfo.imageMemoryBarrierCount  = static_cast<uint32_t>(m_imageBarriers.size());
+  dependencyInfo.pImageMemoryBarriers     = m_imageBarriers.data();
+  dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_bufferBarriers.size());
+  dependencyInfo.pBufferMemoryBarriers    = m_bufferBarriers.data();
+
+  commandBuffer.pipelineBarrier2(dependencyInfo);
+}
+
+vk::Image VulkanRenderGraph::getImage(RenderGraphResource resource) const
+{
+  return m_resources.at(resource).image;
+}
+
+vk::ImageView VulkanRenderGraph::getImageView(RenderGraphResource resource) const
+{
+  return m_resources.at(resource).view;
+}
+
+vk::Buffer VulkanRenderGraph::getBuffer(RenderGraphResource resource) const
+{
+  return m_resources.at(resource).buffer;
+}
+
+VulkanRenderGraph::AccessInfo VulkanRenderGraph::getQueueAccessInfo(
+    RenderGraphAccess access) const
+{
+  AccessInfo info = getAccessInfo(access);
+  info.stage &= m_supportedStages;
+  return info;
+}
+
+VulkanRenderGraph::AccessInfo VulkanRenderGraph::getAccessInfo(RenderGraphAccess access)
+{
+  using Stage  = vk::PipelineStageFlagBits2;
+  using Access = vk::AccessFlagBits2;
+  using Layout = vk::ImageLayout;
+
+  switch (access)
+  {
+    case RenderGraphAccess::ColorAttachmentWrite:
+      return {Stage::eColorAttachmentOutput,
+              Access::eColorAttachmentRead | Access::eColorAttachmentWrite,
+              Layout::eColorAttachmentOptimal, true};
+    case RenderGraphAccess::DepthAttachmentWrite:
+      return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+              Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite,
+              Layout::eDepthStencilAttachmentOptimal, true};
+    case RenderGraphAccess::SampledRead:
+      return {Stage::eFragmentShader | Stage::eComputeShader, Access::eShaderSampledRead,
+              Layout::eShaderReadOnlyOptimal, false};
+    case RenderGraphAccess::StorageRead:
+      return {Stage::eComputeShader, Access::eShaderStorageRead, Layout::eGeneral, false};
+    case RenderGraphAccess::StorageWrite:
+      return {Stage::eComputeShader, Access::eShaderStorageRead | Access::eShaderStorageWrite,
+              Layout::eGeneral, true};
+    case RenderGraphAccess::TransferRead:
+      return {Stage::eAllTransfer, Access::eTransferRead, Layout::eTransferSrcOptimal, false};
+    case RenderGraphAccess::TransferWrite:
+      return {Stage::eAllTransfer, Access::eTransferWrite, Layout::eTransferDstOptimal, true};
+    case RenderGraphAccess::VertexBufferRead:
+      return {Stage::eVertexAttributeInput, Access::eVertexAttributeRead, Layout::eUndefined,
+              false};
+    case RenderGraphAccess::Present:
+      return {Stage::eBottomOfPipe, Access::eNone, Layout::ePresentSrcKHR, false};
+  }
+
+  throw std::runtime_error("Неизвестный тип доступа к ресурсу графа");
+}
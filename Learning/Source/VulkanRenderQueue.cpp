@@ -0,0 +1,104 @@
+#include "VulkanRenderQueue.h"
+
+#include <cstring>
+
+VulkanRenderQueue::VulkanRenderQueue(ThreadPool* pool) : m_pool(pool) {}
+
+void VulkanRenderQueue::clear()
+{
+  m_packets.clear();
+  m_entries.clear();
+}
+
+void VulkanRenderQueue::reserve(size_t packetCount)
+{
+  m_packets.reserve(packetCount);
+  m_entries.reserve(packetCount);
+  m_scratch.reserve(packetCount);
+}
+
+void VulkanRenderQueue::push(const DrawPacket& packet)
+{
+  m_entries.push_back({packet.key, static_cast<uint32_t>(m_packets.size())});
+  m_packets.push_back(packet);
+}
+
+void VulkanRenderQueue::sort()
+{
+  // Сортируются только ключи с индексами, сами пакеты не перемещаются
+  RadixSort::sort(m_entries, m_scratch, m_pool);
+}
+
+RenderQueueStats VulkanRenderQueue::execute(vk::CommandBuffer commandBuffer) const
+{
+  RenderQueueStats stats;
+
+  // Последнее привязанное состояние
+  vk::Pipeline      boundPipeline;
+  vk::DescriptorSet boundDescriptorSet;
+  uint32_t          boundOffsetCount = 0;
+  uint32_t          boundOffsets[2]  = {};
+  vk::Buffer        boundVertexBuffer;
+  vk::Buffer        boundIndexBuffer;
+
+  for (const SortEntry& entry : m_entries)
+  {
+    const DrawPacket& packet = m_packets[entry.index];
+
+    if (packet.pipeline != boundPipeline)
+    {
+      commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, packet.pipeline);
+      boundPipeline = packet.pipeline;
+      stats.pipelineBinds++;
+
+      // Смена конвейера может сменить layout - набор привязывается заново
+      boundDescriptorSet = nullptr;
+    }
+
+    if (packet.descriptorSet &&
+        (packet.descriptorSet != boundDescriptorSet ||
+         packet.dynamicOffsetCount != boundOffsetCount ||
+         memcmp(packet.dynamicOffsets, boundOffsets, sizeof(uint32_t) * boundOffsetCount) != 0))
+    {
+      commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, packet.pipelineLayout, 0,
+                                       1, &packet.descriptorSet, packet.dynamicOffsetCount,
+                                       packet.dynamicOffsets);
+      boundDescriptorSet = packet.descriptorSet;
+      boundOffsetCount   = packet.dynamicOffsetCount;
+      memcpy(boundOffsets, packet.dynamicOffsets, sizeof(boundOffsets));
+      stats.descriptorSetBinds++;
+    }
+
+    if (packet.vertexBuffer && packet.vertexBuffer != boundVertexBuffer)
+    {
+      vk::DeviceSize offset = 0;
+      commandBuffer.bindVertexBuffers(0, 1, &packet.vertexBuffer, &offset);
+      boundVertexBuffer = packet.vertexBuffer;
+      stats.vertexBufferBinds++;
+    }
+
+    if (packet.indexBuffer)
+    {
+      if (packet.indexBuffer != boundIndexBuffer)
+      {
+        commandBuffer.bindIndexBuffer(packet.indexBuffer, 0, vk::IndexType::eUint32);
+        boundIndexBuffer = packet.indexBuffer;
+        stats.indexBufferBinds++;
+      }
+      commandBuffer.drawIndexed(packet.count, packet.instanceCount, packet.firstVertex,
+                                packet.vertexOffset, 0);
+    }
+    else
+    {
+      commandBuffer.draw(packet.count, packet.instanceCount, packet.firstVertex, 0);
+    }
+
+    stats.draws++;
+    if (packet.topology == vk::PrimitiveTopology::eTriangleList)
+    {
+      stats.triangles += static_cast<uint64_t>(packet.count / 3) * packet.instanceCount;
+    }
+  }
+
+  return stats;
+}
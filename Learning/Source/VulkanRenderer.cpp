@@ -1,13 +1,19 @@
 #include "VulkanRenderer.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
 
-VulkanRenderer::VulkanRenderer(VulkanDevice& device, VulkanSwapChain& swapChain)
-    : m_device(device), m_swapChain(swapChain)
+VulkanRenderer::VulkanRenderer(VulkanDevice& device, VulkanSwapChain& swapChain,
+                               ThreadPool& threadPool)
+    : m_device(device), m_swapChain(swapChain), m_threadPool(threadPool),
+      m_renderQueue(&threadPool), m_culler(&threadPool), m_lodSelector(&threadPool)
 {
 }
 
@@ -18,17 +24,63 @@ VulkanRenderer::~VulkanRenderer()
 }
 
 int VulkanRenderer::init()
+{
+  if (initDeviceResources() != 0)
+  {
+    return -1;
+  }
+  return initSwapChainResources();
+}
+
+int VulkanRenderer::initDeviceResources()
 {
   try
   {
-    // Последовательная инициализация компонентов рендеринга
-    createRenderPass();
+    createMetrics();
+
+    // Формат сцены и глубины известны без swap chain, размер кадра задаётся
+    // динамическим состоянием, поэтому конвейеры компилируются уже здесь
+    chooseSampleCount();
+    chooseRenderingBackend();
+    if (!m_useDynamicRendering)
+    {
+      createRenderPass();
+    }
+    createUniformBuffer();
+    createCommandTrace();
     createGraphicsPipeline();
-    createFramebuffers();
+    createParticleSystem();
     createCommandPool();
-    createVertexBuffer();  // Добавляем создание буфера вершин
-    createCommandBuffers();
+    createMeshBuffers();
+    createFrameContexts();
     createSyncObjects();
+    createTextureManager();
+    createSpriteBatch();
+    createMemoryTelemetry();
+
+    std::cout << "Ресурсы устройства VulkanRenderer созданы" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanRenderer: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+int VulkanRenderer::initSwapChainResources()
+{
+  try
+  {
+    createPostProcess();
+    createHud();
+    createRenderGraph();
+    if (!m_useDynamicRendering)
+    {
+      createFramebuffers();
+    }
+    createPresentSemaphores();
+    createFrameCapture();
 
     std::cout << "VulkanRenderer инициализирован успешно!" << std::endl;
     return 0;
@@ -45,50 +97,169 @@ void VulkanRenderer::cleanup()
   // Ожидаем завершения всех операций
   m_device.getDevice().waitIdle();
 
+  // Обработчик порога захватывает this и не должен пережить рендерер
+  if (m_memoryPressureHandle != INVALID_MEMORY_THRESHOLD)
+  {
+    m_device.getMemoryTracker().removeThresholdCallback(m_memoryPressureHandle);
+    m_memoryPressureHandle = INVALID_MEMORY_THRESHOLD;
+  }
+
+  // Последний снимок метрик записывается при остановке экспорта
+  if (m_metricsExporter)
+  {
+    m_metricsExporter->stop();
+  }
+
   // Объекты освобождаются автоматически через RAII (vk::Unique*)
 }
 
+void VulkanRenderer::chooseSampleCount()
+{
+  // VKAPI_MSAA переопределяет запрошенное количество семплов (1, 2, 4, 8...)
+  if (const char* msaaEnv = std::getenv("VKAPI_MSAA"))
+  {
+    m_requestedSamples = static_cast<vk::SampleCountFlagBits>(std::strtoul(msaaEnv, nullptr, 10));
+  }
+
+  // Поддерживаемые одновременно для цвета и глубины
+  vk::PhysicalDeviceLimits limits = m_device.getPhysicalDevice().getProperties().limits;
+  vk::SampleCountFlags     supported =
+      limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+
+  // Наибольшее поддерживаемое значение, не превышающее запрошенное
+  m_msaaSamples      = vk::SampleCountFlagBits::e1;
+  uint32_t requested = static_cast<uint32_t>(m_requestedSamples);
+  for (uint32_t count = 64; count > 1; count >>= 1)
+  {
+    auto candidate = static_cast<vk::SampleCountFlagBits>(count);
+    if (count <= requested && (supported & candidate))
+    {
+      m_msaaSamples = candidate;
+      break;
+    }
+  }
+
+  m_depthFormat = findDepthFormat();
+  std::cout << "MSAA: " << static_cast<uint32_t>(m_msaaSamples) << "x (запрошено "
+            << static_cast<uint32_t>(m_requestedSamples) << "x)" << std::endl;
+}
+
+void VulkanRenderer::chooseRenderingBackend()
+{
+  // Dynamic rendering входит в ядро Vulkan 1.3 и включается на каждом устройстве;
+  // VKAPI_RENDER_PASS=1 возвращает путь через VkRenderPass и VkFramebuffer
+  const char* renderPassEnv = std::getenv("VKAPI_RENDER_PASS");
+  m_useDynamicRendering     = !(renderPassEnv && std::strcmp(renderPassEnv, "0") != 0);
+
+  std::cout << "Путь рендеринга: "
+            << (m_useDynamicRendering ? "dynamic rendering" : "render pass + framebuffer")
+            << std::endl;
+}
+
+vk::Format VulkanRenderer::findDepthFormat() const
+{
+  const vk::Format candidates[] = {vk::Format::eD32Sfloat, vk::Format::eD24UnormS8Uint,
+                                   vk::Format::eD16Unorm};
+  for (vk::Format format : candidates)
+  {
+    vk::FormatProperties properties = m_device.getPhysicalDevice().getFormatProperties(format);
+    if (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment)
+    {
+      return format;
+    }
+  }
+
+  throw std::runtime_error("Не удалось найти формат буфера глубины");
+}
+
+void VulkanRenderer::createPostProcess()
+{
+  // Результат постобработки копируется в swap chain через blit
+  vk::FormatProperties swapChainFormatProperties =
+      m_device.getPhysicalDevice().getFormatProperties(m_swapChain.getImageFormat());
+  if (!(swapChainFormatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eBlitDst))
+  {
+    throw std::runtime_error("Формат swap chain не поддерживает blit");
+  }
+
+  m_postProcess = std::make_unique<VulkanPostProcess>(
+      m_device, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT), m_swapChain.getExtent());
+  if (m_postProcess->init() != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать постобработку");
+  }
+}
+
 void VulkanRenderer::createRenderPass()
 {
+  bool msaa = m_msaaSamples != vk::SampleCountFlagBits::e1;
+
+  // Переходы layout и синхронизацию с презентацией выполняет граф кадра, поэтому
+  // вложения входят и выходят из render pass в layout вложения.
+  // С MSAA: многосемпловые цвет и глубина живут только внутри прохода (dontCare),
+  // в HDR-изображение сцены попадает результат resolve
+  std::array<vk::AttachmentDescription, 3> attachments = {};
+
   // Описание цветового вложения
-  vk::AttachmentDescription colorAttachment = {};
-  colorAttachment.format                    = m_swapChain.getImageFormat();
-  colorAttachment.samples                   = vk::SampleCountFlagBits::e1;
-  colorAttachment.loadOp                    = vk::AttachmentLoadOp::eClear;
-  colorAttachment.storeOp                   = vk::AttachmentStoreOp::eStore;
-  colorAttachment.stencilLoadOp             = vk::AttachmentLoadOp::eDontCare;
-  colorAttachment.stencilStoreOp            = vk::AttachmentStoreOp::eDontCare;
-  colorAttachment.initialLayout             = vk::ImageLayout::eUndefined;
-  colorAttachment.finalLayout               = vk::ImageLayout::ePresentSrcKHR;
-
-  // Описание подключения вложения
+  vk::AttachmentDescription& colorAttachment = attachments[0];
+  colorAttachment.format                     = VulkanPostProcess::getSceneFormat();
+  colorAttachment.samples                    = m_msaaSamples;
+  colorAttachment.loadOp                     = vk::AttachmentLoadOp::eClear;
+  colorAttachment.storeOp = msaa ? vk::AttachmentStoreOp::eDontCare : vk::AttachmentStoreOp::eStore;
+  colorAttachment.stencilLoadOp  = vk::AttachmentLoadOp::eDontCare;
+  colorAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+  colorAttachment.initialLayout  = vk::ImageLayout::eColorAttachmentOptimal;
+  colorAttachment.finalLayout    = vk::ImageLayout::eColorAttachmentOptimal;
+
+  // Описание вложения глубины
+  vk::AttachmentDescription& depthAttachment = attachments[1];
+  depthAttachment.format                     = m_depthFormat;
+  depthAttachment.samples                    = m_msaaSamples;
+  depthAttachment.loadOp                     = vk::AttachmentLoadOp::eClear;
+  depthAttachment.storeOp                    = vk::AttachmentStoreOp::eDontCare;
+  depthAttachment.stencilLoadOp              = vk::AttachmentLoadOp::eDontCare;
+  depthAttachment.stencilStoreOp             = vk::AttachmentStoreOp::eDontCare;
+  depthAttachment.initialLayout              = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+  depthAttachment.finalLayout                = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+  // Описание вложения resolve (HDR-изображение сцены)
+  vk::AttachmentDescription& resolveAttachment = attachments[2];
+  resolveAttachment.format                     = VulkanPostProcess::getSceneFormat();
+  resolveAttachment.samples                    = vk::SampleCountFlagBits::e1;
+  resolveAttachment.loadOp                     = vk::AttachmentLoadOp::eDontCare;
+  resolveAttachment.storeOp                    = vk::AttachmentStoreOp::eStore;
+  resolveAttachment.stencilLoadOp              = vk::AttachmentLoadOp::eDontCare;
+  resolveAttachment.stencilStoreOp             = vk::AttachmentStoreOp::eDontCare;
+  resolveAttachment.initialLayout              = vk::ImageLayout::eColorAttachmentOptimal;
+  resolveAttachment.finalLayout                = vk::ImageLayout::eColorAttachmentOptimal;
+
+  // Описание подключения вложений
   vk::AttachmentReference colorAttachmentRef = {};
   colorAttachmentRef.attachment              = 0;
   colorAttachmentRef.layout                  = vk::ImageLayout::eColorAttachmentOptimal;
 
+  vk::AttachmentReference depthAttachmentRef = {};
+  depthAttachmentRef.attachment              = 1;
+  depthAttachmentRef.layout                  = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+  vk::AttachmentReference resolveAttachmentRef = {};
+  resolveAttachmentRef.attachment              = 2;
+  resolveAttachmentRef.layout                  = vk::ImageLayout::eColorAttachmentOptimal;
+
   // Описание подпрохода
-  vk::SubpassDescription subpass = {};
-  subpass.pipelineBindPoint      = vk::PipelineBindPoint::eGraphics;
-  subpass.colorAttachmentCount   = 1;
-  subpass.pColorAttachments      = &colorAttachmentRef;
-
-  // Описание зависимости подпрохода
-  vk::SubpassDependency dependency = {};
-  dependency.srcSubpass            = VK_SUBPASS_EXTERNAL;
-  dependency.dstSubpass            = 0;
-  dependency.srcStageMask          = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-  dependency.srcAccessMask         = vk::AccessFlags();
-  dependency.dstStageMask          = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-  dependency.dstAccessMask         = vk::AccessFlagBits::eColorAttachmentWrite;
+  vk::SubpassDescription subpass  = {};
+  subpass.pipelineBindPoint       = vk::PipelineBindPoint::eGraphics;
+  subpass.colorAttachmentCount    = 1;
+  subpass.pColorAttachments       = &colorAttachmentRef;
+  subpass.pDepthStencilAttachment = &depthAttachmentRef;
+  subpass.pResolveAttachments     = msaa ? &resolveAttachmentRef : nullptr;
 
   // Создание render pass
   vk::RenderPassCreateInfo renderPassInfo = {};
-  renderPassInfo.attachmentCount          = 1;
-  renderPassInfo.pAttachments             = &colorAttachment;
+  renderPassInfo.attachmentCount          = msaa ? 3 : 2;
+  renderPassInfo.pAttachments             = attachments.data();
   renderPassInfo.subpassCount             = 1;
   renderPassInfo.pSubpasses               = &subpass;
-  renderPassInfo.dependencyCount          = 1;
-  renderPassInfo.pDependencies            = &dependency;
 
   try
   {
@@ -104,8 +275,10 @@ void VulkanRenderer::createRenderPass()
 void VulkanRenderer::createGraphicsPipeline()
 {
   // Загрузка байт-кода шейдеров
-  auto vertShaderCode = VulkanUtils::readFile("Learning/Shaders/triangle.vert.spv");
-  auto fragShaderCode = VulkanUtils::readFile("Learning/Shaders/triangle.frag.spv");
+  const char* vertShaderPath = "Learning/Shaders/triangle.vert.spv";
+  const char* fragShaderPath = "Learning/Shaders/triangle.frag.spv";
+  auto        vertShaderCode = VulkanUtils::loadShader(vertShaderPath);
+  auto        fragShaderCode = VulkanUtils::loadShader(fragShaderPath);
 
   // Создание шейдерных модулей
   auto vertShaderModule = createShaderModule(vertShaderCode);
@@ -140,24 +313,17 @@ void VulkanRenderer::createGraphicsPipeline()
   inputAssembly.topology                                 = vk::PrimitiveTopology::eTriangleList;
   inputAssembly.primitiveRestartEnable                   = VK_FALSE;
 
-  // Настройка вьюпорта и ножниц
-  vk::Viewport viewport = {};
-  viewport.x            = 0.0f;
-  viewport.y            = 0.0f;
-  viewport.width        = static_cast<float>(m_swapChain.getExtent().width);
-  viewport.height       = static_cast<float>(m_swapChain.getExtent().height);
-  viewport.minDepth     = 0.0f;
-  viewport.maxDepth     = 1.0f;
-
-  vk::Rect2D scissor = {};
-  scissor.offset     = vk::Offset2D{0, 0};
-  scissor.extent     = m_swapChain.getExtent();
-
+  // Вьюпорт и ножницы задаются при записи кадра: конвейер не зависит от размера
+  // swap chain и компилируется параллельно с её созданием
   vk::PipelineViewportStateCreateInfo viewportState = {};
   viewportState.viewportCount                       = 1;
-  viewportState.pViewports                          = &viewport;
   viewportState.scissorCount                        = 1;
-  viewportState.pScissors                           = &scissor;
+
+  vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                        vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+  dynamicState.dynamicStateCount                     = 2;
+  dynamicState.pDynamicStates                        = dynamicStates;
 
   // Настройка растеризатора
   vk::PipelineRasterizationStateCreateInfo rasterizer = {};
@@ -169,10 +335,18 @@ void VulkanRenderer::createGraphicsPipeline()
   rasterizer.frontFace       = vk::FrontFace::eCounterClockwise;
   rasterizer.depthBiasEnable = VK_FALSE;
 
-  // Настройка мультисемплинга (отключен)
+  // Настройка мультисемплинга
   vk::PipelineMultisampleStateCreateInfo multisampling = {};
   multisampling.sampleShadingEnable                    = VK_FALSE;
-  multisampling.rasterizationSamples                   = vk::SampleCountFlagBits::e1;
+  multisampling.rasterizationSamples                   = m_msaaSamples;
+
+  // Настройка теста глубины
+  vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
+  depthStencil.depthTestEnable                         = VK_TRUE;
+  depthStencil.depthWriteEnable                        = VK_TRUE;
+  depthStencil.depthCompareOp                          = vk::CompareOp::eLess;
+  depthStencil.depthBoundsTestEnable                   = VK_FALSE;
+  depthStencil.stencilTestEnable                       = VK_FALSE;
 
   // Настройка смешивания цветов
   vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
@@ -188,7 +362,9 @@ void VulkanRenderer::createGraphicsPipeline()
 
   // Создание layout'а пайплайна
   vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {};
-  pipelineLayoutInfo.setLayoutCount               = 0;
+  vk::DescriptorSetLayout setLayouts[]           = {m_uniformBuffer->getDescriptorSetLayout()};
+  pipelineLayoutInfo.setLayoutCount               = 1;
+  pipelineLayoutInfo.pSetLayouts                  = setLayouts;
   pipelineLayoutInfo.pushConstantRangeCount       = 0;
 
   try
@@ -209,14 +385,30 @@ void VulkanRenderer::createGraphicsPipeline()
   pipelineInfo.pViewportState                 = &viewportState;
   pipelineInfo.pRasterizationState            = &rasterizer;
   pipelineInfo.pMultisampleState              = &multisampling;
-  pipelineInfo.pDepthStencilState             = nullptr;
+  pipelineInfo.pDepthStencilState             = &depthStencil;
   pipelineInfo.pColorBlendState               = &colorBlending;
-  pipelineInfo.pDynamicState                  = nullptr;
+  pipelineInfo.pDynamicState                  = &dynamicState;
   pipelineInfo.layout                         = *m_vkPipelineLayout;
-  pipelineInfo.renderPass                     = *m_vkRenderPass;
   pipelineInfo.subpass                        = 0;
   pipelineInfo.basePipelineHandle             = nullptr;
 
+  // При dynamic rendering форматы вложений задаются в самом конвейере
+  vk::Format                      colorFormat   = VulkanPostProcess::getSceneFormat();
+  vk::PipelineRenderingCreateInfo renderingInfo = {};
+  renderingInfo.colorAttachmentCount            = 1;
+  renderingInfo.pColorAttachmentFormats         = &colorFormat;
+  renderingInfo.depthAttachmentFormat           = m_depthFormat;
+
+  if (m_useDynamicRendering)
+  {
+    pipelineInfo.pNext      = &renderingInfo;
+    pipelineInfo.renderPass = nullptr;
+  }
+  else
+  {
+    pipelineInfo.renderPass = *m_vkRenderPass;
+  }
+
   try
   {
     auto result          = m_device.getDevice().createGraphicsPipelineUnique(nullptr, pipelineInfo);
@@ -227,24 +419,32 @@ void VulkanRenderer::createGraphicsPipeline()
   {
     throw std::runtime_error("Не удалось создать графический конвейер: " + std::string(e.what()));
   }
+
+  if (m_commandTrace)
+  {
+    m_commandTrace->addPipeline(*m_vkGraphicsPipeline, pipelineInfo, vertShaderPath,
+                                fragShaderPath, true);
+  }
 }
 
 void VulkanRenderer::createFramebuffers()
 {
-  // Изменение размера вектора для хранения framebuffers
-  auto imageViews = m_swapChain.getImageViews();
-  m_vkSwapChainFramebuffers.resize(imageViews.size());
+  // Сцена рисуется в HDR-изображение слота кадра, поэтому framebuffer - на каждый слот
+  m_vkSceneFramebuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
-  // Создание framebuffer для каждого image view
-  for (size_t i = 0; i < imageViews.size(); i++)
+  for (size_t i = 0; i < m_vkSceneFramebuffers.size(); i++)
   {
-    // Массив из одного image view
-    vk::ImageView attachments[] = {imageViews[i]};
+    // Без MSAA изображение сцены - само цветовое вложение, с MSAA - цель resolve
+    bool          msaa      = m_msaaSamples != vk::SampleCountFlagBits::e1;
+    vk::ImageView sceneView = m_postProcess->getSceneView(static_cast<uint32_t>(i));
+    vk::ImageView attachments[] = {
+        msaa ? m_renderGraph->getImageView(m_msaaColorTarget) : sceneView,
+        m_renderGraph->getImageView(m_depthTarget), sceneView};
 
     // Создание framebuffer
     vk::FramebufferCreateInfo framebufferInfo = {};
     framebufferInfo.renderPass                = *m_vkRenderPass;
-    framebufferInfo.attachmentCount           = 1;
+    framebufferInfo.attachmentCount           = msaa ? 3 : 2;
     framebufferInfo.pAttachments              = attachments;
     framebufferInfo.width                     = m_swapChain.getExtent().width;
     framebufferInfo.height                    = m_swapChain.getExtent().height;
@@ -252,7 +452,7 @@ void VulkanRenderer::createFramebuffers()
 
     try
     {
-      m_vkSwapChainFramebuffers[i] = m_device.getDevice().createFramebufferUnique(framebufferInfo);
+      m_vkSceneFramebuffers[i] = m_device.getDevice().createFramebufferUnique(framebufferInfo);
     }
     catch (const vk::SystemError& e)
     {
@@ -263,168 +463,265 @@ void VulkanRenderer::createFramebuffers()
   std::cout << "Framebuffers созданы успешно" << std::endl;
 }
 
-void VulkanRenderer::createCommandPool()
+void VulkanRenderer::createRenderGraph()
 {
-  // Получение индекса семейства очередей для графических операций
-  QueueFamilyIndices queueFamilyIndices = m_device.getQueueFamilyIndices();
+  m_renderGraph = std::make_unique<VulkanRenderGraph>(m_device);
+
+  // Изображение swap chain: доступно после ожидания семафора получения изображения
+  // (на стадии копирования), в конце кадра переводится в layout для презентации
+  m_swapChainTarget = m_renderGraph->importImage("swapchain", vk::ImageAspectFlagBits::eColor,
+                                                 vk::PipelineStageFlagBits2::eAllTransfer,
+                                                 RenderGraphAccess::Present);
+
+  // HDR-сцена слота: прежнее содержимое не нужно, а его чтение постобработкой
+  // завершено до начала кадра (CPU дождался timeline постобработки). В конце кадра
+  // сцена переводится в layout для чтения вычислительной очередью
+  m_sceneTarget = m_renderGraph->importImage("scene", vk::ImageAspectFlagBits::eColor,
+                                             vk::PipelineStageFlagBits2::eNone,
+                                             RenderGraphAccess::SampledRead);
+
+  // Результат постобработки предыдущего кадра: между кадрами в General, доступен после
+  // ожидания timeline постобработки на стадии копирования
+  m_postOutputTarget = m_renderGraph->importImage(
+      "postOutput", vk::ImageAspectFlagBits::eColor, vk::PipelineStageFlagBits2::eAllTransfer,
+      RenderGraphAccess::StorageWrite, vk::ImageLayout::eGeneral);
+
+  // Многосемпловый цвет и глубина нужны только внутри прохода: transient-вложения,
+  // которые граф размещает в лениво выделяемой памяти, если она есть
+  bool msaa = m_msaaSamples != vk::SampleCountFlagBits::e1;
+  if (msaa)
+  {
+    RenderGraphImageDesc colorDesc = {};
+    colorDesc.format               = VulkanPostProcess::getSceneFormat();
+    colorDesc.extent               = m_swapChain.getExtent();
+    colorDesc.usage                = vk::ImageUsageFlagBits::eColorAttachment |
+                      vk::ImageUsageFlagBits::eTransientAttachment;
+    colorDesc.samples              = m_msaaSamples;
+    m_msaaColorTarget = m_renderGraph->createImage("msaaColor", colorDesc);
+  }
 
-  // Создание пула командных буферов
-  vk::CommandPoolCreateInfo poolInfo = {};
-  poolInfo.queueFamilyIndex          = queueFamilyIndices.graphicsFamily.value();
-  poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+  RenderGraphImageDesc depthDesc = {};
+  depthDesc.format               = m_depthFormat;
+  depthDesc.extent               = m_swapChain.getExtent();
+  depthDesc.usage                = vk::ImageUsageFlagBits::eDepthStencilAttachment |
+                    vk::ImageUsageFlagBits::eTransientAttachment;
+  depthDesc.samples              = m_msaaSamples;
+  depthDesc.aspect               = m_depthFormat == vk::Format::eD24UnormS8Uint
+                                       ? vk::ImageAspectFlagBits::eDepth |
+                                             vk::ImageAspectFlagBits::eStencil
+                                       : vk::ImageAspectFlagBits::eDepth;
+  m_depthTarget = m_renderGraph->createImage("depth", depthDesc);
+
+  // Симуляция частиц: запись в буфер, который основной проход читает как буфер вершин
+  if (m_particleSystem)
+  {
+    m_particleBuffer = m_renderGraph->importBuffer(
+        "particles", vk::PipelineStageFlagBits2::eVertexAttributeInput);
+    m_renderGraph->setImportedBuffer(m_particleBuffer, m_particleSystem->getBuffer());
+
+    uint32_t particlePass = m_renderGraph->addPass(
+        "particles",
+        [this](vk::CommandBuffer commandBuffer)
+        {
+          m_particleSystem->simulate(commandBuffer, static_cast<uint32_t>(m_currentFrame),
+                                     m_frameDeltaTime);
+        });
+    m_renderGraph->use(particlePass, m_particleBuffer, RenderGraphAccess::StorageWrite);
+  }
 
-  try
+  // Основной проход: очередь отрисовки
+  uint32_t mainPass = m_renderGraph->addPass(
+      "main", [this](vk::CommandBuffer commandBuffer) { recordMainPass(commandBuffer); });
+  m_renderGraph->use(mainPass, m_sceneTarget, RenderGraphAccess::ColorAttachmentWrite);
+  if (msaa)
   {
-    m_vkCommandPool = m_device.getDevice().createCommandPoolUnique(poolInfo);
-    std::cout << "Command pool создан успешно" << std::endl;
+    m_renderGraph->use(mainPass, m_msaaColorTarget, RenderGraphAccess::ColorAttachmentWrite);
   }
-  catch (const vk::SystemError& e)
+  m_renderGraph->use(mainPass, m_depthTarget, RenderGraphAccess::DepthAttachmentWrite);
+  if (m_particleSystem)
   {
-    throw std::runtime_error("Не удалось создать command pool: " + std::string(e.what()));
+    m_renderGraph->use(mainPass, m_particleBuffer, RenderGraphAccess::VertexBufferRead);
+  }
+
+  // Показ: копирование готового результата предыдущего кадра в swap chain. Не зависит
+  // от основного прохода, поэтому графика кадра идёт параллельно с постобработкой
+  uint32_t presentPass = m_renderGraph->addPass(
+      "present", [this](vk::CommandBuffer commandBuffer) { recordPresentPass(commandBuffer); });
+  m_renderGraph->use(presentPass, m_postOutputTarget, RenderGraphAccess::TransferRead);
+  m_renderGraph->use(presentPass, m_swapChainTarget, RenderGraphAccess::TransferWrite);
+
+  // Оверлей рисуется поверх показанного кадра и в захват кадров не попадает
+  if (m_hud)
+  {
+    uint32_t hudPass = m_renderGraph->addPass(
+        "hud", [this](vk::CommandBuffer commandBuffer) { recordHudPass(commandBuffer); });
+    m_renderGraph->use(hudPass, m_swapChainTarget, RenderGraphAccess::ColorAttachmentWrite);
   }
+
+  m_renderGraph->compile();
 }
 
-void VulkanRenderer::createCommandBuffers()
+void VulkanRenderer::createCommandPool()
 {
-  // Изменение размера вектора для хранения командных буферов
-  m_vkCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+  // Получение индекса семейства очередей для графических операций
+  QueueFamilyIndices queueFamilyIndices = m_device.getQueueFamilyIndices();
 
-  // Создание командных буферов
-  vk::CommandBufferAllocateInfo allocInfo = {};
-  allocInfo.commandPool                   = *m_vkCommandPool;
-  allocInfo.level                         = vk::CommandBufferLevel::ePrimary;
-  allocInfo.commandBufferCount            = static_cast<uint32_t>(m_vkCommandBuffers.size());
+  // Пул только для однократных загрузок: команды кадров живут в VulkanFrameContext
+  vk::CommandPoolCreateInfo poolInfo = {};
+  poolInfo.queueFamilyIndex          = queueFamilyIndices.graphicsFamily.value();
+  poolInfo.flags                     = vk::CommandPoolCreateFlagBits::eTransient;
 
   try
   {
-    m_vkCommandBuffers = m_device.getDevice().allocateCommandBuffersUnique(allocInfo);
-    std::cout << "Command buffers созданы успешно" << std::endl;
+    m_vkCommandPool = m_device.getDevice().createCommandPoolUnique(poolInfo);
+    std::cout << "Command pool создан успешно" << std::endl;
   }
   catch (const vk::SystemError& e)
   {
-    throw std::runtime_error("Не удалось создать command buffers: " + std::string(e.what()));
+    throw std::runtime_error("Не удалось создать command pool: " + std::string(e.what()));
   }
 }
 
-void VulkanRenderer::createSyncObjects()
+void VulkanRenderer::createFrameContexts()
 {
-  // Изменение размера векторов для хранения объектов синхронизации
-  m_vkImageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-  m_vkRenderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-  m_vkInFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-
-  // Создание семафоров и заборов
-  vk::SemaphoreCreateInfo semaphoreInfo = {};
-  vk::FenceCreateInfo     fenceInfo     = {};
-  fenceInfo.flags                       = vk::FenceCreateFlagBits::eSignaled;
-
-  // Создание объектов синхронизации для каждого кадра
-  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+  // У каждого кадра в обработке свой пул команд: сброс одним вызовом на кадр
+  m_frames.clear();
+  for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
   {
-    try
-    {
-      m_vkImageAvailableSemaphores[i] = m_device.getDevice().createSemaphoreUnique(semaphoreInfo);
-      m_vkRenderFinishedSemaphores[i] = m_device.getDevice().createSemaphoreUnique(semaphoreInfo);
-      m_vkInFlightFences[i]           = m_device.getDevice().createFenceUnique(fenceInfo);
-    }
-    catch (const vk::SystemError& e)
+    auto frame = std::make_unique<VulkanFrameContext>(m_device, FRAME_ARENA_BYTES);
+    if (frame->init() != 0)
     {
-      throw std::runtime_error("Не удалось создать объекты синхронизации: " +
-                               std::string(e.what()));
+      throw std::runtime_error("Не удалось создать контекст кадра");
     }
+    m_frames.push_back(std::move(frame));
   }
 
-  std::cout << "Объекты синхронизации созданы успешно" << std::endl;
+  std::cout << "Контексты кадров созданы успешно" << std::endl;
 }
 
-void VulkanRenderer::createVertexBuffer()
+void VulkanRenderer::createSyncObjects()
 {
-  // Размер данных вершин в байтах
-  vk::DeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
+  // Timeline-семафор графической очереди: кадр N сигналит значение N
+  vk::SemaphoreTypeCreateInfo timelineTypeInfo = {};
+  timelineTypeInfo.semaphoreType               = vk::SemaphoreType::eTimeline;
+  timelineTypeInfo.initialValue                = 0;
 
-  // Создание стадийного буфера (staging buffer)
-  vk::UniqueBuffer       stagingBuffer;
-  vk::UniqueDeviceMemory stagingBufferMemory;
-
-  // Создание стадийного буфера
-  vk::BufferCreateInfo bufferInfo = {};
-  bufferInfo.size                 = bufferSize;
-  bufferInfo.usage                = vk::BufferUsageFlagBits::eTransferSrc;
-  bufferInfo.sharingMode          = vk::SharingMode::eExclusive;
+  vk::SemaphoreCreateInfo timelineInfo = {};
+  timelineInfo.pNext                   = &timelineTypeInfo;
 
+  // Бинарные семафоры остаются только там, где их требует swap chain:
+  // получение изображения (в контексте кадра) и презентация (по изображению,
+  // так как семафор освобождается только когда изображение снова получено)
   try
   {
-    stagingBuffer = m_device.getDevice().createBufferUnique(bufferInfo);
+    m_vkGraphicsTimeline = m_device.getDevice().createSemaphoreUnique(timelineInfo);
   }
   catch (const vk::SystemError& e)
   {
-    throw std::runtime_error("Не удалось создать staging buffer: " + std::string(e.what()));
+    throw std::runtime_error("Не удалось создать объекты синхронизации: " + std::string(e.what()));
   }
 
-  // Выделение памяти для стадийного буфера
-  vk::MemoryRequirements memRequirements =
-      m_device.getDevice().getBufferMemoryRequirements(*stagingBuffer);
+  std::cout << "Объекты синхронизации созданы успешно" << std::endl;
+}
 
-  vk::MemoryAllocateInfo allocInfo = {};
-  allocInfo.allocationSize         = memRequirements.size;
-  allocInfo.memoryTypeIndex =
-      findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible |
-                                                         vk::MemoryPropertyFlagBits::eHostCoherent);
+void VulkanRenderer::createPresentSemaphores()
+{
+  vk::SemaphoreCreateInfo semaphoreInfo = {};
 
   try
   {
-    stagingBufferMemory = m_device.getDevice().allocateMemoryUnique(allocInfo);
+    m_vkRenderFinishedSemaphores.resize(m_swapChain.getImages().size());
+    for (auto& semaphore : m_vkRenderFinishedSemaphores)
+    {
+      semaphore = m_device.getDevice().createSemaphoreUnique(semaphoreInfo);
+    }
   }
   catch (const vk::SystemError& e)
   {
-    throw std::runtime_error("Не удалось выделить память для staging buffer: " +
-                             std::string(e.what()));
+    throw std::runtime_error("Не удалось создать семафоры презентации: " + std::string(e.what()));
   }
+}
 
-  // Связывание буфера с памятью
-  m_device.getDevice().bindBufferMemory(*stagingBuffer, *stagingBufferMemory, 0);
-
-  // Копирование данных вершин в стадийный буфер
-  void* data;
-  m_device.getDevice().mapMemory(*stagingBufferMemory, 0, bufferSize, {}, &data);
-  memcpy(data, m_vertices.data(), (size_t)bufferSize);
-  m_device.getDevice().unmapMemory(*stagingBufferMemory);
-
-  // Создание буфера вершин
-  bufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer;
-
-  try
-  {
-    m_vkVertexBuffer = m_device.getDevice().createBufferUnique(bufferInfo);
-  }
-  catch (const vk::SystemError& e)
+void VulkanRenderer::createMeshBuffers()
+{
+  // Треугольник разбивается сеткой: цвет линеен по площади, поэтому грубые уровни
+  // выглядят так же, а полная детализация нужна только вблизи
+  std::vector<Vertex>    vertices;
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t>  indices;
+  const uint32_t         n = TRIANGLE_SUBDIVISIONS;
+  for (uint32_t i = 0; i <= n; i++)
   {
-    throw std::runtime_error("Не удалось создать буфер вершин: " + std::string(e.what()));
+    for (uint32_t j = 0; j <= n - i; j++)
+    {
+      // Барицентрические координаты узла сетки относительно углов m_vertices
+      float  weights[3] = {static_cast<float>(n - i - j) / n, static_cast<float>(i) / n,
+                           static_cast<float>(j) / n};
+      Vertex vertex     = {};
+      for (uint32_t corner = 0; corner < 3; corner++)
+      {
+        for (uint32_t k = 0; k < 2; k++)
+        {
+          vertex.position[k] += m_vertices[corner].position[k] * weights[corner];
+        }
+        for (uint32_t k = 0; k < 3; k++)
+        {
+          vertex.color[k] += m_vertices[corner].color[k] * weights[corner];
+        }
+      }
+      vertices.push_back(vertex);
+      positions.emplace_back(vertex.position[0], vertex.position[1], 0.0f);
+    }
   }
 
-  // Выделение памяти для буфера вершин
-  memRequirements = m_device.getDevice().getBufferMemoryRequirements(*m_vkVertexBuffer);
-
-  // Создаем новый объект вместо переиспользования allocInfo
-  vk::MemoryAllocateInfo vertexAllocInfo = {};
-  vertexAllocInfo.allocationSize         = memRequirements.size;
-  vertexAllocInfo.memoryTypeIndex =
-      findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-  try
-  {
-    m_vkVertexBufferMemory = m_device.getDevice().allocateMemoryUnique(vertexAllocInfo);
-  }
-  catch (const vk::SystemError& e)
+  // Узел (i, j) лежит после строк 0..i-1 длиной n + 1, n, ...
+  auto node = [n](uint32_t i, uint32_t j) { return i * (2 * n + 3 - i) / 2 + j; };
+  for (uint32_t i = 0; i < n; i++)
   {
-    throw std::runtime_error("Не удалось выделить память для буфера вершин: " +
-                             std::string(e.what()));
+    for (uint32_t j = 0; j < n - i; j++)
+    {
+      indices.insert(indices.end(), {node(i, j), node(i + 1, j), node(i, j + 1)});
+      if (i + j + 1 < n)
+      {
+        indices.insert(indices.end(), {node(i + 1, j), node(i + 1, j + 1), node(i, j + 1)});
+      }
+    }
   }
 
-  // Связывание буфера с памятью
-  m_device.getDevice().bindBufferMemory(*m_vkVertexBuffer, *m_vkVertexBufferMemory, 0);
+  // Уровни детализации строятся при загрузке и лежат в одном индексном буфере
+  m_triangleLods = MeshSimplifier::buildLodChain(positions, indices);
+  m_lodSelector.clear();
+  m_lodSelector.setThreshold(LOD_THRESHOLD_PX);
+
+  vk::DeviceSize vertexSize = sizeof(Vertex) * vertices.size();
+  vk::DeviceSize indexSize  = sizeof(uint32_t) * m_triangleLods.indices.size();
+  vk::DeviceSize bufferSize = vertexSize + indexSize;
+
+  // Создание стадийного буфера (staging buffer) для вершин и индексов
+  vk::UniqueBuffer    stagingBuffer;
+  TrackedDeviceMemory stagingBufferMemory;
+  m_device.createBuffer(
+      bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      stagingBuffer, stagingBufferMemory, MemoryCategory::Staging);
+  m_pUploadBytesMetric->add(bufferSize);
+
+  // Копирование вершин и индексов в стадийный буфер
+  void* data;
+  m_device.getDevice().mapMemory(*stagingBufferMemory, 0, bufferSize, {}, &data);
+  memcpy(data, vertices.data(), (size_t)vertexSize);
+  memcpy(static_cast<char*>(data) + vertexSize, m_triangleLods.indices.data(), (size_t)indexSize);
+  m_device.getDevice().unmapMemory(*stagingBufferMemory);
+
+  // Создание буферов вершин и индексов в локальной памяти устройства
+  m_device.createBuffer(
+      vertexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+      vk::MemoryPropertyFlagBits::eDeviceLocal, m_vkVertexBuffer, m_vkVertexBufferMemory);
+  m_device.createBuffer(
+      indexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+      vk::MemoryPropertyFlagBits::eDeviceLocal, m_vkIndexBuffer, m_vkIndexBufferMemory);
 
-  // Копирование данных из стадийного буфера в буфер вершин
+  // Копирование данных из стадийного буфера
   vk::CommandBufferAllocateInfo cmdBufAllocInfo = {};
   cmdBufAllocInfo.level                         = vk::CommandBufferLevel::ePrimary;
   cmdBufAllocInfo.commandPool                   = *m_vkCommandPool;
@@ -439,10 +736,15 @@ void VulkanRenderer::createVertexBuffer()
 
   tempCommandBuffer->begin(beginInfo);
 
-  // Команда копирования
-  vk::BufferCopy copyRegion = {};
-  copyRegion.size           = bufferSize;
-  tempCommandBuffer->copyBuffer(*stagingBuffer, *m_vkVertexBuffer, copyRegion);
+  // Команды копирования
+  vk::BufferCopy vertexRegion = {};
+  vertexRegion.size           = vertexSize;
+  tempCommandBuffer->copyBuffer(*stagingBuffer, *m_vkVertexBuffer, vertexRegion);
+
+  vk::BufferCopy indexRegion = {};
+  indexRegion.srcOffset      = vertexSize;
+  indexRegion.size           = indexSize;
+  tempCommandBuffer->copyBuffer(*stagingBuffer, *m_vkIndexBuffer, indexRegion);
 
   // Конец записи команд
   tempCommandBuffer->end();
@@ -456,24 +758,394 @@ void VulkanRenderer::createVertexBuffer()
   m_device.getGraphicsQueue().submit(submitInfo, nullptr);
   m_device.getGraphicsQueue().waitIdle();
 
-  std::cout << "Буфер вершин создан успешно" << std::endl;
+  if (m_commandTrace)
+  {
+    m_commandTrace->addBuffer(*m_vkVertexBuffer, vk::BufferUsageFlagBits::eVertexBuffer,
+                              vertices.data(), static_cast<size_t>(vertexSize));
+    m_commandTrace->addBuffer(*m_vkIndexBuffer, vk::BufferUsageFlagBits::eIndexBuffer,
+                              m_triangleLods.indices.data(), static_cast<size_t>(indexSize));
+  }
+
+  // Ограничивающая сфера треугольника для отсечения и LOD: центр масс и дальняя вершина
+  glm::vec3 center(0.0f);
+  for (const Vertex& vertex : m_vertices)
+  {
+    center += glm::vec3(vertex.position[0], vertex.position[1], 0.0f);
+  }
+  center /= static_cast<float>(m_vertices.size());
+
+  float radius = 0.0f;
+  for (const Vertex& vertex : m_vertices)
+  {
+    glm::vec3 position(vertex.position[0], vertex.position[1], 0.0f);
+    radius = std::max(radius, glm::length(position - center));
+  }
+  m_culler.clear();
+  m_culler.addSphere(center, radius);
+  m_lodSelector.addObject(m_lodSelector.addMesh(m_triangleLods), center, radius);
+
+  std::cout << "Буферы меша созданы: " << m_triangleLods.levels.size() << " уровней детализации, "
+            << indices.size() / 3 << " -> " << m_triangleLods.levels.back().indexCount / 3
+            << " треугольников" << std::endl;
+}
+
+void VulkanRenderer::createUniformBuffer()
+{
+  // 64 КБ на кадр хватает на сотни объектов
+  m_uniformBuffer = std::make_unique<VulkanUniformBuffer>(
+      m_device, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT), 64 * 1024);
+  if (m_uniformBuffer->init() != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать uniform-буфер");
+  }
 }
 
-bool VulkanRenderer::drawFrame()
+void VulkanRenderer::createCommandTrace()
+{
+  // Трасса включается путём VKAPI_TRACE_FILE, количество кадров - VKAPI_TRACE_FRAMES
+  const char* traceFile = std::getenv("VKAPI_TRACE_FILE");
+  if (!traceFile || !*traceFile)
+  {
+    return;
+  }
+  uint32_t frameCount = DEFAULT_TRACE_FRAMES;
+  if (const char* framesEnv = std::getenv("VKAPI_TRACE_FRAMES"))
+  {
+    frameCount = std::max(1u, static_cast<uint32_t>(std::strtoul(framesEnv, nullptr, 10)));
+  }
+
+  TraceTarget target = {};
+  target.colorFormat = static_cast<uint32_t>(VulkanPostProcess::getSceneFormat());
+  target.depthFormat = static_cast<uint32_t>(m_depthFormat);
+  target.samples     = static_cast<uint32_t>(m_msaaSamples);
+
+  m_commandTrace = std::make_unique<CommandTraceRecorder>(traceFile, target, frameCount);
+  m_commandTrace->setFrameUniforms(m_uniformBuffer->getDescriptorSet());
+}
+
+void VulkanRenderer::createParticleSystem()
+{
+  // Частицы включаются через VKAPI_PARTICLES=N (например, 1048576); по умолчанию их нет
+  uint32_t particleCount = 0;
+  if (const char* particlesEnv = std::getenv("VKAPI_PARTICLES"))
+  {
+    particleCount = static_cast<uint32_t>(std::strtoul(particlesEnv, nullptr, 10));
+  }
+  if (particleCount == 0)
+  {
+    return;
+  }
+
+  ParticleRenderTarget target = {};
+  target.renderPass           = m_useDynamicRendering ? vk::RenderPass() : *m_vkRenderPass;
+  target.colorFormat          = VulkanPostProcess::getSceneFormat();
+  target.depthFormat          = m_depthFormat;
+  target.samples              = m_msaaSamples;
+  target.frameSetLayout       = m_uniformBuffer->getDescriptorSetLayout();
+
+  m_particleSystem = std::make_unique<VulkanParticleSystem>(
+      m_device, particleCount, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
+  if (m_particleSystem->init(target) != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать систему частиц");
+  }
+}
+
+void VulkanRenderer::createHud()
+{
+  // VKAPI_HUD=0 отключает оверлей, другое значение задаёт масштаб шрифта
+  uint32_t scale = 2;
+  if (const char* hudEnv = std::getenv("VKAPI_HUD"))
+  {
+    scale = static_cast<uint32_t>(std::strtoul(hudEnv, nullptr, 10));
+  }
+  if (scale == 0)
+  {
+    return;
+  }
+
+  m_hud = std::make_unique<VulkanHud>(m_device, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
+  m_hud->setScale(scale);
+  if (m_hud->init(m_swapChain.getImageFormat(), *m_vkCommandPool, m_useDynamicRendering) != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать оверлей производительности");
+  }
+
+  // Без dynamic rendering оверлею нужен framebuffer на каждое изображение swap chain
+  if (!m_useDynamicRendering)
+  {
+    m_hud->createFramebuffers(m_swapChain.getImageViews(), m_swapChain.getExtent());
+  }
+}
+
+void VulkanRenderer::createTextureManager()
+{
+  // Бюджет задаётся через VKAPI_TEXTURE_BUDGET_MB, по умолчанию - половина
+  // самой большой локальной кучи устройства
+  vk::DeviceSize budget = 0;
+  if (const char* budgetEnv = std::getenv("VKAPI_TEXTURE_BUDGET_MB"))
+  {
+    budget = static_cast<vk::DeviceSize>(std::strtoull(budgetEnv, nullptr, 10)) << 20;
+  }
+  else
+  {
+    vk::PhysicalDeviceMemoryProperties memProperties =
+        m_device.getPhysicalDevice().getMemoryProperties();
+    for (uint32_t i = 0; i < memProperties.memoryHeapCount; i++)
+    {
+      if (memProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+      {
+        budget = std::max(budget, memProperties.memoryHeaps[i].size / 2);
+      }
+    }
+  }
+
+  m_textureManager = std::make_unique<VulkanTextureManager>(
+      m_device, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT), budget);
+  if (m_textureManager->init() != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать подсистему текстур");
+  }
+}
+
+void VulkanRenderer::createSpriteBatch()
+{
+  // Количество спрайтов демонстрационной сетки задаётся через VKAPI_SPRITES (0 - без спрайтов)
+  if (const char* spritesEnv = std::getenv("VKAPI_SPRITES"))
+  {
+    m_spriteCount = static_cast<uint32_t>(std::strtoul(spritesEnv, nullptr, 10));
+  }
+  if (m_spriteCount == 0)
+  {
+    return;
+  }
+
+  ParticleRenderTarget target = {};
+  target.renderPass           = m_useDynamicRendering ? vk::RenderPass() : *m_vkRenderPass;
+  target.colorFormat          = VulkanPostProcess::getSceneFormat();
+  target.depthFormat          = m_depthFormat;
+  target.samples              = m_msaaSamples;
+
+  m_spriteBatch = std::make_unique<VulkanSpriteBatch>(
+      m_device, *m_textureManager, &m_threadPool, m_spriteCount, SPRITE_PAGE_COUNT,
+      static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
+  if (m_spriteBatch->init(target, *m_vkCommandPool) != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать отрисовку спрайтов");
+  }
+
+  // Страницы атласа - белые фигуры, цвет задаёт вершина: диск и кольцо со сглаженным краем
+  for (uint32_t page = 0; page < SPRITE_PAGE_COUNT; page++)
+  {
+    std::vector<uint8_t> pixels(SPRITE_PAGE_SIZE * SPRITE_PAGE_SIZE * 4);
+    float                half = 0.5f * static_cast<float>(SPRITE_PAGE_SIZE);
+    for (uint32_t y = 0; y < SPRITE_PAGE_SIZE; y++)
+    {
+      for (uint32_t x = 0; x < SPRITE_PAGE_SIZE; x++)
+      {
+        float dx       = (static_cast<float>(x) + 0.5f - half) / half;
+        float dy       = (static_cast<float>(y) + 0.5f - half) / half;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float edge     = page == 0 ? 1.0f - distance : 0.15f - std::abs(distance - 0.8f);
+        float coverage = std::min(std::max(edge * half * 0.5f, 0.0f), 1.0f);
+
+        uint8_t* pixel = pixels.data() + (static_cast<size_t>(y) * SPRITE_PAGE_SIZE + x) * 4;
+        pixel[0]       = 255;
+        pixel[1]       = 255;
+        pixel[2]       = 255;
+        pixel[3]       = static_cast<uint8_t>(coverage * 255.0f);
+      }
+    }
+    m_spriteBatch->setPage(page, m_textureManager->createTextureFromPixels(
+                                     SPRITE_PAGE_SIZE, SPRITE_PAGE_SIZE, std::move(pixels)));
+  }
+}
+
+void VulkanRenderer::fillSprites(float animationTime, vk::Extent2D extent)
+{
+  // Сетка на весь кадр: столбцов столько, чтобы ячейки были близки к квадратным
+  float    width   = static_cast<float>(extent.width);
+  float    height  = static_cast<float>(extent.height);
+  uint32_t columns = std::max(
+      1u, static_cast<uint32_t>(std::ceil(std::sqrt(m_spriteCount * width / height))));
+  uint32_t rows       = (m_spriteCount + columns - 1) / columns;
+  float    cellWidth  = width / static_cast<float>(columns);
+  float    cellHeight = height / static_cast<float>(rows);
+  float    phase      = animationTime * 6.2831853f;
+
+  SpriteBatcher& batcher = m_spriteBatch->getBatcher();
+  batcher.clear();
+  Sprite* sprites = batcher.allocate(m_spriteCount);
+
+  // Спрайты заполняются параллельно: каждый блок пишет свой участок массива
+  m_threadPool.parallelFor(
+      m_spriteCount, 16384,
+      [&](uint32_t begin, uint32_t end, uint32_t)
+      {
+        for (uint32_t i = begin; i < end; i++)
+        {
+          uint32_t column = i % columns;
+          uint32_t row    = i / columns;
+
+          // Диагональная волна меняет размер и цвет ячеек
+          float pulse = 0.5f + 0.5f * std::sin(phase - 0.15f * static_cast<float>(column + row));
+          float scale = 0.3f + 0.6f * pulse;
+
+          Sprite& sprite = sprites[i];
+          sprite.width   = cellWidth * scale;
+          sprite.height  = cellHeight * scale;
+          sprite.x       = (static_cast<float>(column) + 0.5f) * cellWidth - 0.5f * sprite.width;
+          sprite.y       = (static_cast<float>(row) + 0.5f) * cellHeight - 0.5f * sprite.height;
+          sprite.u0      = 0.0f;
+          sprite.v0      = 0.0f;
+          sprite.u1      = 1.0f;
+          sprite.v1      = 1.0f;
+          sprite.color   = static_cast<uint32_t>(pulse * 255.0f) |
+                         static_cast<uint32_t>((1.0f - pulse) * 160.0f + 64.0f) << 8 |
+                         0xE0u << 16 | 0xFFu << 24;
+          sprite.page = (column + row) % SPRITE_PAGE_COUNT;
+        }
+      });
+}
+
+void VulkanRenderer::createMetrics()
+{
+  // Имена и единицы - по соглашениям Prometheus: время в секундах, счётчики с _total
+  m_pFrameTimeMetric    = &m_metrics.addHistogram("vkapi_frame_time_seconds",
+                                                  "Время между началами соседних кадров");
+  m_pAcquireWaitMetric  = &m_metrics.addHistogram("vkapi_acquire_wait_seconds",
+                                                  "Ожидание изображения swap chain");
+  m_pTimelineWaitMetric = &m_metrics.addHistogram("vkapi_timeline_wait_seconds",
+                                                  "Ожидание завершения кадра на GPU");
+  m_pSubmitMetric       = &m_metrics.addHistogram("vkapi_submit_seconds",
+                                                  "Отправка команд кадра в очереди");
+  m_pDrawsMetric        = &m_metrics.addCounter("vkapi_draws_total", "Draw-вызовы");
+  m_pTrianglesMetric    = &m_metrics.addCounter("vkapi_triangles_total",
+                                                "Отправленные треугольники");
+  m_pUploadBytesMetric  = &m_metrics.addCounter("vkapi_uploaded_bytes_total",
+                                                "Байты, загруженные с CPU на GPU");
+  m_pCullMetric         = &m_metrics.addHistogram("vkapi_cull_seconds",
+                                                  "Отсечение объектов по пирамиде видимости");
+  m_pCulledMetric       = &m_metrics.addCounter("vkapi_culled_objects_total",
+                                                "Объекты вне пирамиды видимости");
+  m_pVisibleMetric      = &m_metrics.addCounter("vkapi_visible_objects_total",
+                                                "Объекты, прошедшие отсечение");
+  m_pLodSwitchesMetric  = &m_metrics.addCounter("vkapi_lod_switches_total",
+                                                "Смены уровня детализации объектов");
+  m_pLodSavedMetric     = &m_metrics.addCounter("vkapi_lod_saved_triangles_total",
+                                                "Треугольники, не отправленные благодаря LOD");
+
+  // Экспорт включается путём к файлу VKAPI_METRICS_FILE
+  const char* metricsFile = std::getenv("VKAPI_METRICS_FILE");
+  if (!metricsFile || !*metricsFile)
+  {
+    return;
+  }
+
+  double interval = DEFAULT_METRICS_INTERVAL_SEC;
+  if (const char* intervalEnv = std::getenv("VKAPI_METRICS_INTERVAL_SEC"))
+  {
+    interval = std::max(std::strtod(intervalEnv, nullptr), 0.1);
+  }
+
+  m_metricsExporter = std::make_unique<MetricsExporter>(m_metrics, metricsFile, interval);
+  m_metricsExporter->start();
+  std::cout << "Метрики: " << metricsFile << " каждые " << interval << " с" << std::endl;
+}
+
+void VulkanRenderer::createMemoryTelemetry()
+{
+  VulkanMemoryTracker& tracker = m_device.getMemoryTracker();
+
+  // Период отчёта - VKAPI_MEMORY_REPORT_SEC (0 отключает отчёты)
+  double reportInterval = DEFAULT_MEMORY_REPORT_SEC;
+  if (const char* reportEnv = std::getenv("VKAPI_MEMORY_REPORT_SEC"))
+  {
+    reportInterval = std::strtod(reportEnv, nullptr);
+  }
+  tracker.setReportInterval(reportInterval);
+
+  // Кэш текстур уступает память первым: драйвер начнёт вытеснять раньше, чем закончится куча
+  m_memoryPressureHandle = tracker.addThresholdCallback(
+      MEMORY_PRESSURE_THRESHOLD,
+      [this](const MemoryHeapReport& heap, float threshold)
+      {
+        vk::DeviceSize resident = m_textureManager->getResidentBytes();
+        vk::DeviceSize budget   = std::max(resident / 4 * 3, MIN_TEXTURE_BUDGET);
+        if (budget < m_textureManager->getBudget())
+        {
+          m_textureManager->setBudget(budget);
+        }
+        std::cout << "Куча " << heap.heapIndex << " заполнена на "
+                  << static_cast<int>(heap.getUsageFraction() * 100.0f) << "% (порог "
+                  << static_cast<int>(threshold * 100.0f) << "%), бюджет текстур "
+                  << (m_textureManager->getBudget() >> 20) << " МБ" << std::endl;
+      });
+}
+
+void VulkanRenderer::createFrameCapture()
+{
+  // Захват включается каталогом VKAPI_CAPTURE_DIR, формат - VKAPI_CAPTURE_FORMAT
+  const char* captureDir = std::getenv("VKAPI_CAPTURE_DIR");
+  if (!captureDir || !*captureDir)
+  {
+    return;
+  }
+
+  m_frameCapture = std::make_unique<VulkanFrameCapture>(
+      m_device, m_postProcess->getExtent(), captureDir,
+      VulkanFrameCapture::parseFormat(std::getenv("VKAPI_CAPTURE_FORMAT")));
+  if (m_frameCapture->init() != 0)
+  {
+    throw std::runtime_error("Не удалось инициализировать захват кадров");
+  }
+}
+
+bool VulkanRenderer::drawFrame(const FrameSnapshot& snapshot)
 {
   try
   {
-    // Ожидание завершения предыдущего кадра
-    auto result = m_device.getDevice().waitForFences(*m_vkInFlightFences[m_currentFrame], VK_TRUE,
-                                                     std::numeric_limits<uint64_t>::max());
+    // Слот определяется номером кадра: кадр N + 1 использует слот N % MAX_FRAMES_IN_FLIGHT.
+    // Ранний выход после отправки (устаревший swap chain) всё равно переводит на следующий
+    // слот, а выход до отправки оставляет текущий - в нём нет незавершённой работы
+    m_currentFrame = static_cast<size_t>(m_frameNumber % MAX_FRAMES_IN_FLIGHT);
+
+    // Ожидание кадра, который последним использовал этот слот, на обеих очередях:
+    // глубина перекрытия CPU и GPU равна MAX_FRAMES_IN_FLIGHT кадрам
+    uint64_t slotFrame = m_frameNumber + 1 > MAX_FRAMES_IN_FLIGHT
+                             ? m_frameNumber + 1 - MAX_FRAMES_IN_FLIGHT
+                             : 0;
+    if (slotFrame > 0)
+    {
+      vk::Semaphore         timelines[] = {*m_vkGraphicsTimeline, m_postProcess->getTimeline()};
+      uint64_t              values[]    = {slotFrame, slotFrame};
+      vk::SemaphoreWaitInfo waitInfo    = {};
+      waitInfo.semaphoreCount           = 2;
+      waitInfo.pSemaphores              = timelines;
+      waitInfo.pValues                  = values;
+
+      auto waitStart = std::chrono::steady_clock::now();
+      auto result    = m_device.getDevice().waitSemaphores(waitInfo,
+                                                           std::numeric_limits<uint64_t>::max());
+      m_pTimelineWaitMetric->record(std::chrono::steady_clock::now() - waitStart);
+      if (result != vk::Result::eSuccess)
+      {
+        throw std::runtime_error("Не удалось дождаться завершения кадра слота");
+      }
+    }
+
+    // Кадр слота завершён: отложенная работа, сброс пула команд и арены кадра
+    VulkanFrameContext& frame = *m_frames[m_currentFrame];
+    frame.begin();
 
     // Получение индекса изображения из цепочки обмена
     uint32_t imageIndex;
+    auto     acquireStart = std::chrono::steady_clock::now();
     try
     {
       auto result = m_device.getDevice().acquireNextImageKHR(
           m_swapChain.getSwapChain(), std::numeric_limits<uint64_t>::max(),
-          *m_vkImageAvailableSemaphores[m_currentFrame], nullptr);
+          frame.getImageAvailableSemaphore(), nullptr);
       imageIndex = result.value;
     }
     catch (const vk::OutOfDateKHRError&)
@@ -486,41 +1158,203 @@ bool VulkanRenderer::drawFrame()
       throw std::runtime_error("Не удалось получить следующее изображение: " +
                                std::string(e.what()));
     }
+    m_pAcquireWaitMetric->record(std::chrono::steady_clock::now() - acquireStart);
+    auto cpuStart = std::chrono::steady_clock::now();
+
+    // Значение timeline - номер последнего завершённого на GPU кадра
+    m_frameNumber++;
+    uint64_t completedFrame = m_device.getDevice().getSemaphoreCounterValue(*m_vkGraphicsTimeline);
+    vk::CommandBuffer streamingCommandBuffer = m_textureManager->update(frame, m_frameNumber);
+
+    // Бюджет видеопамяти: пороги и периодический отчёт
+    m_device.getMemoryTracker().update();
+
+    // Готовые копии кадров уходят на запись в файлы
+    if (m_frameCapture)
+    {
+      m_frameCapture->poll(completedFrame);
+    }
+
+    // Время симуляции слота уже записано - кадр завершён
+    if (m_particleSystem)
+    {
+      m_particleSystem->collectTimings(static_cast<uint32_t>(m_currentFrame));
+    }
+    if (m_hud)
+    {
+      m_hud->collectTimings(static_cast<uint32_t>(m_currentFrame));
+    }
+
+    // Частицы продвигаются на время симуляции между показанными снимками (не больше
+    // 50 мс после пауз): если симуляция отстаёт, кадр повторяет тот же снимок без шага
+    float simulationDelta = static_cast<float>(snapshot.simulationTime - m_lastSimulationTime);
+    m_frameDeltaTime      = m_frameNumber > 1 ? std::min(simulationDelta, 0.05f) : 0.0f;
+    m_lastSimulationTime  = snapshot.simulationTime;
+
+    auto now = std::chrono::steady_clock::now();
+    if (m_frameNumber > 1)
+    {
+      m_pFrameTimeMetric->record(now - m_lastFrameTime);
+      m_hudStats.frameMs = std::chrono::duration<float, std::milli>(now - m_lastFrameTime).count();
+    }
+    m_lastFrameTime = now;
+
+    // Константы кадра и объекта загружаются один раз за кадр, цвет считается в шейдере
+    m_uniformBuffer->beginFrame(static_cast<uint32_t>(m_currentFrame));
+
+    FrameConstants frameConstants = {};
+    frameConstants.viewProj       = snapshot.viewProj;
+    frameConstants.params         = glm::vec4(snapshot.animationTime, 0.0f, 0.0f, 0.0f);
+    uint32_t frameUniformOffset   = m_uniformBuffer->push(frameConstants);
+
+    ObjectConstants objectConstants = {};
+    objectConstants.model           = glm::mat4(1.0f);
+    uint32_t objectUniformOffset    = m_uniformBuffer->push(objectConstants);
+
+    // Отсечение по камере кадра: в очередь попадают только видимые объекты
+    m_culler.cull(snapshot.viewProj);
+    const CullingStats& cullingStats = m_culler.getStats();
+    m_pCullMetric->record(static_cast<uint64_t>(cullingStats.timeMs * 1e6));
+    m_pCulledMetric->add(cullingStats.culled);
+    m_pVisibleMetric->add(cullingStats.visible);
+
+    // Уровень детализации по ошибке на экране
+    vk::Extent2D extent = m_swapChain.getExtent();
+    m_lodSelector.select(snapshot.viewProj, glm::vec2(extent.width, extent.height));
+    m_pLodSwitchesMetric->add(m_lodSelector.getStats().switches);
+    m_pLodSavedMetric->add(m_lodSelector.getStats().saved);
+    const LodLevel& triangleLod = m_triangleLods.levels[m_lodSelector.getLevels()[0]];
+
+    // Сбор пакетов отрисовки кадра
+    m_renderQueue.clear();
+
+    DrawPacket trianglePacket         = {};
+    trianglePacket.key                = RenderKey::makeOpaque(0, 0, 0, 0.0f, 0);
+    trianglePacket.pipeline           = *m_vkGraphicsPipeline;
+    trianglePacket.pipelineLayout     = *m_vkPipelineLayout;
+    trianglePacket.descriptorSet      = m_uniformBuffer->getDescriptorSet();
+    trianglePacket.dynamicOffsetCount = 2;
+    trianglePacket.dynamicOffsets[0]  = frameUniformOffset;
+    trianglePacket.dynamicOffsets[1]  = objectUniformOffset;
+    trianglePacket.vertexBuffer       = *m_vkVertexBuffer;
+    trianglePacket.indexBuffer        = *m_vkIndexBuffer;
+    trianglePacket.firstVertex        = triangleLod.firstIndex;
+    trianglePacket.count              = triangleLod.indexCount;
+    if (!m_culler.getVisibleSpheres().empty())
+    {
+      m_renderQueue.push(trianglePacket);
+    }
+
+    // Частицы: аддитивное смешивание, поэтому отдельный проход после непрозрачных
+    if (m_particleSystem)
+    {
+      DrawPacket particlePacket         = {};
+      particlePacket.key                = RenderKey::makeTransparent(1, 1, 0, 0.0f, 0);
+      particlePacket.descriptorSet      = m_uniformBuffer->getDescriptorSet();
+      particlePacket.dynamicOffsetCount = 2;
+      particlePacket.dynamicOffsets[0]  = frameUniformOffset;
+      particlePacket.dynamicOffsets[1]  = objectUniformOffset;
+      m_particleSystem->fillDrawPacket(particlePacket);
+      m_renderQueue.push(particlePacket);
+    }
 
-    // Сброс забора для текущего кадра
-    m_device.getDevice().resetFences(*m_vkInFlightFences[m_currentFrame]);
+    // Спрайты: вершины пишутся в слот кадра, по одному пакету на страницу атласа
+    if (m_spriteBatch)
+    {
+      fillSprites(snapshot.animationTime, extent);
+      m_spriteBatch->submit(static_cast<uint32_t>(m_currentFrame), extent, m_renderQueue);
+    }
 
-    // Сброс и запись команд для текущего буфера
-    m_vkCommandBuffers[m_currentFrame]->reset();
-    recordCommandBuffer(*m_vkCommandBuffers[m_currentFrame], imageIndex);
+    m_renderQueue.sort();
+
+    // Трасса: константы кадра и поток draw-вызовов в порядке воспроизведения
+    if (m_commandTrace)
+    {
+      m_commandTrace->beginFrame(m_uniformBuffer->getFrameBase());
+      m_commandTrace->addUniform(frameUniformOffset, &frameConstants, sizeof(frameConstants));
+      m_commandTrace->addUniform(objectUniformOffset, &objectConstants, sizeof(objectConstants));
+      if (m_commandTrace->endFrame(m_renderQueue, extent))
+      {
+        m_commandTrace.reset();
+      }
+    }
 
-    // Настройка отправки команд в очередь
-    vk::SubmitInfo submitInfo = {};
+    // Запись команд (буфер сброшен вместе с пулом кадра)
+    recordCommandBuffer(frame.getCommandBuffer(), imageIndex);
 
-    // Семафоры ожидания (ждем, пока изображение станет доступным)
-    vk::Semaphore          waitSemaphores[] = {*m_vkImageAvailableSemaphores[m_currentFrame]};
-    vk::PipelineStageFlags waitStages[]     = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-    submitInfo.waitSemaphoreCount           = 1;
-    submitInfo.pWaitSemaphores              = waitSemaphores;
-    submitInfo.pWaitDstStageMask            = waitStages;
+    m_pDrawsMetric->add(m_renderQueueStats.draws);
+    m_pTrianglesMetric->add(m_renderQueueStats.triangles);
+    m_pUploadBytesMetric->add(m_textureManager->getUploadedBytes() +
+                              m_uniformBuffer->getFrameBytes());
 
-    // Буфер команд для отправки
-    vk::CommandBuffer commandBuffers[] = {*m_vkCommandBuffers[m_currentFrame]};
-    submitInfo.commandBufferCount      = 1;
-    submitInfo.pCommandBuffers         = commandBuffers;
+    // Видеопамять для оверлея: занято и доступно в локальных кучах устройства
+    if (m_hud && m_frameNumber % HUD_MEMORY_INTERVAL == 1)
+    {
+      m_hudStats.memoryUsage  = 0;
+      m_hudStats.memoryBudget = 0;
+      for (const MemoryHeapReport& heap : m_device.getMemoryTracker().query())
+      {
+        if (heap.deviceLocal)
+        {
+          m_hudStats.memoryUsage += heap.usage;
+          m_hudStats.memoryBudget += heap.budget;
+        }
+      }
+    }
 
-    // Семафоры сигнала (сигнализируем о завершении рендеринга)
-    vk::Semaphore signalSemaphores[] = {*m_vkRenderFinishedSemaphores[m_currentFrame]};
-    submitInfo.signalSemaphoreCount  = 1;
-    submitInfo.pSignalSemaphores     = signalSemaphores;
+    // Swap chain и результат постобработки прошлого кадра нужны только копированию:
+    // основной проход кадра не ждёт ни получения изображения, ни вычислительной очереди
+    vk::SemaphoreSubmitInfo waitInfos[2] = {};
+    waitInfos[0].semaphore               = frame.getImageAvailableSemaphore();
+    waitInfos[0].stageMask               = vk::PipelineStageFlagBits2::eAllTransfer;
+    waitInfos[1].semaphore               = m_postProcess->getTimeline();
+    waitInfos[1].value                   = m_frameNumber - 1;
+    waitInfos[1].stageMask               = vk::PipelineStageFlagBits2::eAllTransfer;
+
+    // Все буферы команд кадра одной отправкой: сначала загрузка текстур, затем кадр
+    vk::CommandBufferSubmitInfo commandBufferInfos[2];
+    uint32_t                    commandBufferCount = 0;
+    if (streamingCommandBuffer)
+    {
+      commandBufferInfos[commandBufferCount++].commandBuffer = streamingCommandBuffer;
+    }
+    commandBufferInfos[commandBufferCount++].commandBuffer = frame.getCommandBuffer();
+
+    // Сигнал: номер кадра в timeline и бинарный семафор для презентации
+    vk::SemaphoreSubmitInfo signalInfos[2] = {};
+    signalInfos[0].semaphore               = *m_vkGraphicsTimeline;
+    signalInfos[0].value                   = m_frameNumber;
+    signalInfos[0].stageMask               = vk::PipelineStageFlagBits2::eAllCommands;
+    signalInfos[1].semaphore               = *m_vkRenderFinishedSemaphores[imageIndex];
+    signalInfos[1].stageMask               = vk::PipelineStageFlagBits2::eAllCommands;
+
+    vk::SubmitInfo2 submitInfo          = {};
+    submitInfo.waitSemaphoreInfoCount   = m_frameNumber > 1 ? 2 : 1;
+    submitInfo.pWaitSemaphoreInfos      = waitInfos;
+    submitInfo.commandBufferInfoCount   = commandBufferCount;
+    submitInfo.pCommandBufferInfos      = commandBufferInfos;
+    submitInfo.signalSemaphoreInfoCount = 2;
+    submitInfo.pSignalSemaphoreInfos    = signalInfos;
 
     // Отправка команд в очередь
-    m_device.getGraphicsQueue().submit(submitInfo, *m_vkInFlightFences[m_currentFrame]);
+    auto submitStart = std::chrono::steady_clock::now();
+    m_device.getGraphicsQueue().submit2(submitInfo);
+
+    // Постобработка кадра: ждёт графику этого кадра, выполняется параллельно со следующим
+    m_postProcess->submit(static_cast<uint32_t>(m_currentFrame), m_frameNumber,
+                          *m_vkGraphicsTimeline);
+    m_pSubmitMetric->record(std::chrono::steady_clock::now() - submitStart);
+
+    // Время CPU становится известно после записи, поэтому оверлей показывает его кадром позже
+    m_hudStats.cpuMs =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - cpuStart)
+            .count();
 
     // Настройка отображения на экране
+    vk::Semaphore      presentWait = *m_vkRenderFinishedSemaphores[imageIndex];
     vk::PresentInfoKHR presentInfo = {};
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores    = signalSemaphores;
+    presentInfo.pWaitSemaphores    = &presentWait;
 
     vk::SwapchainKHR swapChains[] = {m_swapChain.getSwapChain()};
     presentInfo.swapchainCount    = 1;
@@ -542,19 +1376,6 @@ bool VulkanRenderer::drawFrame()
       throw std::runtime_error("Не удалось отобразить кадр: " + std::string(e.what()));
     }
 
-    // Обновление времени анимации
-    m_animationTime += 0.01f;
-    if (m_animationTime > 1.0f)
-      m_animationTime = 0.0f;
-
-    // Обновление цвета вершин
-    m_vertices[0].color[0] = 0.5f + 0.5f * sin(m_animationTime * 6.28f);
-    m_vertices[1].color[1] = 0.5f + 0.5f * sin(m_animationTime * 6.28f + 2.09f);
-    m_vertices[2].color[2] = 0.5f + 0.5f * sin(m_animationTime * 6.28f + 4.19f);
-
-    // Переход к следующему кадру
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
-
     return true;
   }
   catch (const std::exception& e)
@@ -581,63 +1402,175 @@ vk::UniqueShaderModule VulkanRenderer::createShaderModule(const std::vector<char
   }
 }
 
-uint32_t VulkanRenderer::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties)
+void VulkanRenderer::recordMainPass(vk::CommandBuffer commandBuffer)
 {
-  // Получение информации о памяти физического устройства
-  vk::PhysicalDeviceMemoryProperties memProperties =
-      m_device.getPhysicalDevice().getMemoryProperties();
+  bool          msaa      = m_msaaSamples != vk::SampleCountFlagBits::e1;
+  vk::ImageView sceneView = m_renderGraph->getImageView(m_sceneTarget);
 
-  // Поиск подходящего типа памяти
-  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+  // Цвет фона (почти темный) и дальняя глубина
+  vk::ClearValue clearColor =
+      vk::ClearColorValue(std::array<float, 4>{0.01f, 0.01f, 0.01f, 1.0f});
+  vk::ClearValue clearDepth = vk::ClearDepthStencilValue(1.0f, 0);
+
+  // Динамическое состояние, общее для всех конвейеров прохода
+  vk::Extent2D extent = m_swapChain.getExtent();
+  vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(extent.width),
+                        static_cast<float>(extent.height), 0.0f, 1.0f);
+  vk::Rect2D   scissor(vk::Offset2D{0, 0}, extent);
+
+  if (m_useDynamicRendering)
   {
-    if ((typeFilter & (1 << i)) &&
-        (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+    // Вложения подключаются напрямую через image view, без framebuffer
+    vk::RenderingAttachmentInfo colorAttachment = {};
+    colorAttachment.imageView =
+        msaa ? m_renderGraph->getImageView(m_msaaColorTarget) : sceneView;
+    colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    colorAttachment.loadOp      = vk::AttachmentLoadOp::eClear;
+    colorAttachment.storeOp = msaa ? vk::AttachmentStoreOp::eDontCare : vk::AttachmentStoreOp::eStore;
+    colorAttachment.clearValue = clearColor;
+    if (msaa)
     {
-      return i;
+      colorAttachment.resolveMode        = vk::ResolveModeFlagBits::eAverage;
+      colorAttachment.resolveImageView   = sceneView;
+      colorAttachment.resolveImageLayout = vk::ImageLayout::eColorAttachmentOptimal;
     }
+
+    vk::RenderingAttachmentInfo depthAttachment = {};
+    depthAttachment.imageView                   = m_renderGraph->getImageView(m_depthTarget);
+    depthAttachment.imageLayout                 = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+    depthAttachment.loadOp                      = vk::AttachmentLoadOp::eClear;
+    depthAttachment.storeOp                     = vk::AttachmentStoreOp::eDontCare;
+    depthAttachment.clearValue                  = clearDepth;
+
+    vk::RenderingInfo renderingInfo    = {};
+    renderingInfo.renderArea.offset    = vk::Offset2D{0, 0};
+    renderingInfo.renderArea.extent    = extent;
+    renderingInfo.layerCount           = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments    = &colorAttachment;
+    renderingInfo.pDepthAttachment     = &depthAttachment;
+
+    commandBuffer.beginRendering(renderingInfo);
+    commandBuffer.setViewport(0, viewport);
+    commandBuffer.setScissor(0, scissor);
+    m_renderQueueStats = m_renderQueue.execute(commandBuffer);
+    commandBuffer.endRendering();
+    return;
   }
 
-  throw std::runtime_error("Не удалось найти подходящий тип памяти");
+  // Начало render pass
+  vk::ClearValue          clearValues[]  = {clearColor, clearDepth, {}};
+  vk::RenderPassBeginInfo renderPassInfo = {};
+  renderPassInfo.renderPass              = *m_vkRenderPass;
+  renderPassInfo.framebuffer             = *m_vkSceneFramebuffers[m_currentFrame];
+  renderPassInfo.renderArea.offset       = vk::Offset2D{0, 0};
+  renderPassInfo.renderArea.extent       = extent;
+  renderPassInfo.clearValueCount         = msaa ? 3 : 2;
+  renderPassInfo.pClearValues            = clearValues;
+
+  commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+  commandBuffer.setViewport(0, viewport);
+  commandBuffer.setScissor(0, scissor);
+
+  // Воспроизведение отсортированной очереди отрисовки
+  m_renderQueueStats = m_renderQueue.execute(commandBuffer);
+
+  commandBuffer.endRenderPass();
 }
 
-void VulkanRenderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+void VulkanRenderer::recordPresentPass(vk::CommandBuffer commandBuffer)
 {
-  // Начало записи команд в буфер
-  vk::CommandBufferBeginInfo beginInfo = {};
-  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  vk::Image    swapChainImage = m_renderGraph->getImage(m_swapChainTarget);
+  vk::Extent2D extent         = m_swapChain.getExtent();
 
-  try
+  // В первом кадре готового результата ещё нет - показывается цвет фона
+  if (m_frameNumber == 1)
   {
-    commandBuffer.begin(beginInfo);
+    vk::ClearColorValue       clearColor(std::array<float, 4>{0.01f, 0.01f, 0.01f, 1.0f});
+    vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+    commandBuffer.clearColorImage(swapChainImage, vk::ImageLayout::eTransferDstOptimal, clearColor,
+                                  range);
+    return;
+  }
+
+  // Размеры совпадают: blit только меняет формат (RGBA8 -> формат swap chain)
+  vk::Offset3D corner(static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1);
+
+  vk::ImageBlit2 region = {};
+  region.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+  region.srcOffsets[1]  = corner;
+  region.dstSubresource = region.srcSubresource;
+  region.dstOffsets[1]  = corner;
 
-    // Цвет фона (почти темный)
-    vk::ClearValue clearColor =
-        vk::ClearColorValue(std::array<float, 4>{0.01f, 0.01f, 0.01f, 1.0f});
+  vk::BlitImageInfo2 blitInfo = {};
+  blitInfo.srcImage           = m_renderGraph->getImage(m_postOutputTarget);
+  blitInfo.srcImageLayout     = vk::ImageLayout::eTransferSrcOptimal;
+  blitInfo.dstImage           = swapChainImage;
+  blitInfo.dstImageLayout     = vk::ImageLayout::eTransferDstOptimal;
+  blitInfo.regionCount        = 1;
+  blitInfo.pRegions           = &region;
+  blitInfo.filter             = vk::Filter::eNearest;
 
-    // Начало render pass
-    vk::RenderPassBeginInfo renderPassInfo = {};
-    renderPassInfo.renderPass              = *m_vkRenderPass;
-    renderPassInfo.framebuffer             = *m_vkSwapChainFramebuffers[imageIndex];
-    renderPassInfo.renderArea.offset       = vk::Offset2D{0, 0};
-    renderPassInfo.renderArea.extent       = m_swapChain.getExtent();
-    renderPassInfo.clearValueCount         = 1;
-    renderPassInfo.pClearValues            = &clearColor;
+  commandBuffer.blitImage2(blitInfo);
 
-    commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+  // Захват показанного кадра: та же копия в layout источника, готовность - timeline кадра
+  if (m_frameCapture)
+  {
+    m_frameCapture->record(commandBuffer, blitInfo.srcImage, m_frameNumber - 1, m_frameNumber);
+  }
+}
+
+void VulkanRenderer::recordHudPass(vk::CommandBuffer commandBuffer)
+{
+  // Основной проход уже записан: статистика очереди относится к этому кадру
+  m_hudStats.gpuMs       = static_cast<float>(m_hud->getGpuFrameMs());
+  m_hudStats.cullMs      = static_cast<float>(m_culler.getStats().timeMs);
+  m_hudStats.lodMs       = static_cast<float>(m_lodSelector.getStats().timeMs);
+  m_hudStats.draws       = m_renderQueueStats.draws;
+  m_hudStats.triangles   = m_renderQueueStats.triangles;
+  m_hudStats.particlesMs = 0.0f;
+  if (m_particleSystem)
+  {
+    m_hudStats.particlesMs = static_cast<float>(m_particleSystem->getSimulationMs());
+  }
 
-    // Привязка графического пайплайна
-    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *m_vkGraphicsPipeline);
+  uint32_t slot = static_cast<uint32_t>(m_currentFrame);
+  m_hud->update(slot, m_hudStats);
+  m_hud->record(commandBuffer, slot, m_renderGraph->getImageView(m_swapChainTarget),
+                m_swapChain.getExtent());
+}
 
-    // Привязка буфера вершин
-    vk::Buffer     vertexBuffers[] = {*m_vkVertexBuffer};
-    vk::DeviceSize offsets[]       = {0};
-    commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
+void VulkanRenderer::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+{
+  // Начало записи команд в буфер
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 
-    // Отрисовка треугольника
-    commandBuffer.draw(static_cast<uint32_t>(m_vertices.size()), 1, 0, 0);
+  try
+  {
+    commandBuffer.begin(beginInfo);
 
-    // Завершение render pass
-    commandBuffer.endRenderPass();
+    // Проходы графа кадра с барьерами между ними
+    m_currentImageIndex = imageIndex;
+    m_renderGraph->setImportedImage(m_swapChainTarget, m_swapChain.getImages()[imageIndex],
+                                    m_swapChain.getImageViews()[imageIndex]);
+
+    // Сцена пишется в слот текущего кадра, показывается результат предыдущего
+    uint32_t slot     = static_cast<uint32_t>(m_currentFrame);
+    uint32_t prevSlot = (slot + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+    m_renderGraph->setImportedImage(m_sceneTarget, m_postProcess->getSceneImage(slot),
+                                    m_postProcess->getSceneView(slot));
+    m_renderGraph->setImportedImage(m_postOutputTarget, m_postProcess->getOutputImage(prevSlot),
+                                    m_postProcess->getOutputView(prevSlot));
+    if (m_hud)
+    {
+      m_hud->beginFrame(commandBuffer, slot);
+    }
+    m_renderGraph->execute(commandBuffer);
+    if (m_hud)
+    {
+      m_hud->endFrame(commandBuffer, slot);
+    }
 
     // Завершение записи команд
     commandBuffer.end();
@@ -0,0 +1,377 @@
+#include "VulkanSpriteBatch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "VulkanUtils.h"
+
+VulkanSpriteBatch::VulkanSpriteBatch(VulkanDevice& device, VulkanTextureManager& textures,
+                                     ThreadPool* pool, uint32_t maxSprites, uint32_t pageCount,
+                                     uint32_t framesInFlight)
+    : m_device(device),
+      m_textures(textures),
+      m_maxSprites(maxSprites),
+      m_pageCount(std::max(pageCount, 1u)),
+      m_framesInFlight(framesInFlight),
+      m_batcher(m_pageCount, pool)
+{
+  m_pages.assign(m_pageCount, 0);
+  m_pageAssigned.assign(m_pageCount, false);
+  m_setVersions.assign(static_cast<size_t>(m_framesInFlight) * m_pageCount, NOT_WRITTEN);
+}
+
+VulkanSpriteBatch::~VulkanSpriteBatch()
+{
+  cleanup();
+}
+
+int VulkanSpriteBatch::init(const ParticleRenderTarget& target, vk::CommandPool commandPool)
+{
+  try
+  {
+    createIndexBuffer(commandPool);
+    createVertexBuffer();
+    createDescriptorSets();
+    createPipeline(target);
+
+    std::cout << "Пакетная отрисовка спрайтов создана: до " << m_maxSprites
+              << " спрайтов на кадр, страниц атласа: " << m_pageCount << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanSpriteBatch: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanSpriteBatch::cleanup()
+{
+  m_vkPipeline.reset();
+  m_vkPipelineLayout.reset();
+  m_vkDescriptorSets.clear();
+  m_vkDescriptorPool.reset();
+  m_vkDescriptorSetLayout.reset();
+  if (m_pVertices)
+  {
+    m_device.getDevice().unmapMemory(*m_vkVertexMemory);
+    m_pVertices = nullptr;
+  }
+  m_vkVertexBuffer.reset();
+  m_vkVertexMemory.reset();
+  m_vkIndexBuffer.reset();
+  m_vkIndexMemory.reset();
+}
+
+void VulkanSpriteBatch::setPage(uint32_t page, TextureHandle texture)
+{
+  m_pages.at(page)        = texture;
+  m_pageAssigned.at(page) = true;
+
+  // Наборы всех слотов будут перезаписаны при следующем использовании
+  for (uint32_t slot = 0; slot < m_framesInFlight; slot++)
+  {
+    m_setVersions[slot * m_pageCount + page] = NOT_WRITTEN;
+  }
+}
+
+void VulkanSpriteBatch::createIndexBuffer(vk::CommandPool commandPool)
+{
+  vk::Device device = m_device.getDevice();
+
+  // Индексы одинаковы для всех пачек: пачка выбирает свои вершины через vertexOffset
+  std::vector<uint32_t> indices = SpriteBatcher::buildQuadIndices(m_maxSprites);
+  vk::DeviceSize        size    = sizeof(uint32_t) * indices.size();
+
+  vk::UniqueBuffer    stagingBuffer;
+  TrackedDeviceMemory stagingBufferMemory;
+  m_device.createBuffer(
+      size, vk::BufferUsageFlagBits::eTransferSrc,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      stagingBuffer, stagingBufferMemory, MemoryCategory::Staging);
+
+  void* data = device.mapMemory(*stagingBufferMemory, 0, size);
+  memcpy(data, indices.data(), static_cast<size_t>(size));
+  device.unmapMemory(*stagingBufferMemory);
+
+  m_device.createBuffer(
+      size, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+      vk::MemoryPropertyFlagBits::eDeviceLocal, m_vkIndexBuffer, m_vkIndexMemory);
+
+  vk::CommandBufferAllocateInfo cmdBufAllocInfo = {};
+  cmdBufAllocInfo.level                         = vk::CommandBufferLevel::ePrimary;
+  cmdBufAllocInfo.commandPool                   = commandPool;
+  cmdBufAllocInfo.commandBufferCount            = 1;
+
+  auto tempCommandBuffers = device.allocateCommandBuffersUnique(cmdBufAllocInfo);
+  vk::CommandBuffer cmd   = *tempCommandBuffers[0];
+
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  cmd.begin(beginInfo);
+  cmd.copyBuffer(*stagingBuffer, *m_vkIndexBuffer, vk::BufferCopy(0, 0, size));
+  cmd.end();
+
+  vk::SubmitInfo submitInfo     = {};
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers    = &cmd;
+  m_device.getGraphicsQueue().submit(submitInfo, nullptr);
+  m_device.getGraphicsQueue().waitIdle();
+}
+
+void VulkanSpriteBatch::createVertexBuffer()
+{
+  // Область на каждый кадр в обработке: CPU пишет слот, который GPU уже не читает
+  vk::DeviceSize size = static_cast<vk::DeviceSize>(m_maxSprites) * 4 * m_framesInFlight *
+                        sizeof(SpriteVertex);
+  m_device.createBuffer(
+      size, vk::BufferUsageFlagBits::eVertexBuffer,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      m_vkVertexBuffer, m_vkVertexMemory);
+
+  // Постоянное отображение на всё время жизни буфера
+  m_pVertices =
+      static_cast<SpriteVertex*>(m_device.getDevice().mapMemory(*m_vkVertexMemory, 0, size));
+}
+
+void VulkanSpriteBatch::createDescriptorSets()
+{
+  vk::Device device   = m_device.getDevice();
+  uint32_t   setCount = m_framesInFlight * m_pageCount;
+
+  vk::DescriptorSetLayoutBinding binding = {};
+  binding.binding                        = 0;
+  binding.descriptorType                 = vk::DescriptorType::eCombinedImageSampler;
+  binding.descriptorCount                = 1;
+  binding.stageFlags                     = vk::ShaderStageFlagBits::eFragment;
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
+  layoutInfo.bindingCount                      = 1;
+  layoutInfo.pBindings                         = &binding;
+  m_vkDescriptorSetLayout = device.createDescriptorSetLayoutUnique(layoutInfo);
+
+  vk::DescriptorPoolSize poolSize = {};
+  poolSize.type                   = vk::DescriptorType::eCombinedImageSampler;
+  poolSize.descriptorCount        = setCount;
+
+  vk::DescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.maxSets                      = setCount;
+  poolInfo.poolSizeCount                = 1;
+  poolInfo.pPoolSizes                   = &poolSize;
+  m_vkDescriptorPool                    = device.createDescriptorPoolUnique(poolInfo);
+
+  std::vector<vk::DescriptorSetLayout> setLayouts(setCount, *m_vkDescriptorSetLayout);
+  vk::DescriptorSetAllocateInfo        allocInfo = {};
+  allocInfo.descriptorPool                       = *m_vkDescriptorPool;
+  allocInfo.descriptorSetCount                   = setCount;
+  allocInfo.pSetLayouts                          = setLayouts.data();
+  m_vkDescriptorSets                             = device.allocateDescriptorSets(allocInfo);
+}
+
+void VulkanSpriteBatch::createPipeline(const ParticleRenderTarget& target)
+{
+  vk::Device device = m_device.getDevice();
+
+  auto vertShaderCode = VulkanUtils::loadShader("Learning/Shaders/sprite.vert.spv");
+  auto fragShaderCode = VulkanUtils::loadShader("Learning/Shaders/sprite.frag.spv");
+
+  vk::ShaderModuleCreateInfo vertModuleInfo = {};
+  vertModuleInfo.codeSize                   = vertShaderCode.size();
+  vertModuleInfo.pCode = reinterpret_cast<const uint32_t*>(vertShaderCode.data());
+  vk::ShaderModuleCreateInfo fragModuleInfo = {};
+  fragModuleInfo.codeSize                   = fragShaderCode.size();
+  fragModuleInfo.pCode = reinterpret_cast<const uint32_t*>(fragShaderCode.data());
+
+  vk::UniqueShaderModule vertShaderModule = device.createShaderModuleUnique(vertModuleInfo);
+  vk::UniqueShaderModule fragShaderModule = device.createShaderModuleUnique(fragModuleInfo);
+
+  std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = {};
+  shaderStages[0].stage  = vk::ShaderStageFlagBits::eVertex;
+  shaderStages[0].module = *vertShaderModule;
+  shaderStages[0].pName  = "main";
+  shaderStages[1].stage  = vk::ShaderStageFlagBits::eFragment;
+  shaderStages[1].module = *fragShaderModule;
+  shaderStages[1].pName  = "main";
+
+  // Положение в NDC, координаты атласа в unorm16 и цвет RGBA8 - 16 байт на вершину
+  vk::VertexInputBindingDescription bindingDescription = {};
+  bindingDescription.binding                           = 0;
+  bindingDescription.stride                            = sizeof(SpriteVertex);
+  bindingDescription.inputRate                         = vk::VertexInputRate::eVertex;
+
+  std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions = {};
+  attributeDescriptions[0].location = 0;
+  attributeDescriptions[0].format   = vk::Format::eR32G32Sfloat;
+  attributeDescriptions[0].offset   = offsetof(SpriteVertex, position);
+  attributeDescriptions[1].location = 1;
+  attributeDescriptions[1].format   = vk::Format::eR16G16Unorm;
+  attributeDescriptions[1].offset   = offsetof(SpriteVertex, uv);
+  attributeDescriptions[2].location = 2;
+  attributeDescriptions[2].format   = vk::Format::eR8G8B8A8Unorm;
+  attributeDescriptions[2].offset   = offsetof(SpriteVertex, color);
+
+  vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
+  vertexInputInfo.vertexBindingDescriptionCount          = 1;
+  vertexInputInfo.pVertexBindingDescriptions             = &bindingDescription;
+  vertexInputInfo.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(attributeDescriptions.size());
+  vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+  vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.topology                                 = vk::PrimitiveTopology::eTriangleList;
+
+  // Вьюпорт и ножницы выставляет основной проход рендерера
+  vk::PipelineViewportStateCreateInfo viewportState = {};
+  viewportState.viewportCount                       = 1;
+  viewportState.scissorCount                        = 1;
+
+  vk::DynamicState                   dynamicStates[] = {vk::DynamicState::eViewport,
+                                                        vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState    = {};
+  dynamicState.dynamicStateCount                     = 2;
+  dynamicState.pDynamicStates                        = dynamicStates;
+
+  vk::PipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.polygonMode                              = vk::PolygonMode::eFill;
+  rasterizer.lineWidth                                = 1.0f;
+  rasterizer.cullMode                                 = vk::CullModeFlagBits::eNone;
+
+  vk::PipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.rasterizationSamples                   = target.samples;
+
+  // Спрайты - плоский слой поверх сцены: глубина не проверяется и не пишется
+  vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
+  depthStencil.depthTestEnable                         = VK_FALSE;
+  depthStencil.depthWriteEnable                        = VK_FALSE;
+
+  vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
+  colorBlendAttachment.colorWriteMask =
+      vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+      vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+  colorBlendAttachment.blendEnable         = VK_TRUE;
+  colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+  colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+  colorBlendAttachment.colorBlendOp        = vk::BlendOp::eAdd;
+  colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+  colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+  colorBlendAttachment.alphaBlendOp        = vk::BlendOp::eAdd;
+
+  vk::PipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.attachmentCount                       = 1;
+  colorBlending.pAttachments                          = &colorBlendAttachment;
+
+  vk::DescriptorSetLayout      setLayout  = *m_vkDescriptorSetLayout;
+  vk::PipelineLayoutCreateInfo layoutInfo = {};
+  layoutInfo.setLayoutCount               = 1;
+  layoutInfo.pSetLayouts                  = &setLayout;
+  m_vkPipelineLayout                      = device.createPipelineLayoutUnique(layoutInfo);
+
+  vk::PipelineRenderingCreateInfo renderingInfo = {};
+  renderingInfo.colorAttachmentCount            = 1;
+  renderingInfo.pColorAttachmentFormats         = &target.colorFormat;
+  renderingInfo.depthAttachmentFormat           = target.depthFormat;
+
+  vk::GraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.pNext                          = target.renderPass ? nullptr : &renderingInfo;
+  pipelineInfo.stageCount                     = static_cast<uint32_t>(shaderStages.size());
+  pipelineInfo.pStages                        = shaderStages.data();
+  pipelineInfo.pVertexInputState              = &vertexInputInfo;
+  pipelineInfo.pInputAssemblyState            = &inputAssembly;
+  pipelineInfo.pViewportState                 = &viewportState;
+  pipelineInfo.pRasterizationState            = &rasterizer;
+  pipelineInfo.pMultisampleState              = &multisampling;
+  pipelineInfo.pDepthStencilState             = &depthStencil;
+  pipelineInfo.pColorBlendState               = &colorBlending;
+  pipelineInfo.pDynamicState                  = &dynamicState;
+  pipelineInfo.layout                         = *m_vkPipelineLayout;
+  pipelineInfo.renderPass                     = target.renderPass;
+  pipelineInfo.subpass                        = 0;
+
+  try
+  {
+    auto result  = device.createGraphicsPipelineUnique(nullptr, pipelineInfo);
+    m_vkPipeline = std::move(result.value);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать конвейер спрайтов: " + std::string(e.what()));
+  }
+}
+
+vk::DescriptorSet VulkanSpriteBatch::getPageSet(uint32_t frameSlot, uint32_t page)
+{
+  size_t            index   = static_cast<size_t>(frameSlot) * m_pageCount + page;
+  vk::DescriptorSet set     = m_vkDescriptorSets[index];
+  uint32_t          version = m_textures.getVersion(m_pages[page]);
+
+  // Набор слота читал только завершённый кадр этого слота, поэтому его можно перезаписать
+  if (m_setVersions[index] != version)
+  {
+    vk::DescriptorImageInfo imageInfo = m_textures.getDescriptorInfo(m_pages[page]);
+
+    vk::WriteDescriptorSet write = {};
+    write.dstSet                 = set;
+    write.dstBinding             = 0;
+    write.descriptorCount        = 1;
+    write.descriptorType         = vk::DescriptorType::eCombinedImageSampler;
+    write.pImageInfo             = &imageInfo;
+    m_device.getDevice().updateDescriptorSets(write, nullptr);
+    m_setVersions[index] = version;
+  }
+  return set;
+}
+
+void VulkanSpriteBatch::submit(uint32_t frameSlot, vk::Extent2D extent, VulkanRenderQueue& queue)
+{
+  m_batchCount       = 0;
+  m_submittedSprites = 0;
+  if (m_batcher.getSpriteCount() == 0)
+  {
+    return;
+  }
+
+  // Страницы запрашиваются в полном размере цели: так поток текстур держит верхний уровень
+  float screenSize = static_cast<float>(std::max(extent.width, extent.height));
+  for (uint32_t page = 0; page < m_pageCount; page++)
+  {
+    if (m_pageAssigned[page])
+    {
+      m_textures.requestScreenSize(m_pages[page], screenSize);
+    }
+  }
+
+  // Вершины слота пишутся сразу в отображённую память, пачки становятся пакетами очереди
+  size_t slotVertices = static_cast<size_t>(m_maxSprites) * 4;
+  m_batcher.setViewport(static_cast<float>(extent.width), static_cast<float>(extent.height));
+  const std::vector<SpriteBatch>& batches =
+      m_batcher.build(m_pVertices + frameSlot * slotVertices, m_maxSprites);
+
+  for (const SpriteBatch& batch : batches)
+  {
+    if (!m_pageAssigned[batch.page] || !m_textures.isResident(m_pages[batch.page]))
+    {
+      continue;
+    }
+
+    // Прозрачный проход после частиц; внутри прохода пачки идут по страницам
+    DrawPacket packet     = {};
+    packet.key            = RenderKey::makeTransparent(2, 2, batch.page, 0.0f, 0);
+    packet.pipeline       = *m_vkPipeline;
+    packet.pipelineLayout = *m_vkPipelineLayout;
+    packet.descriptorSet  = getPageSet(frameSlot, batch.page);
+    packet.vertexBuffer   = *m_vkVertexBuffer;
+    packet.indexBuffer    = *m_vkIndexBuffer;
+    packet.count          = batch.quadCount * 6;
+    packet.firstVertex    = 0;
+    packet.vertexOffset =
+        static_cast<int32_t>(frameSlot * slotVertices + static_cast<size_t>(batch.firstQuad) * 4);
+    queue.push(packet);
+
+    m_batchCount++;
+    m_submittedSprites += batch.quadCount;
+  }
+}
@@ -83,7 +83,8 @@ void VulkanSwapChain::createSwapChain()
   createInfo.imageColorSpace            = surfaceFormat.colorSpace;
   createInfo.imageExtent                = extent;
   createInfo.imageArrayLayers           = 1;
-  createInfo.imageUsage                 = vk::ImageUsageFlagBits::eColorAttachment;
+  createInfo.imageUsage                 = vk::ImageUsageFlagBits::eColorAttachment |
+                          vk::ImageUsageFlagBits::eTransferDst;  // Цель blit постобработки
 
   // Указание режима использования изображений из разных семейств очередей
   QueueFamilyIndices indices    = m_device.getQueueFamilyIndices();
@@ -228,9 +229,13 @@ vk::Extent2D VulkanSwapChain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR&
   }
   else
   {
-    // Получение фактических размеров окна
-    int width, height;
-    SDL_GetWindowSize(m_pWindow, &width, &height);
+    // Получение фактических размеров окна (без окна, например на headless-поверхности,
+    // используется размер по умолчанию)
+    int width = DEFAULT_WIDTH, height = DEFAULT_HEIGHT;
+    if (m_pWindow)
+    {
+      SDL_GetWindowSize(m_pWindow, &width, &height);
+    }
 
     vk::Extent2D actualExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
 
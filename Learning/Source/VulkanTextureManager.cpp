@@ -0,0 +1,606 @@
+#include "VulkanTextureManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+  // Размер мип-уровня по одной оси
+  uint32_t mipDimension(uint32_t size, uint32_t level) { return std::max(1u, size >> level); }
+
+  // Уменьшение RGBA8 изображения в два раза (box-фильтр)
+  std::vector<uint8_t> downsampleRgba8(const std::vector<uint8_t>& src, uint32_t width,
+                                       uint32_t height)
+  {
+    uint32_t             dstWidth  = std::max(1u, width / 2);
+    uint32_t             dstHeight = std::max(1u, height / 2);
+    std::vector<uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+    for (uint32_t y = 0; y < dstHeight; y++)
+    {
+      uint32_t y0 = std::min(y * 2, height - 1);
+      uint32_t y1 = std::min(y * 2 + 1, height - 1);
+      for (uint32_t x = 0; x < dstWidth; x++)
+      {
+        uint32_t x0 = std::min(x * 2, width - 1);
+        uint32_t x1 = std::min(x * 2 + 1, width - 1);
+        for (uint32_t c = 0; c < 4; c++)
+        {
+          uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+                         src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+          dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+        }
+      }
+    }
+
+    return dst;
+  }
+}  // namespace
+
+VulkanTextureManager::VulkanTextureManager(VulkanDevice& device, uint32_t framesInFlight,
+                                           vk::DeviceSize budgetBytes)
+    : m_device(device), m_framesInFlight(framesInFlight), m_budgetBytes(budgetBytes)
+{
+}
+
+VulkanTextureManager::~VulkanTextureManager()
+{
+  // Очистка ресурсов
+  cleanup();
+}
+
+int VulkanTextureManager::init()
+{
+  try
+  {
+    // Формат должен поддерживать линейный blit для генерации мип-уровней
+    vk::FormatProperties formatProperties =
+        m_device.getPhysicalDevice().getFormatProperties(TEXTURE_FORMAT);
+    if (!(formatProperties.optimalTilingFeatures &
+          vk::FormatFeatureFlagBits::eSampledImageFilterLinear))
+    {
+      throw std::runtime_error("Формат текстур не поддерживает линейный blit");
+    }
+
+    createSampler();
+
+    std::cout << "VulkanTextureManager инициализирован успешно! Бюджет: "
+              << (m_budgetBytes >> 20) << " МБ" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanTextureManager: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanTextureManager::cleanup()
+{
+  // Изображения освобождаются через RAII, GPU к этому моменту уже простаивает
+  m_textures.clear();
+  m_residentBytes = 0;
+}
+
+void VulkanTextureManager::createSampler()
+{
+  // Трилинейная фильтрация, диапазон уровней ограничивается image view
+  vk::SamplerCreateInfo samplerInfo = {};
+  samplerInfo.magFilter             = vk::Filter::eLinear;
+  samplerInfo.minFilter             = vk::Filter::eLinear;
+  samplerInfo.mipmapMode            = vk::SamplerMipmapMode::eLinear;
+  samplerInfo.addressModeU          = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.addressModeV          = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.addressModeW          = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.minLod                = 0.0f;
+  samplerInfo.maxLod                = VK_LOD_CLAMP_NONE;
+
+  try
+  {
+    m_vkSampler = m_device.getDevice().createSamplerUnique(samplerInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать сэмплер: " + std::string(e.what()));
+  }
+}
+
+TextureHandle VulkanTextureManager::createTexture(uint32_t width, uint32_t height,
+                                                  TextureMipLoader loader)
+{
+  if (width == 0 || height == 0)
+  {
+    throw std::invalid_argument("Размер текстуры должен быть ненулевым");
+  }
+
+  Texture texture;
+  texture.width  = width;
+  texture.height = height;
+  texture.loader = std::move(loader);
+
+  // Число уровней - номер старшего бита большей стороны, плюс один
+  texture.mipCount = 0;
+  for (uint32_t size = std::max(width, height); size > 0; size >>= 1)
+  {
+    texture.mipCount++;
+  }
+
+  // Загрузка начинается с уровня, который не больше TAIL_SIZE
+  texture.tailMip = 0;
+  while (texture.tailMip + 1 < texture.mipCount &&
+         std::max(mipDimension(width, texture.tailMip), mipDimension(height, texture.tailMip)) >
+             TAIL_SIZE)
+  {
+    texture.tailMip++;
+  }
+
+  texture.residentMip   = texture.mipCount;
+  texture.desiredMip    = texture.tailMip;
+  texture.lastUsedFrame = m_frameNumber;
+
+  m_textures.push_back(std::move(texture));
+  return static_cast<TextureHandle>(m_textures.size() - 1);
+}
+
+TextureHandle VulkanTextureManager::createTextureFromPixels(uint32_t width, uint32_t height,
+                                                            std::vector<uint8_t> pixels)
+{
+  if (pixels.size() != static_cast<size_t>(width) * height * 4)
+  {
+    throw std::runtime_error("Размер пикселей не соответствует размеру RGBA8 текстуры");
+  }
+
+  auto source = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+  return createTexture(width, height,
+                       [source, width, height](uint32_t mipLevel, uint32_t, uint32_t)
+                       {
+                         // Последовательное уменьшение нулевого уровня до нужного
+                         std::vector<uint8_t> level = *source;
+                         for (uint32_t i = 0; i < mipLevel; i++)
+                         {
+                           level = downsampleRgba8(level, mipDimension(width, i),
+                                                   mipDimension(height, i));
+                         }
+                         return level;
+                       });
+}
+
+void VulkanTextureManager::requestScreenSize(TextureHandle handle, float screenSizePixels)
+{
+  Texture& texture      = m_textures.at(handle);
+  texture.lastUsedFrame = m_frameNumber;
+
+  // Уровень, у которого на один тексель приходится примерно один пиксель экрана
+  float    texels  = static_cast<float>(std::max(texture.width, texture.height));
+  float    ratio   = texels / std::max(screenSizePixels, 1.0f);
+  uint32_t desired = ratio > 1.0f ? static_cast<uint32_t>(std::floor(std::log2(ratio))) : 0;
+  texture.desiredMip = std::min(desired, texture.tailMip);
+}
+
+bool VulkanTextureManager::isResident(TextureHandle handle) const
+{
+  const Texture& texture = m_textures.at(handle);
+  return texture.residentMip < texture.mipCount;
+}
+
+vk::DescriptorImageInfo VulkanTextureManager::getDescriptorInfo(TextureHandle handle) const
+{
+  vk::DescriptorImageInfo imageInfo = {};
+  imageInfo.sampler                 = *m_vkSampler;
+  imageInfo.imageView               = *m_textures.at(handle).gpu.view;
+  imageInfo.imageLayout             = vk::ImageLayout::eShaderReadOnlyOptimal;
+  return imageInfo;
+}
+
+uint32_t VulkanTextureManager::getVersion(TextureHandle handle) const
+{
+  return m_textures.at(handle).version;
+}
+
+vk::CommandBuffer VulkanTextureManager::update(VulkanFrameContext& frame, uint64_t frameNumber)
+{
+  m_frameNumber   = frameNumber;
+  m_uploadedBytes = 0;
+  m_pFrame        = &frame;
+
+  // Кандидаты на повышение детализации: недавно использованные, с нехваткой уровней.
+  // Список живёт до конца кадра, поэтому берётся из его арены, а не из кучи
+  ArenaVector<Texture*> pending{ArenaAllocator<Texture*>(frame.getArena())};
+  pending.reserve(m_textures.size());
+  bool hasWork = m_residentBytes > m_budgetBytes;
+  for (auto& texture : m_textures)
+  {
+    if (texture.residentMip == texture.mipCount)
+    {
+      hasWork = true;
+    }
+    else if (texture.desiredMip < texture.residentMip &&
+             texture.lastUsedFrame + m_framesInFlight >= frameNumber)
+    {
+      pending.push_back(&texture);
+    }
+  }
+
+  if (!hasWork && pending.empty())
+  {
+    return nullptr;
+  }
+
+  // Буфер сброшен вместе с пулом кадра в VulkanFrameContext::begin()
+  vk::CommandBuffer cmd = frame.getUploadCommandBuffer();
+
+  vk::CommandBufferBeginInfo beginInfo = {};
+  beginInfo.flags                      = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  cmd.begin(beginInfo);
+
+  // Бюджет мог уменьшиться: вытесняем до попадания в него
+  makeRoom(cmd, 0, std::numeric_limits<uint64_t>::max());
+
+  // Новые текстуры сразу получают хвост мип-цепочки
+  uint32_t steps = 0;
+  for (auto& texture : m_textures)
+  {
+    if (texture.residentMip == texture.mipCount && steps < MAX_STEPS_PER_FRAME)
+    {
+      // Без места текстура остаётся незагруженной и ждёт следующего кадра
+      if (!makeRoom(cmd, estimateBytes(texture, texture.tailMip), texture.lastUsedFrame))
+      {
+        continue;
+      }
+      loadTail(cmd, texture);
+      steps++;
+    }
+  }
+
+  // Сначала самые свежие текстуры с наибольшей нехваткой детализации
+  std::sort(pending.begin(), pending.end(),
+            [](const Texture* a, const Texture* b)
+            {
+              if (a->lastUsedFrame != b->lastUsedFrame)
+              {
+                return a->lastUsedFrame > b->lastUsedFrame;
+              }
+              return a->residentMip - a->desiredMip > b->residentMip - b->desiredMip;
+            });
+
+  for (Texture* texture : pending)
+  {
+    if (steps >= MAX_STEPS_PER_FRAME)
+    {
+      break;
+    }
+
+    vk::DeviceSize extra = estimateBytes(*texture, texture->residentMip - 1) -
+                           estimateBytes(*texture, texture->residentMip);
+    if (!makeRoom(cmd, extra, texture->lastUsedFrame))
+    {
+      continue;
+    }
+
+    stepUp(cmd, *texture);
+    steps++;
+  }
+
+  cmd.end();
+  return cmd;
+}
+
+vk::DeviceSize VulkanTextureManager::estimateBytes(const Texture& texture, uint32_t baseMip) const
+{
+  vk::DeviceSize bytes = 0;
+  for (uint32_t level = baseMip; level < texture.mipCount; level++)
+  {
+    bytes += static_cast<vk::DeviceSize>(mipDimension(texture.width, level)) *
+             mipDimension(texture.height, level) * 4;
+  }
+  return bytes;
+}
+
+bool VulkanTextureManager::makeRoom(vk::CommandBuffer cmd, vk::DeviceSize bytes,
+                                    uint64_t protectedFrame)
+{
+  while (m_residentBytes + bytes > m_budgetBytes)
+  {
+    // Жертва - самая давно использованная текстура старше protectedFrame,
+    // у которой есть уровни выше хвоста
+    Texture* victim = nullptr;
+    for (auto& texture : m_textures)
+    {
+      if (texture.residentMip >= texture.tailMip || texture.lastUsedFrame >= protectedFrame)
+      {
+        continue;
+      }
+      if (!victim || texture.lastUsedFrame < victim->lastUsedFrame)
+      {
+        victim = &texture;
+      }
+    }
+
+    if (!victim)
+    {
+      return false;
+    }
+
+    dropTop(cmd, *victim);
+  }
+
+  return true;
+}
+
+VulkanTextureManager::GpuImage VulkanTextureManager::createGpuImage(uint32_t width,
+                                                                    uint32_t height,
+                                                                    uint32_t levels)
+{
+  GpuImage gpuImage;
+  gpuImage.levels = levels;
+
+  vk::ImageCreateInfo imageInfo = {};
+  imageInfo.imageType           = vk::ImageType::e2D;
+  imageInfo.format              = TEXTURE_FORMAT;
+  imageInfo.extent              = vk::Extent3D{width, height, 1};
+  imageInfo.mipLevels           = levels;
+  imageInfo.arrayLayers         = 1;
+  imageInfo.samples             = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling              = vk::ImageTiling::eOptimal;
+  imageInfo.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc |
+                    vk::ImageUsageFlagBits::eTransferDst;
+  imageInfo.sharingMode   = vk::SharingMode::eExclusive;
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+
+  try
+  {
+    gpuImage.image = m_device.getDevice().createImageUnique(imageInfo);
+
+    // Выделение памяти под изображение
+    vk::MemoryRequirements memRequirements =
+        m_device.getDevice().getImageMemoryRequirements(*gpuImage.image);
+
+    vk::MemoryAllocateInfo allocInfo = {};
+    allocInfo.allocationSize         = memRequirements.size;
+    allocInfo.memoryTypeIndex        = m_device.findMemoryType(
+        memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    gpuImage.memory = m_device.allocateMemory(allocInfo, MemoryCategory::Image);
+    gpuImage.size   = memRequirements.size;
+    m_device.getDevice().bindImageMemory(*gpuImage.image, *gpuImage.memory, 0);
+
+    // Image view на все резидентные уровни
+    vk::ImageViewCreateInfo viewInfo         = {};
+    viewInfo.image                           = *gpuImage.image;
+    viewInfo.viewType                        = vk::ImageViewType::e2D;
+    viewInfo.format                          = TEXTURE_FORMAT;
+    viewInfo.subresourceRange.aspectMask     = vk::ImageAspectFlagBits::eColor;
+    viewInfo.subresourceRange.baseMipLevel   = 0;
+    viewInfo.subresourceRange.levelCount     = levels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount     = 1;
+
+    gpuImage.view = m_device.getDevice().createImageViewUnique(viewInfo);
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать изображение текстуры: " + std::string(e.what()));
+  }
+
+  return gpuImage;
+}
+
+void VulkanTextureManager::loadTail(vk::CommandBuffer cmd, Texture& texture)
+{
+  uint32_t width  = mipDimension(texture.width, texture.tailMip);
+  uint32_t height = mipDimension(texture.height, texture.tailMip);
+  uint32_t levels = texture.mipCount - texture.tailMip;
+
+  GpuImage image = createGpuImage(width, height, levels);
+  transitionImage(cmd, *image.image, vk::ImageLayout::eUndefined,
+                  vk::ImageLayout::eTransferDstOptimal, 0, levels,
+                  vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eTransfer,
+                  vk::AccessFlagBits::eTransferWrite);
+
+  // Верхний уровень хвоста из загрузчика, остальные - blit-цепочкой на GPU
+  uploadLevel(cmd, texture, texture.tailMip, *image.image);
+  generateMipChain(cmd, *image.image, width, height, levels);
+
+  replaceImage(texture, std::move(image), texture.tailMip);
+}
+
+void VulkanTextureManager::stepUp(vk::CommandBuffer cmd, Texture& texture)
+{
+  uint32_t newBase = texture.residentMip - 1;
+  uint32_t width   = mipDimension(texture.width, newBase);
+  uint32_t height  = mipDimension(texture.height, newBase);
+  uint32_t levels  = texture.mipCount - newBase;
+
+  GpuImage image = createGpuImage(width, height, levels);
+  transitionImage(cmd, *image.image, vk::ImageLayout::eUndefined,
+                  vk::ImageLayout::eTransferDstOptimal, 0, levels,
+                  vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eTransfer,
+                  vk::AccessFlagBits::eTransferWrite);
+
+  // Новый верхний уровень загружается, уже резидентные копируются без пересчёта
+  uploadLevel(cmd, texture, newBase, *image.image);
+
+  transitionImage(cmd, *texture.gpu.image, vk::ImageLayout::eShaderReadOnlyOptimal,
+                  vk::ImageLayout::eTransferSrcOptimal, 0, texture.gpu.levels,
+                  vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead,
+                  vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+  copyLevels(cmd, *texture.gpu.image, 0, *image.image, 1, texture.gpu.levels,
+             mipDimension(texture.width, texture.residentMip),
+             mipDimension(texture.height, texture.residentMip));
+
+  transitionImage(cmd, *image.image, vk::ImageLayout::eTransferDstOptimal,
+                  vk::ImageLayout::eShaderReadOnlyOptimal, 0, levels,
+                  vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite,
+                  vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+
+  replaceImage(texture, std::move(image), newBase);
+}
+
+void VulkanTextureManager::dropTop(vk::CommandBuffer cmd, Texture& texture)
+{
+  uint32_t newBase = texture.residentMip + 1;
+  uint32_t width   = mipDimension(texture.width, newBase);
+  uint32_t height  = mipDimension(texture.height, newBase);
+  uint32_t levels  = texture.mipCount - newBase;
+
+  GpuImage image = createGpuImage(width, height, levels);
+  transitionImage(cmd, *image.image, vk::ImageLayout::eUndefined,
+                  vk::ImageLayout::eTransferDstOptimal, 0, levels,
+                  vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eTransfer,
+                  vk::AccessFlagBits::eTransferWrite);
+
+  // Все уровни, кроме верхнего, переезжают в изображение меньшего размера
+  transitionImage(cmd, *texture.gpu.image, vk::ImageLayout::eShaderReadOnlyOptimal,
+                  vk::ImageLayout::eTransferSrcOptimal, 0, texture.gpu.levels,
+                  vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead,
+                  vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+  copyLevels(cmd, *texture.gpu.image, 1, *image.image, 0, levels, width, height);
+
+  transitionImage(cmd, *image.image, vk::ImageLayout::eTransferDstOptimal,
+                  vk::ImageLayout::eShaderReadOnlyOptimal, 0, levels,
+                  vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite,
+                  vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+
+  replaceImage(texture, std::move(image), newBase);
+}
+
+void VulkanTextureManager::replaceImage(Texture& texture, GpuImage image, uint32_t residentMip)
+{
+  // Старое изображение может читаться кадрами в обработке - удаляем его позже
+  if (texture.gpu.image)
+  {
+    m_residentBytes -= texture.gpu.size;
+    m_pFrame->retire(std::move(texture.gpu));
+  }
+
+  m_residentBytes += image.size;
+  texture.gpu         = std::move(image);
+  texture.residentMip = residentMip;
+  texture.version++;
+}
+
+void VulkanTextureManager::uploadLevel(vk::CommandBuffer cmd, Texture& texture, uint32_t mipLevel,
+                                       vk::Image dstImage)
+{
+  uint32_t width  = mipDimension(texture.width, mipLevel);
+  uint32_t height = mipDimension(texture.height, mipLevel);
+
+  std::vector<uint8_t> pixels = texture.loader(mipLevel, width, height);
+  if (pixels.size() != static_cast<size_t>(width) * height * 4)
+  {
+    throw std::runtime_error("Загрузчик вернул уровень текстуры неверного размера");
+  }
+
+  // Стадийный буфер живёт до завершения кадра на GPU
+  vk::UniqueBuffer    stagingBuffer;
+  TrackedDeviceMemory stagingMemory;
+  m_device.createBuffer(
+      pixels.size(), vk::BufferUsageFlagBits::eTransferSrc,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      stagingBuffer, stagingMemory, MemoryCategory::Staging);
+
+  void* data = m_device.getDevice().mapMemory(*stagingMemory, 0, pixels.size());
+  memcpy(data, pixels.data(), pixels.size());
+  m_device.getDevice().unmapMemory(*stagingMemory);
+  m_uploadedBytes += pixels.size();
+
+  // Копирование в нулевой уровень изображения
+  vk::BufferImageCopy region             = {};
+  region.imageSubresource.aspectMask     = vk::ImageAspectFlagBits::eColor;
+  region.imageSubresource.mipLevel       = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount     = 1;
+  region.imageExtent                     = vk::Extent3D{width, height, 1};
+
+  cmd.copyBufferToImage(*stagingBuffer, dstImage, vk::ImageLayout::eTransferDstOptimal, region);
+
+  // Буфер освобождается раньше памяти, к которой он привязан
+  m_pFrame->retire(std::move(stagingBuffer));
+  m_pFrame->retire(std::move(stagingMemory));
+}
+
+void VulkanTextureManager::copyLevels(vk::CommandBuffer cmd, vk::Image srcImage,
+                                      uint32_t srcBaseLevel, vk::Image dstImage,
+                                      uint32_t dstBaseLevel, uint32_t levelCount, uint32_t width,
+                                      uint32_t height)
+{
+  ArenaVector<vk::ImageCopy> regions(levelCount,
+                                     ArenaAllocator<vk::ImageCopy>(m_pFrame->getArena()));
+  for (uint32_t i = 0; i < levelCount; i++)
+  {
+    regions[i].srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor,
+                                                           srcBaseLevel + i, 0, 1);
+    regions[i].dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor,
+                                                           dstBaseLevel + i, 0, 1);
+    regions[i].extent = vk::Extent3D{mipDimension(width, i), mipDimension(height, i), 1};
+  }
+
+  cmd.copyImage(srcImage, vk::ImageLayout::eTransferSrcOptimal, dstImage,
+                vk::ImageLayout::eTransferDstOptimal, regions);
+}
+
+void VulkanTextureManager::generateMipChain(vk::CommandBuffer cmd, vk::Image image, uint32_t width,
+                                            uint32_t height, uint32_t levels)
+{
+  // Каждый уровень получается линейным blit из предыдущего
+  for (uint32_t level = 1; level < levels; level++)
+  {
+    transitionImage(cmd, image, vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eTransferSrcOptimal, level - 1, 1,
+                    vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite,
+                    vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+
+    vk::ImageBlit blit  = {};
+    blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1,
+                                                     0, 1);
+    blit.srcOffsets[1]  = vk::Offset3D{static_cast<int32_t>(mipDimension(width, level - 1)),
+                                      static_cast<int32_t>(mipDimension(height, level - 1)), 1};
+    blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1);
+    blit.dstOffsets[1]  = vk::Offset3D{static_cast<int32_t>(mipDimension(width, level)),
+                                      static_cast<int32_t>(mipDimension(height, level)), 1};
+
+    cmd.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image,
+                  vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+    transitionImage(cmd, image, vk::ImageLayout::eTransferSrcOptimal,
+                    vk::ImageLayout::eShaderReadOnlyOptimal, level - 1, 1,
+                    vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead,
+                    vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+  }
+
+  // Последний уровень только записывался
+  transitionImage(cmd, image, vk::ImageLayout::eTransferDstOptimal,
+                  vk::ImageLayout::eShaderReadOnlyOptimal, levels - 1, 1,
+                  vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite,
+                  vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+}
+
+void VulkanTextureManager::transitionImage(vk::CommandBuffer cmd, vk::Image image,
+                                           vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                                           uint32_t baseLevel, uint32_t levelCount,
+                                           vk::PipelineStageFlags srcStage,
+                                           vk::AccessFlags        srcAccess,
+                                           vk::PipelineStageFlags dstStage,
+                                           vk::AccessFlags        dstAccess)
+{
+  vk::ImageMemoryBarrier barrier          = {};
+  barrier.oldLayout                       = oldLayout;
+  barrier.newLayout                       = newLayout;
+  barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image                           = image;
+  barrier.subresourceRange.aspectMask     = vk::ImageAspectFlagBits::eColor;
+  barrier.subresourceRange.baseMipLevel   = baseLevel;
+  barrier.subresourceRange.levelCount     = levelCount;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount     = 1;
+  barrier.srcAccessMask                   = srcAccess;
+  barrier.dstAccessMask                   = dstAccess;
+
+  cmd.pipelineBarrier(srcStage, dstStage, {}, nullptr, nullptr, barrier);
+}
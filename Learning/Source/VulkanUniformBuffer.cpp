@@ -0,0 +1,130 @@
+#include "VulkanUniformBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+VulkanUniformBuffer::VulkanUniformBuffer(VulkanDevice& device, uint32_t framesInFlight,
+                                         vk::DeviceSize bytesPerFrame)
+    : m_device(device), m_framesInFlight(framesInFlight), m_bytesPerFrame(bytesPerFrame)
+{
+}
+
+VulkanUniformBuffer::~VulkanUniformBuffer()
+{
+  // Очистка ресурсов
+  cleanup();
+}
+
+int VulkanUniformBuffer::init()
+{
+  try
+  {
+    createBuffer();
+    createDescriptorSet();
+
+    std::cout << "VulkanUniformBuffer инициализирован успешно! Выравнивание: " << m_alignment
+              << " байт" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Ошибка при инициализации VulkanUniformBuffer: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void VulkanUniformBuffer::cleanup()
+{
+  // Память остаётся отображённой до освобождения, vkFreeMemory снимает отображение сам
+  m_pMapped = nullptr;
+}
+
+void VulkanUniformBuffer::createBuffer()
+{
+  // Смещения динамических дескрипторов должны быть кратны этому значению
+  vk::PhysicalDeviceProperties properties = m_device.getPhysicalDevice().getProperties();
+  m_alignment = std::max<vk::DeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 16);
+
+  // Область кадра округляется, чтобы каждая начиналась с выровненного смещения
+  m_bytesPerFrame = (m_bytesPerFrame + m_alignment - 1) & ~(m_alignment - 1);
+
+  m_device.createBuffer(
+      m_bytesPerFrame * m_framesInFlight, vk::BufferUsageFlagBits::eUniformBuffer,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      m_vkBuffer, m_vkMemory);
+
+  // Постоянное отображение на всё время жизни буфера
+  m_pMapped = static_cast<uint8_t*>(
+      m_device.getDevice().mapMemory(*m_vkMemory, 0, m_bytesPerFrame * m_framesInFlight));
+}
+
+void VulkanUniformBuffer::createDescriptorSet()
+{
+  // Два динамических uniform-буфера: константы кадра и константы объекта
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {};
+  bindings[0].binding                                    = 0;
+  bindings[0].descriptorType  = vk::DescriptorType::eUniformBufferDynamic;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+  bindings[1].binding         = 1;
+  bindings[1].descriptorType  = vk::DescriptorType::eUniformBufferDynamic;
+  bindings[1].descriptorCount = 1;
+  bindings[1].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
+  layoutInfo.bindingCount                      = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings                         = bindings.data();
+
+  vk::DescriptorPoolSize poolSize = {};
+  poolSize.type                   = vk::DescriptorType::eUniformBufferDynamic;
+  poolSize.descriptorCount        = static_cast<uint32_t>(bindings.size());
+
+  vk::DescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.maxSets                      = 1;
+  poolInfo.poolSizeCount                = 1;
+  poolInfo.pPoolSizes                   = &poolSize;
+
+  try
+  {
+    m_vkDescriptorSetLayout = m_device.getDevice().createDescriptorSetLayoutUnique(layoutInfo);
+    m_vkDescriptorPool      = m_device.getDevice().createDescriptorPoolUnique(poolInfo);
+
+    vk::DescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.descriptorPool                = *m_vkDescriptorPool;
+    allocInfo.descriptorSetCount            = 1;
+    allocInfo.pSetLayouts                   = &*m_vkDescriptorSetLayout;
+    m_vkDescriptorSet = m_device.getDevice().allocateDescriptorSets(allocInfo)[0];
+  }
+  catch (const vk::SystemError& e)
+  {
+    throw std::runtime_error("Не удалось создать дескрипторы uniform-буфера: " +
+                             std::string(e.what()));
+  }
+
+  // Оба дескриптора смотрят в начало буфера, реальное положение задают динамические смещения
+  vk::DescriptorBufferInfo frameInfo  = {*m_vkBuffer, 0, sizeof(FrameConstants)};
+  vk::DescriptorBufferInfo objectInfo = {*m_vkBuffer, 0, sizeof(ObjectConstants)};
+
+  std::array<vk::WriteDescriptorSet, 2> writes = {};
+  writes[0].dstSet                             = m_vkDescriptorSet;
+  writes[0].dstBinding                         = 0;
+  writes[0].descriptorCount                    = 1;
+  writes[0].descriptorType                     = vk::DescriptorType::eUniformBufferDynamic;
+  writes[0].pBufferInfo                        = &frameInfo;
+
+  writes[1].dstSet          = m_vkDescriptorSet;
+  writes[1].dstBinding      = 1;
+  writes[1].descriptorCount = 1;
+  writes[1].descriptorType  = vk::DescriptorType::eUniformBufferDynamic;
+  writes[1].pBufferInfo     = &objectInfo;
+
+  m_device.getDevice().updateDescriptorSets(writes, nullptr);
+}
+
+void VulkanUniformBuffer::beginFrame(uint32_t frameSlot)
+{
+  m_offset   = m_bytesPerFrame * frameSlot;
+  m_frameEnd = m_offset + m_bytesPerFrame;
+}
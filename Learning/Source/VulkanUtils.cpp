@@ -1,11 +1,25 @@
 #include "VulkanUtils.h"
 
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+
+// Диспетчер vulkan.hpp по умолчанию (VULKAN_HPP_DISPATCH_LOADER_DYNAMIC): единственное
+// определение на программу
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
 namespace VulkanUtils
 {
+  namespace
+  {
+    // Кэш байт-кода шейдеров, ключ - путь в том виде, в котором его передают конвейеры
+    std::mutex                                         g_shaderCacheMutex;
+    std::unordered_map<std::string, std::vector<char>> g_shaderCache;
+  }  // namespace
+
   bool checkVkResult(VkResult result, const std::string& message)
   {
     if (result != VK_SUCCESS)
@@ -37,4 +51,44 @@ namespace VulkanUtils
 
     return buffer;
   }
-}  // namespace VulkanUtils
\ No newline at end of file
+
+  size_t preloadShaders(const std::string& directory)
+  {
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory))
+    {
+      if (!entry.is_regular_file() || entry.path().extension() != ".spv")
+      {
+        continue;
+      }
+
+      // Чтение вне блокировки: конвейеры могут уже забирать готовые шейдеры
+      std::string       filename = directory + "/" + entry.path().filename().string();
+      std::vector<char> code     = readFile(filename);
+
+      std::lock_guard<std::mutex> lock(g_shaderCacheMutex);
+      g_shaderCache[filename] = std::move(code);
+      count++;
+    }
+    return count;
+  }
+
+  std::vector<char> loadShader(const std::string& filename)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_shaderCacheMutex);
+      auto                        it = g_shaderCache.find(filename);
+      if (it != g_shaderCache.end())
+      {
+        return it->second;
+      }
+    }
+    return readFile(filename);
+  }
+
+  void releaseShaderCache()
+  {
+    std::lock_guard<std::mutex> lock(g_shaderCacheMutex);
+    g_shaderCache.clear();
+  }
+}  // namespace VulkanUtils